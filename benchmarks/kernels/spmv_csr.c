@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// generated CSR matrix with random column indices, so x[col[j]] misses cache
+#define ROWS 2000000
+#define PER_ROW 16
+#define NNZ (ROWS * PER_ROW)
+#define REPEAT 10
+
+void spmv(int* row_ptr, int* col, double* val, double* x, double* y) {
+    for (int i = 0; i < ROWS; i++) {
+        double sum = 0.0;
+        for (int j = row_ptr[i]; j < row_ptr[i + 1]; j++) {
+            sum += val[j] * x[col[j]];
+        }
+        y[i] = sum;
+    }
+}
+
+int main() {
+    int* row_ptr = malloc((ROWS + 1) * sizeof(int));
+    int* col = malloc((size_t)NNZ * sizeof(int));
+    double* val = malloc((size_t)NNZ * sizeof(double));
+    double* x = malloc(ROWS * sizeof(double));
+    double* y = malloc(ROWS * sizeof(double));
+
+    unsigned seed = 12345;
+    for (int i = 0; i <= ROWS; i++) {
+        row_ptr[i] = i * PER_ROW;
+    }
+    for (int j = 0; j < NNZ; j++) {
+        seed = seed * 1103515245u + 12345u;
+        col[j] = (int)((seed >> 8) % ROWS);
+        val[j] = 1.0 / (1 + j % PER_ROW);
+    }
+    for (int i = 0; i < ROWS; i++) {
+        x[i] = 1.0 + (i % 100) * 0.01;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int r = 0; r < REPEAT; r++) {
+        spmv(row_ptr, col, val, x, y);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    // time on stdout like the polybench kernels, checksum on stderr so it isn't dead code
+    printf("%f\n", (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9);
+    double checksum = 0.0;
+    for (int i = 0; i < ROWS; i++) {
+        checksum += y[i];
+    }
+    fprintf(stderr, "checksum %f\n", checksum);
+
+    free(row_ptr);
+    free(col);
+    free(val);
+    free(x);
+    free(y);
+    return 0;
+}
@@ -0,0 +1,53 @@
+#!/bin/bash
+
+# benchmark for --prefetch on a generated CSR SpMV: baseline vs paralyze with and
+# without prefetches of the x[col[j]] gather
+# usage: ./run_prefetch.sh
+
+set -e
+
+kernel_dir="../kernels"
+paralyze_bin="../../build/paralyze"
+results_dir="../results"
+kernel="spmv_csr"
+
+echo "=== benchmarking $kernel prefetch ==="
+
+# paralyze always writes <name>_openmp.c, so the prefetch run works on a copy
+cp $kernel_dir/$kernel.c ${kernel}_plain.c
+cp $kernel_dir/$kernel.c ${kernel}_prefetch.c
+
+echo "generating paralyze versions..."
+$paralyze_bin --generate-pragmas ${kernel}_plain.c
+$paralyze_bin --generate-pragmas --prefetch ${kernel}_prefetch.c
+
+echo "compiling baseline..."
+clang -O3 $kernel_dir/$kernel.c -o ${kernel}_baseline
+
+echo "compiling paralyze versions..."
+clang -O3 -fopenmp ${kernel}_plain_openmp.c -o ${kernel}_paralyze
+clang -O3 -fopenmp ${kernel}_prefetch_openmp.c -o ${kernel}_prefetch
+
+echo "running baseline..."
+baseline_time=$(./${kernel}_baseline 2>/dev/null)
+echo "baseline: $baseline_time seconds"
+
+row="$kernel,$baseline_time"
+for threads in 1 2 4 8; do
+    export OMP_NUM_THREADS=$threads
+    plain=$(./${kernel}_paralyze 2>/dev/null)
+    prefetch=$(./${kernel}_prefetch 2>/dev/null)
+    echo "  $threads threads: $plain seconds, $prefetch with prefetch"
+    row="$row,$plain,$prefetch"
+done
+
+# save results
+mkdir -p $results_dir
+if [ ! -f $results_dir/prefetch.csv ]; then
+    echo "kernel,baseline,paralyze_1t,prefetch_1t,paralyze_2t,prefetch_2t,paralyze_4t,prefetch_4t,paralyze_8t,prefetch_8t" > $results_dir/prefetch.csv
+fi
+echo "$row" >> $results_dir/prefetch.csv
+
+rm -f ${kernel}_plain.c ${kernel}_prefetch.c
+
+echo "=== done ==="
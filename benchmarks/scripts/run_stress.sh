@@ -0,0 +1,74 @@
+#!/bin/bash
+
+# analysis-time stress test: one loop unrolled into more and more statements, the
+# shape generated code and manual unrolling produce. with array accesses bucketed per
+# array and identical subscripts checked once, time should grow about linearly
+# usage: ./run_stress.sh [max_statements]
+
+set -e
+
+paralyze_bin="../../build/paralyze"
+results_dir="../results"
+max_statements=${1:-16000}
+
+if [ ! -x "$paralyze_bin" ]; then
+    echo "error: $paralyze_bin not found, build paralyze first"
+    exit 1
+fi
+
+# stress_<n>.c: n statements over a, b and c, with repeated, shifted and indirect subscripts
+generate() {
+    local n=$1
+    local file=$2
+    {
+        echo "#define N 100000"
+        echo "double a[N + 64], b[N + 64], c[N + 64];"
+        echo "int idx[N + 64];"
+        echo ""
+        echo "void stress(void) {"
+        echo "    for (int i = 1; i < N; i++) {"
+        for ((k = 0; k < n; k++)); do
+            case $((k % 4)) in
+            0) echo "        a[i] = b[i + $((k % 32))] * 0.5;" ;;
+            1) echo "        c[i + $((k % 16))] += b[i - 1];" ;;
+            2) echo "        b[i] = a[idx[i]] + c[i];" ;;
+            3) echo "        a[2 * i] = a[2 * i] + b[i + $((k % 8))];" ;;
+            esac
+        done
+        echo "    }"
+        echo "}"
+    } > $file
+}
+
+echo "=== analysis stress test ==="
+
+rows=""
+for ((n = 250; n <= max_statements; n *= 2)); do
+    generate $n stress_$n.c
+
+    start=$(date +%s.%N)
+    $paralyze_bin --stats=json stress_$n.c > /dev/null 2> stress_$n.json
+    end=$(date +%s.%N)
+    seconds=$(awk "BEGIN { print $end - $start }")
+
+    # flat microseconds per statement is linear growth
+    per_statement=$(awk "BEGIN { printf \"%.1f\", ($end - $start) * 1000000 / $n }")
+
+    # pull the counters out of the --stats=json line
+    accesses=$(grep -o '"accesses": {"total": [0-9]*' stress_$n.json | grep -o '[0-9]*$')
+    pairs=$(grep -o '"pairs": {"total": [0-9]*' stress_$n.json | grep -o '[0-9]*$')
+    echo "  $n statements: $accesses accesses, $pairs pairs compared, $seconds seconds" \
+        "($per_statement us per statement)"
+    rows="$rows$n,$accesses,$pairs,$seconds,$per_statement\n"
+
+    rm -f stress_$n.c stress_$n.json
+done
+
+# save results
+mkdir -p $results_dir
+if [ ! -f $results_dir/stress.csv ]; then
+    echo "statements,accesses,pairs,seconds,us_per_statement" > $results_dir/stress.csv
+fi
+printf "$rows" >> $results_dir/stress.csv
+
+echo "=== done ==="
@@ -1,10 +1,14 @@
 #pragma once
 
+#include "analyzer/AnalysisStats.h"
 #include "analyzer/DependencyAnalyzer.h"
 #include "analyzer/LoopVisitor.h"
+#include "analyzer/PragmaGenerator.h"
+#include "analyzer/ReportWriter.h"
 #include "clang/AST/ASTConsumer.h"
 #include "clang/AST/RecursiveASTVisitor.h"
 #include "clang/Frontend/CompilerInstance.h"
+#include "llvm/Support/TimeProfiler.h"
 
 namespace paralyze
 {
@@ -35,17 +39,32 @@ public:
   }
 
   void setPragmaVerbose(bool verbose) { pragma_verbose_ = verbose; }
+  void setProcBindPolicy(ProcBindPolicy policy) { proc_bind_policy_ = policy; }
+  void setMachine(const MachineModel& machine) { machine_ = machine; }
+  void setPrefetch(bool enabled) { prefetch_ = enabled; }
+  void setReport(ReportFormat format, std::ostream* out, const std::string& input_file)
+  {
+    report_format_ = format;
+    report_out_ = out;
+    input_filename_ = input_file;
+  }
 
   bool VisitFunctionDecl(clang::FunctionDecl* func);
   void runAnalysis();
 
 private:
+  void writeReport(); // --format=json / sarif
   clang::ASTContext* context_;
   DependencyAnalyzer dependency_analyzer_;
   LoopVisitor loop_visitor_;
   bool generate_pragmas_; // whether to emit pragmas
   bool verbose_;
   bool pragma_verbose_;
+  ProcBindPolicy proc_bind_policy_ = ProcBindPolicy::AUTO;
+  MachineModel machine_;
+  bool prefetch_ = false;
+  ReportFormat report_format_ = ReportFormat::TEXT;
+  std::ostream* report_out_ = nullptr; // stdout, even while the chatter on std::cout is muted
   std::string output_filename_;
   std::string input_filename_;
 };
@@ -54,7 +73,12 @@ private:
 class AnalyzerConsumer : public clang::ASTConsumer
 {
 public:
-  explicit AnalyzerConsumer(clang::ASTContext* context) : visitor_(context) {}
+  // made before clang starts on the file, so the wait until HandleTranslationUnit is parsing
+  explicit AnalyzerConsumer(clang::ASTContext* context)
+      : visitor_(context), created_(std::chrono::steady_clock::now())
+  {
+    llvm::timeTraceProfilerBegin("Frontend", "parse");
+  }
 
   void enablePragmaGeneration(const std::string& output_file, const std::string& input_file)
   {
@@ -65,14 +89,30 @@ public:
 
   void setPragmaVerbose(bool verbose) { visitor_.setPragmaVerbose(verbose); }
 
+  void setProcBindPolicy(ProcBindPolicy policy) { visitor_.setProcBindPolicy(policy); }
+
+  void setMachine(const MachineModel& machine) { visitor_.setMachine(machine); }
+
+  void setPrefetch(bool enabled) { visitor_.setPrefetch(enabled); }
+
+  void setReport(ReportFormat format, std::ostream* out, const std::string& input_file)
+  {
+    visitor_.setReport(format, out, input_file);
+  }
+
   void HandleTranslationUnit(clang::ASTContext& context) override
   {
+    std::chrono::duration<double> parse = std::chrono::steady_clock::now() - created_;
+    AnalysisStats::get().addTime(Phase::PARSE, parse.count());
+    llvm::timeTraceProfilerEnd();
+
     visitor_.TraverseDecl(context.getTranslationUnitDecl()); // walk entire TU
     visitor_.runAnalysis();
   }
 
 private:
   AnalyzerVisitor visitor_;
+  std::chrono::steady_clock::time_point created_;
 };
 
 } // namespace paralyze
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Decl.h"
+#include "clang/AST/Expr.h"
+#include <optional>
+#include <vector>
+
+namespace paralyze
+{
+
+// follows an array or pointer back to where its storage came from and reports the
+// alignment that storage is guaranteed to start on
+//   double* p = aligned_alloc(64, n * sizeof(double));   64
+//   posix_memalign((void**)&q, 32, bytes);                32
+//   static float grid[N];                                 ABI large-array alignment
+// 0 means unknown, e.g. a parameter or a pointer that is reassigned from elsewhere
+class AlignmentTracker
+{
+public:
+  explicit AlignmentTracker(clang::ASTContext* context) : context_(context) {}
+
+  unsigned knownAlignment(const clang::ValueDecl* decl) const; // in bytes
+
+private:
+  static constexpr unsigned kMaxHops = 4; // q = p copies followed before giving up
+
+  clang::ASTContext* context_;
+
+  unsigned arrayAlignment(const clang::VarDecl* var) const;
+  unsigned pointerAlignment(const clang::VarDecl* var, unsigned hops) const;
+  unsigned valueAlignment(const clang::Expr* value, unsigned hops) const;
+  std::optional<unsigned> allocatorAlignment(const clang::CallExpr* call) const;
+
+  // every value stored into var in the function body; false if its address leaks
+  bool collectStores(const clang::Stmt* stmt, const clang::VarDecl* var,
+                     std::vector<const clang::Expr*>& values) const;
+};
+
+} // namespace paralyze
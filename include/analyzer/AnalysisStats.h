@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+
+namespace paralyze
+{
+
+// phases --stats times; the later ones run inside the earlier ones, so times are inclusive
+enum class Phase
+{
+  PARSE,       // clang building the AST
+  TRAVERSAL,   // LoopVisitor over every function body, dependence analysis included
+  DEPENDENCE,  // DependencyManager::analyzeLoop
+  ARRAY_PAIRS, // pairwise array access checks, cross-iteration included
+  PRAGMAS,     // PragmaGenerator
+  ANNOTATION,  // SourceAnnotator building and writing the output file
+  COUNT
+};
+
+// events --stats counts
+enum class Counter
+{
+  LOOPS,          // loops analyzed
+  ACCESSES,       // array accesses fed to dependence analysis
+  PAIRS,          // access pairs compared
+  PARENT_LOOKUPS, // ASTContext::getParents calls
+  ARENA_BYTES,    // bump-allocated per function, the per-function max bounds the peak
+  COUNT
+};
+
+// process-wide totals and per-function maxima for --stats
+//   Stats: clang parse 41.2 ms, loop traversal 12.8 ms (max 9.1 ms in solve), 2 loops ...
+// everything is a no-op until enabled, so the hot paths pay one branch
+class AnalysisStats
+{
+public:
+  static AnalysisStats& get();
+
+  void setEnabled(bool enabled) { enabled_ = enabled; }
+  bool isEnabled() const { return enabled_; }
+
+  // work from here on is charged to the function as well as to the totals
+  void beginFunction(const std::string& name);
+  void endFunction() { current_ = nullptr; }
+
+  void count(Counter counter, uint64_t amount = 1)
+  {
+    if (!enabled_)
+    {
+      return;
+    }
+    totals_.counters[index(counter)] += amount;
+    if (current_)
+    {
+      current_->counters[index(counter)] += amount;
+    }
+  }
+
+  void addTime(Phase phase, double seconds);
+
+  void printTable(std::ostream& out) const;
+  void printJson(std::ostream& out) const;
+
+private:
+  struct Tally
+  {
+    std::array<double, static_cast<size_t>(Phase::COUNT)> seconds{};
+    std::array<uint64_t, static_cast<size_t>(Counter::COUNT)> counters{};
+  };
+
+  bool enabled_ = false;
+  Tally totals_;
+  std::map<std::string, Tally> functions_;
+  Tally* current_ = nullptr;
+
+  static size_t index(Phase phase) { return static_cast<size_t>(phase); }
+  static size_t index(Counter counter) { return static_cast<size_t>(counter); }
+  static const char* name(Phase phase);
+  static const char* name(Counter counter);
+  static const char* key(Phase phase);
+  static const char* key(Counter counter);
+
+  // function with the largest value, empty when nothing was charged to one
+  double maxSeconds(Phase phase, std::string& function) const;
+  uint64_t maxCount(Counter counter, std::string& function) const;
+};
+
+// adds the time until the end of the scope to a phase
+class ScopedTimer
+{
+public:
+  explicit ScopedTimer(Phase phase)
+      : phase_(phase), running_(AnalysisStats::get().isEnabled())
+  {
+    if (running_)
+    {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~ScopedTimer()
+  {
+    if (running_)
+    {
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+      AnalysisStats::get().addTime(phase_, elapsed.count());
+    }
+  }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+  Phase phase_;
+  bool running_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace paralyze
@@ -15,6 +15,7 @@ struct ArrayAccess
   clang::SourceLocation location;
   unsigned line_number;
   bool is_write;
+  bool distinct_base = false; // an array object or a restrict pointer, no other name reaches it
 
   ArrayAccess(const std::string& name, clang::Expr* sub, clang::SourceLocation loc, unsigned line,
               bool write)
@@ -23,4 +24,29 @@ struct ArrayAccess
   }
 };
 
+// accesses to one array that share a subscript; the representatives are all a
+// pairwise check needs, however often an unrolled body repeats the subscript
+struct AccessGroup
+{
+  const ArrayAccess* first = nullptr;
+  const ArrayAccess* second = nullptr; // another access with the same subscript, if any
+  const ArrayAccess* write = nullptr;  // first store, if any
+
+  void add(const ArrayAccess* access)
+  {
+    if (!first)
+    {
+      first = access;
+    }
+    else if (!second)
+    {
+      second = access;
+    }
+    if (access->is_write && !write)
+    {
+      write = access;
+    }
+  }
+};
+
 } // namespace paralyze
@@ -65,6 +65,8 @@ private:
   std::string exprToString(clang::Expr* expr);
   bool isSimpleInductionAccess(clang::Expr* index, const std::string& induction_var);
   bool hasConstantOffset(clang::Expr* index1, clang::Expr* index2);
+  void checkArrayBucket(const std::vector<const ArrayAccess*>& accesses,
+                        const std::string& induction_var);
   void checkArrayAccessPair(const ArrayAccess& access1, const ArrayAccess& access2,
                             const std::string& induction_var);
 };
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "analyzer/LoopInfo.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Expr.h"
+#include "clang/AST/Stmt.h"
+#include <vector>
+
+namespace paralyze
+{
+
+// finds small work arrays declared before a loop that every iteration overwrites in full
+// before reading them:
+//   for (k = 0; k < K; k++) tmp[k] = in[i + k] * w[k];
+//   out[i] = tmp[0] + ... ;
+// such arrays carry nothing between iterations and can be private(tmp)
+class ArrayPrivatizer
+{
+public:
+  explicit ArrayPrivatizer(clang::ASTContext* context) : context_(context) {}
+
+  void analyzeLoop(clang::Stmt* loopStmt, LoopInfo& loop);
+  void setVerbose(bool verbose) { verbose_ = verbose; }
+
+private:
+  // every thread gets its own copy on its stack
+  static constexpr unsigned long long kMaxPrivateElements = 4096;
+
+  clang::ASTContext* context_;
+  bool verbose_ = false;
+
+  void collectCandidates(const clang::Stmt* stmt, const clang::Stmt* loopStmt,
+                         std::vector<const clang::VarDecl*>& candidates) const;
+  bool isWorkArray(const clang::VarDecl* var, const clang::Stmt* loopStmt) const;
+  bool isUsedOutside(const clang::Stmt* stmt, const clang::VarDecl* var,
+                     const clang::Stmt* loopStmt) const;
+
+  // walk one iteration in order, tracking which elements are already written
+  bool coverStatement(const clang::Stmt* stmt, const clang::VarDecl* var,
+                      std::vector<bool>& written) const;
+  bool coverFillLoop(const clang::ForStmt* fill, const clang::VarDecl* var,
+                     std::vector<bool>& written) const;
+  bool readsOnlyWritten(const clang::Stmt* stmt, const clang::VarDecl* var,
+                        const std::vector<bool>& written,
+                        const clang::VarDecl* fill_iterator) const;
+
+  const clang::ArraySubscriptExpr* elementOf(const clang::Expr* expr,
+                                             const clang::VarDecl* var) const;
+  bool constantIndex(const clang::Expr* index, const std::vector<bool>& written,
+                     size_t& element) const;
+  bool isRefTo(const clang::Expr* expr, const clang::VarDecl* var) const;
+  bool references(const clang::Stmt* stmt, const clang::VarDecl* var) const;
+  bool modifies(const clang::Stmt* stmt, const clang::VarDecl* var) const;
+  bool leavesEarly(const clang::Stmt* stmt) const;
+};
+
+} // namespace paralyze
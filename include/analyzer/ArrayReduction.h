@@ -0,0 +1,30 @@
+#pragma once
+
+#include "analyzer/LineEdit.h"
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+enum class ReductionStrategy
+{
+  UNRESOLVED, // recognized, but neither form can be emitted, so it stays a conflict
+  SECTION,    // reduction(+:hist[0:n]), each thread bins into a private copy
+  ATOMIC      // #pragma omp atomic on every update
+};
+
+// array only ever accumulated into at data-dependent positions, e.g. hist[key[i]]++
+struct ArrayReduction
+{
+  std::string array_name;
+  ReductionStrategy strategy = ReductionStrategy::UNRESOLVED;
+  std::string section_length;   // element count for the array section, empty when unknown
+  std::vector<unsigned> update_lines;
+  std::vector<LineEdit> edits;  // atomic directives above each update
+  std::string justification;    // why this strategy won
+
+  std::string section() const { return array_name + "[0:" + section_length + "]"; }
+};
+
+} // namespace paralyze
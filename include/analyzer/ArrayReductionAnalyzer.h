@@ -0,0 +1,62 @@
+#pragma once
+
+#include "analyzer/LoopInfo.h"
+#include "analyzer/SourceTextReader.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Expr.h"
+#include "clang/AST/Stmt.h"
+#include <set>
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+// finds arrays the loop only accumulates into, at positions the iterator doesn't pin down:
+//   for (i = 0; i < n; i++) hist[key[i]]++;
+// and picks between an array-section reduction and atomic updates
+class ArrayReductionAnalyzer
+{
+public:
+  explicit ArrayReductionAnalyzer(clang::ASTContext* context) : context_(context), source_(context)
+  {
+  }
+
+  void analyzeLoop(clang::Stmt* loopStmt, LoopInfo& loop);
+  void setVerbose(bool verbose) { verbose_ = verbose; }
+
+private:
+  // past this, zeroing and merging per-thread copies costs more than the contention it saves
+  static constexpr long long kMaxSectionElements = 1 << 16;
+
+  // one hist[idx] += e (or ++, --, -=, hist[idx] = hist[idx] + e) statement
+  struct Update
+  {
+    const clang::VarDecl* array;
+    const clang::ArraySubscriptExpr* element;
+    const clang::Expr* stmt;
+  };
+
+  clang::ASTContext* context_;
+  SourceTextReader source_;
+  bool verbose_ = false;
+
+  void collectUpdates(const clang::Stmt* stmt, std::vector<Update>& updates,
+                      std::set<const clang::VarDecl*>& other_uses) const;
+  bool matchUpdate(const clang::Expr* expr, Update& update, const clang::Expr*& addend) const;
+  void collectReferences(const clang::Stmt* stmt, std::set<const clang::VarDecl*>& vars) const;
+  bool followsIterator(const clang::Expr* index, const LoopInfo& loop) const;
+
+  bool sectionLength(const clang::VarDecl* array, const std::vector<Update>& updates,
+                     const clang::Stmt* loopStmt, std::string& length,
+                     long long& elements) const;
+  bool indexBound(const clang::Expr* index, const clang::Stmt* loopStmt, std::string& length,
+                  long long& elements) const;
+  bool isInvariant(const clang::Expr* expr, const clang::Stmt* loopStmt) const;
+  bool assignsAny(const clang::Stmt* stmt, const std::set<const clang::VarDecl*>& vars) const;
+
+  void chooseStrategy(ArrayReduction& reduction, long long elements, const LoopInfo& loop) const;
+  bool buildAtomicEdits(const std::vector<Update>& updates, ArrayReduction& reduction) const;
+};
+
+} // namespace paralyze
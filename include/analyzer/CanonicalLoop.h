@@ -0,0 +1,44 @@
+#pragma once
+
+#include "analyzer/LineEdit.h"
+#include "clang/AST/Expr.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+// how a non-for loop was brought into canonical for-form
+enum class CanonicalForm
+{
+  NONE,
+  POINTER_WALK,    // while (*s) { *d++ = *s++; } -> indexed for loop
+  COUNTED_WHILE,   // i = 0; while (i < n) { ...; i++; } -> for (i = 0; i < n; i++)
+  COUNTED_DO_WHILE // same, for do-while loops whose first test provably holds
+};
+
+// canonical for-form of a while/do-while loop
+struct CanonicalLoop
+{
+  CanonicalForm form = CanonicalForm::NONE;
+  std::string index_var;                    // loop index used by the for-form
+  std::string trip_count;                   // expression text for the iteration count
+  std::vector<std::string> walked_pointers; // pointers advanced by one element per iteration
+  clang::Expr* index_ref = nullptr;         // synthesized reference to index_var, not owned
+  std::vector<LineEdit> edits;              // source edits that produce the for-form
+
+  bool isCanonical() const { return form != CanonicalForm::NONE; }
+  bool isCounted() const
+  {
+    return form == CanonicalForm::COUNTED_WHILE || form == CanonicalForm::COUNTED_DO_WHILE;
+  }
+
+  bool walksPointer(const std::string& name) const
+  {
+    return std::find(walked_pointers.begin(), walked_pointers.end(), name) !=
+           walked_pointers.end();
+  }
+};
+
+} // namespace paralyze
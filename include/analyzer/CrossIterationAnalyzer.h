@@ -59,6 +59,11 @@ private:
   void analyzeArrayAccessPattern(const std::string& array_name,
                                  const std::vector<ArrayAccess>& accesses,
                                  const std::string& induction_var);
+  void recordOffsetConflict(const std::string& array_name, const ArrayAccess& access1,
+                            const ArrayAccess& access2, int offset1, int offset2,
+                            const std::string& induction_var);
+  void recordComplexConflict(const std::string& array_name, const ArrayAccess& access1,
+                             const ArrayAccess& access2);
 
   bool detectsStridePattern(clang::Expr* index, const std::string& induction_var, int& stride);
   bool hasOffsetFromInduction(clang::Expr* index, const std::string& induction_var, int& offset);
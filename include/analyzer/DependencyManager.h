@@ -23,6 +23,7 @@ public:
 
   void analyzeLoop(LoopInfo& loop);
   bool isLoopParallelizable(const LoopInfo& loop) const;
+  bool isSafelenCovered(const LoopInfo& loop) const;
   void setVerbose(bool verbose) { verbose_ = verbose; }
   void mapPragmaLocations(const std::vector<LoopInfo>& loops);
   void generatePragmas(const std::vector<LoopInfo>& loops);
@@ -52,6 +53,7 @@ private:
   void runArrayAnalysis(LoopInfo& loop);
   void runPointerAnalysis(LoopInfo& loop);
   void runFunctionAnalysis(LoopInfo& loop);
+  void runControlFlowAnalysis(LoopInfo& loop);
   void recordWarning(const std::string& warning);
   bool hasScalarDependencies(const LoopInfo& loop) const;
 };
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "analyzer/LineEdit.h"
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+// perfect nest whose carried dependences all have constant distances, run as a
+// doacross pipeline: #pragma omp for ordered(n) with depend(sink)/depend(source)
+struct DoacrossNest
+{
+  unsigned depth = 0;                        // loops covered by ordered(n), 0 when not pipelined
+  std::vector<std::string> iterators;        // outermost first
+  std::vector<std::vector<long long>> sinks; // lexicographically negative distance vectors
+  std::vector<LineEdit> edits;               // ordered directives around the innermost body
+
+  bool isPipelined() const { return depth > 0; }
+};
+
+} // namespace paralyze
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "analyzer/LoopInfo.h"
+#include "analyzer/SourceTextReader.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Expr.h"
+#include "clang/AST/Stmt.h"
+#include <set>
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+// finds perfect nests like seidel-2d where every array written in the body is only read at
+// constant offsets from the written element:
+//   A[i][j] = (A[i-1][j] + A[i][j-1] + A[i+1][j] + A[i][j+1]) / 4;
+// and turns the distances into depend(sink) vectors for an ordered(n) doacross loop
+class DoacrossAnalyzer
+{
+public:
+  explicit DoacrossAnalyzer(clang::ASTContext* context) : context_(context), source_(context) {}
+
+  bool analyzeNest(std::vector<LoopInfo>& loops, size_t root);
+  void setVerbose(bool verbose) { verbose_ = verbose; }
+
+private:
+  // one array reference in the innermost body, split into per-dimension offsets
+  struct NestAccess
+  {
+    std::string array_name;
+    std::vector<long long> offsets; // offset from each nest iterator, outermost first
+    bool affine = true;             // every dimension is iterator + constant, in nest order
+    bool is_write = false;
+  };
+
+  clang::ASTContext* context_;
+  SourceTextReader source_;
+  bool verbose_ = false;
+
+  bool collectNest(const std::vector<LoopInfo>& loops, size_t root,
+                   std::vector<size_t>& nest) const;
+  bool isUnitStepUp(const LoopInfo& loop) const;
+  bool referencesAny(const clang::Stmt* stmt, const std::set<std::string>& names) const;
+
+  bool walkBody(const clang::Stmt* stmt, const clang::Stmt* root,
+                const std::vector<std::string>& iterators, const std::set<std::string>& safe_calls,
+                std::vector<NestAccess>& accesses) const;
+  bool recordTarget(const clang::Expr* target, const clang::Stmt* root,
+                    const std::vector<std::string>& iterators,
+                    const std::set<std::string>& safe_calls,
+                    std::vector<NestAccess>& accesses) const;
+  bool recordArrayAccess(const clang::ArraySubscriptExpr* access, bool is_write,
+                         const clang::Stmt* root, const std::vector<std::string>& iterators,
+                         const std::set<std::string>& safe_calls,
+                         std::vector<NestAccess>& accesses) const;
+  bool offsetFrom(const clang::Expr* index, const std::string& iterator, long long& offset) const;
+  bool isDeclaredOutside(const clang::VarDecl* var, const clang::Stmt* root) const;
+
+  bool computeSinks(const std::vector<NestAccess>& accesses, size_t depth,
+                    std::vector<std::vector<long long>>& sinks) const;
+  void pruneSinks(std::vector<std::vector<long long>>& sinks) const;
+  std::string sinkClause(const std::vector<long long>& sink,
+                         const std::vector<std::string>& iterators) const;
+  bool buildOrderedEdits(const LoopInfo& innermost, DoacrossNest& nest) const;
+};
+
+} // namespace paralyze
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "analyzer/LineEdit.h"
+#include "clang/AST/Stmt.h"
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+enum class EarlyExitKind
+{
+  BREAK,
+  RETURN,
+  GOTO
+};
+
+// a statement that leaves the loop before the trip count runs out
+struct EarlyExit
+{
+  EarlyExitKind kind;
+  clang::Stmt* stmt;
+  unsigned line_number;
+
+  EarlyExit(EarlyExitKind exit_kind, clang::Stmt* exit_stmt, unsigned line)
+      : kind(exit_kind), stmt(exit_stmt), line_number(line)
+  {
+  }
+};
+
+// loop that stops at the first iteration passing a side-effect free test
+struct SearchLoop
+{
+  bool is_search = false;
+  bool counter_outside = false; // iterator declared before the loop, needs lastprivate
+  std::string hit_var;          // set once any iteration matched
+  std::string first_var;        // lowest matching index
+  std::vector<LineEdit> edits;  // cancel + lowest-index combine rewrite
+};
+
+} // namespace paralyze
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "analyzer/LoopInfo.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Expr.h"
+#include "clang/AST/Stmt.h"
+#include <map>
+#include <string>
+
+namespace paralyze
+{
+
+// finds arrays a loop splits across its iterations by the leading subscript:
+//   for (i = 0; i < n; i++) { a[i] = 0.0; b[i][j] = ...; }
+// iteration i owns row i of a and b, so the thread running it is the one that first
+// touches those pages when this loop is the array's initializer
+class FirstTouchAnalyzer
+{
+public:
+  explicit FirstTouchAnalyzer(clang::ASTContext* context) : context_(context) {}
+
+  void analyzeLoop(clang::Stmt* loopStmt, LoopInfo& loop);
+  void setVerbose(bool verbose) { verbose_ = verbose; }
+
+private:
+  clang::ASTContext* context_;
+  bool verbose_ = false;
+
+  // per array: every access leads with the iterator, and whether any of them writes
+  struct Partition
+  {
+    bool by_iterator = true;
+    bool written = false;
+  };
+
+  void collect(const clang::Stmt* stmt, const std::string& iterator, bool is_write,
+               std::map<std::string, Partition>& arrays) const;
+  void recordElement(const clang::ArraySubscriptExpr* element, const std::string& iterator,
+                     bool is_write, std::map<std::string, Partition>& arrays) const;
+};
+
+} // namespace paralyze
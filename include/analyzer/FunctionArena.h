@@ -0,0 +1,64 @@
+#pragma once
+
+#include "llvm/Support/Allocator.h"
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <set>
+#include <type_traits>
+#include <vector>
+
+namespace paralyze
+{
+
+// standard allocator over the bump arena of the function being traversed; frees are no-ops
+// and the whole arena goes at once when the function is done. without an arena it falls
+// back to the heap, which is what anything outliving the function has to use
+template <typename T> class ArenaAllocator
+{
+public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  ArenaAllocator() = default;
+  explicit ArenaAllocator(llvm::BumpPtrAllocator* arena) : arena_(arena) {}
+  template <typename U> ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena()) {}
+
+  T* allocate(size_t count)
+  {
+    if (!arena_)
+    {
+      return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+    return static_cast<T*>(arena_->Allocate(count * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* pointer, size_t)
+  {
+    if (!arena_)
+    {
+      ::operator delete(pointer);
+    }
+  }
+
+  llvm::BumpPtrAllocator* arena() const { return arena_; }
+
+  template <typename U> bool operator==(const ArenaAllocator<U>& other) const
+  {
+    return arena_ == other.arena();
+  }
+  template <typename U> bool operator!=(const ArenaAllocator<U>& other) const
+  {
+    return arena_ != other.arena();
+  }
+
+private:
+  llvm::BumpPtrAllocator* arena_ = nullptr;
+};
+
+template <typename T> using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+template <typename T> using ArenaSet = std::set<T, std::less<T>, ArenaAllocator<T>>;
+
+} // namespace paralyze
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+
+namespace paralyze
+{
+
+// kinds of line-level edits applied to the annotated output
+enum class LineEditKind
+{
+  REPLACE,       // swap the line content for text
+  REMOVE,        // drop the line
+  INSERT_BEFORE, // add text above the line (and above its pragma)
+  INSERT_AFTER   // add text below the line
+};
+
+// single edit against one line of the original source
+struct LineEdit
+{
+  unsigned line_number;
+  LineEditKind kind;
+  std::string text; // may span several lines separated by '\n'
+
+  LineEdit(unsigned line, LineEditKind edit_kind, const std::string& edit_text = "")
+      : line_number(line), kind(edit_kind), text(edit_text)
+  {
+  }
+};
+
+} // namespace paralyze
@@ -2,6 +2,7 @@
 
 #include "clang/AST/Expr.h"
 #include "clang/AST/Stmt.h"
+#include <optional>
 #include <string>
 
 namespace paralyze
@@ -15,6 +16,10 @@ struct LoopBounds
   clang::Expr* condition_expr;
   clang::Expr* increment_expr;
   bool is_simple_pattern;
+  std::optional<long long> constant_trip_count; // when init, bound and step are constants
+  long long step = 0;          // constant iterator change per iteration, 0 if unknown
+  std::string trip_count_text; // iteration count as written, e.g. "n - 1", empty if unknown
+  std::string start_text;      // first iterator value as written, set along with the count
 
   LoopBounds()
       : init_expr(nullptr), condition_expr(nullptr), increment_expr(nullptr),
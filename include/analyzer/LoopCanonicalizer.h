@@ -0,0 +1,106 @@
+#pragma once
+
+#include "analyzer/LoopInfo.h"
+#include "analyzer/SourceTextReader.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Stmt.h"
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+// text replacement inside a single source line
+struct ColumnReplacement
+{
+  unsigned line_number;
+  unsigned begin_column; // 1-based, inclusive
+  unsigned end_column;   // 1-based, exclusive
+  std::string text;
+
+  ColumnReplacement(unsigned line, unsigned begin, unsigned end, const std::string& replacement)
+      : line_number(line), begin_column(begin), end_column(end), text(replacement)
+  {
+  }
+};
+
+// brings while and do-while loops into canonical for-form so the normal dependency analysis applies
+class LoopCanonicalizer
+{
+public:
+  explicit LoopCanonicalizer(clang::ASTContext* context) : context_(context), source_(context) {}
+
+  bool canonicalizeWhileLoop(clang::WhileStmt* whileLoop, LoopInfo& loop);
+  bool canonicalizeDoLoop(clang::DoStmt* doLoop, LoopInfo& loop);
+  void setVerbose(bool verbose) { verbose_ = verbose; }
+
+private:
+  // bookkeeping while scanning the body of a candidate pointer walk
+  struct PointerWalkScan
+  {
+    std::string index_var;
+    std::map<std::string, unsigned> increments; // pointer -> unit steps per iteration
+    std::set<std::string> advanced;             // pointers already stepped in this iteration
+    std::set<std::string> dereferenced;
+    std::set<std::string> written_through; // *p = ...
+    std::set<std::string> bare_uses;       // anything other than *p, *p++ or p++
+    std::vector<ColumnReplacement> replacements;
+    std::set<unsigned> removed_lines; // lines holding only a pointer step
+    bool valid = true;
+  };
+
+  clang::ASTContext* context_;
+  SourceTextReader source_;
+  bool verbose_ = false;
+
+  // pointer walks: while (*s) { *d++ = *s++; }
+  bool matchPointerWalk(clang::WhileStmt* whileLoop, LoopInfo& loop);
+  void scanWalkStatement(clang::Stmt* stmt, PointerWalkScan& scan);
+  void scanWalkExpr(clang::Stmt* stmt, PointerWalkScan& scan, bool is_write, bool conditional);
+  bool isPointerStep(clang::Expr* expr, std::string& name) const;
+  std::string walkTripCount(clang::Expr* cond, const PointerWalkScan& scan) const;
+
+  // counted loops: init before the loop, invariant bound, single step at the end of the body
+  struct CountedLoop
+  {
+    clang::VarDecl* counter = nullptr;
+    clang::Expr* init = nullptr;
+    clang::Stmt* init_stmt = nullptr;
+    clang::Expr* step = nullptr;
+    clang::BinaryOperatorKind relation = clang::BO_LT; // counter <relation> bound
+    clang::Expr* bound = nullptr;
+  };
+
+  bool matchCountedLoop(clang::Stmt* loopStmt, clang::Expr* cond, clang::Stmt* body,
+                        CountedLoop& counted);
+  bool isCounterStep(clang::Expr* expr, clang::VarDecl*& counter, int& step) const;
+  bool isCounterInit(clang::Stmt* stmt, clang::VarDecl* counter, clang::Expr*& init) const;
+  bool firstTestHolds(const CountedLoop& counted) const;
+  bool isLoopInvariant(clang::Expr* expr, const std::map<std::string, unsigned>& written,
+                       bool body_has_calls) const;
+  void collectWrites(clang::Stmt* stmt, std::map<std::string, unsigned>& written,
+                     bool& has_calls) const;
+  bool hasEarlyExit(clang::Stmt* stmt, bool in_nested_loop, bool in_switch) const;
+  clang::Stmt* findPrecedingStatement(clang::Stmt* stmt);
+  std::string countedHeader(const CountedLoop& counted, clang::Expr* cond) const;
+  void removeStatement(clang::Expr* expr, std::vector<LineEdit>& edits,
+                       std::vector<ColumnReplacement>& replacements) const;
+  void finishCountedLoop(const CountedLoop& counted, clang::Expr* cond, CanonicalForm form,
+                         std::vector<LineEdit> edits, std::vector<ColumnReplacement> replacements,
+                         LoopInfo& loop);
+
+  // shared helpers
+  bool isLocalPointer(clang::Expr* expr, std::string& name) const;
+  bool isZeroLiteral(clang::Expr* expr) const;
+  std::string trimmedLine(unsigned line) const;
+  bool isInCompoundStmt(clang::Stmt* stmt);
+  bool addReplacement(clang::SourceRange range, const std::string& text,
+                      std::vector<ColumnReplacement>& replacements) const;
+  std::string applyReplacements(unsigned line,
+                                const std::vector<ColumnReplacement>& replacements) const;
+  clang::Expr* createIndexRef(const std::string& name, clang::SourceLocation loc);
+};
+
+} // namespace paralyze
@@ -1,11 +1,23 @@
 #pragma once
 
 #include "analyzer/ArrayAccess.h"
+#include "analyzer/ArrayReduction.h"
+#include "analyzer/CanonicalLoop.h"
+#include "analyzer/Doacross.h"
+#include "analyzer/EarlyExit.h"
 #include "analyzer/LoopBounds.h"
 #include "analyzer/LoopMetrics.h"
+#include "analyzer/LoopTransform.h"
+#include "analyzer/NestAccessTable.h"
+#include "analyzer/Prefetch.h"
+#include "analyzer/Roofline.h"
+#include "analyzer/Scan.h"
+#include "analyzer/SharedUpdate.h"
+#include "analyzer/Simd.h"
 #include "analyzer/VariableInfo.h"
 #include "clang/AST/Stmt.h"
 #include "clang/Basic/SourceLocation.h"
+#include <algorithm>
 #include <map>
 #include <optional>
 #include <vector>
@@ -19,23 +31,45 @@ struct LoopInfo
   clang::Stmt* stmt;
   clang::SourceLocation location;
   unsigned line_number;
-  std::string loop_type; // for, while, or do-while
+  unsigned end_line_number = 0;
+  std::string indentation;   // leading whitespace of the loop's first line
+  std::string loop_type;     // for, while, or do-while
+  std::string function_name; // function whose body holds the loop
 
   // nesting
   unsigned depth = 0;
   std::optional<size_t> parent_loop_index;
   std::vector<size_t> child_loop_indices;
+  std::optional<size_t> next_sibling_loop; // loop that is the very next statement in the block
 
-  std::vector<ArrayAccess> array_accesses;
+  std::vector<ArrayAccess> array_accesses; // the loop's own statements, not its nested loops
+  AccessRange body_accesses; // into the function's NestAccessTable, nested loops included
+  std::vector<std::string> nest_conflicts; // arrays carried through nested loops
   LoopBounds bounds;
+  CanonicalLoop canonical; // set when a while loop was rewritten to for-form
+  std::vector<EarlyExit> early_exits;
+  SearchLoop search; // set when the early exit is a first-match search
+  LoopTransform transform;
+  DoacrossNest doacross; // set on the outer loop of a nest pipelined with ordered(n)
+  std::optional<size_t> fused_into; // earlier sibling that absorbed this loop's body
+  std::vector<std::string> private_arrays; // work arrays fully rewritten before use each iteration
+  std::vector<ArrayReduction> array_reductions; // accumulate-only arrays, e.g. hist[key[i]]++
+  SharedUpdates shared_updates; // scalar writes isolated under atomic / critical
+  ScanLoop scan;                // running sum rewritten for reduction(inscan)
+  SimdPlan simd;                // vector lanes, clauses and linear counters
+  PrefetchPlan prefetch;        // look-ahead prefetches for indirect gathers
+  std::map<std::string, bool> partitioned_arrays; // led by the iterator: a[i], b[i][j] -> written
   std::map<std::string, VariableInfo> variables;
 
-  LoopMetrics metrics; // performance metrics
+  LoopMetrics metrics;        // performance metrics
+  RooflineEstimate roofline; // flops and DRAM bytes per iteration
 
   // function calls
   std::vector<std::string> detected_function_calls;
   std::vector<bool> function_call_safety;
   bool has_dependencies = false;
+  bool safelen_covered = false; // the only dependences are recurrences simd.safelen stays under
+  std::vector<std::string> blocking_factors; // what the dependence analysis found, if anything
 
   LoopInfo(clang::Stmt* s, clang::SourceLocation loc, unsigned line, const std::string& type)
       : stmt(s), location(loc), line_number(line), loop_type(type)
@@ -108,10 +142,59 @@ struct LoopInfo
     return false;
   }
 
+  bool isPrivateArray(const std::string& name) const
+  {
+    return std::find(private_arrays.begin(), private_arrays.end(), name) != private_arrays.end();
+  }
+
+  // reductions that can be emitted no longer count as conflicts
+  bool isReductionArray(const std::string& name) const
+  {
+    for (const auto& reduction : array_reductions)
+      if (reduction.array_name == name && reduction.strategy != ReductionStrategy::UNRESOLVED)
+        return true;
+    return false;
+  }
+
+  bool isScanArray(const std::string& name) const
+  {
+    return scan.isScan() && scan.array_name == name;
+  }
+
+  bool hasArrayReduction(ReductionStrategy strategy) const
+  {
+    for (const auto& reduction : array_reductions)
+      if (reduction.strategy == strategy)
+        return true;
+    return false;
+  }
+
+  bool hasEarlyExit() const { return !early_exits.empty(); }
+  bool hasUnsafeEarlyExit() const { return hasEarlyExit() && !search.is_search; }
+
   bool isOutermost() const { return depth == 0; }
   bool isHot() const { return metrics.hotness_score > 10.0; }
   bool isParallelizable() const { return !has_dependencies; }
+  // fission, doacross and safelen-bounded simd leave a parallel loop even though the loop
+  // as written has dependencies
+  bool hasParallelForm() const
+  {
+    return !has_dependencies || transform.isFission() || doacross.isPipelined() ||
+           safelen_covered;
+  }
   bool hasParent() const { return parent_loop_index.has_value(); }
+
+  // what runs every iteration, whichever kind of loop this is
+  clang::Stmt* body() const
+  {
+    if (auto* forLoop = llvm::dyn_cast_or_null<clang::ForStmt>(stmt))
+      return forLoop->getBody();
+    if (auto* whileLoop = llvm::dyn_cast_or_null<clang::WhileStmt>(stmt))
+      return whileLoop->getBody();
+    if (auto* doLoop = llvm::dyn_cast_or_null<clang::DoStmt>(stmt))
+      return doLoop->getBody();
+    return nullptr;
+  }
 };
 
 } // namespace paralyze
\ No newline at end of file
@@ -11,8 +11,17 @@ struct LoopMetrics
   unsigned function_calls = 0;  // function call expressions
   unsigned comparisons = 0;     // <, >, ==
   unsigned assignments = 0;     // = and compound assignments
+  unsigned opaque_calls = 0;    // calls into user code whose cost we can't see
 
   double hotness_score = 0.0;
+  double iteration_cost = 0.0;     // estimated ops per iteration, nested loops included
+  double iteration_flops = 0.0;    // arithmetic and math-call ops, nested loops included
+  double iteration_accesses = 0.0; // memory accesses per iteration, nested loops included
+  bool uneven_iterations = false;  // iterations may do very different amounts of work
+
+  static constexpr double kCallCost = 10.0;            // rough ops behind one call
+  static constexpr double kAssumedTripCount = 16.0;    // nested loops with unknown bounds
+  static constexpr double kMemoryBoundIntensity = 2.0; // ops per access, below it bandwidth wins
 
   void calculateHotness()
   {
@@ -25,6 +34,23 @@ struct LoopMetrics
   {
     return arithmetic_ops + memory_accesses + function_calls + comparisons + assignments;
   }
+
+  // ops per memory access; loops below kMemoryBoundIntensity wait on bandwidth, not the ALUs
+  double arithmeticIntensity() const
+  {
+    return iteration_accesses > 0.0 ? iteration_flops / iteration_accesses : 0.0;
+  }
+  bool isMemoryBound() const
+  {
+    return iteration_accesses > 0.0 && arithmeticIntensity() < kMemoryBoundIntensity;
+  }
+
+  // ops in the loop's own body, not counting nested loops
+  double getOwnIterationCost() const
+  {
+    return arithmetic_ops + memory_accesses + comparisons + assignments +
+           function_calls * kCallCost;
+  }
 };
 
 } // namespace paralyze
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "analyzer/LineEdit.h"
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+// structural rewrites applied before parallelizing a loop
+enum class LoopTransformKind
+{
+  NONE,
+  FUSION, // the next sibling loop's body is merged into this loop
+  FISSION // statements without a carried dependence are split into a loop of their own
+};
+
+// result of fusing or splitting a loop, emitted as line edits
+struct LoopTransform
+{
+  LoopTransformKind kind = LoopTransformKind::NONE;
+  std::optional<size_t> fused_loop; // FUSION: the sibling whose body moved into this loop
+  size_t parallel_statements = 0;   // FISSION: statements kept in the parallel loop
+  size_t serial_statements = 0;     // FISSION: statements moved to the serial loop after it
+  std::string justification;        // dependence facts that make the rewrite legal
+  std::vector<LineEdit> edits;
+
+  bool isFusion() const { return kind == LoopTransformKind::FUSION; }
+  bool isFission() const { return kind == LoopTransformKind::FISSION; }
+};
+
+} // namespace paralyze
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "analyzer/LoopInfo.h"
+#include "analyzer/SourceTextReader.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Stmt.h"
+#include <set>
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+// restructures outermost loops using their recorded accesses:
+//   fusion  - merges a parallel loop into the parallel loop before it when both walk the same
+//             range and share arrays, so the data is streamed once
+//   fission - splits a loop with a carried dependence so the statements outside the
+//             recurrence get a parallel loop of their own
+class LoopTransformer
+{
+public:
+  explicit LoopTransformer(clang::ASTContext* context) : context_(context), source_(context) {}
+
+  bool tryFusion(std::vector<LoopInfo>& loops, size_t first, size_t second);
+  bool tryFission(std::vector<LoopInfo>& loops, size_t index);
+  void setVerbose(bool verbose) { verbose_ = verbose; }
+
+private:
+  // what one top-level body statement touches, taken from the loop's recorded accesses
+  struct StatementFootprint
+  {
+    clang::Stmt* stmt;
+    unsigned first_line;
+    unsigned last_line;
+    std::set<std::string> array_reads;
+    std::set<std::string> array_writes;
+    std::set<std::string> offset_arrays; // touched at something other than the bare iterator
+    std::set<std::string> scalar_reads;
+    std::set<std::string> scalar_writes;
+    bool opaque = false; // writes or calls the recorded accesses can't describe
+  };
+
+  clang::ASTContext* context_;
+  SourceTextReader source_;
+  bool verbose_ = false;
+
+  bool isRestructurable(const LoopInfo& loop) const;
+  bool hasPlainBlockBody(clang::ForStmt* forLoop) const;
+  std::string headerText(const LoopInfo& loop) const;
+
+  void collectAccesses(const std::vector<LoopInfo>& loops, size_t index,
+                       std::vector<const ArrayAccess*>& accesses) const;
+  void collectVariables(const std::vector<LoopInfo>& loops, size_t index,
+                        std::vector<const VariableInfo*>& variables) const;
+  void collectCalls(const std::vector<LoopInfo>& loops, size_t index,
+                    std::set<std::string>& safe_calls) const;
+  bool isBareIterator(const clang::Expr* subscript, const std::string& iterator) const;
+  bool isTrackedScalar(const VariableInfo& var, const clang::Stmt* loopStmt) const;
+
+  bool sharesArrayStreams(const std::vector<LoopInfo>& loops, size_t first, size_t second,
+                          std::string& shared) const;
+  bool hasCrossLoopConflict(const std::vector<LoopInfo>& loops, size_t first,
+                            size_t second) const;
+  bool hasNameClash(clang::ForStmt* first, clang::ForStmt* second) const;
+
+  std::vector<StatementFootprint> buildFootprints(const std::vector<LoopInfo>& loops,
+                                                  size_t index) const;
+  bool hasUntrackedEffects(const clang::Stmt* stmt, const std::set<std::string>& safe_calls) const;
+  bool containsContinue(const clang::Stmt* stmt) const;
+  std::vector<bool> partitionStatements(const std::vector<StatementFootprint>& footprints) const;
+};
+
+} // namespace paralyze
@@ -1,10 +1,27 @@
 #pragma once
 
+#include "analyzer/ArrayPrivatizer.h"
+#include "analyzer/ArrayReductionAnalyzer.h"
 #include "analyzer/DependencyAnalyzer.h"
+#include "analyzer/DoacrossAnalyzer.h"
+#include "analyzer/FirstTouchAnalyzer.h"
+#include "analyzer/FunctionArena.h"
+#include "analyzer/LoopCanonicalizer.h"
 #include "analyzer/LoopInfo.h"
+#include "analyzer/LoopTransformer.h"
+#include "analyzer/NestAccessTable.h"
+#include "analyzer/NestDependenceAnalyzer.h"
+#include "analyzer/PrefetchAnalyzer.h"
+#include "analyzer/RooflineAnalyzer.h"
+#include "analyzer/ScanAnalyzer.h"
+#include "analyzer/SearchLoopAnalyzer.h"
+#include "analyzer/SharedUpdateAnalyzer.h"
+#include "analyzer/SimdAnalyzer.h"
+#include "analyzer/SourceTextReader.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/RecursiveASTVisitor.h"
 #include <map>
+#include <set>
 #include <stack>
 #include <vector>
 
@@ -22,7 +39,14 @@ class LoopVisitor : public clang::RecursiveASTVisitor<LoopVisitor>
 {
 public:
   explicit LoopVisitor(clang::ASTContext* context, DependencyAnalyzer* analyzer)
-      : context_(context), dependency_analyzer_(analyzer), verbose_(false)
+      : context_(context), dependency_analyzer_(analyzer), canonicalizer_(context),
+        search_analyzer_(context), transformer_(context), doacross_analyzer_(context),
+        privatizer_(context), reduction_analyzer_(context), shared_update_analyzer_(context),
+        scan_analyzer_(context), simd_analyzer_(context), first_touch_analyzer_(context),
+        roofline_analyzer_(context), prefetch_analyzer_(context), nest_analyzer_(context),
+        source_(context),
+        inner_subscripts_(ArenaAllocator<const clang::ArraySubscriptExpr*>(&arena_)),
+        verbose_(false)
   {
   }
 
@@ -36,16 +60,62 @@ public:
   bool VisitUnaryOperator(clang::UnaryOperator* unaryOp);
   bool VisitCallExpr(clang::CallExpr* callExpr);
   bool VisitArraySubscriptExpr(clang::ArraySubscriptExpr* arrayExpr);
+  bool VisitBreakStmt(clang::BreakStmt* breakStmt);
+  bool VisitReturnStmt(clang::ReturnStmt* returnStmt);
+  bool VisitGotoStmt(clang::GotoStmt* gotoStmt);
+  bool VisitIndirectGotoStmt(clang::IndirectGotoStmt* gotoStmt);
 
   const std::vector<LoopInfo>& getLoops() const { return loops_; }
+  void setCurrentFunction(const std::string& name)
+  {
+    current_function_ = name;
+    function_first_loop_ = loops_.size();
+    nest_accesses_.clear();
+  }
+  void finishFunction(); // frees what only the traversal of the current function needed
   void printLoopSummary() const;
-  void setVerbose(bool verbose) { verbose_ = verbose; }
+  void setVerbose(bool verbose)
+  {
+    verbose_ = verbose;
+    canonicalizer_.setVerbose(verbose);
+    search_analyzer_.setVerbose(verbose);
+    transformer_.setVerbose(verbose);
+    doacross_analyzer_.setVerbose(verbose);
+    privatizer_.setVerbose(verbose);
+    reduction_analyzer_.setVerbose(verbose);
+    shared_update_analyzer_.setVerbose(verbose);
+    scan_analyzer_.setVerbose(verbose);
+    simd_analyzer_.setVerbose(verbose);
+    first_touch_analyzer_.setVerbose(verbose);
+    roofline_analyzer_.setVerbose(verbose);
+    prefetch_analyzer_.setVerbose(verbose);
+    nest_analyzer_.setVerbose(verbose);
+  }
 
 private:
   clang::ASTContext* context_;
   DependencyAnalyzer* dependency_analyzer_;
+  LoopCanonicalizer canonicalizer_;
+  SearchLoopAnalyzer search_analyzer_;
+  LoopTransformer transformer_;
+  DoacrossAnalyzer doacross_analyzer_;
+  ArrayPrivatizer privatizer_;
+  ArrayReductionAnalyzer reduction_analyzer_;
+  SharedUpdateAnalyzer shared_update_analyzer_;
+  ScanAnalyzer scan_analyzer_;
+  SimdAnalyzer simd_analyzer_;
+  FirstTouchAnalyzer first_touch_analyzer_;
+  RooflineAnalyzer roofline_analyzer_;
+  PrefetchAnalyzer prefetch_analyzer_;
+  NestDependenceAnalyzer nest_analyzer_;
+  SourceTextReader source_;
   std::vector<LoopInfo> loops_;
   std::stack<size_t> loop_stack_;
+  std::string current_function_;
+  size_t function_first_loop_ = 0;
+  NestAccessTable nest_accesses_; // this function's elements, every loop level ranges over it
+  llvm::BumpPtrAllocator arena_;  // usage lists and scratch of the function being traversed
+  ArenaSet<const clang::ArraySubscriptExpr*> inner_subscripts_; // a[i] of a recorded a[i][j]
   bool verbose_ = false;
 
   std::map<unsigned, LineArrayAccesses> line_access_summaries_;
@@ -68,15 +138,39 @@ private:
   bool isInsideLoop() const { return !loop_stack_.empty(); }
 
   void addLoop(clang::Stmt* stmt, clang::SourceLocation loc, const std::string& type);
+  void linkPreviousSibling(clang::Stmt* stmt, size_t index);
+  std::string traceDetail(size_t index) const; // function:line for --trace spans
+  void recordNestAccess(clang::ArraySubscriptExpr* element, const std::string& array,
+                        unsigned line, bool is_write);
+  void analyzeLoopBody(size_t index); // everything after the body traversal, any loop kind
+  void analyzeNestAccesses(size_t index); // closes the loop's table range and checks the nest
+  void restructureLoop(size_t index);
   void analyzeForLoopBounds(clang::ForStmt* forLoop, LoopInfo& info);
+  void computeTripCount(LoopInfo& info);
+  std::string tripCountText(const clang::Expr* start, const clang::Expr* limit,
+                            clang::BinaryOperatorKind relation, long long step,
+                            const LoopBounds& bounds) const;
+  bool mentionsVariable(const clang::Stmt* stmt, const std::string& name) const;
+  void estimateIterationWork(LoopInfo& loop);
+  bool dependsOnIteration(const clang::Stmt* stmt, const LoopInfo& outer) const;
+  bool isOpaqueCall(const clang::CallExpr* call) const; // user code, cost unknown
+  bool hasUnevenWork(const clang::Stmt* stmt, const LoopInfo& loop) const;
+  bool containsHeavyWork(const clang::Stmt* stmt) const; // a loop or an opaque call
+  bool hasParameterBoundLoop(const clang::Stmt* stmt, const clang::FunctionDecl* function) const;
+  bool referencesParameter(const clang::Stmt* stmt, const clang::FunctionDecl* function) const;
   void markInductionVariable(LoopInfo& loop);
   void finalizeDependencyAnalysis(LoopInfo& loop);
+  bool enclosesPipelinedNest(const LoopInfo& loop) const;
+  void recordEarlyExit(LoopInfo& loop, EarlyExitKind kind, clang::Stmt* stmt);
+  bool isInsideSwitch(clang::Stmt* stmt, const clang::Stmt* loopStmt);
+  bool containsLocation(const clang::Stmt* stmt, clang::SourceLocation loc) const;
 
   std::string extractArrayBaseName(clang::ArraySubscriptExpr* arrayExpr);
   std::string extractSubscriptString(clang::Expr* idx);
   void printArrayAccessSummary();
 
   std::string extractPointerBaseName(clang::Expr* expr);
+  bool isDistinctBase(const clang::Expr* base) const;
   bool isWriteAccessUnary(clang::UnaryOperator* unaryOp);
 
   bool isWriteAccess(clang::DeclRefExpr* declRef);
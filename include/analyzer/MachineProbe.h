@@ -0,0 +1,23 @@
+#pragma once
+
+#include "analyzer/Roofline.h"
+#include <cstddef>
+
+namespace paralyze
+{
+
+// measures memory bandwidth with a STREAM-style triad, once on one thread and once on
+// every core, so the roofline uses this machine's numbers instead of the defaults
+class MachineProbe
+{
+public:
+  MachineModel measure(MachineModel machine) const;
+
+private:
+  static constexpr size_t kProbeElements = 1 << 22; // 32 MiB per array, past the last-level cache
+  static constexpr int kProbeRuns = 3;               // best of, to skip page faults and warm-up
+
+  double triadBandwidth(unsigned threads) const; // GB/s
+};
+
+} // namespace paralyze
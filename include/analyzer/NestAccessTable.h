@@ -0,0 +1,67 @@
+#pragma once
+
+#include "clang/AST/Expr.h"
+#include "llvm/ADT/ArrayRef.h"
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+// one array element a function's loops load or store, every dimension together
+//   C[i][j] += A[i][k] * B[k][j];   three entries, two subscripts each
+struct NestTableEntry
+{
+  std::string array;
+  size_t first_subscript; // into the table's subscript store, outermost dimension first
+  unsigned dimensions;
+  unsigned line;
+  bool is_write;
+  size_t loop; // innermost loop around the access
+};
+
+// [begin, end) of the table entries inside a loop, nested loops included; accesses are
+// appended in traversal order, so every loop's range contains its children's
+struct AccessRange
+{
+  size_t begin = 0;
+  size_t end = 0;
+
+  bool empty() const { return begin == end; }
+};
+
+// the accesses of one function's loop nests, shared by every level of each nest instead
+// of copied up from the inner loops
+class NestAccessTable
+{
+public:
+  // between functions; the storage stays allocated for the next one
+  void clear()
+  {
+    accesses_.clear();
+    subscripts_.clear();
+  }
+
+  size_t size() const { return accesses_.size(); }
+  const NestTableEntry& operator[](size_t index) const { return accesses_[index]; }
+
+  void add(const std::string& array, llvm::ArrayRef<const clang::Expr*> subscripts, unsigned line,
+           bool is_write, size_t loop)
+  {
+    accesses_.push_back(NestTableEntry{array, subscripts_.size(),
+                                       static_cast<unsigned>(subscripts.size()), line, is_write,
+                                       loop});
+    subscripts_.insert(subscripts_.end(), subscripts.begin(), subscripts.end());
+  }
+
+  const clang::Expr* subscript(const NestTableEntry& access, unsigned dimension) const
+  {
+    return subscripts_[access.first_subscript + dimension];
+  }
+
+private:
+  std::vector<NestTableEntry> accesses_;
+  std::vector<const clang::Expr*> subscripts_;
+};
+
+} // namespace paralyze
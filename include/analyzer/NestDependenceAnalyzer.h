@@ -0,0 +1,43 @@
+#pragma once
+
+#include "analyzer/LoopInfo.h"
+#include "analyzer/NestAccessTable.h"
+#include "analyzer/SourceTextReader.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Expr.h"
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+// finds arrays an outer loop carries through its nested loops, which the per-loop array
+// analysis misses because it only sees the loop's own statements
+//   for (t...) for (i...) v[i] = u[i - 1] + u[i + 1];   every t shares all of u and v
+//   for (i...) for (j...) C[i][j] += A[i][k] * B[k][j];  iteration i owns row i of C
+// an array is fine when every access to it sits at the same place in one dimension
+class NestDependenceAnalyzer
+{
+public:
+  explicit NestDependenceAnalyzer(clang::ASTContext* context) : source_(context) {}
+
+  void analyzeLoop(size_t index, std::vector<LoopInfo>& loops, const NestAccessTable& table);
+  void setVerbose(bool verbose) { verbose_ = verbose; }
+
+private:
+  SourceTextReader source_;
+  bool verbose_ = false;
+
+  bool isPartitioned(const std::vector<size_t>& accesses, const NestAccessTable& table,
+                     const std::string& iterator) const;
+
+  // where a subscript sits along the iterator: "i", "i+1", "i*n" for a row of a flat array
+  std::optional<std::string> partitionKey(const clang::Expr* subscript,
+                                          const std::string& iterator) const;
+  std::optional<std::string> scaleKey(const clang::Expr* expr, const std::string& iterator) const;
+  bool isIterator(const clang::Expr* expr, const std::string& iterator) const;
+  bool mentions(const clang::Stmt* stmt, const std::string& name) const;
+};
+
+} // namespace paralyze
@@ -1,8 +1,12 @@
 #pragma once
 
 #include "analyzer/ConfidenceScorer.h"
+#include "analyzer/LineEdit.h"
 #include "analyzer/LoopInfo.h"
+#include <map>
 #include <memory>
+#include <optional>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -15,7 +19,19 @@ enum class PragmaType
   NO_PRAGMA,
   PARALLEL_FOR,
   PARALLEL_FOR_SIMD,
-  SIMD
+  SIMD,
+  TASKLOOP, // parallel + single + taskloop, for iterations of uneven cost
+  DOACROSS  // parallel for ordered(n), iterations wait on constant-distance sinks
+};
+
+// which proc_bind clause parallel loops get
+enum class ProcBindPolicy
+{
+  AUTO,   // spread for memory-bound loops, close for compute-bound ones
+  SPREAD, // threads over all places, for bandwidth
+  CLOSE,  // threads next to the primary thread, for shared caches
+  MASTER, // every thread on the primary thread's place
+  NONE    // no clause, OMP_PROC_BIND decides
 };
 
 // representation of a pragma for a loop
@@ -28,6 +44,10 @@ struct GeneratedPragma
   std::string reasoning;
   bool requires_private_vars = false;
   std::vector<std::string> private_variables;
+  std::vector<LineEdit> edits; // source rewrites that go with the pragma
+  std::string thread_guard;    // if() condition that keeps small instances serial
+  std::string thread_cap;      // num_threads() expression sized to the work
+  std::string proc_bind;       // spread, close or master, empty for no clause
   ConfidenceScore confidence;
 
   GeneratedPragma(PragmaType t, const std::string& text, const std::string& ltype, unsigned line,
@@ -47,21 +67,93 @@ public:
   void printPragmaSummary() const;
 
   const std::vector<GeneratedPragma>& getGeneratedPragmas() const { return generated_pragmas_; }
+  const GeneratedPragma* pragmaForLoop(size_t loop_index) const
+  {
+    auto it = pragma_for_loop_.find(loop_index);
+    return it != pragma_for_loop_.end() ? &generated_pragmas_[it->second] : nullptr;
+  }
 
   void setVerbose(bool verbose) { verbose_ = verbose; }
+  void setProcBindPolicy(ProcBindPolicy policy) { proc_bind_policy_ = policy; }
+  void setMachine(const MachineModel& machine) { machine_ = machine; }
+  void setPrefetch(bool enabled) { prefetch_enabled_ = enabled; }
 
 private:
   std::vector<GeneratedPragma> generated_pragmas_;
   std::unique_ptr<ConfidenceScorer> confidence_scorer_;
   bool verbose_ = false;
+  size_t rewritten_loop_count_ = 0; // counted while/do-while loops emitted in for-form
+  std::map<size_t, size_t> pragma_for_loop_; // loop index -> generated pragma index
+  size_t loop_fusion_count_ = 0;       // sibling loops merged into one loop body
+  size_t loop_fission_count_ = 0;      // loops split into a parallel and a serial loop
+  size_t doacross_count_ = 0;          // nests pipelined with ordered(n)
+  size_t array_reduction_count_ = 0;   // pragmas with reduction(+:array[0:n])
+  size_t synchronized_loop_count_ = 0; // loops with atomic / critical scalar updates
+  size_t scan_count_ = 0;              // pragmas with reduction(inscan)
+  size_t search_loop_count_ = 0;       // first-match searches with cancel for
+  std::vector<std::pair<unsigned, std::string>> peel_reports_; // line, how to reach alignment
+  std::set<size_t> parallel_levels_;   // loops that hold their nest's parallel for
+  size_t inner_level_count_ = 0;       // nests parallelized below the outermost loop
+  size_t guarded_loop_count_ = 0;      // pragmas with if() / num_threads() from the trip count
+  std::vector<std::string> first_touch_arrays_; // arrays whose initializer now matches its user
+  std::vector<std::pair<unsigned, std::string>> first_touch_advice_; // serial initializers
+  ProcBindPolicy proc_bind_policy_ = ProcBindPolicy::AUTO;
+  size_t spread_count_ = 0; // pragmas with proc_bind(spread)
+  size_t close_count_ = 0;  // pragmas with proc_bind(close)
+  MachineModel machine_;    // roofs the loop estimates are held against
+  std::vector<std::pair<unsigned, std::string>> roofline_reports_; // line, bound and speedup
+  bool prefetch_enabled_ = false; // --prefetch, off by default since it rewrites loop bodies
+  std::vector<std::pair<unsigned, std::string>> prefetch_reports_; // line, what is prefetched
+  std::vector<std::pair<unsigned, std::string>> prefetch_advice_;  // serial nests, not rewritten
 
-  PragmaType determinePragmaType(const LoopInfo& loop);
+  // region fusion stats
+  size_t fused_region_count_ = 0;
+  size_t fused_loop_count_ = 0;
+  size_t barriers_removed_ = 0;
+
+  static constexpr double kOpsPerTask = 10000.0; // keeps task overhead in the noise
+  static constexpr long long kMaxGrainsize = 4096;
+  static constexpr long long kMinTasks = 64; // enough tasks to even out uneven iterations
+  static constexpr long long kMinParallelTrips = 8;   // fewer iterations than a typical team
+  static constexpr double kOpsPerThread = 20000.0;    // work that hides a fork/join
+  static constexpr long long kMaxUsefulThreads = 256; // literal bounds this big need no guard
+
+  PragmaType determinePragmaType(const LoopInfo& loop, bool parallel_level);
+  PragmaType fusedPragmaType(PragmaType type, const LoopInfo& absorbed);
   std::string generatePragmaText(PragmaType type, const LoopInfo& loop);
   std::string generateReasoning(PragmaType type, const LoopInfo& loop);
+  std::string generateTaskloopClauses(const LoopInfo& loop) const;
+  void addThreadGuard(const LoopInfo& loop, GeneratedPragma& pragma);
+  std::string chooseProcBind(const LoopInfo& loop) const;
+  std::string describeProcBind(const LoopInfo& loop, const std::string& bind) const;
+  std::string describeRoofline(const LoopInfo& loop) const;
+  std::string threadClauses(const GeneratedPragma& pragma) const;
+  std::string procBindClause(const GeneratedPragma& pragma) const;
+  void eraseClause(std::string& text, const std::string& clause) const;
+
+  void attachPrefetches(const std::vector<LoopInfo>& loops);
+
+  // first-touch placement: initializers take the static schedule of the loops they feed
+  void placeFirstTouch(const std::vector<LoopInfo>& loops);
+  std::optional<size_t> findFirstToucher(const std::string& name, size_t use,
+                                         const std::vector<LoopInfo>& loops) const;
+  bool isWorksharing(PragmaType type) const;
   bool shouldUseSimd(const LoopInfo& loop);
-  bool hasSimpleArrayAccess(const LoopInfo& loop);
-  bool isInnerLoop(const LoopInfo& loop);
+  void chooseParallelLevels(size_t loop_index, const std::vector<LoopInfo>& loops);
+  bool hasProfitableLevelBelow(size_t loop_index, const std::vector<LoopInfo>& loops) const;
+  bool isIndependentLevel(const LoopInfo& loop) const;
+  bool isProfitableLevel(const LoopInfo& loop) const;
+  bool isInsidePipelinedNest(const LoopInfo& loop, const std::vector<LoopInfo>& loops) const;
   std::vector<std::string> identifyPrivateVariables(const LoopInfo& loop);
+
+  // merging adjacent parallel loops into one parallel region
+  void fuseParallelRegions(const std::vector<LoopInfo>& loops);
+  bool isFusable(size_t loop_index, const std::vector<LoopInfo>& loops) const;
+  void emitFusedRegion(const std::vector<size_t>& chain, const std::vector<LoopInfo>& loops);
+  void collectFootprint(size_t loop_index, const std::vector<LoopInfo>& loops,
+                        std::set<std::string>& reads, std::set<std::string>& writes,
+                        bool& aliased_write) const;
+  size_t lastFusedLoop(size_t loop_index, const std::vector<LoopInfo>& loops) const;
 };
 
 } // namespace paralyze
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "analyzer/LineEdit.h"
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+// software prefetches for gathers whose address comes from another array load
+//   y[i] += val[j] * x[col[j]];  ->  if (j + 16 < end) __builtin_prefetch(&x[col[j + 16]]);
+struct PrefetchPlan
+{
+  std::vector<std::string> accesses; // indirect accesses as written, e.g. x[col[j]]
+  unsigned distance = 0;             // iterations ahead, from the per-iteration cost
+  std::vector<LineEdit> edits;       // guarded prefetches at the top of the body
+
+  bool isPlanned() const { return !edits.empty(); }
+
+  std::string note() const
+  {
+    std::string text = "prefetching";
+    for (size_t i = 0; i < accesses.size(); i++)
+      text += (i > 0 ? ", " : " ") + accesses[i];
+    return text + " " + std::to_string(distance) + " iterations ahead";
+  }
+};
+
+} // namespace paralyze
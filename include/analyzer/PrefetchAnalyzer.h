@@ -0,0 +1,56 @@
+#pragma once
+
+#include "analyzer/LoopInfo.h"
+#include "analyzer/SourceTextReader.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Expr.h"
+#include "clang/AST/Stmt.h"
+#include <set>
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+// finds gathers in innermost loops whose subscript is itself an array load and plans
+// a prefetch of the element the loop will need a few iterations later
+//   for (j = lo; j < hi; j++) sum += val[j] * x[col[j]];
+// the load of col[j + d] is real, so the prefetch is guarded by the loop bound
+class PrefetchAnalyzer
+{
+public:
+  explicit PrefetchAnalyzer(clang::ASTContext* context) : context_(context), source_(context) {}
+
+  void analyzeLoop(clang::ForStmt* forLoop, LoopInfo& loop);
+  void setVerbose(bool verbose) { verbose_ = verbose; }
+
+private:
+  static constexpr double kMissLatencyOps = 200.0; // ops a core retires during one DRAM miss
+  static constexpr unsigned kMinDistance = 4;
+  static constexpr unsigned kMaxDistance = 64; // further ahead the lines get evicted unused
+  static constexpr size_t kMaxPrefetches = 4;  // each one costs a load and a compare
+
+  // one indirect access worth prefetching
+  struct Gather
+  {
+    const clang::ArraySubscriptExpr* element;
+    bool is_write;
+  };
+
+  clang::ASTContext* context_;
+  SourceTextReader source_;
+  bool verbose_ = false;
+
+  void collectGathers(const clang::Stmt* stmt, const std::string& iterator, bool is_write,
+                      std::vector<Gather>& gathers) const;
+  bool isIndirect(const clang::ArraySubscriptExpr* element, const std::string& iterator) const;
+  bool isInvariant(const clang::Stmt* stmt, const std::string& iterator,
+                   const std::set<const clang::ValueDecl*>& written) const;
+  void collectWritten(const clang::Stmt* stmt, std::set<const clang::ValueDecl*>& written) const;
+  bool mentions(const clang::Stmt* stmt, const std::string& name) const;
+  std::string shiftIterator(const std::string& text, const std::string& iterator,
+                            unsigned distance) const;
+  unsigned prefetchDistance(const LoopInfo& loop) const;
+};
+
+} // namespace paralyze
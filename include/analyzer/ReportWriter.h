@@ -0,0 +1,55 @@
+#pragma once
+
+#include "analyzer/LoopInfo.h"
+#include "analyzer/PragmaGenerator.h"
+#include "analyzer/Roofline.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+// how loop verdicts are reported
+enum class ReportFormat
+{
+  TEXT,  // summary table and free-text reasoning on stdout
+  JSON,  // one object per loop under "loops"
+  SARIF  // SARIF 2.1.0, one result per loop, for code-scanning dashboards
+};
+
+// writes loop verdicts as they are handed over, so nothing but the current loop is held
+//   {"id": "L2", "line": 14, "depth": 1, "parent": "L1", "trip_count": 1024, ...,
+//    "pragma": {"text": "#pragma omp parallel for", "confidence": {"score": 0.85, ...}}}
+class ReportWriter
+{
+public:
+  ReportWriter(std::ostream& out, ReportFormat format, const std::string& file)
+      : out_(out), format_(format), file_(file)
+  {
+  }
+
+  void begin(const MachineModel& machine);
+  void writeLoop(size_t index, const std::vector<LoopInfo>& loops, const GeneratedPragma* pragma,
+                 const MachineModel& machine);
+  void end();
+
+private:
+  std::ostream& out_;
+  ReportFormat format_;
+  std::string file_;
+  bool first_loop_ = true;
+
+  void writeLoopFields(size_t index, const std::vector<LoopInfo>& loops,
+                       const GeneratedPragma* pragma, const MachineModel& machine);
+  void writePragma(const GeneratedPragma& pragma);
+  void writeStrings(const std::vector<std::string>& values);
+  void writeNumber(double value);
+
+  static std::string quote(const std::string& text);
+  static std::string loopId(size_t index) { return "\"L" + std::to_string(index + 1) + "\""; }
+  static const char* pragmaKind(PragmaType type);
+  static const char* confidenceLevel(ConfidenceLevel level);
+};
+
+} // namespace paralyze
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <thread>
+
+namespace paralyze
+{
+
+// peak compute and memory bandwidth of the machine the output will run on
+struct MachineModel
+{
+  static constexpr double kCoreGflops = 16.0;        // one core, 4-wide double fma at ~2 GHz
+  static constexpr double kCoreBandwidthGbs = 12.0;  // what one core's misses can keep in flight
+  static constexpr double kSocketBandwidthGbs = 40.0;
+
+  unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  double core_gflops = kCoreGflops;
+  double core_bandwidth_gbs = kCoreBandwidthGbs;
+  double bandwidth_gbs = kSocketBandwidthGbs; // all cores together
+  bool measured = false;                      // bandwidth came from the STREAM probe
+
+  double peakGflops() const { return core_gflops * cores; }
+
+  // flops per byte where a loop stops waiting on memory
+  double ridgePoint() const { return peakGflops() / bandwidth_gbs; }
+};
+
+// per-iteration work and DRAM traffic of a loop, nested loops included
+//   a[i] = b[i] + s * c[i]     2 flops, 32 bytes (a is written, so its line is read first)
+//   sum += a[i] * a[i]         2 flops,  8 bytes
+struct RooflineEstimate
+{
+  double flops = 0.0;          // value arithmetic, subscript arithmetic excluded
+  double bytes = 0.0;          // traffic that misses cache, write-allocate included
+  double resident_bytes = 0.0; // touched every iteration but reused from cache
+  unsigned streams = 0;        // distinct array streams after merging neighbours like a[i±1]
+
+  bool isKnown() const { return flops > 0.0 || bytes > 0.0; }
+
+  double intensity() const { return bytes > 0.0 ? flops / bytes : 0.0; }
+
+  // min(compute roof, bandwidth roof) for a team of this many threads
+  double attainableGflops(const MachineModel& machine, unsigned threads) const
+  {
+    double compute = machine.core_gflops * threads;
+    if (bytes <= 0.0)
+    {
+      return compute;
+    }
+    double bandwidth = std::min(machine.core_bandwidth_gbs * threads, machine.bandwidth_gbs);
+    return std::min(compute, intensity() * bandwidth);
+  }
+
+  // best case for the whole team over one thread; memory-bound loops flatten out early
+  double threadSpeedup(const MachineModel& machine) const
+  {
+    double serial = attainableGflops(machine, 1);
+    return serial > 0.0 ? attainableGflops(machine, machine.cores) / serial : 1.0;
+  }
+
+  bool isMemoryBound(const MachineModel& machine) const
+  {
+    return bytes > 0.0 && intensity() < machine.ridgePoint();
+  }
+};
+
+} // namespace paralyze
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "analyzer/LoopInfo.h"
+#include "analyzer/SourceTextReader.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Expr.h"
+#include "clang/AST/Stmt.h"
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+// estimates flops and DRAM bytes per iteration from element types and subscripts
+//   a[i] = b[i-1] + b[i+1]       b is one stream, its neighbours share cache lines
+//   y[i] += m[i][j] * x[j]       x is reused from cache on every i, m is not
+// accesses that stay resident between reuses cost no bandwidth
+class RooflineAnalyzer
+{
+public:
+  explicit RooflineAnalyzer(clang::ASTContext* context) : context_(context), source_(context) {}
+
+  void analyzeLoop(size_t index, std::vector<LoopInfo>& loops);
+  void setVerbose(bool verbose) { verbose_ = verbose; }
+
+private:
+  static constexpr double kCacheLineBytes = 64.0;
+  static constexpr double kReuseBytes = 512.0 * 1024; // half of a per-core L2, the rest is churn
+  static constexpr unsigned kDefaultElementBytes = 8;
+
+  // one loop between the analyzed loop and an access, the analyzed loop first
+  struct Level
+  {
+    std::string iterator;
+    double trips;
+  };
+
+  // one array element the body loads or stores, and the loops around it
+  struct Touch
+  {
+    std::string array;
+    std::vector<const clang::Expr*> subscripts; // outermost dimension first
+    unsigned element_bytes;
+    bool is_write;
+    std::vector<Level> levels;
+  };
+
+  struct Walk
+  {
+    const std::vector<LoopInfo>& loops;
+    size_t root;
+    std::vector<Level> levels;
+    std::vector<Touch> touches;
+    double flops = 0.0;
+  };
+
+  clang::ASTContext* context_;
+  SourceTextReader source_;
+  bool verbose_ = false;
+
+  bool walkLoopBody(const clang::Stmt* stmt, Walk& state) const; // false if not a loop
+  void walk(const clang::Stmt* stmt, Walk& state, bool is_write, bool in_subscript) const;
+  void recordTouch(const clang::ArraySubscriptExpr* element, Walk& state, bool is_write) const;
+  const LoopInfo* findLoop(const clang::Stmt* stmt, size_t index,
+                           const std::vector<LoopInfo>& loops) const;
+  double repeats(const Walk& state) const; // trips of the nested loops around the current point
+
+  RooflineEstimate estimate(const Walk& state) const;
+  bool movesWith(const Touch& touch, size_t level) const; // the level's iterator is subscripted
+  double touchBytes(const Touch& touch, size_t level) const;
+  std::string streamKey(const Touch& touch, size_t level) const;
+  std::string strippedText(const clang::Expr* expr) const;
+  std::optional<long long> coefficient(const clang::Expr* expr, const std::string& iterator) const;
+  bool mentions(const clang::Stmt* stmt, const std::string& name) const;
+};
+
+} // namespace paralyze
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "analyzer/LineEdit.h"
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+enum class ScanKind
+{
+  NONE,
+  INCLUSIVE, // sum += in[i]; out[i] = sum;
+  EXCLUSIVE  // out[i] = sum; sum += in[i];
+};
+
+// running sum (or product, and, or, xor) that each iteration extends and reads back
+struct ScanLoop
+{
+  ScanKind kind = ScanKind::NONE;
+  std::string variable;   // scalar carried by the scan: sum, or out_scan for an array recurrence
+  std::string array_name; // set when rewritten from out[i] = out[i - 1] + in[i]
+  std::string op;         // "+", "*", "&", "|" or "^"
+  std::vector<LineEdit> edits; // scan directive, OpenMP 5.0 guard and blocked two-pass fallback
+  std::string justification;
+
+  bool isScan() const { return kind != ScanKind::NONE; }
+  std::string clause() const { return "reduction(inscan, " + op + ":" + variable + ")"; }
+  std::string directive() const
+  {
+    return std::string("#pragma omp scan ") +
+           (kind == ScanKind::INCLUSIVE ? "inclusive(" : "exclusive(") + variable + ")";
+  }
+};
+
+} // namespace paralyze
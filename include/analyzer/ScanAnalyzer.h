@@ -0,0 +1,79 @@
+#pragma once
+
+#include "analyzer/LoopInfo.h"
+#include "analyzer/SourceTextReader.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Expr.h"
+#include "clang/AST/Stmt.h"
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+// recognizes prefix computations that look like plain recurrences:
+//   for (i = 1; i < n; i++) out[i] = out[i - 1] + in[i];
+//   for (i = 0; i < n; i++) { sum += in[i]; out[i] = sum; }
+// and rewrites them for reduction(inscan) with a blocked two-pass scan for pre-5.0 compilers
+class ScanAnalyzer
+{
+public:
+  explicit ScanAnalyzer(clang::ASTContext* context) : context_(context), source_(context) {}
+
+  void analyzeLoop(clang::ForStmt* forLoop, LoopInfo& loop);
+  void setVerbose(bool verbose) { verbose_ = verbose; }
+
+private:
+  static constexpr int kFallbackBlocks = 64; // enough blocks to keep any common thread count busy
+
+  // pieces of a unit-stride header the fallback loops are rebuilt from
+  struct Header
+  {
+    std::string iterator;
+    std::string type;
+    std::string lower;
+    std::string end; // exclusive
+  };
+
+  // one x op= e (or x = x op e) statement
+  struct Update
+  {
+    const clang::ValueDecl* target = nullptr;
+    const clang::Expr* lhs = nullptr;
+    std::vector<const clang::Expr*> operands; // x and e, or x[i - 1] and e; just x for x++
+    std::string op;
+  };
+
+  // what the fallback replays per iteration: the update alone, then the whole body
+  struct Replay
+  {
+    std::string type;
+    std::string seed; // declaration of the carried scalar an array recurrence starts from
+    std::vector<std::string> update_lines;
+    std::vector<std::string> body_lines;
+  };
+
+  clang::ASTContext* context_;
+  SourceTextReader source_;
+  bool verbose_ = false;
+
+  bool readHeader(const clang::ForStmt* forLoop, const LoopInfo& loop, Header& header) const;
+  bool matchScalarScan(const std::vector<const clang::Stmt*>& stmts,
+                       const clang::ForStmt* forLoop, ScanLoop& scan, Replay& replay) const;
+  bool matchArrayScan(const clang::Stmt* stmt, const Header& header, ScanLoop& scan,
+                      Replay& replay) const;
+
+  bool matchUpdate(const clang::Stmt* stmt, Update& update) const;
+  const clang::ValueDecl* storedTarget(const clang::Expr* expr) const;
+  bool isElementAt(const clang::Expr* expr, const clang::ValueDecl* array,
+                   const std::string& iterator, int offset) const;
+  bool references(const clang::Stmt* stmt, const clang::ValueDecl* decl) const;
+  bool writes(const clang::Stmt* stmt, const clang::ValueDecl* decl) const;
+  bool isOnOwnLines(const clang::Stmt* stmt) const;
+  std::vector<std::string> linesOf(const clang::Stmt* first, const clang::Stmt* last) const;
+
+  std::string buildFallback(const ScanLoop& scan, const Header& header, const Replay& replay,
+                            const std::string& indent) const;
+};
+
+} // namespace paralyze
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "analyzer/LoopInfo.h"
+#include "analyzer/SourceTextReader.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Stmt.h"
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+// recognizes for loops that stop at the first match:
+//   for (i = 0; i < n; i++) { if (a[i] == key) { found = i; break; } }
+// and rewrites them for parallel for + cancel with a lowest-index combine
+class SearchLoopAnalyzer
+{
+public:
+  explicit SearchLoopAnalyzer(clang::ASTContext* context) : context_(context), source_(context)
+  {
+  }
+
+  bool analyzeSearchLoop(clang::ForStmt* forLoop, LoopInfo& loop);
+  void setVerbose(bool verbose) { verbose_ = verbose; }
+
+private:
+  clang::ASTContext* context_;
+  SourceTextReader source_;
+  bool verbose_ = false;
+
+  clang::IfStmt* findMatchTest(clang::ForStmt* forLoop) const;
+  bool collectMatchActions(clang::IfStmt* test, const LoopInfo& loop,
+                           std::vector<clang::Stmt*>& actions) const;
+  bool isResultAssignment(clang::Stmt* stmt, const LoopInfo& loop) const;
+  bool referencesLoopLocal(clang::Stmt* stmt, const LoopInfo& loop) const;
+  bool referencesDecl(clang::Stmt* stmt, const clang::Decl* decl) const;
+  bool isOnOwnLine(clang::Stmt* stmt) const;
+  bool isInCompoundStmt(clang::Stmt* stmt);
+  clang::VarDecl* findCounter(const LoopInfo& loop) const;
+  std::string indentUnit(clang::ForStmt* forLoop) const;
+};
+
+} // namespace paralyze
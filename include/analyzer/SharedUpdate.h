@@ -0,0 +1,47 @@
+#pragma once
+
+#include "analyzer/LineEdit.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+enum class SyncKind
+{
+  ATOMIC,  // single x++, x += e or x = x op e statement
+  CRITICAL // compare-and-update block such as if (v > best) best = v;
+};
+
+// one statement that touches shared scalars and has to run one thread at a time
+struct SyncSite
+{
+  SyncKind kind;
+  unsigned line_number;
+  std::vector<std::string> variables;
+
+  SyncSite(SyncKind sync_kind, unsigned line, const std::vector<std::string>& vars)
+      : kind(sync_kind), line_number(line), variables(vars)
+  {
+  }
+};
+
+// scalars declared before the loop that the body writes, and how the writes are made safe
+struct SharedUpdates
+{
+  std::vector<std::string> variables; // synchronized by the sites below
+  std::vector<std::string> carried;   // updated in place (x++, x += e) with no safe form
+  std::vector<SyncSite> sites;
+  std::vector<LineEdit> edits; // atomic / critical directives above each site
+  double contention = 0.0;     // estimated share of an iteration spent serialized
+  std::string justification;
+
+  bool isSynchronized() const { return !sites.empty(); }
+  bool synchronizes(const std::string& name) const
+  {
+    return std::find(variables.begin(), variables.end(), name) != variables.end();
+  }
+};
+
+} // namespace paralyze
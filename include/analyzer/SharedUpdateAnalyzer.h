@@ -0,0 +1,70 @@
+#pragma once
+
+#include "analyzer/LoopInfo.h"
+#include "analyzer/SourceTextReader.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Expr.h"
+#include "clang/AST/Stmt.h"
+#include <set>
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+// finds loops whose only conflicts are a few writes to shared scalars next to heavy
+// independent work:
+//   for (i = 0; i < n; i++) { out[i] = expensive(in[i]); if (out[i] > 0) hits++; }
+// and isolates those writes under atomic or critical so the rest can run in parallel
+class SharedUpdateAnalyzer
+{
+public:
+  explicit SharedUpdateAnalyzer(clang::ASTContext* context) : context_(context), source_(context)
+  {
+  }
+
+  // needs the loop's iteration cost, so run after estimating work
+  void analyzeLoop(clang::Stmt* loopStmt, LoopInfo& loop);
+  void setVerbose(bool verbose) { verbose_ = verbose; }
+
+private:
+  static constexpr double kAtomicCost = 10.0;   // ops an atomic update costs under contention
+  static constexpr double kCriticalCost = 40.0; // lock acquire and release around a block
+  static constexpr double kMaxContention = 0.1; // serialized share that still scales to ~10x
+
+  using VarSet = std::set<const clang::VarDecl*>;
+
+  struct Site
+  {
+    SyncKind kind;
+    const clang::Stmt* stmt;
+    VarSet vars;
+    std::string family; // update operator, sites of one variable must agree
+    std::string clause; // " write" for atomic stores of a constant
+    double weight;      // executions per iteration of the analyzed loop
+  };
+
+  clang::ASTContext* context_;
+  SourceTextReader source_;
+  bool verbose_ = false;
+
+  void collectShared(const clang::Stmt* stmt, const clang::Stmt* loopStmt,
+                     const LoopInfo& loop, VarSet& shared, VarSet& in_place) const;
+  void collectHeaderVars(const clang::Stmt* stmt, VarSet& header_vars) const;
+  bool isCandidate(const clang::VarDecl* var, const clang::Stmt* loopStmt,
+                   const LoopInfo& loop) const;
+
+  void findAtomicSites(const clang::Stmt* stmt, const VarSet& shared, double weight,
+                       std::vector<Site>& sites) const;
+  bool matchAtomic(const clang::Expr* expr, const VarSet& shared, Site& site) const;
+  void collectReferences(const clang::Stmt* stmt, const VarSet& shared,
+                         const std::set<const clang::Stmt*>& skip, VarSet& found) const;
+  bool isCriticalBlock(const clang::Stmt* stmt, const VarSet& vars) const;
+  bool readsAny(const clang::Stmt* stmt, const VarSet& vars) const;
+  void collectWritten(const clang::Stmt* stmt, VarSet& written) const;
+  bool hasJumpOrLoop(const clang::Stmt* stmt) const;
+  bool isOnOwnLines(const clang::Stmt* stmt) const;
+  const clang::VarDecl* sharedRef(const clang::Expr* expr, const VarSet& shared) const;
+};
+
+} // namespace paralyze
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace paralyze
+{
+
+// what a simd directive on the loop is allowed to promise and whether it pays off
+struct SimdPlan
+{
+  bool vectorizable = false;
+  std::string blocker; // why not, e.g. "gathers through idx[i] outnumber contiguous accesses"
+
+  unsigned element_bits = 0; // widest element carried in the lanes
+  unsigned simdlen = 0;      // lanes of that width in one vector register
+  unsigned safelen = 0;      // set when a recurrence this many iterations apart limits the lanes
+  std::vector<std::pair<std::string, unsigned>> aligned;   // array, bytes
+  std::vector<std::pair<std::string, long long>> linear;   // scalar, step per iteration
+  unsigned contiguous_accesses = 0;
+  unsigned gathers = 0;
+
+  // contiguous array a peel loop would start on a 64-byte boundary, empty when already there
+  std::string peel_array;
+  unsigned peel_iterations = 0; // fixed peel count, 0 when it depends on the runtime address
+  unsigned peel_limit = 0;      // most iterations a runtime peel can take
+
+  bool isLinear(const std::string& name) const
+  {
+    return std::any_of(linear.begin(), linear.end(),
+                       [&name](const std::pair<std::string, long long>& entry)
+                       { return entry.first == name; });
+  }
+
+  // only legal as a simd loop, the recurrence keeps it from running in parallel
+  bool needsSafelen() const { return vectorizable && safelen > 0; }
+
+  // simdlen / safelen / aligned, for simd directives only
+  std::string clauses() const
+  {
+    std::string text;
+    if (simdlen > 0)
+      text += " simdlen(" + std::to_string(simdlen) + ")";
+    if (safelen > 0)
+      text += " safelen(" + std::to_string(safelen) + ")";
+    for (const auto& entry : aligned)
+      text += " aligned(" + entry.first + ":" + std::to_string(entry.second) + ")";
+    return text;
+  }
+
+  std::string peelNote() const
+  {
+    if (peel_iterations > 0)
+      return "peeling " + std::to_string(peel_iterations) + " iteration" +
+             (peel_iterations > 1 ? "s" : "") + " starts " + peel_array +
+             " on a 64-byte boundary";
+    return "a runtime peel of up to " + std::to_string(peel_limit) + " iterations would align " +
+           peel_array + " to 64 bytes";
+  }
+
+  // linear(j:1) keeps a hand-rolled counter correct under any loop directive
+  std::string linearClause() const
+  {
+    std::string text;
+    for (const auto& entry : linear)
+      text += " linear(" + entry.first + ":" + std::to_string(entry.second) + ")";
+    return text;
+  }
+};
+
+} // namespace paralyze
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "analyzer/AlignmentTracker.h"
+#include "analyzer/LoopInfo.h"
+#include "analyzer/SourceTextReader.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Expr.h"
+#include "clang/AST/Stmt.h"
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace paralyze
+{
+
+// decides whether a loop body maps onto vector lanes: unit-stride accesses, only
+// vectorizable math calls, if-convertible branches and plain arithmetic element types
+//   for (i = 0; i < n; i++) y[i] = a * x[i] + y[i];          simd simdlen(4)
+//   for (i = 0; i < n; i++) y[i] = x[idx[i]];                gather-bound, no simd
+// and records the simdlen / safelen / aligned / linear clauses it can justify
+class SimdAnalyzer
+{
+public:
+  explicit SimdAnalyzer(clang::ASTContext* context)
+      : context_(context), source_(context), alignment_(context)
+  {
+  }
+
+  void analyzeLoop(clang::ForStmt* forLoop, LoopInfo& loop);
+  void setVerbose(bool verbose) { verbose_ = verbose; }
+
+private:
+  static constexpr unsigned kVectorBits = 256; // AVX2-class registers, the common baseline
+  static constexpr unsigned kMaxBranches = 2;  // if-converted arms all execute, keep it small
+  static constexpr long long kPeelAlignment = 64; // cache line and AVX-512 register
+
+  // one array element the body loads or stores
+  struct Access
+  {
+    const clang::ValueDecl* array;
+    const clang::Expr* expr;
+    bool is_write;
+    std::optional<long long> stride; // in elements per iteration, nullopt when irregular
+    std::optional<long long> offset; // c in a[i + c], for recurrence distances
+  };
+
+  // what the walk over the body has to know about the loop
+  struct Scope
+  {
+    std::string iterator;
+    long long step = 0;
+    const clang::ForStmt* loop = nullptr;
+    std::map<const clang::ValueDecl*, long long> linear;
+    std::set<const clang::ValueDecl*> written;
+  };
+
+  clang::ASTContext* context_;
+  SourceTextReader source_;
+  AlignmentTracker alignment_;
+  bool verbose_ = false;
+
+  void findLinear(const clang::CompoundStmt* body, const LoopInfo& loop, Scope& scope,
+                  SimdPlan& plan) const;
+  std::optional<long long> constantStep(const clang::Stmt* stmt,
+                                        const clang::ValueDecl*& var) const;
+
+  bool walk(const clang::Stmt* stmt, const Scope& scope, bool is_write,
+            std::vector<Access>& accesses, unsigned& branches, std::string& blocker) const;
+  void recordAccess(const clang::ArraySubscriptExpr* element, const Scope& scope, bool is_write,
+                    std::vector<Access>& accesses) const;
+  std::optional<long long> strideOf(const clang::Expr* expr, const Scope& scope) const;
+  std::optional<long long> offsetOf(const clang::Expr* expr, const Scope& scope) const;
+  bool isInvariant(const clang::Expr* expr, const Scope& scope) const;
+  bool isVectorMathCall(const clang::CallExpr* call) const;
+
+  bool checkElementTypes(const std::vector<Access>& accesses, SimdPlan& plan) const;
+  bool checkRecurrences(const std::vector<Access>& accesses, const Scope& scope,
+                        SimdPlan& plan) const;
+  void chooseClauses(const std::vector<Access>& accesses, SimdPlan& plan) const;
+  void planPeel(const clang::ForStmt* forLoop, const std::vector<Access>& accesses,
+                const Scope& scope, SimdPlan& plan) const;
+  std::optional<long long> startIndex(const clang::ForStmt* forLoop, const Scope& scope) const;
+  void collectWritten(const clang::Stmt* stmt, std::set<const clang::ValueDecl*>& written) const;
+  unsigned countWrites(const clang::Stmt* stmt, const clang::ValueDecl* decl) const;
+  bool isDeclaredBefore(const clang::ValueDecl* decl, const clang::ForStmt* forLoop) const;
+};
+
+} // namespace paralyze
@@ -17,6 +17,13 @@ struct AnnotatedLine
   std::string pragma_annotation;
   bool has_pragma;
 
+  // loop rewrites
+  std::vector<std::string> inserted_before; // emitted above the pragma
+  std::vector<std::string> inserted_after;
+  std::string rewritten_content;
+  bool is_rewritten = false;
+  bool is_removed = false;
+
   AnnotatedLine(unsigned line, const std::string& content)
       : line_number(line), original_content(content), has_pragma(false)
   {
@@ -45,6 +52,7 @@ private:
   bool readSourceFile(const std::string& filename);
   void insertPragmaAnnotations(const std::vector<GeneratedPragma>& pragmas,
                                const std::vector<PragmaInsertionPoint>& insertion_points);
+  void applyLineEdit(const LineEdit& edit);
   std::string getIndentationForLine(unsigned line_number);
   std::string generateOutputFilename(const std::string& input_filename);
 };
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "clang/AST/ASTContext.h"
+#include "clang/Basic/SourceLocation.h"
+#include <string>
+
+namespace paralyze
+{
+
+// reads spelled source text so loop rewrites can be expressed as line edits
+class SourceTextReader
+{
+public:
+  explicit SourceTextReader(clang::ASTContext* context) : context_(context) {}
+
+  std::string getText(clang::SourceRange range) const; // text of a token range
+  // main-file text of the range with macros left unexpanded, e.g. "N - 1"
+  std::string getWrittenText(clang::SourceRange range) const;
+  std::string getLineText(unsigned line) const;        // full main-file line, no newline
+  std::string getIndentation(unsigned line) const;
+
+  unsigned getLine(clang::SourceLocation loc) const;
+  unsigned getColumn(clang::SourceLocation loc) const;
+  unsigned getEndColumn(clang::SourceLocation loc) const; // column just past the token at loc
+
+  // true if the range is spelled directly in the main file (no macros)
+  bool isRewritable(clang::SourceRange range) const;
+
+  // true if only whitespace precedes loc on its line
+  bool startsLine(clang::SourceLocation loc) const;
+  // true if only whitespace, an optional ';' or a line comment follows the token at loc
+  bool endsLine(clang::SourceLocation loc) const;
+
+private:
+  clang::ASTContext* context_;
+};
+
+} // namespace paralyze
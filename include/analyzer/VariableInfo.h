@@ -1,9 +1,9 @@
 #pragma once
 
+#include "analyzer/FunctionArena.h"
 #include "clang/AST/Decl.h"
 #include "clang/Basic/SourceLocation.h"
 #include <string>
-#include <vector>
 
 namespace paralyze
 {
@@ -43,54 +43,36 @@ struct VariableInfo
   VariableScope scope;
   VariableRole role;
   clang::SourceLocation declaration_location;
-  std::vector<VariableUsage> usages;
+  ArenaVector<VariableUsage> usages; // only while its function is traversed, see releaseUsages
+  size_t read_count = 0;
+  size_t write_count = 0;
 
   VariableInfo(const std::string& var_name, clang::VarDecl* var_decl, VariableScope var_scope,
-               clang::SourceLocation decl_loc)
+               clang::SourceLocation decl_loc, llvm::BumpPtrAllocator* arena = nullptr)
       : name(var_name), decl(var_decl), scope(var_scope), role(VariableRole::DATA_VAR),
-        declaration_location(decl_loc)
+        declaration_location(decl_loc), usages(ArenaAllocator<VariableUsage>(arena))
   {
   }
 
-  void addUsage(const VariableUsage& usage) { usages.push_back(usage); }
-
-  void setRole(VariableRole var_role) { role = var_role; }
-
-  bool hasWrites() const
+  void addUsage(const VariableUsage& usage)
   {
-    for (const auto& u : usages)
-      if (u.is_write)
-        return true;
-    return false;
+    usages.push_back(usage);
+    read_count += usage.is_read;
+    write_count += usage.is_write;
   }
 
-  bool hasReads() const
-  {
-    for (const auto& u : usages)
-      if (u.is_read)
-        return true;
-    return false;
-  }
+  // before the function's arena goes; the counts below stay valid
+  void releaseUsages() { usages = ArenaVector<VariableUsage>(); }
 
-  bool isInductionVariable() const { return role == VariableRole::INDUCTION_VAR; }
+  void setRole(VariableRole var_role) { role = var_role; }
 
-  size_t getWriteCount() const
-  {
-    size_t count = 0;
-    for (const auto& u : usages)
-      if (u.is_write)
-        count++;
-    return count;
-  }
+  bool hasWrites() const { return write_count > 0; }
+  bool hasReads() const { return read_count > 0; }
 
-  size_t getReadCount() const
-  {
-    size_t count = 0;
-    for (const auto& u : usages)
-      if (u.is_read)
-        count++;
-    return count;
-  }
+  bool isInductionVariable() const { return role == VariableRole::INDUCTION_VAR; }
+
+  size_t getWriteCount() const { return write_count; }
+  size_t getReadCount() const { return read_count; }
 
   bool isPotentialDependency() const
   {
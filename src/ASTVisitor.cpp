@@ -1,8 +1,10 @@
 #include "analyzer/ASTVisitor.h"
+#include "analyzer/AnalysisStats.h"
 #include "analyzer/PragmaGenerator.h"
 #include "analyzer/PragmaLocationMapper.h"
 #include "analyzer/SourceAnnotator.h"
 #include "clang/AST/ASTContext.h"
+#include "llvm/Support/TimeProfiler.h"
 #include <iostream>
 
 using namespace clang;
@@ -33,12 +35,27 @@ bool AnalyzerVisitor::VisitFunctionDecl(FunctionDecl* func)
     std::cout << "\n";
   }
 
-  loop_visitor_.TraverseStmt(func->getBody());
+  loop_visitor_.setCurrentFunction(funcName);
+  AnalysisStats::get().beginFunction(funcName);
+  {
+    ScopedTimer timer(Phase::TRAVERSAL);
+    llvm::TimeTraceScope trace("AnalyzeFunction", funcName);
+    loop_visitor_.TraverseStmt(func->getBody());
+  }
+  loop_visitor_.finishFunction();
+  AnalysisStats::get().endFunction();
   return true;
 }
 
 void AnalyzerVisitor::runAnalysis()
 {
+  // machine-readable report, with or without an annotated file
+  if (report_format_ != ReportFormat::TEXT && report_out_)
+  {
+    writeReport();
+    return;
+  }
+
   // mode 1: analysis-only without verbose - summary table
   if (!generate_pragmas_ && !verbose_)
   {
@@ -68,6 +85,9 @@ void AnalyzerVisitor::runAnalysis()
 
     // set up the pipeline quietly
     PragmaGenerator pragma_gen;
+    pragma_gen.setProcBindPolicy(proc_bind_policy_);
+    pragma_gen.setMachine(machine_);
+    pragma_gen.setPrefetch(prefetch_);
     PragmaLocationMapper location_mapper(&context_->getSourceManager());
     SourceAnnotator annotator(&context_->getSourceManager());
 
@@ -75,10 +95,10 @@ void AnalyzerVisitor::runAnalysis()
     pragma_gen.setVerbose(false);
     pragma_gen.generatePragmasForLoops(detected_loops);
 
-    // only map insertion points for parallelizable loops
+    // only map insertion points for loops that end up with a parallel form
     for (const auto& loop : detected_loops)
     {
-      if (!loop.has_dependencies)
+      if (loop.hasParallelForm())
       {
         location_mapper.mapLoopToPragmaLocation(loop);
       }
@@ -121,6 +141,9 @@ void AnalyzerVisitor::runAnalysis()
     try
     {
       PragmaGenerator pragma_gen;
+      pragma_gen.setProcBindPolicy(proc_bind_policy_);
+      pragma_gen.setMachine(machine_);
+      pragma_gen.setPrefetch(prefetch_);
       PragmaLocationMapper location_mapper(&context_->getSourceManager());
       SourceAnnotator annotator(&context_->getSourceManager());
 
@@ -131,7 +154,7 @@ void AnalyzerVisitor::runAnalysis()
       // map insertion points
       for (const auto& loop : detected_loops)
       {
-        if (!loop.has_dependencies)
+        if (loop.hasParallelForm())
         {
           location_mapper.mapLoopToPragmaLocation(loop);
         }
@@ -162,4 +185,44 @@ void AnalyzerVisitor::runAnalysis()
   }
 }
 
+void AnalyzerVisitor::writeReport()
+{
+  const auto& detected_loops = loop_visitor_.getLoops();
+
+  // the pragma each loop would get, whether or not a file is written
+  PragmaGenerator pragma_gen;
+  pragma_gen.setProcBindPolicy(proc_bind_policy_);
+  pragma_gen.setMachine(machine_);
+  pragma_gen.setPrefetch(prefetch_);
+  pragma_gen.setVerbose(false);
+  pragma_gen.generatePragmasForLoops(detected_loops);
+
+  if (generate_pragmas_ && !detected_loops.empty())
+  {
+    PragmaLocationMapper location_mapper(&context_->getSourceManager());
+    SourceAnnotator annotator(&context_->getSourceManager());
+    for (const auto& loop : detected_loops)
+    {
+      if (loop.hasParallelForm())
+      {
+        location_mapper.mapLoopToPragmaLocation(loop);
+      }
+    }
+    annotator.annotateSourceWithPragmas(input_filename_, pragma_gen.getGeneratedPragmas(),
+                                        location_mapper.getInsertionPoints());
+    if (!annotator.writeAnnotatedFile(output_filename_))
+    {
+      std::cerr << "Error: Failed to create output file\n";
+    }
+  }
+
+  ReportWriter writer(*report_out_, report_format_, input_filename_);
+  writer.begin(machine_);
+  for (size_t i = 0; i < detected_loops.size(); i++)
+  {
+    writer.writeLoop(i, detected_loops, pragma_gen.pragmaForLoop(i), machine_);
+  }
+  writer.end();
+}
+
 } // namespace paralyze
\ No newline at end of file
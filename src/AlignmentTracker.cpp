@@ -0,0 +1,201 @@
+#include "analyzer/AlignmentTracker.h"
+#include "clang/Basic/TargetInfo.h"
+#include <algorithm>
+
+using namespace clang;
+
+namespace paralyze
+{
+
+unsigned AlignmentTracker::knownAlignment(const ValueDecl* decl) const
+{
+  auto* var = dyn_cast_or_null<VarDecl>(decl);
+  if (!var)
+  {
+    return 0;
+  }
+  if (context_->getAsConstantArrayType(var->getType()))
+  {
+    return arrayAlignment(var);
+  }
+  return var->getType()->isPointerType() ? pointerAlignment(var, 0) : 0;
+}
+
+unsigned AlignmentTracker::arrayAlignment(const VarDecl* var) const
+{
+  unsigned bytes = static_cast<unsigned>(context_->getDeclAlign(var).getQuantity());
+
+  // the ABI lifts big static arrays to the target's large-array alignment
+  const TargetInfo& target = context_->getTargetInfo();
+  if (var->hasGlobalStorage() && context_->getTypeSize(var->getType()) >=
+                                     target.getLargeArrayMinWidth())
+  {
+    bytes = std::max(bytes, target.getLargeArrayAlign() / 8);
+  }
+  return bytes;
+}
+
+unsigned AlignmentTracker::pointerAlignment(const VarDecl* var, unsigned hops) const
+{
+  // parameters and globals can be pointed anywhere by code we don't see
+  auto* function = dyn_cast_or_null<FunctionDecl>(var->getParentFunctionOrMethod());
+  if (!function || !function->getBody() || isa<ParmVarDecl>(var) || var->hasGlobalStorage() ||
+      hops > kMaxHops)
+  {
+    return 0;
+  }
+
+  std::vector<const Expr*> values;
+  if (var->getInit())
+  {
+    values.push_back(var->getInit());
+  }
+  if (!collectStores(function->getBody(), var, values) || values.empty())
+  {
+    return 0;
+  }
+
+  // whatever the pointer holds has to come from a site we understand
+  unsigned bytes = 0;
+  for (const Expr* value : values)
+  {
+    unsigned alignment = valueAlignment(value, hops);
+    if (alignment == 0)
+    {
+      return 0;
+    }
+    bytes = bytes == 0 ? alignment : std::min(bytes, alignment);
+  }
+  return bytes;
+}
+
+unsigned AlignmentTracker::valueAlignment(const Expr* value, unsigned hops) const
+{
+  value = value->IgnoreParenCasts();
+
+  if (auto* call = dyn_cast<CallExpr>(value))
+  {
+    return allocatorAlignment(call).value_or(0);
+  }
+
+  // q = p and q = grid inherit the source's alignment
+  if (auto* ref = dyn_cast<DeclRefExpr>(value))
+  {
+    auto* source = dyn_cast<VarDecl>(ref->getDecl());
+    if (source && context_->getAsConstantArrayType(source->getType()))
+    {
+      return arrayAlignment(source);
+    }
+    if (source && source->getType()->isPointerType())
+    {
+      return pointerAlignment(source, hops + 1);
+    }
+  }
+  return 0;
+}
+
+std::optional<unsigned> AlignmentTracker::allocatorAlignment(const CallExpr* call) const
+{
+  auto* callee = call->getDirectCallee();
+  if (!callee)
+  {
+    return std::nullopt;
+  }
+
+  // which argument carries the alignment
+  std::string name = callee->getNameAsString();
+  unsigned arg = 0;
+  if (name == "aligned_alloc" || name == "memalign")
+  {
+    arg = 0;
+  }
+  else if (name == "_mm_malloc" || name == "__builtin_assume_aligned" || name == "posix_memalign")
+  {
+    arg = 1;
+  }
+  else
+  {
+    return std::nullopt;
+  }
+
+  Expr::EvalResult value;
+  if (call->getNumArgs() <= arg || !call->getArg(arg)->EvaluateAsInt(value, *context_))
+  {
+    return std::nullopt;
+  }
+  long long bytes = value.Val.getInt().getExtValue();
+  if (bytes <= 0 || (bytes & (bytes - 1)) != 0)
+  {
+    return std::nullopt;
+  }
+  return static_cast<unsigned>(bytes);
+}
+
+bool AlignmentTracker::collectStores(const Stmt* stmt, const VarDecl* var,
+                                     std::vector<const Expr*>& values) const
+{
+  if (!stmt)
+  {
+    return true;
+  }
+
+  auto refersTo = [var](const Expr* expr)
+  {
+    auto* ref = dyn_cast<DeclRefExpr>(expr->IgnoreParenCasts());
+    return ref && ref->getDecl() == var;
+  };
+
+  // posix_memalign(&p, 64, bytes) stores through the address it is handed
+  if (auto* call = dyn_cast<CallExpr>(stmt))
+  {
+    auto* callee = call->getDirectCallee();
+    auto* address = call->getNumArgs() > 0
+                        ? dyn_cast<UnaryOperator>(call->getArg(0)->IgnoreParenCasts())
+                        : nullptr;
+    if (callee && callee->getNameAsString() == "posix_memalign" && address &&
+        address->getOpcode() == UO_AddrOf && refersTo(address->getSubExpr()))
+    {
+      values.push_back(call);
+      for (unsigned i = 1; i < call->getNumArgs(); i++)
+      {
+        if (!collectStores(call->getArg(i), var, values))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+  }
+
+  if (auto* assign = dyn_cast<BinaryOperator>(stmt))
+  {
+    if (assign->isAssignmentOp() && refersTo(assign->getLHS()))
+    {
+      // p += k moves the pointer off its allocation boundary
+      if (assign->getOpcode() != BO_Assign)
+      {
+        return false;
+      }
+      values.push_back(assign->getRHS());
+    }
+  }
+  else if (auto* unary = dyn_cast<UnaryOperator>(stmt))
+  {
+    if ((unary->isIncrementDecrementOp() || unary->getOpcode() == UO_AddrOf) &&
+        refersTo(unary->getSubExpr()))
+    {
+      return false;
+    }
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    if (!collectStores(child, var, values))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace paralyze
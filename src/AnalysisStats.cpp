@@ -0,0 +1,212 @@
+#include "analyzer/AnalysisStats.h"
+#include <cstdio>
+#include <iomanip>
+
+namespace paralyze
+{
+
+AnalysisStats& AnalysisStats::get()
+{
+  static AnalysisStats stats;
+  return stats;
+}
+
+void AnalysisStats::beginFunction(const std::string& name)
+{
+  current_ = enabled_ ? &functions_[name] : nullptr;
+}
+
+void AnalysisStats::addTime(Phase phase, double seconds)
+{
+  if (!enabled_)
+  {
+    return;
+  }
+  totals_.seconds[index(phase)] += seconds;
+  if (current_)
+  {
+    current_->seconds[index(phase)] += seconds;
+  }
+}
+
+double AnalysisStats::maxSeconds(Phase phase, std::string& function) const
+{
+  double best = 0.0;
+  function.clear();
+  for (const auto& entry : functions_)
+  {
+    if (entry.second.seconds[index(phase)] > best)
+    {
+      best = entry.second.seconds[index(phase)];
+      function = entry.first;
+    }
+  }
+  return best;
+}
+
+uint64_t AnalysisStats::maxCount(Counter counter, std::string& function) const
+{
+  uint64_t best = 0;
+  function.clear();
+  for (const auto& entry : functions_)
+  {
+    if (entry.second.counters[index(counter)] > best)
+    {
+      best = entry.second.counters[index(counter)];
+      function = entry.first;
+    }
+  }
+  return best;
+}
+
+void AnalysisStats::printTable(std::ostream& out) const
+{
+  out << "\n=== Analysis Statistics ===\n";
+  out << std::left << std::setw(24) << "Phase" << std::right << std::setw(12) << "Total ms"
+      << std::setw(12) << "Max ms" << "  Function\n";
+  out << std::string(60, '-') << "\n";
+  for (size_t i = 0; i < index(Phase::COUNT); i++)
+  {
+    Phase phase = static_cast<Phase>(i);
+    std::string function;
+    double worst = maxSeconds(phase, function);
+    out << std::left << std::setw(24) << name(phase) << std::right << std::fixed
+        << std::setprecision(2) << std::setw(12) << totals_.seconds[i] * 1000.0;
+    if (function.empty())
+    {
+      out << std::setw(12) << "-" << "\n";
+    }
+    else
+    {
+      out << std::setw(12) << worst * 1000.0 << "  " << function << "\n";
+    }
+  }
+
+  out << "\n" << std::left << std::setw(24) << "Counter" << std::right << std::setw(12) << "Total"
+      << std::setw(12) << "Max" << "  Function\n";
+  out << std::string(60, '-') << "\n";
+  for (size_t i = 0; i < index(Counter::COUNT); i++)
+  {
+    Counter counter = static_cast<Counter>(i);
+    std::string function;
+    uint64_t worst = maxCount(counter, function);
+    out << std::left << std::setw(24) << name(counter) << std::right << std::setw(12)
+        << totals_.counters[i];
+    if (function.empty())
+    {
+      out << std::setw(12) << "-" << "\n";
+    }
+    else
+    {
+      out << std::setw(12) << worst << "  " << function << "\n";
+    }
+  }
+  out << "===========================\n";
+  out.unsetf(std::ios::floatfield);
+}
+
+void AnalysisStats::printJson(std::ostream& out) const
+{
+  // {"phases": {"parse": {"total_ms": 41.2, "max_ms": 0, "max_function": null}, ...}, ...}
+  auto function = [](const std::string& name)
+  { return name.empty() ? std::string("null") : "\"" + name + "\""; };
+  char number[32];
+
+  out << "{\"phases\": {";
+  for (size_t i = 0; i < index(Phase::COUNT); i++)
+  {
+    Phase phase = static_cast<Phase>(i);
+    std::string worst_function;
+    double worst = maxSeconds(phase, worst_function);
+    std::snprintf(number, sizeof(number), "%.3f", totals_.seconds[i] * 1000.0);
+    out << (i ? ", " : "") << "\"" << key(phase) << "\": {\"total_ms\": " << number;
+    std::snprintf(number, sizeof(number), "%.3f", worst * 1000.0);
+    out << ", \"max_ms\": " << number << ", \"max_function\": " << function(worst_function)
+        << "}";
+  }
+
+  out << "}, \"counters\": {";
+  for (size_t i = 0; i < index(Counter::COUNT); i++)
+  {
+    Counter counter = static_cast<Counter>(i);
+    std::string worst_function;
+    uint64_t worst = maxCount(counter, worst_function);
+    out << (i ? ", " : "") << "\"" << key(counter) << "\": {\"total\": " << totals_.counters[i]
+        << ", \"max\": " << worst << ", \"max_function\": " << function(worst_function) << "}";
+  }
+  out << "}, \"functions\": " << functions_.size() << "}\n";
+}
+
+const char* AnalysisStats::name(Phase phase)
+{
+  switch (phase)
+  {
+  case Phase::PARSE:
+    return "Clang parse";
+  case Phase::TRAVERSAL:
+    return "Loop traversal";
+  case Phase::DEPENDENCE:
+    return "  Dependence analysis";
+  case Phase::ARRAY_PAIRS:
+    return "    Array pair checks";
+  case Phase::PRAGMAS:
+    return "Pragma generation";
+  default:
+    return "Source annotation";
+  }
+}
+
+const char* AnalysisStats::name(Counter counter)
+{
+  switch (counter)
+  {
+  case Counter::LOOPS:
+    return "Loops";
+  case Counter::ACCESSES:
+    return "Array accesses";
+  case Counter::PAIRS:
+    return "Access pairs compared";
+  case Counter::PARENT_LOOKUPS:
+    return "getParents calls";
+  default:
+    return "Function arena bytes";
+  }
+}
+
+const char* AnalysisStats::key(Phase phase)
+{
+  switch (phase)
+  {
+  case Phase::PARSE:
+    return "parse";
+  case Phase::TRAVERSAL:
+    return "traversal";
+  case Phase::DEPENDENCE:
+    return "dependence";
+  case Phase::ARRAY_PAIRS:
+    return "array_pairs";
+  case Phase::PRAGMAS:
+    return "pragmas";
+  default:
+    return "annotation";
+  }
+}
+
+const char* AnalysisStats::key(Counter counter)
+{
+  switch (counter)
+  {
+  case Counter::LOOPS:
+    return "loops";
+  case Counter::ACCESSES:
+    return "accesses";
+  case Counter::PAIRS:
+    return "pairs";
+  case Counter::PARENT_LOOKUPS:
+    return "parent_lookups";
+  default:
+    return "arena_bytes";
+  }
+}
+
+} // namespace paralyze
@@ -1,6 +1,9 @@
 #include "analyzer/ArrayDependencyAnalyzer.h"
+#include "analyzer/AnalysisStats.h"
 #include "clang/AST/Expr.h"
+#include <algorithm>
 #include <iostream>
+#include <map>
 
 using namespace clang;
 
@@ -9,6 +12,7 @@ namespace paralyze
 
 void ArrayDependencyAnalyzer::analyzeArrayDependencies(LoopInfo& loop)
 {
+  ScopedTimer timer(Phase::ARRAY_PAIRS);
   detected_dependencies_.clear();
 
   if (verbose_)
@@ -17,20 +21,20 @@ void ArrayDependencyAnalyzer::analyzeArrayDependencies(LoopInfo& loop)
               << " array accesses\n";
   }
 
-  // check all pairs of array accesses for conflicts
-  for (size_t i = 0; i < loop.array_accesses.size(); i++)
+  // only accesses to the same array can conflict
+  std::map<std::string, std::vector<const ArrayAccess*>> buckets;
+  for (const ArrayAccess& access : loop.array_accesses)
   {
-    for (size_t j = i + 1; j < loop.array_accesses.size(); j++)
+    if (!loop.isPrivateArray(access.array_name) && !loop.isReductionArray(access.array_name) &&
+        !loop.isScanArray(access.array_name))
     {
-      const ArrayAccess& access1 = loop.array_accesses[i];
-      const ArrayAccess& access2 = loop.array_accesses[j];
-
-      if (access1.array_name == access2.array_name)
-      {
-        checkArrayAccessPair(access1, access2, loop.bounds.iterator_var);
-      }
+      buckets[access.array_name].push_back(&access);
     }
   }
+  for (const auto& bucket : buckets)
+  {
+    checkArrayBucket(bucket.second, loop.bounds.iterator_var);
+  }
 
   // run cross-iteration analysis
   cross_iteration_analyzer_->setVerbose(verbose_);
@@ -44,6 +48,12 @@ void ArrayDependencyAnalyzer::analyzeArrayDependencies(LoopInfo& loop)
 
 bool ArrayDependencyAnalyzer::hasArrayDependencies(const LoopInfo& loop) const
 {
+  // accumulations we could neither reduce nor make atomic
+  if (loop.hasArrayReduction(ReductionStrategy::UNRESOLVED))
+  {
+    return true;
+  }
+
   for (const auto& dep : detected_dependencies_)
   {
     if (dep.type != ArrayDependencyType::NO_DEPENDENCY)
@@ -60,6 +70,54 @@ bool ArrayDependencyAnalyzer::hasArrayDependencies(const LoopInfo& loop) const
   return false;
 }
 
+void ArrayDependencyAnalyzer::checkArrayBucket(const std::vector<const ArrayAccess*>& accesses,
+                                               const std::string& induction_var)
+{
+  // reads alone never conflict
+  if (std::none_of(accesses.begin(), accesses.end(),
+                   [](const ArrayAccess* access) { return access->is_write; }))
+  {
+    return;
+  }
+
+  // a verdict only depends on the two subscripts, so unrolled copies of the same
+  // subscript are checked once
+  std::vector<AccessGroup> forms;
+  std::map<std::string, size_t> form_index;
+  for (const ArrayAccess* access : accesses)
+  {
+    auto inserted = form_index.emplace(exprToString(access->subscript), forms.size());
+    if (inserted.second)
+    {
+      forms.emplace_back();
+    }
+    forms[inserted.first->second].add(access);
+  }
+
+  for (size_t i = 0; i < forms.size(); i++)
+  {
+    const AccessGroup& form = forms[i];
+    if (!form.write)
+    {
+      continue;
+    }
+
+    // a[i] written twice, or a[i + 1] written and read
+    if (form.second)
+    {
+      checkArrayAccessPair(*form.write, form.write == form.first ? *form.second : *form.first,
+                           induction_var);
+    }
+
+    // two different subscripts always relate, as a constant offset or an unknown one, so one
+    // partner per written subscript is enough to find and report it
+    if (forms.size() > 1)
+    {
+      checkArrayAccessPair(*form.write, *forms[i == 0 ? 1 : 0].first, induction_var);
+    }
+  }
+}
+
 void ArrayDependencyAnalyzer::checkArrayAccessPair(const ArrayAccess& access1,
                                                    const ArrayAccess& access2,
                                                    const std::string& induction_var)
@@ -69,6 +127,7 @@ void ArrayDependencyAnalyzer::checkArrayAccessPair(const ArrayAccess& access1,
   {
     return;
   }
+  AnalysisStats::get().count(Counter::PAIRS);
 
   ArrayDependencyType dep_type =
       compareArrayIndices(access1.subscript, access2.subscript, induction_var);
@@ -0,0 +1,431 @@
+#include "analyzer/ArrayPrivatizer.h"
+#include <algorithm>
+#include <iostream>
+
+using namespace clang;
+
+namespace paralyze
+{
+
+void ArrayPrivatizer::analyzeLoop(Stmt* loopStmt, LoopInfo& loop)
+{
+  if (!loopStmt || !loop.body())
+  {
+    return;
+  }
+
+  std::vector<const VarDecl*> candidates;
+  collectCandidates(loop.body(), loopStmt, candidates);
+
+  for (const VarDecl* var : candidates)
+  {
+    const ConstantArrayType* type = context_->getAsConstantArrayType(var->getType());
+    std::vector<bool> written(type->getSize().getZExtValue(), false);
+
+    bool covered = coverStatement(loop.body(), var, written) &&
+                   std::find(written.begin(), written.end(), false) == written.end();
+    if (!covered)
+    {
+      if (verbose_)
+      {
+        std::cout << "  Work array " << var->getNameAsString()
+                  << " may be read before it is written, keeping it shared\n";
+      }
+      continue;
+    }
+
+    loop.private_arrays.push_back(var->getNameAsString());
+
+    if (verbose_)
+    {
+      std::cout << "  Work array " << var->getNameAsString() << "[" << written.size()
+                << "] is fully written before any read, privatizing\n";
+    }
+  }
+}
+
+void ArrayPrivatizer::collectCandidates(const Stmt* stmt, const Stmt* loopStmt,
+                                        std::vector<const VarDecl*>& candidates) const
+{
+  if (!stmt)
+  {
+    return;
+  }
+
+  if (auto* ref = dyn_cast<DeclRefExpr>(stmt))
+  {
+    auto* var = dyn_cast<VarDecl>(ref->getDecl());
+    if (var && std::find(candidates.begin(), candidates.end(), var) == candidates.end() &&
+        isWorkArray(var, loopStmt))
+    {
+      candidates.push_back(var);
+    }
+    return;
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    collectCandidates(child, loopStmt, candidates);
+  }
+}
+
+bool ArrayPrivatizer::isWorkArray(const VarDecl* var, const Stmt* loopStmt) const
+{
+  // a small automatic array with a known extent
+  if (!var->hasLocalStorage())
+  {
+    return false;
+  }
+  const ConstantArrayType* type = context_->getAsConstantArrayType(var->getType());
+  if (!type || type->getElementType()->isArrayType())
+  {
+    return false;
+  }
+  unsigned long long extent = type->getSize().getZExtValue();
+  if (extent == 0 || extent > kMaxPrivateElements)
+  {
+    return false;
+  }
+
+  // arrays declared in the body are private already
+  const SourceManager& sm = context_->getSourceManager();
+  if (!sm.isBeforeInTranslationUnit(var->getLocation(), loopStmt->getBeginLoc()))
+  {
+    return false;
+  }
+
+  // private copies start undefined and are dropped afterwards, so nothing else may use it
+  auto* function = dyn_cast<FunctionDecl>(var->getDeclContext());
+  return function && function->getBody() && !isUsedOutside(function->getBody(), var, loopStmt);
+}
+
+bool ArrayPrivatizer::isUsedOutside(const Stmt* stmt, const VarDecl* var,
+                                    const Stmt* loopStmt) const
+{
+  if (!stmt || stmt == loopStmt)
+  {
+    return false;
+  }
+
+  if (auto* ref = dyn_cast<DeclRefExpr>(stmt))
+  {
+    return ref->getDecl() == var;
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    if (isUsedOutside(child, var, loopStmt))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ArrayPrivatizer::coverStatement(const Stmt* stmt, const VarDecl* var,
+                                     std::vector<bool>& written) const
+{
+  if (!stmt || !references(stmt, var))
+  {
+    return true;
+  }
+
+  // once every element is written the rest of the iteration can use the array freely
+  if (std::find(written.begin(), written.end(), false) == written.end())
+  {
+    return true;
+  }
+
+  if (isa<CompoundStmt>(stmt))
+  {
+    for (const Stmt* child : stmt->children())
+    {
+      if (!coverStatement(child, var, written))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  if (auto* fill = dyn_cast<ForStmt>(stmt))
+  {
+    return coverFillLoop(fill, var, written);
+  }
+
+  // tmp[c] = expr
+  if (auto* expr = dyn_cast<Expr>(stmt))
+  {
+    auto* assign = dyn_cast<BinaryOperator>(expr->IgnoreParenImpCasts());
+    const ArraySubscriptExpr* element =
+        assign && assign->getOpcode() == BO_Assign ? elementOf(assign->getLHS(), var) : nullptr;
+    size_t index = 0;
+    if (element && constantIndex(element->getIdx(), written, index))
+    {
+      if (!readsOnlyWritten(assign->getRHS(), var, written, nullptr))
+      {
+        return false;
+      }
+      written[index] = true;
+      return true;
+    }
+  }
+
+  // anything else (branches, reads into locals) may only read what is already written
+  return readsOnlyWritten(stmt, var, written, nullptr);
+}
+
+bool ArrayPrivatizer::coverFillLoop(const ForStmt* fill, const VarDecl* var,
+                                    std::vector<bool>& written) const
+{
+  // for (k = lo; k < hi; k++) with constant bounds
+  const VarDecl* iterator = nullptr;
+  const Expr* start = nullptr;
+  if (auto* decl = dyn_cast_or_null<DeclStmt>(fill->getInit()))
+  {
+    if (decl->isSingleDecl())
+    {
+      iterator = dyn_cast<VarDecl>(decl->getSingleDecl());
+      start = iterator ? iterator->getInit() : nullptr;
+    }
+  }
+  else if (auto* init = dyn_cast_or_null<Expr>(fill->getInit()))
+  {
+    auto* assign = dyn_cast<BinaryOperator>(init->IgnoreParenImpCasts());
+    auto* ref = assign && assign->getOpcode() == BO_Assign
+                    ? dyn_cast<DeclRefExpr>(assign->getLHS()->IgnoreParenImpCasts())
+                    : nullptr;
+    iterator = ref ? dyn_cast<VarDecl>(ref->getDecl()) : nullptr;
+    start = assign ? assign->getRHS() : nullptr;
+  }
+
+  auto* cond = fill->getCond() ? dyn_cast<BinaryOperator>(fill->getCond()->IgnoreParenImpCasts())
+                               : nullptr;
+  auto* step =
+      fill->getInc() ? dyn_cast<UnaryOperator>(fill->getInc()->IgnoreParenImpCasts()) : nullptr;
+  Expr::EvalResult low, high;
+  bool counted = iterator && start && cond && step && step->isIncrementOp() &&
+                 isRefTo(step->getSubExpr(), iterator) &&
+                 (cond->getOpcode() == BO_LT || cond->getOpcode() == BO_LE) &&
+                 isRefTo(cond->getLHS(), iterator) && start->EvaluateAsInt(low, *context_) &&
+                 cond->getRHS()->EvaluateAsInt(high, *context_);
+
+  const Stmt* body = fill->getBody();
+  if (!counted || !body || leavesEarly(body) || modifies(body, iterator))
+  {
+    return readsOnlyWritten(fill, var, written, nullptr);
+  }
+
+  // the first use of the array in the body stores tmp[k], later ones may read it back
+  std::vector<const Stmt*> statements;
+  if (isa<CompoundStmt>(body))
+  {
+    for (const Stmt* child : body->children())
+    {
+      statements.push_back(child);
+    }
+  }
+  else
+  {
+    statements.push_back(body);
+  }
+
+  bool stored = false;
+  for (const Stmt* stmt : statements)
+  {
+    if (!references(stmt, var))
+    {
+      continue;
+    }
+    if (stored)
+    {
+      if (!readsOnlyWritten(stmt, var, written, iterator))
+      {
+        return false;
+      }
+      continue;
+    }
+
+    auto* expr = dyn_cast<Expr>(stmt);
+    auto* assign = expr ? dyn_cast<BinaryOperator>(expr->IgnoreParenImpCasts()) : nullptr;
+    const ArraySubscriptExpr* element =
+        assign && assign->getOpcode() == BO_Assign ? elementOf(assign->getLHS(), var) : nullptr;
+    if (!element || !isRefTo(element->getIdx(), iterator) ||
+        !readsOnlyWritten(assign->getRHS(), var, written, nullptr))
+    {
+      return false;
+    }
+    stored = true;
+  }
+
+  long long lo = low.Val.getInt().getExtValue();
+  long long hi = high.Val.getInt().getExtValue() + (cond->getOpcode() == BO_LE ? 1 : 0);
+  if (!stored || lo >= hi)
+  {
+    return readsOnlyWritten(fill, var, written, nullptr);
+  }
+  if (lo < 0 || hi > static_cast<long long>(written.size()))
+  {
+    return false;
+  }
+
+  std::fill(written.begin() + lo, written.begin() + hi, true);
+  return true;
+}
+
+bool ArrayPrivatizer::readsOnlyWritten(const Stmt* stmt, const VarDecl* var,
+                                       const std::vector<bool>& written,
+                                       const VarDecl* fill_iterator) const
+{
+  if (!stmt)
+  {
+    return true;
+  }
+
+  if (auto* expr = dyn_cast<Expr>(stmt))
+  {
+    size_t index = 0;
+    if (const ArraySubscriptExpr* element = elementOf(expr, var))
+    {
+      bool own_element = fill_iterator && isRefTo(element->getIdx(), fill_iterator);
+      return (own_element || (constantIndex(element->getIdx(), written, index) &&
+                              written[index])) &&
+             !references(element->getIdx(), var);
+    }
+
+    // a plain store doesn't read the element it overwrites
+    auto* assign = dyn_cast<BinaryOperator>(expr->IgnoreParenImpCasts());
+    const ArraySubscriptExpr* target =
+        assign && assign->getOpcode() == BO_Assign ? elementOf(assign->getLHS(), var) : nullptr;
+    if (target && ((fill_iterator && isRefTo(target->getIdx(), fill_iterator)) ||
+                   constantIndex(target->getIdx(), written, index)))
+    {
+      return readsOnlyWritten(assign->getRHS(), var, written, fill_iterator);
+    }
+
+    // the bare array escapes (memcpy, pointer arithmetic), so we lose track of it
+    if (isRefTo(expr, var))
+    {
+      return false;
+    }
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    if (!readsOnlyWritten(child, var, written, fill_iterator))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+const ArraySubscriptExpr* ArrayPrivatizer::elementOf(const Expr* expr, const VarDecl* var) const
+{
+  auto* element = dyn_cast<ArraySubscriptExpr>(expr->IgnoreParenImpCasts());
+  return element && isRefTo(element->getBase(), var) ? element : nullptr;
+}
+
+bool ArrayPrivatizer::constantIndex(const Expr* index, const std::vector<bool>& written,
+                                    size_t& element) const
+{
+  Expr::EvalResult result;
+  if (!index->EvaluateAsInt(result, *context_))
+  {
+    return false;
+  }
+
+  long long value = result.Val.getInt().getExtValue();
+  if (value < 0 || value >= static_cast<long long>(written.size()))
+  {
+    return false;
+  }
+  element = static_cast<size_t>(value);
+  return true;
+}
+
+bool ArrayPrivatizer::isRefTo(const Expr* expr, const VarDecl* var) const
+{
+  auto* ref = dyn_cast<DeclRefExpr>(expr->IgnoreParenImpCasts());
+  return ref && ref->getDecl() == var;
+}
+
+bool ArrayPrivatizer::references(const Stmt* stmt, const VarDecl* var) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+
+  if (auto* ref = dyn_cast<DeclRefExpr>(stmt))
+  {
+    return ref->getDecl() == var;
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    if (references(child, var))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ArrayPrivatizer::modifies(const Stmt* stmt, const VarDecl* var) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+
+  if (auto* assign = dyn_cast<BinaryOperator>(stmt))
+  {
+    if (assign->isAssignmentOp() && isRefTo(assign->getLHS(), var))
+    {
+      return true;
+    }
+  }
+  else if (auto* unary = dyn_cast<UnaryOperator>(stmt))
+  {
+    if ((unary->isIncrementDecrementOp() || unary->getOpcode() == UO_AddrOf) &&
+        isRefTo(unary->getSubExpr(), var))
+    {
+      return true;
+    }
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    if (modifies(child, var))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ArrayPrivatizer::leavesEarly(const Stmt* stmt) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+
+  if (isa<BreakStmt>(stmt) || isa<ContinueStmt>(stmt) || isa<ReturnStmt>(stmt) ||
+      isa<GotoStmt>(stmt))
+  {
+    return true;
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    if (leavesEarly(child))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace paralyze
@@ -0,0 +1,462 @@
+#include "analyzer/ArrayReductionAnalyzer.h"
+#include <algorithm>
+#include <iostream>
+
+using namespace clang;
+
+namespace paralyze
+{
+
+void ArrayReductionAnalyzer::analyzeLoop(Stmt* loopStmt, LoopInfo& loop)
+{
+  if (!loopStmt || !loop.body())
+  {
+    return;
+  }
+
+  std::vector<Update> updates;
+  std::set<const VarDecl*> other_uses;
+  collectUpdates(loop.body(), updates, other_uses);
+
+  // arrays that are read or stored anywhere else can't be combined after the fact
+  std::vector<const VarDecl*> arrays;
+  for (const auto& update : updates)
+  {
+    if (!other_uses.count(update.array) &&
+        std::find(arrays.begin(), arrays.end(), update.array) == arrays.end())
+    {
+      arrays.push_back(update.array);
+    }
+  }
+
+  for (const VarDecl* array : arrays)
+  {
+    std::vector<Update> own;
+    bool pinned = true;
+    for (const auto& update : updates)
+    {
+      if (update.array == array)
+      {
+        own.push_back(update);
+        pinned = pinned && followsIterator(update.element->getIdx(), loop);
+      }
+    }
+
+    // every iteration owns the element it updates, nothing to combine
+    if (pinned)
+    {
+      continue;
+    }
+
+    ArrayReduction reduction;
+    reduction.array_name = array->getNameAsString();
+    for (const auto& update : own)
+    {
+      reduction.update_lines.push_back(source_.getLine(update.stmt->getBeginLoc()));
+    }
+
+    long long elements = -1;
+    bool sized = sectionLength(array, own, loopStmt, reduction.section_length, elements);
+    if (!sized)
+    {
+      reduction.section_length.clear();
+    }
+    chooseStrategy(reduction, elements, loop);
+
+    if (reduction.strategy == ReductionStrategy::ATOMIC && !buildAtomicEdits(own, reduction))
+    {
+      reduction.edits.clear();
+      reduction.strategy = sized ? ReductionStrategy::SECTION : ReductionStrategy::UNRESOLVED;
+      reduction.justification = sized ? "updates don't sit on lines of their own for an atomic "
+                                        "directive, so each thread gets a private copy instead"
+                                      : "size unknown and updates don't sit on lines of their own";
+    }
+
+    if (verbose_)
+    {
+      std::cout << "  Accumulate-only array " << reduction.array_name << " ("
+                << own.size() << " update" << (own.size() > 1 ? "s" : "") << "): ";
+      switch (reduction.strategy)
+      {
+      case ReductionStrategy::SECTION:
+        std::cout << "reduction(+:" << reduction.section() << ")";
+        break;
+      case ReductionStrategy::ATOMIC:
+        std::cout << "atomic updates";
+        break;
+      case ReductionStrategy::UNRESOLVED:
+        std::cout << "unresolved";
+        break;
+      }
+      std::cout << " - " << reduction.justification << "\n";
+    }
+
+    loop.array_reductions.push_back(reduction);
+  }
+}
+
+void ArrayReductionAnalyzer::collectUpdates(const Stmt* stmt, std::vector<Update>& updates,
+                                            std::set<const VarDecl*>& other_uses) const
+{
+  if (!stmt)
+  {
+    return;
+  }
+
+  // statement-level expressions are where updates live, anything deeper is a plain use
+  if (auto* expr = dyn_cast<Expr>(stmt))
+  {
+    Update update{nullptr, nullptr, nullptr};
+    const Expr* addend = nullptr;
+    if (matchUpdate(expr, update, addend))
+    {
+      updates.push_back(update);
+      collectReferences(update.element->getIdx(), other_uses);
+      collectReferences(addend, other_uses);
+    }
+    else
+    {
+      collectReferences(expr, other_uses);
+    }
+    return;
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    collectUpdates(child, updates, other_uses);
+  }
+}
+
+bool ArrayReductionAnalyzer::matchUpdate(const Expr* expr, Update& update,
+                                         const Expr*& addend) const
+{
+  const Expr* target = nullptr;
+  addend = nullptr;
+  expr = expr->IgnoreParenImpCasts();
+
+  if (auto* unary = dyn_cast<UnaryOperator>(expr))
+  {
+    if (unary->isIncrementDecrementOp())
+    {
+      target = unary->getSubExpr();
+    }
+  }
+  else if (auto* compound = dyn_cast<CompoundAssignOperator>(expr))
+  {
+    if (compound->getOpcode() == BO_AddAssign || compound->getOpcode() == BO_SubAssign)
+    {
+      target = compound->getLHS();
+      addend = compound->getRHS();
+    }
+  }
+  else if (auto* assign = dyn_cast<BinaryOperator>(expr))
+  {
+    // hist[k] = hist[k] + e, hist[k] = e + hist[k] or hist[k] = hist[k] - e
+    auto* sum = assign->getOpcode() == BO_Assign
+                    ? dyn_cast<BinaryOperator>(assign->getRHS()->IgnoreParenImpCasts())
+                    : nullptr;
+    std::string lhs = source_.getText(assign->getLHS()->getSourceRange());
+    if (sum && !lhs.empty() && (sum->getOpcode() == BO_Add || sum->getOpcode() == BO_Sub))
+    {
+      if (source_.getText(sum->getLHS()->IgnoreParenImpCasts()->getSourceRange()) == lhs)
+      {
+        target = assign->getLHS();
+        addend = sum->getRHS();
+      }
+      else if (sum->getOpcode() == BO_Add &&
+               source_.getText(sum->getRHS()->IgnoreParenImpCasts()->getSourceRange()) == lhs)
+      {
+        target = assign->getLHS();
+        addend = sum->getLHS();
+      }
+    }
+  }
+
+  if (!target)
+  {
+    return false;
+  }
+
+  auto* element = dyn_cast<ArraySubscriptExpr>(target->IgnoreParenImpCasts());
+  auto* base = element ? dyn_cast<DeclRefExpr>(element->getBase()->IgnoreParenImpCasts()) : nullptr;
+  auto* array = base ? dyn_cast<VarDecl>(base->getDecl()) : nullptr;
+  if (!array ||
+      !(element->getType()->isIntegerType() || element->getType()->isRealFloatingType()))
+  {
+    return false;
+  }
+
+  update = Update{array, element, expr};
+  return true;
+}
+
+void ArrayReductionAnalyzer::collectReferences(const Stmt* stmt,
+                                               std::set<const VarDecl*>& vars) const
+{
+  if (!stmt)
+  {
+    return;
+  }
+
+  if (auto* ref = dyn_cast<DeclRefExpr>(stmt))
+  {
+    if (auto* var = dyn_cast<VarDecl>(ref->getDecl()))
+    {
+      vars.insert(var);
+    }
+    return;
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    collectReferences(child, vars);
+  }
+}
+
+bool ArrayReductionAnalyzer::followsIterator(const Expr* index, const LoopInfo& loop) const
+{
+  const std::string& iterator = loop.bounds.iterator_var;
+  if (iterator.empty())
+  {
+    return false;
+  }
+
+  auto isIterator = [&iterator](const Expr* expr)
+  {
+    auto* ref = dyn_cast<DeclRefExpr>(expr->IgnoreParenImpCasts());
+    return ref && ref->getDecl()->getNameAsString() == iterator;
+  };
+
+  // hist[i] or hist[i + 1]: distinct iterations never meet on an element
+  index = index->IgnoreParenImpCasts();
+  if (isIterator(index))
+  {
+    return true;
+  }
+
+  auto* offset = dyn_cast<BinaryOperator>(index);
+  if (!offset || (offset->getOpcode() != BO_Add && offset->getOpcode() != BO_Sub))
+  {
+    return false;
+  }
+  return (isIterator(offset->getLHS()) &&
+          isa<IntegerLiteral>(offset->getRHS()->IgnoreParenImpCasts())) ||
+         (offset->getOpcode() == BO_Add && isIterator(offset->getRHS()) &&
+          isa<IntegerLiteral>(offset->getLHS()->IgnoreParenImpCasts()));
+}
+
+bool ArrayReductionAnalyzer::sectionLength(const VarDecl* array, const std::vector<Update>& updates,
+                                           const Stmt* loopStmt, std::string& length,
+                                           long long& elements) const
+{
+  if (auto* type = context_->getAsConstantArrayType(array->getType()))
+  {
+    elements = static_cast<long long>(type->getSize().getZExtValue());
+    length = std::to_string(elements);
+    return true;
+  }
+
+  // behind a pointer the index itself has to bound it: hist[key[i] % nbins], hist[v & 255]
+  length.clear();
+  for (const auto& update : updates)
+  {
+    std::string bound;
+    long long count = -1;
+    if (!indexBound(update.element->getIdx(), loopStmt, bound, count))
+    {
+      return false;
+    }
+
+    if (length.empty() || bound == length)
+    {
+      length = bound;
+      elements = count;
+    }
+    else if (count < 0 || elements < 0)
+    {
+      return false;
+    }
+    else if (count > elements)
+    {
+      length = bound;
+      elements = count;
+    }
+  }
+  return !length.empty();
+}
+
+bool ArrayReductionAnalyzer::indexBound(const Expr* index, const Stmt* loopStmt,
+                                        std::string& length, long long& elements) const
+{
+  auto* op = dyn_cast<BinaryOperator>(index->IgnoreParenImpCasts());
+  if (!op)
+  {
+    return false;
+  }
+
+  Expr::EvalResult value;
+  if (op->getOpcode() == BO_Rem)
+  {
+    const Expr* modulus = op->getRHS();
+    if (modulus->EvaluateAsInt(value, *context_))
+    {
+      elements = value.Val.getInt().getExtValue();
+      length = std::to_string(elements);
+      return elements > 0;
+    }
+
+    // a runtime bin count works too, as long as the loop leaves it alone
+    SourceRange range = modulus->getSourceRange();
+    if (!source_.isRewritable(range) || !isInvariant(modulus, loopStmt))
+    {
+      return false;
+    }
+    elements = -1;
+    length = source_.getText(range);
+    return !length.empty();
+  }
+
+  if (op->getOpcode() == BO_And)
+  {
+    const Expr* mask = op->getRHS()->EvaluateAsInt(value, *context_) ? op->getRHS()
+                       : op->getLHS()->EvaluateAsInt(value, *context_) ? op->getLHS()
+                                                                       : nullptr;
+    if (mask && value.Val.getInt().getExtValue() >= 0)
+    {
+      elements = value.Val.getInt().getExtValue() + 1;
+      length = std::to_string(elements);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ArrayReductionAnalyzer::isInvariant(const Expr* expr, const Stmt* loopStmt) const
+{
+  std::set<const VarDecl*> vars;
+  collectReferences(expr, vars);
+
+  const SourceManager& sm = context_->getSourceManager();
+  for (const VarDecl* var : vars)
+  {
+    // declared in the loop means recomputed every iteration
+    if (!sm.isBeforeInTranslationUnit(var->getLocation(), loopStmt->getBeginLoc()))
+    {
+      return false;
+    }
+  }
+
+  // calls may return something different each time
+  std::vector<const Stmt*> pending = {expr};
+  while (!pending.empty())
+  {
+    const Stmt* stmt = pending.back();
+    pending.pop_back();
+    if (isa<CallExpr>(stmt))
+    {
+      return false;
+    }
+    for (const Stmt* child : stmt->children())
+    {
+      if (child)
+      {
+        pending.push_back(child);
+      }
+    }
+  }
+
+  return !assignsAny(loopStmt, vars);
+}
+
+bool ArrayReductionAnalyzer::assignsAny(const Stmt* stmt,
+                                        const std::set<const VarDecl*>& vars) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+
+  auto isTracked = [&vars](const Expr* expr)
+  {
+    auto* ref = dyn_cast<DeclRefExpr>(expr->IgnoreParenImpCasts());
+    auto* var = ref ? dyn_cast<VarDecl>(ref->getDecl()) : nullptr;
+    return var && vars.count(var);
+  };
+
+  if (auto* assign = dyn_cast<BinaryOperator>(stmt))
+  {
+    if (assign->isAssignmentOp() && isTracked(assign->getLHS()))
+    {
+      return true;
+    }
+  }
+  else if (auto* unary = dyn_cast<UnaryOperator>(stmt))
+  {
+    if ((unary->isIncrementDecrementOp() || unary->getOpcode() == UO_AddrOf) &&
+        isTracked(unary->getSubExpr()))
+    {
+      return true;
+    }
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    if (assignsAny(child, vars))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ArrayReductionAnalyzer::chooseStrategy(ArrayReduction& reduction, long long elements,
+                                            const LoopInfo& loop) const
+{
+  if (reduction.section_length.empty())
+  {
+    reduction.strategy = ReductionStrategy::ATOMIC;
+    reduction.justification = "size of " + reduction.array_name + " is unknown";
+    return;
+  }
+
+  // private copies cost threads * elements to zero and merge, atomics cost contention per update
+  const auto& trips = loop.bounds.constant_trip_count;
+  if (elements > kMaxSectionElements)
+  {
+    reduction.strategy = ReductionStrategy::ATOMIC;
+    reduction.justification =
+        std::to_string(elements) + " elements are too many to copy into every thread";
+  }
+  else if (elements > 0 && trips && elements > *trips)
+  {
+    reduction.strategy = ReductionStrategy::ATOMIC;
+    reduction.justification = "more elements than updates, so collisions are rare and merging "
+                              "private copies would cost more than it saves";
+  }
+  else
+  {
+    reduction.strategy = ReductionStrategy::SECTION;
+    reduction.justification = "each thread accumulates into a private copy, merged at the end";
+  }
+}
+
+bool ArrayReductionAnalyzer::buildAtomicEdits(const std::vector<Update>& updates,
+                                              ArrayReduction& reduction) const
+{
+  for (const auto& update : updates)
+  {
+    SourceRange range = update.stmt->getSourceRange();
+    if (!source_.isRewritable(range) || !source_.startsLine(range.getBegin()) ||
+        !source_.endsLine(range.getEnd()))
+    {
+      return false;
+    }
+
+    unsigned line = source_.getLine(range.getBegin());
+    reduction.edits.emplace_back(line, LineEditKind::INSERT_BEFORE,
+                                 source_.getIndentation(line) + "#pragma omp atomic");
+  }
+  return true;
+}
+
+} // namespace paralyze
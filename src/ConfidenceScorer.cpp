@@ -1,6 +1,7 @@
 #include "analyzer/ConfidenceScorer.h"
 #include "analyzer/LoopInfo.h"
 #include "analyzer/PragmaGenerator.h"
+#include "llvm/Support/TimeProfiler.h"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
@@ -11,6 +12,7 @@ namespace paralyze
 ConfidenceScore ConfidenceScorer::calculateConfidence(const LoopInfo& loop,
                                                       const GeneratedPragma& pragma)
 {
+  llvm::TimeTraceScope trace("ScoreConfidence", [&] { return std::to_string(loop.line_number); });
   ConfidenceScore score;
 
   // Score different aspects of the loop
@@ -66,6 +68,78 @@ ConfidenceScore ConfidenceScorer::calculateConfidence(const LoopInfo& loop,
     negative_factors.push_back("Contains function calls");
   }
 
+  if (loop.canonical.form == CanonicalForm::POINTER_WALK)
+  {
+    negative_factors.push_back("Pointer walk lowered to indexed form (assumes buffers don't overlap)");
+  }
+
+  if (loop.search.is_search)
+  {
+    negative_factors.push_back("Early exit relies on cancellation (OMP_CANCELLATION=true)");
+  }
+
+  if (loop.doacross.isPipelined())
+  {
+    negative_factors.push_back("Doacross pipeline: iterations wait on their sinks, speedup is "
+                               "bounded by the wavefront width");
+  }
+
+  if (loop.transform.isFission())
+  {
+    negative_factors.push_back("Loop split by fission, the serial remainder runs afterwards");
+  }
+  else if (loop.transform.isFusion())
+  {
+    positive_factors.push_back("Fused with a sibling loop that reads the same arrays");
+  }
+
+  for (const auto& reduction : loop.array_reductions)
+  {
+    if (reduction.strategy == ReductionStrategy::SECTION)
+    {
+      positive_factors.push_back("Array reduction into private copies of " +
+                                 reduction.array_name);
+    }
+    else if (reduction.strategy == ReductionStrategy::ATOMIC)
+    {
+      negative_factors.push_back("Atomic updates to " + reduction.array_name +
+                                 " contend when keys collide");
+    }
+  }
+
+  if (loop.scan.isScan())
+  {
+    negative_factors.push_back("Prefix scan makes two passes over " + loop.scan.variable +
+                               "'s inputs");
+  }
+
+  if (loop.safelen_covered)
+  {
+    negative_factors.push_back("Vectorized only up to the recurrence distance (safelen(" +
+                               std::to_string(loop.simd.safelen) + "))");
+  }
+  else if (loop.simd.vectorizable)
+  {
+    positive_factors.push_back("Unit-stride accesses fill " + std::to_string(loop.simd.simdlen) +
+                               " vector lanes");
+  }
+
+  if (loop.shared_updates.isSynchronized())
+  {
+    std::string names;
+    for (const auto& name : loop.shared_updates.variables)
+    {
+      names += (names.empty() ? "" : ", ") + name;
+    }
+    negative_factors.push_back("Estimated contention: " + loop.shared_updates.justification +
+                               " on " + names);
+  }
+
+  if (!loop.private_arrays.empty())
+  {
+    positive_factors.push_back("Work arrays privatized (written in full before any read)");
+  }
+
   if (loop.variables.size() > 5)
   {
     negative_factors.push_back("Many variables in scope");
@@ -115,6 +189,10 @@ double ConfidenceScorer::scorePragmaType(PragmaType type)
     return 0.7;
   case PragmaType::SIMD:
     return 0.6;
+  case PragmaType::TASKLOOP:
+    return 0.7;
+  case PragmaType::DOACROSS:
+    return 0.5;
   case PragmaType::NO_PRAGMA:
   default:
     return 0.0;
@@ -162,13 +240,8 @@ double ConfidenceScorer::scoreDataAccess(const LoopInfo& loop)
   {
     score += 0.3;
 
-    // TODO: Actually analyze access patterns for complexity
+    // TODO: Actually analyze access patterns for complexity, checking index expressions
     bool has_simple_access = true;
-    for (const auto& access : loop.array_accesses)
-    {
-      // Placeholder - should check index expressions
-    }
-
     if (has_simple_access)
     {
       score += 0.2;
@@ -187,7 +260,8 @@ double ConfidenceScorer::scoreDependencyAnalysis(const LoopInfo& loop)
 {
   if (loop.has_dependencies)
   {
-    return 0.0; // Can't be confident if there are dependencies
+    // a split loop is only as certain as the statement partition behind it
+    return loop.transform.isFission() ? 0.5 : 0.0; // Can't be confident if there are dependencies
   }
 
   double score = 0.8;
@@ -238,7 +312,7 @@ std::string ConfidenceScorer::getConfidenceDescription(ConfidenceLevel level) co
   }
 }
 
-std::string ConfidenceScorer::generateReasoning(const LoopInfo& loop, const GeneratedPragma& pragma,
+std::string ConfidenceScorer::generateReasoning(const LoopInfo&, const GeneratedPragma&,
                                                 const std::vector<std::string>& pos_factors,
                                                 const std::vector<std::string>& neg_factors)
 {
@@ -1,5 +1,7 @@
 #include "analyzer/CrossIterationAnalyzer.h"
+#include "analyzer/AnalysisStats.h"
 #include "clang/AST/Expr.h"
+#include "llvm/ADT/FoldingSet.h"
 #include <algorithm>
 #include <iostream>
 #include <map>
@@ -32,7 +34,10 @@ void CrossIterationAnalyzer::analyzeCrossIterationConflicts(LoopInfo& loop)
     const std::string& array_name = array_pair.first;
     const std::vector<ArrayAccess>& accesses = array_pair.second;
 
-    if (accesses.size() > 1)
+    // each thread works on its own copy of a privatized or reduced array, and a scan
+    // array only ever sees its own prefix
+    if (accesses.size() > 1 && !loop.isPrivateArray(array_name) &&
+        !loop.isReductionArray(array_name) && !loop.isScanArray(array_name))
     {
       analyzeArrayAccessPattern(array_name, accesses, loop.bounds.iterator_var);
     }
@@ -51,7 +56,7 @@ void CrossIterationAnalyzer::analyzeCrossIterationConflicts(LoopInfo& loop)
   }
 }
 
-bool CrossIterationAnalyzer::hasCrossIterationConflicts(const LoopInfo& loop) const
+bool CrossIterationAnalyzer::hasCrossIterationConflicts(const LoopInfo&) const
 {
   return !conflicts_.empty();
 }
@@ -66,86 +71,148 @@ void CrossIterationAnalyzer::analyzeArrayAccessPattern(const std::string& array_
     std::cout << "  Analyzing " << accesses.size() << " accesses to array " << array_name << "\n";
   }
 
-  // check every pair of accesses for potential conflicts
-  for (size_t i = 0; i < accesses.size(); i++)
+  // reads alone never conflict
+  const ArrayAccess* any_write = nullptr;
+  for (const ArrayAccess& access : accesses)
   {
-    for (size_t j = i + 1; j < accesses.size(); j++)
+    if (access.is_write)
     {
-      const ArrayAccess& access1 = accesses[i];
-      const ArrayAccess& access2 = accesses[j];
+      any_write = &access;
+      break;
+    }
+  }
+  if (!any_write)
+  {
+    return;
+  }
 
-      // skip if both are reads - no conflict
-      if (!access1.is_write && !access2.is_write)
+  // i + c subscripts collapse onto their offset; only equal and adjacent offsets can conflict,
+  // so the offsets are looked up instead of compared pairwise
+  std::map<int, AccessGroup> by_offset;
+  std::map<llvm::FoldingSetNodeID, AccessGroup> complex; // identical subscripts share a group
+  for (const ArrayAccess& access : accesses)
+  {
+    int offset = 0;
+    if (hasOffsetFromInduction(access.subscript, induction_var, offset))
+    {
+      by_offset[offset].add(&access);
+    }
+    else
+    {
+      llvm::FoldingSetNodeID id;
+      if (access.subscript)
       {
-        continue;
+        access.subscript->Profile(id, *context_, true);
       }
+      complex[id].add(&access);
+    }
+  }
+
+  for (const auto& entry : by_offset)
+  {
+    const AccessGroup& group = entry.second;
+    if (group.write && group.second)
+    {
+      const ArrayAccess* other = group.write == group.first ? group.second : group.first;
+      recordOffsetConflict(array_name, *group.write, *other, entry.first, entry.first,
+                           induction_var);
+    }
 
-      // analyze the index expressions to detect stride patterns
-      int offset1 = 0, offset2 = 0;
-      bool has_offset1 = hasOffsetFromInduction(access1.subscript, induction_var, offset1);
-      bool has_offset2 = hasOffsetFromInduction(access2.subscript, induction_var, offset2);
+    auto next = by_offset.find(entry.first + 1);
+    if (next != by_offset.end() && (group.write || next->second.write))
+    {
+      const ArrayAccess* lower = group.write ? group.write : group.first;
+      const ArrayAccess* upper = group.write ? next->second.first : next->second.write;
+      recordOffsetConflict(array_name, *lower, *upper, entry.first, entry.first + 1,
+                           induction_var);
+    }
+  }
 
-      if (has_offset1 && has_offset2)
+  // one or both indices are complex - conservative; one partner per distinct subscript
+  for (const auto& entry : complex)
+  {
+    const AccessGroup& group = entry.second;
+    const ArrayAccess* access = group.write ? group.write : group.first;
+    const ArrayAccess* partner = any_write;
+    if (group.write)
+    {
+      // a store conflicts with anything else, preferably the same subscript
+      partner = group.write == group.first ? group.second : group.first;
+      if (!partner)
       {
-        // both use induction variable with offsets - check for conflicts
-        int stride = 1; // assume unit stride for now
-        IterationConflictType conflict_type =
-            classifyConflict(access1, access2, offset1, offset2, stride);
+        partner = access != &accesses[0] ? &accesses[0] : &accesses[1];
+      }
+    }
+    recordComplexConflict(array_name, *access, *partner);
+  }
+}
 
-        if (conflict_type != IterationConflictType::NO_CONFLICT)
-        {
-          // format the pattern correctly
-          std::string pattern1 = induction_var;
-          std::string pattern2 = induction_var;
+void CrossIterationAnalyzer::recordOffsetConflict(const std::string& array_name,
+                                                  const ArrayAccess& access1,
+                                                  const ArrayAccess& access2, int offset1,
+                                                  int offset2, const std::string& induction_var)
+{
+  AnalysisStats::get().count(Counter::PAIRS);
 
-          if (offset1 > 0)
-          {
-            pattern1 += "+" + std::to_string(offset1);
-          }
-          else if (offset1 < 0)
-          {
-            pattern1 += std::to_string(offset1);
-          }
+  int stride = 1; // assume unit stride for now
+  IterationConflictType conflict_type =
+      classifyConflict(access1, access2, offset1, offset2, stride);
+  if (conflict_type == IterationConflictType::NO_CONFLICT)
+  {
+    return;
+  }
 
-          if (offset2 > 0)
-          {
-            pattern2 += "+" + std::to_string(offset2);
-          }
-          else if (offset2 < 0)
-          {
-            pattern2 += std::to_string(offset2);
-          }
+  // format the pattern correctly
+  std::string pattern1 = induction_var;
+  std::string pattern2 = induction_var;
 
-          std::string pattern = pattern1 + " vs " + pattern2;
-          std::string desc = describeConflict(conflict_type, array_name, pattern);
+  if (offset1 > 0)
+  {
+    pattern1 += "+" + std::to_string(offset1);
+  }
+  else if (offset1 < 0)
+  {
+    pattern1 += std::to_string(offset1);
+  }
 
-          CrossIterationConflict conflict(array_name, conflict_type, pattern, access1.line_number,
-                                          access2.line_number, desc);
-          conflicts_.push_back(conflict);
+  if (offset2 > 0)
+  {
+    pattern2 += "+" + std::to_string(offset2);
+  }
+  else if (offset2 < 0)
+  {
+    pattern2 += std::to_string(offset2);
+  }
 
-          if (verbose_)
-          {
-            std::cout << "  Cross-iteration conflict: " << desc << "\n";
-          }
-        }
-      }
-      else if (!has_offset1 || !has_offset2)
-      {
-        // one or both indices are complex - conservative
-        std::string pattern = "complex_indices";
-        std::string desc =
-            describeConflict(IterationConflictType::STRIDE_CONFLICT, array_name, pattern);
+  std::string pattern = pattern1 + " vs " + pattern2;
+  std::string desc = describeConflict(conflict_type, array_name, pattern);
 
-        CrossIterationConflict conflict(array_name, IterationConflictType::STRIDE_CONFLICT, pattern,
-                                        access1.line_number, access2.line_number, desc);
-        conflicts_.push_back(conflict);
+  CrossIterationConflict conflict(array_name, conflict_type, pattern, access1.line_number,
+                                  access2.line_number, desc);
+  conflicts_.push_back(conflict);
 
-        if (verbose_)
-        {
-          std::cout << "  Complex index pattern - assuming unsafe: " << desc << "\n";
-        }
-      }
-    }
+  if (verbose_)
+  {
+    std::cout << "  Cross-iteration conflict: " << desc << "\n";
+  }
+}
+
+void CrossIterationAnalyzer::recordComplexConflict(const std::string& array_name,
+                                                   const ArrayAccess& access1,
+                                                   const ArrayAccess& access2)
+{
+  AnalysisStats::get().count(Counter::PAIRS);
+
+  std::string pattern = "complex_indices";
+  std::string desc = describeConflict(IterationConflictType::STRIDE_CONFLICT, array_name, pattern);
+
+  CrossIterationConflict conflict(array_name, IterationConflictType::STRIDE_CONFLICT, pattern,
+                                  access1.line_number, access2.line_number, desc);
+  conflicts_.push_back(conflict);
+
+  if (verbose_)
+  {
+    std::cout << "  Complex index pattern - assuming unsafe: " << desc << "\n";
   }
 }
 
@@ -278,8 +345,7 @@ std::string CrossIterationAnalyzer::describeConflict(IterationConflictType type,
   return desc;
 }
 
-bool CrossIterationAnalyzer::detectsStridePattern(Expr* index, const std::string& induction_var,
-                                                  int& stride)
+bool CrossIterationAnalyzer::detectsStridePattern(Expr*, const std::string&, int& stride)
 {
   // assume unit stride for now
   stride = 1;
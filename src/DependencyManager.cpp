@@ -1,4 +1,5 @@
 #include "analyzer/DependencyManager.h"
+#include "analyzer/AnalysisStats.h"
 #include "analyzer/ArrayDependencyAnalyzer.h"
 #include "analyzer/FunctionCallAnalyzer.h"
 #include "analyzer/LoopInfo.h"
@@ -6,6 +7,8 @@
 #include "analyzer/PragmaGenerator.h"
 #include "analyzer/PragmaLocationMapper.h"
 #include "analyzer/SourceAnnotator.h"
+#include "llvm/Support/TimeProfiler.h"
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 
@@ -26,6 +29,9 @@ DependencyManager::DependencyManager(ASTContext* context)
 
 void DependencyManager::analyzeLoop(LoopInfo& loop)
 {
+  ScopedTimer timer(Phase::DEPENDENCE);
+  AnalysisStats::get().count(Counter::LOOPS);
+  AnalysisStats::get().count(Counter::ACCESSES, loop.array_accesses.size());
   warnings_.clear();
 
   if (verbose_)
@@ -39,10 +45,12 @@ void DependencyManager::analyzeLoop(LoopInfo& loop)
     runArrayAnalysis(loop);
     runPointerAnalysis(loop);
     runFunctionAnalysis(loop);
+    runControlFlowAnalysis(loop);
 
     //set final parallelization decision
     bool is_safe = isLoopParallelizable(loop);
     loop.setHasDependencies(!is_safe);
+    loop.safelen_covered = !is_safe && isSafelenCovered(loop);
 
     if (verbose_)
     {
@@ -70,24 +78,39 @@ void DependencyManager::analyzeLoop(LoopInfo& loop)
   {
     recordWarning("Analysis failed with exception: " + std::string(e.what()));
     loop.setHasDependencies(true); // conservative fallback
+    loop.safelen_covered = false;
 
     if (verbose_)
     {
       std::cout << "Analysis failed: " << e.what() << "\n";
     }
   }
+
+  loop.blocking_factors = warnings_;
 }
 
 bool DependencyManager::isLoopParallelizable(const LoopInfo& loop) const
 {
   // loop is parallelizable if it has no dependencies from any analyzer
-  return !hasScalarDependencies(loop) && !array_analyzer_->hasArrayDependencies(loop) &&
+  return !hasScalarDependencies(loop) && !loop.hasUnsafeEarlyExit() &&
+         !array_analyzer_->hasArrayDependencies(loop) &&
          (pointer_analyzer_->getPointerRisk(loop) == PointerRisk::SAFE) &&
          (function_analyzer_->getFunctionCallSafety(loop) != FunctionCallSafety::UNSAFE);
 }
 
+bool DependencyManager::isSafelenCovered(const LoopInfo& loop) const
+{
+  // the simd plan only measured distances within each array, so every other analyzer has to
+  // come back clean for the recurrence to be all that keeps the loop serial
+  return loop.simd.needsSafelen() && !hasScalarDependencies(loop) &&
+         !loop.hasUnsafeEarlyExit() &&
+         pointer_analyzer_->getPointerRisk(loop) == PointerRisk::SAFE &&
+         function_analyzer_->getFunctionCallSafety(loop) != FunctionCallSafety::UNSAFE;
+}
+
 void DependencyManager::runScalarAnalysis(LoopInfo& loop)
 {
+  llvm::TimeTraceScope trace("ScalarAnalysis");
   if (verbose_)
   {
     std::cout << "\n--- Scalar Variable Analysis ---\n";
@@ -109,6 +132,46 @@ void DependencyManager::runScalarAnalysis(LoopInfo& loop)
       continue;
     }
 
+    if (loop.shared_updates.synchronizes(var.name))
+    {
+      if (verbose_)
+      {
+        std::cout << "  " << var.name << ": SHARED, updates synchronized (safe)\n";
+      }
+      continue;
+    }
+
+    if (loop.scan.isScan() && var.name == loop.scan.variable)
+    {
+      if (verbose_)
+      {
+        std::cout << "  " << var.name << ": SCAN VARIABLE (safe)\n";
+      }
+      continue;
+    }
+
+    if (loop.simd.isLinear(var.name))
+    {
+      if (verbose_)
+      {
+        std::cout << "  " << var.name << ": LINEAR (safe)\n";
+      }
+      continue;
+    }
+
+    // x++ and x += e count as plain writes, but each one reads the previous iteration's value
+    if (std::find(loop.shared_updates.carried.begin(), loop.shared_updates.carried.end(),
+                  var.name) != loop.shared_updates.carried.end())
+    {
+      if (verbose_)
+      {
+        std::cout << "  " << var.name << ": UPDATED IN PLACE (unsafe)\n";
+      }
+      recordWarning("Scalar variable '" + var.name + "' is updated in place across iterations");
+      found_scalar_deps = true;
+      continue;
+    }
+
     // check for read-after-write dependencies
     if (var.hasReads() && var.hasWrites())
     {
@@ -153,6 +216,7 @@ void DependencyManager::runScalarAnalysis(LoopInfo& loop)
 
 void DependencyManager::runArrayAnalysis(LoopInfo& loop)
 {
+  llvm::TimeTraceScope trace("ArrayAnalysis");
   if (verbose_)
   {
     std::cout << "\n--- Array Dependency Analysis ---\n";
@@ -187,6 +251,7 @@ void DependencyManager::runArrayAnalysis(LoopInfo& loop)
 }
 void DependencyManager::runPointerAnalysis(LoopInfo& loop)
 {
+  llvm::TimeTraceScope trace("PointerAnalysis");
   if (verbose_)
   {
     std::cout << "\n--- Pointer Analysis ---\n";
@@ -234,6 +299,7 @@ void DependencyManager::runPointerAnalysis(LoopInfo& loop)
 
 void DependencyManager::runFunctionAnalysis(LoopInfo& loop)
 {
+  llvm::TimeTraceScope trace("FunctionCallAnalysis");
   if (verbose_)
   {
     std::cout << "\n--- Function Call Analysis ---\n";
@@ -278,6 +344,46 @@ void DependencyManager::runFunctionAnalysis(LoopInfo& loop)
   }
 }
 
+void DependencyManager::runControlFlowAnalysis(LoopInfo& loop)
+{
+  llvm::TimeTraceScope trace("ControlFlowAnalysis");
+  if (verbose_)
+  {
+    std::cout << "\n--- Control Flow Analysis ---\n";
+  }
+
+  if (!loop.hasEarlyExit())
+  {
+    if (verbose_)
+    {
+      std::cout << "  No early exits\n";
+    }
+    return;
+  }
+
+  if (loop.search.is_search)
+  {
+    if (verbose_)
+    {
+      std::cout << "  First-match search (safe with cancel and lowest-index combine)\n";
+    }
+    return;
+  }
+
+  // any other way out of the middle of the iteration space can't be split across threads
+  for (const auto& exit : loop.early_exits)
+  {
+    std::string kind = exit.kind == EarlyExitKind::BREAK    ? "break"
+                       : exit.kind == EarlyExitKind::RETURN ? "return"
+                                                            : "goto";
+    recordWarning("Early exit (" + kind + ") at line " + std::to_string(exit.line_number));
+    if (verbose_)
+    {
+      std::cout << "  " << kind << " at line " << exit.line_number << " (unsafe)\n";
+    }
+  }
+}
+
 void DependencyManager::recordWarning(const std::string& warning)
 {
   warnings_.push_back(warning);
@@ -285,11 +391,17 @@ void DependencyManager::recordWarning(const std::string& warning)
 
 bool DependencyManager::hasScalarDependencies(const LoopInfo& loop) const
 {
+  if (!loop.shared_updates.carried.empty())
+  {
+    return true;
+  }
+
   for (const auto& var_pair : loop.variables)
   {
     const auto& var = var_pair.second;
 
-    if (var.isInductionVariable())
+    if (var.isInductionVariable() || loop.shared_updates.synchronizes(var.name) ||
+        (loop.scan.isScan() && var.name == loop.scan.variable) || loop.simd.isLinear(var.name))
     {
       continue;
     }
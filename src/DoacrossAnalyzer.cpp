@@ -0,0 +1,519 @@
+#include "analyzer/DoacrossAnalyzer.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+
+using namespace clang;
+
+namespace paralyze
+{
+
+bool DoacrossAnalyzer::analyzeNest(std::vector<LoopInfo>& loops, size_t root)
+{
+  std::vector<size_t> nest;
+  if (!collectNest(loops, root, nest) || nest.size() < 2)
+  {
+    return false;
+  }
+
+  // only worth a pipeline when the body really carries something across iterations
+  const LoopInfo& innermost = loops[nest.back()];
+  if (!innermost.has_dependencies || innermost.metrics.opaque_calls > 0 ||
+      innermost.hasUnsafeFunctionCalls())
+  {
+    return false;
+  }
+
+  std::vector<std::string> iterators;
+  for (size_t index : nest)
+  {
+    iterators.push_back(loops[index].bounds.iterator_var);
+  }
+
+  std::set<std::string> safe_calls;
+  for (size_t i = 0; i < innermost.detected_function_calls.size(); i++)
+  {
+    if (innermost.function_call_safety[i])
+    {
+      safe_calls.insert(innermost.detected_function_calls[i]);
+    }
+  }
+
+  std::vector<NestAccess> accesses;
+  const Stmt* body = cast<ForStmt>(innermost.stmt)->getBody();
+  if (!walkBody(body, loops[root].stmt, iterators, safe_calls, accesses))
+  {
+    return false;
+  }
+
+  std::vector<std::vector<long long>> sinks;
+  if (!computeSinks(accesses, nest.size(), sinks) || sinks.empty())
+  {
+    return false;
+  }
+  pruneSinks(sinks);
+
+  DoacrossNest doacross;
+  doacross.depth = static_cast<unsigned>(nest.size());
+  doacross.iterators = iterators;
+  doacross.sinks = sinks;
+  if (!buildOrderedEdits(innermost, doacross))
+  {
+    return false;
+  }
+
+  loops[root].doacross = doacross;
+
+  if (verbose_)
+  {
+    std::cout << "  Doacross nest at line " << loops[root].line_number << ": ordered("
+              << doacross.depth << ")";
+    for (const auto& sink : sinks)
+    {
+      std::cout << " " << sinkClause(sink, iterators);
+    }
+    std::cout << "\n";
+  }
+  return true;
+}
+
+bool DoacrossAnalyzer::collectNest(const std::vector<LoopInfo>& loops, size_t root,
+                                   std::vector<size_t>& nest) const
+{
+  std::set<std::string> outer_iterators;
+  size_t current = root;
+
+  while (true)
+  {
+    const LoopInfo& loop = loops[current];
+    auto* forLoop = dyn_cast_or_null<ForStmt>(loop.stmt);
+    if (!forLoop || loop.loop_type != "for" || !loop.bounds.is_simple_pattern ||
+        loop.canonical.form != CanonicalForm::NONE || loop.hasEarlyExit() ||
+        !isUnitStepUp(loop))
+    {
+      return false;
+    }
+
+    // ordered(n) needs a rectangular nest
+    if (referencesAny(forLoop->getInit(), outer_iterators) ||
+        referencesAny(forLoop->getCond(), outer_iterators))
+    {
+      return false;
+    }
+
+    nest.push_back(current);
+    outer_iterators.insert(loop.bounds.iterator_var);
+
+    // descend while the only statement in the body is the next loop
+    if (loop.child_loop_indices.size() != 1)
+    {
+      return true;
+    }
+
+    const Stmt* child = loops[loop.child_loop_indices.front()].stmt;
+    const Stmt* body = forLoop->getBody();
+    if (auto* block = dyn_cast<CompoundStmt>(body))
+    {
+      body = block->size() == 1 ? block->body_front() : nullptr;
+    }
+    if (body != child)
+    {
+      return true;
+    }
+    current = loop.child_loop_indices.front();
+  }
+}
+
+bool DoacrossAnalyzer::isUnitStepUp(const LoopInfo& loop) const
+{
+  // sink offsets count iterations, so the counter has to move up by exactly one
+  const std::string& iterator = loop.bounds.iterator_var;
+  auto isIterator = [&iterator](const Expr* expr)
+  {
+    auto* ref = dyn_cast<DeclRefExpr>(expr->IgnoreParenImpCasts());
+    return ref && ref->getDecl()->getNameAsString() == iterator;
+  };
+
+  const Expr* inc = loop.bounds.increment_expr;
+  const Expr* cond = loop.bounds.condition_expr;
+  if (!inc || !cond)
+  {
+    return false;
+  }
+
+  bool unit_step = false;
+  if (auto* unaryOp = dyn_cast<UnaryOperator>(inc->IgnoreParenImpCasts()))
+  {
+    unit_step = unaryOp->isIncrementOp() && isIterator(unaryOp->getSubExpr());
+  }
+  else if (auto* assign = dyn_cast<CompoundAssignOperator>(inc->IgnoreParenImpCasts()))
+  {
+    auto* step = dyn_cast<IntegerLiteral>(assign->getRHS()->IgnoreParenImpCasts());
+    unit_step = assign->getOpcode() == BO_AddAssign && isIterator(assign->getLHS()) && step &&
+                step->getValue() == 1;
+  }
+
+  auto* test = dyn_cast<BinaryOperator>(cond->IgnoreParenImpCasts());
+  return unit_step && test && (test->getOpcode() == BO_LT || test->getOpcode() == BO_LE) &&
+         isIterator(test->getLHS());
+}
+
+bool DoacrossAnalyzer::referencesAny(const Stmt* stmt, const std::set<std::string>& names) const
+{
+  if (!stmt || names.empty())
+  {
+    return false;
+  }
+
+  if (auto* ref = dyn_cast<DeclRefExpr>(stmt))
+  {
+    if (names.count(ref->getDecl()->getNameAsString()))
+    {
+      return true;
+    }
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    if (referencesAny(child, names))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool DoacrossAnalyzer::walkBody(const Stmt* stmt, const Stmt* root,
+                                const std::vector<std::string>& iterators,
+                                const std::set<std::string>& safe_calls,
+                                std::vector<NestAccess>& accesses) const
+{
+  if (!stmt)
+  {
+    return true;
+  }
+
+  // skipping the end of the body would skip depend(source)
+  if (isa<ContinueStmt>(stmt))
+  {
+    return false;
+  }
+
+  if (auto* binOp = dyn_cast<BinaryOperator>(stmt))
+  {
+    if (binOp->isAssignmentOp())
+    {
+      return recordTarget(binOp->getLHS(), root, iterators, safe_calls, accesses) &&
+             walkBody(binOp->getRHS(), root, iterators, safe_calls, accesses);
+    }
+  }
+  else if (auto* unaryOp = dyn_cast<UnaryOperator>(stmt))
+  {
+    if (unaryOp->isIncrementDecrementOp())
+    {
+      return recordTarget(unaryOp->getSubExpr(), root, iterators, safe_calls, accesses);
+    }
+  }
+  else if (auto* access = dyn_cast<ArraySubscriptExpr>(stmt))
+  {
+    return recordArrayAccess(access, false, root, iterators, safe_calls, accesses);
+  }
+  else if (auto* call = dyn_cast<CallExpr>(stmt))
+  {
+    const FunctionDecl* callee = call->getDirectCallee();
+    if (!callee || !safe_calls.count(callee->getNameAsString()))
+    {
+      return false;
+    }
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    if (!walkBody(child, root, iterators, safe_calls, accesses))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool DoacrossAnalyzer::recordTarget(const Expr* target, const Stmt* root,
+                                    const std::vector<std::string>& iterators,
+                                    const std::set<std::string>& safe_calls,
+                                    std::vector<NestAccess>& accesses) const
+{
+  target = target->IgnoreParenImpCasts();
+  if (auto* access = dyn_cast<ArraySubscriptExpr>(target))
+  {
+    return recordArrayAccess(access, true, root, iterators, safe_calls, accesses);
+  }
+
+  // locals of the body are fine, anything shared would need its own ordering
+  if (auto* ref = dyn_cast<DeclRefExpr>(target))
+  {
+    auto* var = dyn_cast<VarDecl>(ref->getDecl());
+    return var && !isDeclaredOutside(var, root);
+  }
+  return false;
+}
+
+bool DoacrossAnalyzer::recordArrayAccess(const ArraySubscriptExpr* access, bool is_write,
+                                         const Stmt* root,
+                                         const std::vector<std::string>& iterators,
+                                         const std::set<std::string>& safe_calls,
+                                         std::vector<NestAccess>& accesses) const
+{
+  // A[e1][e2] nests as (A[e1])[e2], collect the indices outermost dimension first
+  std::vector<const Expr*> indices;
+  const Expr* base = access;
+  while (auto* subscript = dyn_cast<ArraySubscriptExpr>(base))
+  {
+    indices.push_back(subscript->getIdx());
+    base = subscript->getBase()->IgnoreParenImpCasts();
+  }
+  std::reverse(indices.begin(), indices.end());
+
+  auto* ref = dyn_cast<DeclRefExpr>(base);
+  if (!ref)
+  {
+    return false;
+  }
+
+  NestAccess nest_access;
+  nest_access.array_name = ref->getDecl()->getNameAsString();
+  nest_access.is_write = is_write;
+  nest_access.affine = indices.size() == iterators.size();
+  for (size_t k = 0; k < indices.size() && nest_access.affine; k++)
+  {
+    long long offset = 0;
+    nest_access.affine = offsetFrom(indices[k], iterators[k], offset);
+    nest_access.offsets.push_back(offset);
+  }
+  accesses.push_back(nest_access);
+
+  // indices may read other arrays
+  for (const Expr* index : indices)
+  {
+    if (!walkBody(index, root, iterators, safe_calls, accesses))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool DoacrossAnalyzer::offsetFrom(const Expr* index, const std::string& iterator,
+                                  long long& offset) const
+{
+  index = index->IgnoreParenImpCasts();
+  auto isIterator = [&iterator](const Expr* expr)
+  {
+    auto* ref = dyn_cast<DeclRefExpr>(expr->IgnoreParenImpCasts());
+    return ref && ref->getDecl()->getNameAsString() == iterator;
+  };
+
+  if (isIterator(index))
+  {
+    offset = 0;
+    return true;
+  }
+
+  auto* binOp = dyn_cast<BinaryOperator>(index);
+  if (!binOp || (binOp->getOpcode() != BO_Add && binOp->getOpcode() != BO_Sub))
+  {
+    return false;
+  }
+
+  auto* lhs_literal = dyn_cast<IntegerLiteral>(binOp->getLHS()->IgnoreParenImpCasts());
+  auto* rhs_literal = dyn_cast<IntegerLiteral>(binOp->getRHS()->IgnoreParenImpCasts());
+  if (isIterator(binOp->getLHS()) && rhs_literal)
+  {
+    long long constant = rhs_literal->getValue().getSExtValue();
+    offset = binOp->getOpcode() == BO_Add ? constant : -constant;
+    return true;
+  }
+  if (isIterator(binOp->getRHS()) && lhs_literal && binOp->getOpcode() == BO_Add)
+  {
+    offset = lhs_literal->getValue().getSExtValue();
+    return true;
+  }
+  return false;
+}
+
+bool DoacrossAnalyzer::isDeclaredOutside(const VarDecl* var, const Stmt* root) const
+{
+  const SourceManager& sm = context_->getSourceManager();
+  SourceRange range = root->getSourceRange();
+  SourceLocation loc = var->getLocation();
+  return sm.isBeforeInTranslationUnit(loc, range.getBegin()) ||
+         sm.isBeforeInTranslationUnit(range.getEnd(), loc);
+}
+
+bool DoacrossAnalyzer::computeSinks(const std::vector<NestAccess>& accesses, size_t depth,
+                                    std::vector<std::vector<long long>>& sinks) const
+{
+  std::map<std::string, std::vector<const NestAccess*>> by_array;
+  for (const auto& access : accesses)
+  {
+    by_array[access.array_name].push_back(&access);
+  }
+
+  std::set<std::vector<long long>> distances;
+  for (const auto& entry : by_array)
+  {
+    const std::vector<const NestAccess*>& refs = entry.second;
+    const NestAccess* write = nullptr;
+    for (const auto* ref : refs)
+    {
+      if (ref->is_write)
+      {
+        write = ref;
+      }
+    }
+
+    // read-only arrays carry nothing
+    if (!write)
+    {
+      continue;
+    }
+
+    for (const auto* ref : refs)
+    {
+      // a single write position per array keeps every distance constant
+      if (!ref->affine || (ref->is_write && ref->offsets != write->offsets))
+      {
+        return false;
+      }
+      if (ref->is_write)
+      {
+        continue;
+      }
+
+      std::vector<long long> distance(depth);
+      for (size_t k = 0; k < depth; k++)
+      {
+        distance[k] = ref->offsets[k] - write->offsets[k];
+      }
+
+      auto leading = std::find_if(distance.begin(), distance.end(),
+                                  [](long long d) { return d != 0; });
+      if (leading == distance.end())
+      {
+        continue; // same iteration
+      }
+
+      // reading an earlier iteration waits for it, reading a later one makes it wait
+      if (*leading > 0)
+      {
+        for (auto& d : distance)
+        {
+          d = -d;
+        }
+      }
+      distances.insert(distance);
+    }
+  }
+
+  sinks.assign(distances.begin(), distances.end());
+  return true;
+}
+
+void DoacrossAnalyzer::pruneSinks(std::vector<std::vector<long long>>& sinks) const
+{
+  // with a sink on the previous innermost iteration, iterations of one row finish in order,
+  // so per outer prefix only the sink furthest along that row is needed
+  std::vector<long long> previous(sinks.front().size(), 0);
+  previous.back() = -1;
+  if (std::find(sinks.begin(), sinks.end(), previous) == sinks.end())
+  {
+    return;
+  }
+
+  std::map<std::vector<long long>, long long> furthest;
+  for (const auto& sink : sinks)
+  {
+    std::vector<long long> prefix(sink.begin(), sink.end() - 1);
+    auto it = furthest.find(prefix);
+    if (it == furthest.end() || sink.back() > it->second)
+    {
+      furthest[prefix] = sink.back();
+    }
+  }
+
+  sinks.clear();
+  for (const auto& entry : furthest)
+  {
+    std::vector<long long> sink = entry.first;
+    sink.push_back(entry.second);
+    sinks.push_back(sink);
+  }
+}
+
+std::string DoacrossAnalyzer::sinkClause(const std::vector<long long>& sink,
+                                         const std::vector<std::string>& iterators) const
+{
+  std::string clause = "depend(sink: ";
+  for (size_t k = 0; k < sink.size(); k++)
+  {
+    clause += (k > 0 ? ", " : "") + iterators[k];
+    if (sink[k] != 0)
+    {
+      clause += (sink[k] < 0 ? "-" : "+") + std::to_string(std::abs(sink[k]));
+    }
+  }
+  return clause + ")";
+}
+
+bool DoacrossAnalyzer::buildOrderedEdits(const LoopInfo& innermost, DoacrossNest& nest) const
+{
+  auto* forLoop = cast<ForStmt>(innermost.stmt);
+  const Stmt* body = forLoop->getBody();
+  if (!body || !source_.isRewritable(forLoop->getSourceRange()))
+  {
+    return false;
+  }
+
+  std::string wait = "#pragma omp ordered";
+  for (const auto& sink : nest.sinks)
+  {
+    wait += " " + sinkClause(sink, nest.iterators);
+  }
+  const std::string signal = "#pragma omp ordered depend(source)";
+
+  // wait for the sinks before the body, signal once all of its writes are done
+  if (auto* block = dyn_cast<CompoundStmt>(body))
+  {
+    unsigned open_line = source_.getLine(block->getLBracLoc());
+    unsigned close_line = source_.getLine(block->getRBracLoc());
+    if (block->body_empty() || open_line == close_line || !source_.endsLine(block->getLBracLoc()) ||
+        !source_.startsLine(block->getRBracLoc()))
+    {
+      return false;
+    }
+
+    unsigned first_line = source_.getLine(block->body_front()->getBeginLoc());
+    std::string indent = source_.getIndentation(first_line);
+    nest.edits.emplace_back(open_line, LineEditKind::INSERT_AFTER, indent + wait);
+    nest.edits.emplace_back(close_line, LineEditKind::INSERT_BEFORE, indent + signal);
+    return true;
+  }
+
+  // an unbraced body gets braces so both directives stay inside the loop
+  unsigned first_line = source_.getLine(body->getBeginLoc());
+  unsigned last_line = source_.getLine(body->getEndLoc());
+  if (first_line == innermost.line_number || !source_.startsLine(body->getBeginLoc()) ||
+      !source_.endsLine(body->getEndLoc()))
+  {
+    return false;
+  }
+
+  std::string indent = source_.getIndentation(first_line);
+  nest.edits.emplace_back(first_line, LineEditKind::INSERT_BEFORE,
+                          innermost.indentation + "{\n" + indent + wait);
+  nest.edits.emplace_back(last_line, LineEditKind::INSERT_AFTER,
+                          indent + signal + "\n" + innermost.indentation + "}");
+  return true;
+}
+
+} // namespace paralyze
@@ -0,0 +1,117 @@
+#include "analyzer/FirstTouchAnalyzer.h"
+#include <iostream>
+
+using namespace clang;
+
+namespace paralyze
+{
+
+void FirstTouchAnalyzer::analyzeLoop(Stmt* loopStmt, LoopInfo& loop)
+{
+  if (!loopStmt || !loop.body() || loop.bounds.iterator_var.empty())
+  {
+    return;
+  }
+
+  std::map<std::string, Partition> arrays;
+  collect(loop.body(), loop.bounds.iterator_var, false, arrays);
+
+  for (const auto& entry : arrays)
+  {
+    if (entry.second.by_iterator)
+    {
+      loop.partitioned_arrays[entry.first] = entry.second.written;
+    }
+  }
+
+  if (verbose_ && !loop.partitioned_arrays.empty())
+  {
+    std::cout << "  Arrays split by " << loop.bounds.iterator_var << " at line "
+              << loop.line_number << ":";
+    for (const auto& entry : loop.partitioned_arrays)
+    {
+      std::cout << " " << entry.first << (entry.second ? " (written)" : "");
+    }
+    std::cout << "\n";
+  }
+}
+
+void FirstTouchAnalyzer::collect(const Stmt* stmt, const std::string& iterator, bool is_write,
+                                 std::map<std::string, Partition>& arrays) const
+{
+  if (!stmt)
+  {
+    return;
+  }
+
+  if (auto* element = dyn_cast<ArraySubscriptExpr>(stmt))
+  {
+    recordElement(element, iterator, is_write, arrays);
+    return;
+  }
+
+  // an array handed to a call or through a pointer may be touched anywhere
+  if (auto* ref = dyn_cast<DeclRefExpr>(stmt))
+  {
+    QualType type = ref->getType();
+    if (type->isArrayType() || type->isPointerType())
+    {
+      arrays[ref->getDecl()->getNameAsString()].by_iterator = false;
+    }
+    return;
+  }
+
+  if (auto* assign = dyn_cast<BinaryOperator>(stmt))
+  {
+    if (assign->isAssignmentOp())
+    {
+      collect(assign->getLHS(), iterator, true, arrays);
+      collect(assign->getRHS(), iterator, false, arrays);
+      return;
+    }
+  }
+  if (auto* unary = dyn_cast<UnaryOperator>(stmt))
+  {
+    if (unary->isIncrementDecrementOp())
+    {
+      collect(unary->getSubExpr(), iterator, true, arrays);
+      return;
+    }
+  }
+
+  bool passes_write = is_write && (isa<ParenExpr>(stmt) || isa<ImplicitCastExpr>(stmt));
+  for (const Stmt* child : stmt->children())
+  {
+    collect(child, iterator, passes_write, arrays);
+  }
+}
+
+void FirstTouchAnalyzer::recordElement(const ArraySubscriptExpr* element,
+                                       const std::string& iterator, bool is_write,
+                                       std::map<std::string, Partition>& arrays) const
+{
+  // a[i][j] nests as (a[i])[j], so the leading subscript sits next to the base
+  const Expr* leading = nullptr;
+  const Expr* base = element;
+  while (auto* sub = dyn_cast<ArraySubscriptExpr>(base->IgnoreParenImpCasts()))
+  {
+    leading = sub->getIdx();
+    collect(sub->getIdx(), iterator, false, arrays);
+    base = sub->getBase();
+  }
+
+  auto* ref = dyn_cast<DeclRefExpr>(base->IgnoreParenImpCasts());
+  if (!ref)
+  {
+    collect(base, iterator, false, arrays);
+    return;
+  }
+
+  auto* index = dyn_cast<DeclRefExpr>(leading->IgnoreParenImpCasts());
+  Partition& partition = arrays[ref->getDecl()->getNameAsString()];
+  partition.by_iterator = partition.by_iterator && index &&
+                          index->getDecl()->getNameAsString() == iterator;
+  partition.written = partition.written || is_write;
+}
+
+} // namespace paralyze
@@ -60,7 +60,7 @@ FunctionCallSafety FunctionCallAnalyzer::getFunctionCallSafety(const LoopInfo& l
   return FunctionCallSafety::SAFE;
 }
 
-void FunctionCallAnalyzer::visitCallExpr(CallExpr* callExpr, LoopInfo& loop)
+void FunctionCallAnalyzer::visitCallExpr(CallExpr* callExpr, LoopInfo&)
 {
   if (!callExpr)
   {
@@ -0,0 +1,1029 @@
+#include "analyzer/LoopCanonicalizer.h"
+#include "analyzer/AnalysisStats.h"
+#include "clang/AST/Expr.h"
+#include "clang/AST/ParentMapContext.h"
+#include <algorithm>
+#include <iostream>
+
+using namespace clang;
+
+namespace paralyze
+{
+
+bool LoopCanonicalizer::canonicalizeWhileLoop(WhileStmt* whileLoop, LoopInfo& loop)
+{
+  if (!whileLoop || !whileLoop->getCond() || !whileLoop->getBody())
+  {
+    return false;
+  }
+
+  if (matchPointerWalk(whileLoop, loop))
+  {
+    if (verbose_)
+    {
+      std::cout << "  Pointer walk lowered to indexed form: for (" << loop.canonical.index_var
+                << " < " << loop.canonical.trip_count << ")\n";
+    }
+    return true;
+  }
+
+  CountedLoop counted;
+  if (!matchCountedLoop(whileLoop, whileLoop->getCond(), whileLoop->getBody(), counted))
+  {
+    return false;
+  }
+
+  SourceLocation while_loc = whileLoop->getWhileLoc();
+  SourceLocation rparen_loc = whileLoop->getRParenLoc();
+  if (!source_.startsLine(while_loc) || source_.getLine(while_loc) != source_.getLine(rparen_loc))
+  {
+    return false;
+  }
+
+  // while (cond) -> for (i = init; cond; step), the step statement goes away
+  std::string header = countedHeader(counted, whileLoop->getCond());
+  std::vector<ColumnReplacement> replacements;
+  std::vector<LineEdit> edits;
+  if (header.empty() ||
+      !addReplacement(SourceRange(while_loc, rparen_loc), header, replacements))
+  {
+    return false;
+  }
+  removeStatement(counted.step, edits, replacements);
+
+  finishCountedLoop(counted, whileLoop->getCond(), CanonicalForm::COUNTED_WHILE, edits,
+                    replacements, loop);
+  return true;
+}
+
+bool LoopCanonicalizer::canonicalizeDoLoop(DoStmt* doLoop, LoopInfo& loop)
+{
+  if (!doLoop || !doLoop->getCond() || !doLoop->getBody())
+  {
+    return false;
+  }
+
+  CountedLoop counted;
+  if (!matchCountedLoop(doLoop, doLoop->getCond(), doLoop->getBody(), counted))
+  {
+    return false;
+  }
+
+  // a do-while runs once before testing, so the for-form is only equal when the first test holds
+  if (!firstTestHolds(counted))
+  {
+    return false;
+  }
+
+  SourceLocation do_loc = doLoop->getDoLoc();
+  SourceLocation while_loc = doLoop->getWhileLoc();
+  SourceLocation rparen_loc = doLoop->getRParenLoc();
+  unsigned tail_line = source_.getLine(while_loc);
+  if (!source_.startsLine(do_loc) || tail_line != source_.getLine(rparen_loc) ||
+      tail_line == source_.getLine(do_loc))
+  {
+    return false;
+  }
+
+  // do -> for (i = init; cond; step), drop the trailing while (cond); and the step statement
+  std::string header = countedHeader(counted, doLoop->getCond());
+  std::vector<ColumnReplacement> replacements;
+  std::vector<LineEdit> edits;
+  if (header.empty() || !addReplacement(SourceRange(do_loc, do_loc), header, replacements))
+  {
+    return false;
+  }
+
+  std::string tail = source_.getLineText(tail_line);
+  unsigned tail_end = source_.getEndColumn(rparen_loc);
+  size_t semi = tail.find_first_not_of(" \t", tail_end - 1);
+  if (semi == std::string::npos || tail[semi] != ';')
+  {
+    return false;
+  }
+  replacements.emplace_back(tail_line, source_.getColumn(while_loc), semi + 2, "");
+  removeStatement(counted.step, edits, replacements);
+
+  std::string rewritten_tail = applyReplacements(tail_line, replacements);
+  if (rewritten_tail.find_first_not_of(" \t") == std::string::npos)
+  {
+    edits.emplace_back(tail_line, LineEditKind::REMOVE);
+  }
+  else
+  {
+    // keep the closing brace but not the space before the dropped while
+    rewritten_tail.erase(rewritten_tail.find_last_not_of(" \t") + 1);
+    edits.emplace_back(tail_line, LineEditKind::REPLACE, rewritten_tail);
+  }
+
+  finishCountedLoop(counted, doLoop->getCond(), CanonicalForm::COUNTED_DO_WHILE, edits,
+                    replacements, loop);
+  return true;
+}
+
+bool LoopCanonicalizer::matchCountedLoop(Stmt* loopStmt, Expr* cond, Stmt* body,
+                                         CountedLoop& counted)
+{
+  if (!source_.isRewritable(loopStmt->getSourceRange()) ||
+      !source_.endsLine(loopStmt->getEndLoc()) || !isInCompoundStmt(loopStmt))
+  {
+    return false;
+  }
+
+  // the step has to be the last statement of the body
+  auto* compound = dyn_cast<CompoundStmt>(body);
+  if (!compound || compound->body_empty())
+  {
+    return false;
+  }
+
+  int step = 0;
+  counted.step = dyn_cast<Expr>(compound->body_back());
+  if (!counted.step || !isCounterStep(counted.step, counted.counter, step))
+  {
+    return false;
+  }
+
+  // cond: counter <rel> bound or bound <rel> counter. != would only make a worksharing loop
+  // from OpenMP 5.0 on
+  auto* test = dyn_cast<BinaryOperator>(cond->IgnoreParenImpCasts());
+  if (!test || !test->isRelationalOp())
+  {
+    return false;
+  }
+
+  auto refersToCounter = [&counted](Expr* expr)
+  {
+    auto* declRef = dyn_cast<DeclRefExpr>(expr->IgnoreParenImpCasts());
+    return declRef && declRef->getDecl() == counted.counter;
+  };
+
+  if (refersToCounter(test->getLHS()))
+  {
+    counted.relation = test->getOpcode();
+    counted.bound = test->getRHS();
+  }
+  else if (refersToCounter(test->getRHS()))
+  {
+    counted.relation = BinaryOperator::reverseComparisonOp(test->getOpcode());
+    counted.bound = test->getLHS();
+  }
+  else
+  {
+    return false;
+  }
+
+  // the step has to move the counter towards the bound
+  bool rising = counted.relation == BO_LT || counted.relation == BO_LE;
+  bool falling = counted.relation == BO_GT || counted.relation == BO_GE;
+  if ((rising && step < 0) || (falling && step > 0))
+  {
+    return false;
+  }
+
+  // counter written only by the step, bound untouched by the body
+  std::map<std::string, unsigned> written;
+  bool has_calls = false;
+  collectWrites(body, written, has_calls);
+
+  std::string counter = counted.counter->getNameAsString();
+  if (written[counter] != 1 || !isLoopInvariant(counted.bound, written, has_calls))
+  {
+    return false;
+  }
+
+  if (hasEarlyExit(body, false, false))
+  {
+    return false;
+  }
+
+  // the statement right before the loop sets the start value
+  counted.init_stmt = findPrecedingStatement(loopStmt);
+  if (!counted.init_stmt || !isCounterInit(counted.init_stmt, counted.counter, counted.init))
+  {
+    return false;
+  }
+
+  return !counted.init->HasSideEffects(*context_);
+}
+
+bool LoopCanonicalizer::isCounterStep(Expr* expr, VarDecl*& counter, int& step) const
+{
+  expr = expr->IgnoreParenImpCasts();
+  Expr* target = nullptr;
+
+  if (auto* unaryOp = dyn_cast<UnaryOperator>(expr))
+  {
+    if (!unaryOp->isIncrementDecrementOp())
+    {
+      return false;
+    }
+    target = unaryOp->getSubExpr();
+    step = unaryOp->isIncrementOp() ? 1 : -1;
+  }
+  else if (auto* compound = dyn_cast<CompoundAssignOperator>(expr))
+  {
+    if (compound->getOpcode() != BO_AddAssign && compound->getOpcode() != BO_SubAssign)
+    {
+      return false;
+    }
+    auto* amount = dyn_cast<IntegerLiteral>(compound->getRHS()->IgnoreParenImpCasts());
+    if (!amount || amount->getValue() == 0 || amount->getValue().getActiveBits() > 31)
+    {
+      return false;
+    }
+    target = compound->getLHS();
+    step = static_cast<int>(amount->getValue().getZExtValue());
+    if (compound->getOpcode() == BO_SubAssign)
+    {
+      step = -step;
+    }
+  }
+  else
+  {
+    return false;
+  }
+
+  auto* declRef = dyn_cast<DeclRefExpr>(target->IgnoreParenImpCasts());
+  if (!declRef)
+  {
+    return false;
+  }
+
+  counter = dyn_cast<VarDecl>(declRef->getDecl());
+  return counter && counter->hasLocalStorage() && counter->getType()->isIntegerType();
+}
+
+bool LoopCanonicalizer::isCounterInit(Stmt* stmt, VarDecl* counter, Expr*& init) const
+{
+  // int i = 0;
+  if (auto* declStmt = dyn_cast<DeclStmt>(stmt))
+  {
+    if (!declStmt->isSingleDecl() || declStmt->getSingleDecl() != counter || !counter->hasInit())
+    {
+      return false;
+    }
+    init = counter->getInit();
+    return true;
+  }
+
+  // i = 0;
+  auto* assign = dyn_cast<BinaryOperator>(stmt);
+  if (!assign || assign->getOpcode() != BO_Assign)
+  {
+    return false;
+  }
+
+  auto* declRef = dyn_cast<DeclRefExpr>(assign->getLHS()->IgnoreParenImpCasts());
+  if (!declRef || declRef->getDecl() != counter)
+  {
+    return false;
+  }
+
+  init = assign->getRHS();
+  return true;
+}
+
+bool LoopCanonicalizer::firstTestHolds(const CountedLoop& counted) const
+{
+  Expr::EvalResult init_value, bound_value;
+  if (!counted.init->EvaluateAsInt(init_value, *context_) ||
+      !counted.bound->EvaluateAsInt(bound_value, *context_))
+  {
+    return false;
+  }
+
+  int64_t init = init_value.Val.getInt().getExtValue();
+  int64_t bound = bound_value.Val.getInt().getExtValue();
+
+  switch (counted.relation)
+  {
+  case BO_LT:
+    return init < bound;
+  case BO_LE:
+    return init <= bound;
+  case BO_GT:
+    return init > bound;
+  case BO_GE:
+    return init >= bound;
+  default:
+    return false;
+  }
+}
+
+bool LoopCanonicalizer::isLoopInvariant(Expr* expr,
+                                        const std::map<std::string, unsigned>& written,
+                                        bool body_has_calls) const
+{
+  expr = expr->IgnoreParenImpCasts();
+
+  if (isa<IntegerLiteral>(expr) || isa<CharacterLiteral>(expr) ||
+      isa<UnaryExprOrTypeTraitExpr>(expr))
+  {
+    return true;
+  }
+
+  if (auto* declRef = dyn_cast<DeclRefExpr>(expr))
+  {
+    if (isa<EnumConstantDecl>(declRef->getDecl()))
+    {
+      return true;
+    }
+
+    auto* varDecl = dyn_cast<VarDecl>(declRef->getDecl());
+    if (!varDecl || written.count(varDecl->getNameAsString()))
+    {
+      return false;
+    }
+
+    // a call in the body could change a global bound behind our back
+    return varDecl->hasLocalStorage() || !body_has_calls;
+  }
+
+  if (auto* binOp = dyn_cast<BinaryOperator>(expr))
+  {
+    return binOp->isAdditiveOp() || binOp->isMultiplicativeOp() || binOp->isShiftOp()
+               ? isLoopInvariant(binOp->getLHS(), written, body_has_calls) &&
+                     isLoopInvariant(binOp->getRHS(), written, body_has_calls)
+               : false;
+  }
+
+  if (auto* unaryOp = dyn_cast<UnaryOperator>(expr))
+  {
+    return (unaryOp->getOpcode() == UO_Minus || unaryOp->getOpcode() == UO_Plus) &&
+           isLoopInvariant(unaryOp->getSubExpr(), written, body_has_calls);
+  }
+
+  if (auto* cast = dyn_cast<CastExpr>(expr))
+  {
+    return isLoopInvariant(cast->getSubExpr(), written, body_has_calls);
+  }
+
+  // member loads, array elements, calls... may all change inside the body
+  return false;
+}
+
+void LoopCanonicalizer::collectWrites(Stmt* stmt, std::map<std::string, unsigned>& written,
+                                      bool& has_calls) const
+{
+  if (!stmt)
+  {
+    return;
+  }
+
+  auto recordTarget = [&written](Expr* target)
+  {
+    if (auto* declRef = dyn_cast<DeclRefExpr>(target->IgnoreParenImpCasts()))
+    {
+      written[declRef->getDecl()->getNameAsString()]++;
+    }
+  };
+
+  if (auto* binOp = dyn_cast<BinaryOperator>(stmt))
+  {
+    if (binOp->isAssignmentOp())
+    {
+      recordTarget(binOp->getLHS());
+    }
+  }
+  else if (auto* unaryOp = dyn_cast<UnaryOperator>(stmt))
+  {
+    // taking the address counts as a write, the pointer may be stored through later
+    if (unaryOp->isIncrementDecrementOp() || unaryOp->getOpcode() == UO_AddrOf)
+    {
+      recordTarget(unaryOp->getSubExpr());
+    }
+  }
+  else if (auto* declStmt = dyn_cast<DeclStmt>(stmt))
+  {
+    for (Decl* decl : declStmt->decls())
+    {
+      if (auto* varDecl = dyn_cast<VarDecl>(decl))
+      {
+        written[varDecl->getNameAsString()]++;
+      }
+    }
+  }
+  else if (isa<CallExpr>(stmt))
+  {
+    has_calls = true;
+  }
+
+  for (Stmt* child : stmt->children())
+  {
+    collectWrites(child, written, has_calls);
+  }
+}
+
+bool LoopCanonicalizer::hasEarlyExit(Stmt* stmt, bool in_nested_loop, bool in_switch) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+
+  if (isa<ReturnStmt>(stmt) || isa<GotoStmt>(stmt) || isa<IndirectGotoStmt>(stmt))
+  {
+    return true;
+  }
+
+  // continue would skip the step, break would leave with the counter mid-range
+  if (isa<ContinueStmt>(stmt))
+  {
+    return !in_nested_loop;
+  }
+  if (isa<BreakStmt>(stmt))
+  {
+    return !in_nested_loop && !in_switch;
+  }
+
+  bool nested_loop = in_nested_loop || isa<ForStmt>(stmt) || isa<WhileStmt>(stmt) ||
+                     isa<DoStmt>(stmt);
+  bool nested_switch = in_switch || isa<SwitchStmt>(stmt);
+
+  for (Stmt* child : stmt->children())
+  {
+    if (hasEarlyExit(child, nested_loop, nested_switch))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+Stmt* LoopCanonicalizer::findPrecedingStatement(Stmt* stmt)
+{
+  AnalysisStats::get().count(Counter::PARENT_LOOKUPS);
+  auto parents = context_->getParents(*stmt);
+  if (parents.empty())
+  {
+    return nullptr;
+  }
+
+  const auto* compound = parents[0].get<CompoundStmt>();
+  if (!compound)
+  {
+    return nullptr;
+  }
+
+  Stmt* previous = nullptr;
+  for (Stmt* child : compound->body())
+  {
+    if (child == stmt)
+    {
+      return previous;
+    }
+    previous = child;
+  }
+  return nullptr;
+}
+
+std::string LoopCanonicalizer::countedHeader(const CountedLoop& counted, Expr* cond) const
+{
+  // written text, so while (k < N) keeps its macro instead of losing the bound
+  std::string init = source_.getWrittenText(counted.init->getSourceRange());
+  std::string test = source_.getWrittenText(cond->getSourceRange());
+  std::string step = source_.getWrittenText(counted.step->getSourceRange());
+  if (init.empty() || test.empty() || step.empty())
+  {
+    return "";
+  }
+  return "for (" + counted.counter->getNameAsString() + " = " + init + "; " + test + "; " + step +
+         ")";
+}
+
+void LoopCanonicalizer::removeStatement(Expr* expr, std::vector<LineEdit>& edits,
+                                        std::vector<ColumnReplacement>& replacements) const
+{
+  unsigned line = source_.getLine(expr->getBeginLoc());
+  std::string text = source_.getText(expr->getSourceRange());
+
+  if (trimmedLine(line) == text + ";")
+  {
+    edits.emplace_back(line, LineEditKind::REMOVE);
+    return;
+  }
+
+  // shares its line with other code: drop the statement text, a stray ';' is harmless
+  addReplacement(expr->getSourceRange(), "", replacements);
+}
+
+void LoopCanonicalizer::finishCountedLoop(const CountedLoop& counted, Expr* cond,
+                                          CanonicalForm form, std::vector<LineEdit> edits,
+                                          std::vector<ColumnReplacement> replacements,
+                                          LoopInfo& loop)
+{
+  std::string counter = counted.counter->getNameAsString();
+
+  // i = 0; moves into the header even when other code shares its line, a declaration stays
+  // where it is
+  if (auto* assign = dyn_cast<BinaryOperator>(counted.init_stmt))
+  {
+    removeStatement(assign, edits, replacements);
+  }
+
+  // one edit per line: lines already removed or replaced keep that edit
+  for (const auto& replacement : replacements)
+  {
+    unsigned line = replacement.line_number;
+    if (std::none_of(edits.begin(), edits.end(),
+                     [line](const LineEdit& e) { return e.line_number == line; }))
+    {
+      edits.emplace_back(line, LineEditKind::REPLACE, applyReplacements(line, replacements));
+    }
+  }
+
+  loop.canonical.form = form;
+  loop.canonical.index_var = counter;
+  loop.canonical.trip_count.clear();
+  loop.canonical.walked_pointers.clear();
+  loop.canonical.index_ref = nullptr;
+  loop.canonical.edits = edits;
+
+  loop.bounds.iterator_var = counter;
+  loop.bounds.init_expr = counted.init_stmt;
+  loop.bounds.condition_expr = cond;
+  loop.bounds.increment_expr = counted.step;
+  loop.bounds.is_simple_pattern = true;
+
+  if (verbose_)
+  {
+    std::cout << "  " << (form == CanonicalForm::COUNTED_DO_WHILE ? "Do-while" : "While")
+              << " loop canonicalized to for form: " << countedHeader(counted, cond) << "\n";
+  }
+}
+
+bool LoopCanonicalizer::matchPointerWalk(WhileStmt* whileLoop, LoopInfo& loop)
+{
+  SourceLocation while_loc = whileLoop->getWhileLoc();
+  SourceLocation rparen_loc = whileLoop->getRParenLoc();
+
+  // the rewrite is line based, so the header has to be plain source on its own line
+  if (!source_.isRewritable(whileLoop->getSourceRange()) || !source_.startsLine(while_loc) ||
+      !source_.endsLine(whileLoop->getEndLoc()) ||
+      source_.getLine(while_loc) != source_.getLine(rparen_loc) || !isInCompoundStmt(whileLoop))
+  {
+    return false;
+  }
+
+  PointerWalkScan scan;
+  scan.index_var = "pz_idx_" + std::to_string(loop.line_number);
+
+  if (auto* body = dyn_cast<CompoundStmt>(whileLoop->getBody()))
+  {
+    for (Stmt* stmt : body->body())
+    {
+      scanWalkStatement(stmt, scan);
+    }
+  }
+  else
+  {
+    scanWalkStatement(whileLoop->getBody(), scan);
+  }
+
+  if (!scan.valid || scan.increments.empty())
+  {
+    return false;
+  }
+
+  // every walked pointer steps exactly once and is only touched through *p / *p++ / p++
+  for (const auto& step : scan.increments)
+  {
+    if (step.second != 1 || scan.bare_uses.count(step.first))
+    {
+      return false;
+    }
+  }
+
+  // we can only index pointers that also advance
+  for (const auto& name : scan.dereferenced)
+  {
+    if (!scan.increments.count(name))
+    {
+      return false;
+    }
+  }
+
+  std::string trip_count = walkTripCount(whileLoop->getCond(), scan);
+  if (trip_count.empty())
+  {
+    return false;
+  }
+
+  // build the for-form: length before the loop, indexed header and body, pointer catch-up after
+  unsigned header_line = source_.getLine(while_loc);
+  unsigned last_line = source_.getLine(whileLoop->getEndLoc());
+  std::string indent = source_.getIndentation(header_line);
+  std::string length_var = "pz_len_" + std::to_string(loop.line_number);
+
+  std::string header = "for (long " + scan.index_var + " = 0; " + scan.index_var + " < " +
+                       length_var + "; " + scan.index_var + "++)";
+  if (!addReplacement(SourceRange(while_loc, rparen_loc), header, scan.replacements))
+  {
+    return false;
+  }
+
+  std::vector<LineEdit> edits;
+  edits.emplace_back(header_line, LineEditKind::INSERT_BEFORE,
+                     indent + "const long " + length_var + " = (long)(" + trip_count + ");");
+
+  for (unsigned line = header_line; line <= last_line; line++)
+  {
+    if (scan.removed_lines.count(line))
+    {
+      edits.emplace_back(line, LineEditKind::REMOVE);
+      continue;
+    }
+
+    bool touched = std::any_of(scan.replacements.begin(), scan.replacements.end(),
+                               [line](const ColumnReplacement& r) { return r.line_number == line; });
+    if (touched)
+    {
+      edits.emplace_back(line, LineEditKind::REPLACE, applyReplacements(line, scan.replacements));
+    }
+  }
+
+  std::string catch_up;
+  for (const auto& step : scan.increments)
+  {
+    if (!catch_up.empty())
+      catch_up += "\n";
+    catch_up += indent + step.first + " += " + length_var + ";";
+  }
+  edits.emplace_back(last_line, LineEditKind::INSERT_AFTER, catch_up);
+
+  loop.canonical.form = CanonicalForm::POINTER_WALK;
+  loop.canonical.index_var = scan.index_var;
+  loop.canonical.trip_count = trip_count;
+  loop.canonical.walked_pointers.clear();
+  for (const auto& step : scan.increments)
+  {
+    loop.canonical.walked_pointers.push_back(step.first);
+  }
+  loop.canonical.index_ref = createIndexRef(scan.index_var, while_loc);
+  loop.canonical.edits = edits;
+
+  // from here on the loop is analyzed as its indexed for-form
+  loop.bounds.iterator_var = scan.index_var;
+  loop.bounds.condition_expr = whileLoop->getCond();
+  loop.bounds.is_simple_pattern = true;
+
+  return true;
+}
+
+void LoopCanonicalizer::scanWalkStatement(Stmt* stmt, PointerWalkScan& scan)
+{
+  if (!stmt || !scan.valid || isa<NullStmt>(stmt))
+  {
+    return;
+  }
+
+  if (auto* expr = dyn_cast<Expr>(stmt))
+  {
+    // standalone step: p++; ++p; p += 1;
+    std::string name;
+    if (isPointerStep(expr, name))
+    {
+      if (scan.advanced.count(name))
+      {
+        scan.valid = false;
+        return;
+      }
+      scan.increments[name]++;
+      scan.advanced.insert(name);
+
+      if (trimmedLine(source_.getLine(expr->getBeginLoc())) ==
+          source_.getText(expr->getSourceRange()) + ";")
+      {
+        scan.removed_lines.insert(source_.getLine(expr->getBeginLoc()));
+      }
+      else if (!addReplacement(expr->getSourceRange(), "", scan.replacements))
+      {
+        scan.valid = false;
+      }
+      return;
+    }
+
+    scanWalkExpr(expr, scan, false, false);
+    return;
+  }
+
+  if (isa<DeclStmt>(stmt))
+  {
+    for (Stmt* child : stmt->children())
+    {
+      scanWalkExpr(child, scan, false, false);
+    }
+    return;
+  }
+
+  // control flow in the body (if, nested loops, break, ...) is out of scope
+  scan.valid = false;
+}
+
+void LoopCanonicalizer::scanWalkExpr(Stmt* stmt, PointerWalkScan& scan, bool is_write,
+                                     bool conditional)
+{
+  if (!stmt || !scan.valid)
+  {
+    return;
+  }
+
+  if (auto* unaryOp = dyn_cast<UnaryOperator>(stmt))
+  {
+    if (unaryOp->getOpcode() == UO_Deref)
+    {
+      Expr* target = unaryOp->getSubExpr()->IgnoreParenImpCasts();
+      std::string name;
+      bool steps = false;
+
+      if (auto* step = dyn_cast<UnaryOperator>(target))
+      {
+        // only *p++ keeps the element at the current index
+        if (step->getOpcode() != UO_PostInc || !isLocalPointer(step->getSubExpr(), name))
+        {
+          scan.valid = false;
+          return;
+        }
+        steps = true;
+      }
+      else if (!isLocalPointer(target, name))
+      {
+        scan.valid = false;
+        return;
+      }
+
+      if (scan.advanced.count(name) || (steps && conditional))
+      {
+        scan.valid = false;
+        return;
+      }
+
+      scan.dereferenced.insert(name);
+      if (is_write)
+      {
+        scan.written_through.insert(name);
+      }
+      if (steps)
+      {
+        scan.increments[name]++;
+        scan.advanced.insert(name);
+      }
+
+      if (!addReplacement(unaryOp->getSourceRange(), name + "[" + scan.index_var + "]",
+                          scan.replacements))
+      {
+        scan.valid = false;
+      }
+      return;
+    }
+
+    std::string name;
+    if (unaryOp->isIncrementDecrementOp() && isLocalPointer(unaryOp->getSubExpr(), name))
+    {
+      // pointer stepped in the middle of an expression
+      scan.valid = false;
+      return;
+    }
+  }
+
+  if (auto* binOp = dyn_cast<BinaryOperator>(stmt))
+  {
+    if (binOp->isAssignmentOp())
+    {
+      std::string name;
+      if (isLocalPointer(binOp->getLHS(), name))
+      {
+        // retargeting a pointer breaks the unit-step pattern
+        scan.valid = false;
+        return;
+      }
+      scanWalkExpr(binOp->getLHS(), scan, true, conditional);
+      scanWalkExpr(binOp->getRHS(), scan, false, conditional);
+      return;
+    }
+
+    if (binOp->isLogicalOp())
+    {
+      scanWalkExpr(binOp->getLHS(), scan, false, conditional);
+      scanWalkExpr(binOp->getRHS(), scan, false, true);
+      return;
+    }
+  }
+
+  if (auto* condOp = dyn_cast<ConditionalOperator>(stmt))
+  {
+    scanWalkExpr(condOp->getCond(), scan, false, conditional);
+    scanWalkExpr(condOp->getTrueExpr(), scan, false, true);
+    scanWalkExpr(condOp->getFalseExpr(), scan, false, true);
+    return;
+  }
+
+  if (auto* declRef = dyn_cast<DeclRefExpr>(stmt))
+  {
+    std::string name;
+    if (isLocalPointer(declRef, name))
+    {
+      scan.bare_uses.insert(name);
+    }
+    return;
+  }
+
+  for (Stmt* child : stmt->children())
+  {
+    scanWalkExpr(child, scan, false, conditional);
+  }
+}
+
+bool LoopCanonicalizer::isPointerStep(Expr* expr, std::string& name) const
+{
+  expr = expr->IgnoreParenImpCasts();
+
+  if (auto* unaryOp = dyn_cast<UnaryOperator>(expr))
+  {
+    return unaryOp->isIncrementOp() && isLocalPointer(unaryOp->getSubExpr(), name);
+  }
+
+  if (auto* compound = dyn_cast<CompoundAssignOperator>(expr))
+  {
+    if (compound->getOpcode() != BO_AddAssign)
+    {
+      return false;
+    }
+    auto* step = dyn_cast<IntegerLiteral>(compound->getRHS()->IgnoreParenImpCasts());
+    return step && step->getValue() == 1 && isLocalPointer(compound->getLHS(), name);
+  }
+
+  return false;
+}
+
+std::string LoopCanonicalizer::walkTripCount(Expr* cond, const PointerWalkScan& scan) const
+{
+  cond = cond->IgnoreParenImpCasts();
+
+  Expr* sentinel = nullptr;
+  if (auto* unaryOp = dyn_cast<UnaryOperator>(cond))
+  {
+    // while (*p)
+    if (unaryOp->getOpcode() == UO_Deref)
+    {
+      sentinel = unaryOp->getSubExpr();
+    }
+  }
+  else if (auto* binOp = dyn_cast<BinaryOperator>(cond))
+  {
+    std::string pointer, end;
+
+    // while (*p != '\0')
+    auto* lhs = dyn_cast<UnaryOperator>(binOp->getLHS()->IgnoreParenImpCasts());
+    if (binOp->getOpcode() == BO_NE && lhs && lhs->getOpcode() == UO_Deref &&
+        isZeroLiteral(binOp->getRHS()))
+    {
+      sentinel = lhs->getSubExpr();
+    }
+    // while (p != end) / while (p < end)
+    else if ((binOp->getOpcode() == BO_NE || binOp->getOpcode() == BO_LT) &&
+             isLocalPointer(binOp->getLHS(), pointer) && isLocalPointer(binOp->getRHS(), end))
+    {
+      if (scan.increments.count(pointer) && !scan.increments.count(end))
+      {
+        return end + " - " + pointer;
+      }
+      return "";
+    }
+  }
+
+  std::string pointer;
+  if (!sentinel || !isLocalPointer(sentinel, pointer) || !scan.increments.count(pointer) ||
+      scan.written_through.count(pointer))
+  {
+    return "";
+  }
+
+  // strlen only makes sense on plain char buffers
+  QualType pointee = sentinel->IgnoreParenImpCasts()->getType()->getPointeeType();
+  if (pointee.isNull() || !pointee->isCharType())
+  {
+    return "";
+  }
+
+  return "__builtin_strlen(" + pointer + ")";
+}
+
+bool LoopCanonicalizer::isLocalPointer(Expr* expr, std::string& name) const
+{
+  if (!expr)
+  {
+    return false;
+  }
+
+  auto* declRef = dyn_cast<DeclRefExpr>(expr->IgnoreParenImpCasts());
+  if (!declRef)
+  {
+    return false;
+  }
+
+  auto* varDecl = dyn_cast<VarDecl>(declRef->getDecl());
+  if (!varDecl || !varDecl->hasLocalStorage() || !varDecl->getType()->isPointerType())
+  {
+    return false;
+  }
+
+  name = varDecl->getNameAsString();
+  return true;
+}
+
+bool LoopCanonicalizer::isZeroLiteral(Expr* expr) const
+{
+  expr = expr->IgnoreParenImpCasts();
+
+  if (auto* intLit = dyn_cast<IntegerLiteral>(expr))
+  {
+    return intLit->getValue() == 0;
+  }
+  if (auto* charLit = dyn_cast<CharacterLiteral>(expr))
+  {
+    return charLit->getValue() == 0;
+  }
+  return false;
+}
+
+std::string LoopCanonicalizer::trimmedLine(unsigned line) const
+{
+  std::string content = source_.getLineText(line);
+  size_t first = content.find_first_not_of(" \t");
+  size_t last = content.find_last_not_of(" \t");
+  return first == std::string::npos ? "" : content.substr(first, last - first + 1);
+}
+
+bool LoopCanonicalizer::isInCompoundStmt(Stmt* stmt)
+{
+  AnalysisStats::get().count(Counter::PARENT_LOOKUPS);
+  auto parents = context_->getParents(*stmt);
+  return !parents.empty() && parents[0].get<CompoundStmt>() != nullptr;
+}
+
+bool LoopCanonicalizer::addReplacement(SourceRange range, const std::string& text,
+                                       std::vector<ColumnReplacement>& replacements) const
+{
+  if (!source_.isRewritable(range))
+  {
+    return false;
+  }
+
+  unsigned line = source_.getLine(range.getBegin());
+  if (line != source_.getLine(range.getEnd()))
+  {
+    return false;
+  }
+
+  replacements.emplace_back(line, source_.getColumn(range.getBegin()),
+                            source_.getEndColumn(range.getEnd()), text);
+  return true;
+}
+
+std::string
+LoopCanonicalizer::applyReplacements(unsigned line,
+                                     const std::vector<ColumnReplacement>& replacements) const
+{
+  std::vector<ColumnReplacement> on_line;
+  for (const auto& replacement : replacements)
+  {
+    if (replacement.line_number == line)
+    {
+      on_line.push_back(replacement);
+    }
+  }
+
+  // apply right to left so earlier columns stay valid
+  std::sort(on_line.begin(), on_line.end(),
+            [](const ColumnReplacement& a, const ColumnReplacement& b)
+            { return a.begin_column > b.begin_column; });
+
+  std::string content = source_.getLineText(line);
+  for (const auto& replacement : on_line)
+  {
+    if (replacement.begin_column == 0 || replacement.end_column < replacement.begin_column ||
+        replacement.end_column - 1 > content.size())
+    {
+      continue;
+    }
+    content.replace(replacement.begin_column - 1,
+                    replacement.end_column - replacement.begin_column, replacement.text);
+  }
+
+  return content;
+}
+
+Expr* LoopCanonicalizer::createIndexRef(const std::string& name, SourceLocation loc)
+{
+  // the index only exists in the rewritten source, so give the analyzers a stand-in
+  IdentifierInfo& id = context_->Idents.get(name);
+  VarDecl* index = VarDecl::Create(*context_, context_->getTranslationUnitDecl(), loc, loc, &id,
+                                   context_->LongTy, nullptr, SC_None);
+
+  return DeclRefExpr::Create(*context_, NestedNameSpecifierLoc(), SourceLocation(), index, false,
+                             loc, context_->LongTy, VK_LValue);
+}
+
+} // namespace paralyze
@@ -0,0 +1,738 @@
+#include "analyzer/LoopTransformer.h"
+#include "clang/AST/Decl.h"
+#include "clang/AST/Expr.h"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <map>
+
+using namespace clang;
+
+namespace paralyze
+{
+
+bool LoopTransformer::tryFusion(std::vector<LoopInfo>& loops, size_t first, size_t second)
+{
+  LoopInfo& head = loops[first];
+  LoopInfo& tail = loops[second];
+
+  // both loops must already be parallel on their own, the fused loop inherits that
+  if (!isRestructurable(head) || !isRestructurable(tail) || head.has_dependencies ||
+      tail.has_dependencies || head.metrics.opaque_calls > 0 || tail.metrics.opaque_calls > 0)
+  {
+    return false;
+  }
+
+  auto* head_for = cast<ForStmt>(head.stmt);
+  auto* tail_for = cast<ForStmt>(tail.stmt);
+
+  // same iteration space, spelled the same way
+  if (headerText(head).empty() || headerText(head) != headerText(tail))
+  {
+    return false;
+  }
+
+  // only blank lines or comments may sit between the two loops
+  for (unsigned line = head.end_line_number + 1; line < tail.line_number; line++)
+  {
+    std::string text = source_.getLineText(line);
+    size_t start = text.find_first_not_of(" \t");
+    if (start != std::string::npos && text.compare(start, 2, "//") != 0)
+    {
+      return false;
+    }
+  }
+
+  // fusing only pays when the second loop re-reads what the first one streamed
+  std::string shared;
+  if (!sharesArrayStreams(loops, first, second, shared) ||
+      hasCrossLoopConflict(loops, first, second) || hasNameClash(head_for, tail_for))
+  {
+    return false;
+  }
+
+  // drop the first loop's closing brace and the second loop's header
+  head.transform.kind = LoopTransformKind::FUSION;
+  head.transform.fused_loop = second;
+  head.transform.justification = "fused with the loop at line " +
+                                 std::to_string(tail.line_number) +
+                                 ": same iteration range, both access " + shared +
+                                 ", and every array written by one is only touched at [" +
+                                 head.bounds.iterator_var + "] by the other";
+  head.transform.edits.emplace_back(head.end_line_number, LineEditKind::REMOVE);
+  head.transform.edits.emplace_back(tail.line_number, LineEditKind::REMOVE);
+  tail.fused_into = first;
+
+  if (verbose_)
+  {
+    std::cout << "  Fusing loop at line " << tail.line_number << " into loop at line "
+              << head.line_number << " (shared: " << shared << ")\n";
+  }
+  return true;
+}
+
+bool LoopTransformer::tryFission(std::vector<LoopInfo>& loops, size_t index)
+{
+  LoopInfo& loop = loops[index];
+  if (!isRestructurable(loop) || !loop.has_dependencies)
+  {
+    return false;
+  }
+
+  std::vector<StatementFootprint> footprints = buildFootprints(loops, index);
+  if (footprints.size() < 2)
+  {
+    return false;
+  }
+
+  std::vector<bool> parallel = partitionStatements(footprints);
+  size_t parallel_count = std::count(parallel.begin(), parallel.end(), true);
+  if (parallel_count == 0 || parallel_count == footprints.size())
+  {
+    return false;
+  }
+
+  // the parallel statements stay in place, the recurrence moves to a copy right after
+  std::string serial_loop = source_.getLineText(loop.line_number);
+  std::set<std::string> carried;
+  for (size_t k = 0; k < footprints.size(); k++)
+  {
+    const StatementFootprint& footprint = footprints[k];
+    if (parallel[k])
+    {
+      continue;
+    }
+
+    for (unsigned line = footprint.first_line; line <= footprint.last_line; line++)
+    {
+      serial_loop += "\n" + source_.getLineText(line);
+      loop.transform.edits.emplace_back(line, LineEditKind::REMOVE);
+    }
+    carried.insert(footprint.array_writes.begin(), footprint.array_writes.end());
+    carried.insert(footprint.scalar_writes.begin(), footprint.scalar_writes.end());
+  }
+  serial_loop += "\n" + source_.getLineText(loop.end_line_number);
+  loop.transform.edits.emplace_back(loop.end_line_number, LineEditKind::INSERT_AFTER,
+                                    serial_loop);
+
+  std::string carried_list;
+  for (const auto& name : carried)
+  {
+    carried_list += (carried_list.empty() ? "" : ", ") + name;
+  }
+
+  loop.transform.kind = LoopTransformKind::FISSION;
+  loop.transform.parallel_statements = parallel_count;
+  loop.transform.serial_statements = footprints.size() - parallel_count;
+  loop.transform.justification =
+      "split: " + std::to_string(parallel_count) + " statement" +
+      (parallel_count > 1 ? "s" : "") + " with no carried dependence run in parallel, " +
+      std::to_string(loop.transform.serial_statements) + " statement" +
+      (loop.transform.serial_statements > 1 ? "s" : "") + " writing " +
+      (carried_list.empty() ? "shared state" : carried_list) +
+      " stay serial in a second loop after it";
+
+  if (verbose_)
+  {
+    std::cout << "  Splitting loop at line " << loop.line_number << ": " << parallel_count
+              << " parallel, " << loop.transform.serial_statements << " serial statements\n";
+  }
+  return true;
+}
+
+bool LoopTransformer::isRestructurable(const LoopInfo& loop) const
+{
+  if (loop.loop_type != "for" || loop.depth != 0 || !loop.bounds.is_simple_pattern ||
+      loop.bounds.iterator_var.empty() || loop.canonical.form != CanonicalForm::NONE ||
+      loop.search.is_search || loop.hasEarlyExit() ||
+      loop.transform.kind != LoopTransformKind::NONE || loop.fused_into ||
+      loop.doacross.isPipelined() || !loop.array_reductions.empty() ||
+      loop.shared_updates.isSynchronized() || loop.scan.isScan() || !loop.simd.linear.empty())
+  {
+    return false;
+  }
+
+  auto* forLoop = dyn_cast_or_null<ForStmt>(loop.stmt);
+  return forLoop && hasPlainBlockBody(forLoop);
+}
+
+bool LoopTransformer::hasPlainBlockBody(ForStmt* forLoop) const
+{
+  // header and '{' on one line, '}' alone on the last, so whole lines can move
+  auto* body = dyn_cast_or_null<CompoundStmt>(forLoop->getBody());
+  if (!body || !source_.isRewritable(forLoop->getSourceRange()))
+  {
+    return false;
+  }
+
+  return source_.startsLine(forLoop->getForLoc()) &&
+         source_.getLine(body->getLBracLoc()) == source_.getLine(forLoop->getForLoc()) &&
+         source_.endsLine(body->getLBracLoc()) && source_.startsLine(body->getRBracLoc()) &&
+         source_.endsLine(body->getRBracLoc());
+}
+
+std::string LoopTransformer::headerText(const LoopInfo& loop) const
+{
+  auto* forLoop = cast<ForStmt>(loop.stmt);
+  std::string text = source_.getText(SourceRange(forLoop->getForLoc(), forLoop->getRParenLoc()));
+  auto is_space = [](unsigned char c) { return std::isspace(c) != 0; };
+  text.erase(std::remove_if(text.begin(), text.end(), is_space), text.end());
+  return text;
+}
+
+void LoopTransformer::collectAccesses(const std::vector<LoopInfo>& loops, size_t index,
+                                      std::vector<const ArrayAccess*>& accesses) const
+{
+  for (const auto& access : loops[index].array_accesses)
+  {
+    accesses.push_back(&access);
+  }
+  for (size_t child : loops[index].child_loop_indices)
+  {
+    collectAccesses(loops, child, accesses);
+  }
+}
+
+void LoopTransformer::collectVariables(const std::vector<LoopInfo>& loops, size_t index,
+                                       std::vector<const VariableInfo*>& variables) const
+{
+  for (const auto& var_pair : loops[index].variables)
+  {
+    variables.push_back(&var_pair.second);
+  }
+  for (size_t child : loops[index].child_loop_indices)
+  {
+    collectVariables(loops, child, variables);
+  }
+}
+
+void LoopTransformer::collectCalls(const std::vector<LoopInfo>& loops, size_t index,
+                                   std::set<std::string>& safe_calls) const
+{
+  const LoopInfo& loop = loops[index];
+  for (size_t i = 0; i < loop.detected_function_calls.size(); i++)
+  {
+    if (loop.function_call_safety[i])
+    {
+      safe_calls.insert(loop.detected_function_calls[i]);
+    }
+  }
+  for (size_t child : loop.child_loop_indices)
+  {
+    collectCalls(loops, child, safe_calls);
+  }
+}
+
+bool LoopTransformer::isBareIterator(const Expr* subscript, const std::string& iterator) const
+{
+  auto* ref = subscript ? dyn_cast<DeclRefExpr>(subscript->IgnoreParenImpCasts()) : nullptr;
+  return ref && ref->getDecl()->getNameAsString() == iterator;
+}
+
+bool LoopTransformer::isTrackedScalar(const VariableInfo& var, const Stmt* loopStmt) const
+{
+  // arrays and pointers show up through their element accesses instead
+  if (!var.decl || var.decl->getType()->isArrayType() || var.decl->getType()->isPointerType())
+  {
+    return false;
+  }
+
+  // anything declared inside the loop is private to an iteration
+  const SourceManager& sm = context_->getSourceManager();
+  SourceRange range = loopStmt->getSourceRange();
+  SourceLocation loc = var.decl->getLocation();
+  return sm.isBeforeInTranslationUnit(loc, range.getBegin()) ||
+         sm.isBeforeInTranslationUnit(range.getEnd(), loc);
+}
+
+bool LoopTransformer::sharesArrayStreams(const std::vector<LoopInfo>& loops, size_t first,
+                                         size_t second, std::string& shared) const
+{
+  std::vector<const ArrayAccess*> head_accesses, tail_accesses;
+  collectAccesses(loops, first, head_accesses);
+  collectAccesses(loops, second, tail_accesses);
+
+  std::set<std::string> head_arrays, common;
+  for (const auto* access : head_accesses)
+  {
+    head_arrays.insert(access->array_name);
+  }
+  for (const auto* access : tail_accesses)
+  {
+    if (head_arrays.count(access->array_name) && access->array_name != "unknown")
+    {
+      common.insert(access->array_name);
+    }
+  }
+
+  for (const auto& name : common)
+  {
+    shared += (shared.empty() ? "" : ", ") + name;
+  }
+  return !common.empty();
+}
+
+bool LoopTransformer::hasCrossLoopConflict(const std::vector<LoopInfo>& loops, size_t first,
+                                           size_t second) const
+{
+  const std::string& iterator = loops[first].bounds.iterator_var;
+  std::vector<const ArrayAccess*> accesses[2];
+  std::set<std::string> written[2], touched[2];
+  size_t indices[2] = {first, second};
+
+  for (int side = 0; side < 2; side++)
+  {
+    collectAccesses(loops, indices[side], accesses[side]);
+    for (const auto* access : accesses[side])
+    {
+      // a store through a plain pointer may land in another name's elements, and fusing
+      // reorders it against those even in a serial run
+      if (access->array_name == "unknown" || (access->is_write && !access->distinct_base))
+      {
+        return true;
+      }
+      touched[side].insert(access->array_name);
+      if (access->is_write)
+      {
+        written[side].insert(access->array_name);
+      }
+    }
+  }
+
+  // an array written by one loop and touched by the other may only be used at [i] in both,
+  // so iteration i of the fused loop still sees exactly what it saw before
+  for (int side = 0; side < 2; side++)
+  {
+    for (const auto& name : written[side])
+    {
+      if (!touched[1 - side].count(name))
+      {
+        continue;
+      }
+      for (const auto& side_accesses : accesses)
+      {
+        for (const auto* access : side_accesses)
+        {
+          if (access->array_name == name && !isBareIterator(access->subscript, iterator))
+          {
+            return true;
+          }
+        }
+      }
+    }
+  }
+
+  // shared scalars written by either loop would now be updated in between
+  std::map<std::string, std::pair<bool, bool>> scalar_use[2]; // name -> {read, written}
+  for (int side = 0; side < 2; side++)
+  {
+    std::vector<const VariableInfo*> variables;
+    collectVariables(loops, indices[side], variables);
+    for (const auto* var : variables)
+    {
+      if (var->name == iterator || !isTrackedScalar(*var, loops[indices[side]].stmt))
+      {
+        continue;
+      }
+      scalar_use[side][var->name].first |= var->hasReads();
+      scalar_use[side][var->name].second |= var->hasWrites();
+    }
+  }
+  for (int side = 0; side < 2; side++)
+  {
+    for (const auto& use : scalar_use[side])
+    {
+      if (use.second.second && scalar_use[1 - side].count(use.first))
+      {
+        return true;
+      }
+    }
+  }
+
+  // writes through pointers or members aren't in the recorded accesses at all
+  for (size_t index : indices)
+  {
+    std::set<std::string> safe_calls;
+    collectCalls(loops, index, safe_calls);
+    if (hasUntrackedEffects(cast<ForStmt>(loops[index].stmt)->getBody(), safe_calls))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool LoopTransformer::hasNameClash(ForStmt* first, ForStmt* second) const
+{
+  // locals declared at the top of the first body would be in scope for the second
+  std::set<std::string> declared;
+  for (const Stmt* stmt : cast<CompoundStmt>(first->getBody())->body())
+  {
+    if (auto* declStmt = dyn_cast<DeclStmt>(stmt))
+    {
+      for (const Decl* decl : declStmt->decls())
+      {
+        if (auto* named = dyn_cast<NamedDecl>(decl))
+        {
+          declared.insert(named->getNameAsString());
+        }
+      }
+    }
+  }
+
+  if (declared.empty())
+  {
+    return false;
+  }
+
+  std::vector<const Stmt*> pending = {second->getBody()};
+  while (!pending.empty())
+  {
+    const Stmt* stmt = pending.back();
+    pending.pop_back();
+    if (!stmt)
+    {
+      continue;
+    }
+
+    if (auto* declStmt = dyn_cast<DeclStmt>(stmt))
+    {
+      for (const Decl* decl : declStmt->decls())
+      {
+        auto* named = dyn_cast<NamedDecl>(decl);
+        if (named && declared.count(named->getNameAsString()))
+        {
+          return true;
+        }
+      }
+    }
+    if (auto* ref = dyn_cast<DeclRefExpr>(stmt))
+    {
+      if (declared.count(ref->getDecl()->getNameAsString()))
+      {
+        return true;
+      }
+    }
+
+    for (const Stmt* child : stmt->children())
+    {
+      pending.push_back(child);
+    }
+  }
+  return false;
+}
+
+std::vector<LoopTransformer::StatementFootprint>
+LoopTransformer::buildFootprints(const std::vector<LoopInfo>& loops, size_t index) const
+{
+  const LoopInfo& loop = loops[index];
+  auto* body = cast<CompoundStmt>(cast<ForStmt>(loop.stmt)->getBody());
+  const std::string& iterator = loop.bounds.iterator_var;
+
+  std::set<std::string> safe_calls;
+  collectCalls(loops, index, safe_calls);
+
+  // every top-level statement must own its lines so it can be moved as a block
+  std::vector<StatementFootprint> footprints;
+  unsigned previous_line = loop.line_number;
+  for (Stmt* stmt : body->body())
+  {
+    if (isa<DeclStmt>(stmt) || !source_.startsLine(stmt->getBeginLoc()) ||
+        !source_.endsLine(stmt->getEndLoc()) || containsContinue(stmt))
+    {
+      return {};
+    }
+
+    StatementFootprint footprint;
+    footprint.stmt = stmt;
+    footprint.first_line = source_.getLine(stmt->getBeginLoc());
+    footprint.last_line = source_.getLine(stmt->getEndLoc());
+    if (footprint.first_line <= previous_line || footprint.last_line >= loop.end_line_number)
+    {
+      return {};
+    }
+    previous_line = footprint.last_line;
+
+    footprint.opaque = hasUntrackedEffects(stmt, safe_calls);
+    footprints.push_back(footprint);
+  }
+
+  auto owner = [&footprints](unsigned line) -> StatementFootprint*
+  {
+    for (auto& footprint : footprints)
+    {
+      if (line >= footprint.first_line && line <= footprint.last_line)
+      {
+        return &footprint;
+      }
+    }
+    return nullptr;
+  };
+
+  std::vector<const ArrayAccess*> accesses;
+  collectAccesses(loops, index, accesses);
+  for (const auto* access : accesses)
+  {
+    StatementFootprint* footprint = owner(access->line_number);
+    if (!footprint)
+    {
+      return {};
+    }
+
+    if (access->array_name == "unknown")
+    {
+      footprint->opaque = true;
+    }
+    (access->is_write ? footprint->array_writes : footprint->array_reads)
+        .insert(access->array_name);
+    if (!isBareIterator(access->subscript, iterator))
+    {
+      footprint->offset_arrays.insert(access->array_name);
+    }
+  }
+
+  std::vector<const VariableInfo*> variables;
+  collectVariables(loops, index, variables);
+  for (const auto* var : variables)
+  {
+    for (const auto& usage : var->usages)
+    {
+      StatementFootprint* footprint = owner(usage.line_number);
+      if (!footprint)
+      {
+        continue; // loop header
+      }
+
+      // the iterator is only ever read in the body of a simple loop
+      if (var->name == iterator)
+      {
+        footprint->opaque = footprint->opaque || usage.is_write;
+        continue;
+      }
+
+      if (isTrackedScalar(*var, loop.stmt))
+      {
+        (usage.is_write ? footprint->scalar_writes : footprint->scalar_reads).insert(var->name);
+      }
+    }
+  }
+
+  return footprints;
+}
+
+bool LoopTransformer::hasUntrackedEffects(const Stmt* stmt,
+                                          const std::set<std::string>& safe_calls) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+
+  if (auto* call = dyn_cast<CallExpr>(stmt))
+  {
+    const FunctionDecl* callee = call->getDirectCallee();
+    if (!callee || !safe_calls.count(callee->getNameAsString()))
+    {
+      return true;
+    }
+  }
+
+  // the recorded accesses only cover stores to named arrays and scalars
+  const Expr* target = nullptr;
+  if (auto* binOp = dyn_cast<BinaryOperator>(stmt))
+  {
+    if (binOp->isAssignmentOp())
+    {
+      target = binOp->getLHS()->IgnoreParenImpCasts();
+    }
+  }
+  else if (auto* unaryOp = dyn_cast<UnaryOperator>(stmt))
+  {
+    if (unaryOp->isIncrementDecrementOp())
+    {
+      target = unaryOp->getSubExpr()->IgnoreParenImpCasts();
+      if (isa<ArraySubscriptExpr>(target))
+      {
+        return true; // a[i]++ isn't recorded as a write
+      }
+    }
+  }
+
+  if (target)
+  {
+    if (auto* ref = dyn_cast<DeclRefExpr>(target))
+    {
+      if (ref->getType()->isPointerType())
+      {
+        return true;
+      }
+    }
+    else if (auto* subscript = dyn_cast<ArraySubscriptExpr>(target))
+    {
+      const Expr* base = subscript->getBase()->IgnoreParenImpCasts();
+      while (auto* inner = dyn_cast<ArraySubscriptExpr>(base))
+      {
+        base = inner->getBase()->IgnoreParenImpCasts();
+      }
+      if (!isa<DeclRefExpr>(base))
+      {
+        return true;
+      }
+    }
+    else
+    {
+      return true;
+    }
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    if (hasUntrackedEffects(child, safe_calls))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool LoopTransformer::containsContinue(const Stmt* stmt) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+  if (isa<ContinueStmt>(stmt))
+  {
+    return true;
+  }
+
+  // a continue in a nested loop stays inside it
+  if (isa<ForStmt>(stmt) || isa<WhileStmt>(stmt) || isa<DoStmt>(stmt))
+  {
+    return false;
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    if (containsContinue(child))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<bool>
+LoopTransformer::partitionStatements(const std::vector<StatementFootprint>& footprints) const
+{
+  std::vector<bool> parallel(footprints.size(), false);
+
+  // unknown writes could reach any statement, so nothing can be reordered around them
+  for (const auto& footprint : footprints)
+  {
+    if (footprint.opaque)
+    {
+      return parallel;
+    }
+  }
+
+  // candidates write no shared scalar and store only to a[i]
+  for (size_t k = 0; k < footprints.size(); k++)
+  {
+    const StatementFootprint& footprint = footprints[k];
+    parallel[k] = footprint.scalar_writes.empty();
+    for (const auto& name : footprint.array_writes)
+    {
+      parallel[k] = parallel[k] && !footprint.offset_arrays.count(name);
+    }
+  }
+
+  // demote candidates until no dependence runs from a serial statement into a parallel one
+  bool changed = true;
+  while (changed)
+  {
+    changed = false;
+
+    std::set<std::string> parallel_writes, serial_array_writes, serial_scalar_writes;
+    for (size_t k = 0; k < footprints.size(); k++)
+    {
+      const StatementFootprint& footprint = footprints[k];
+      if (parallel[k])
+      {
+        parallel_writes.insert(footprint.array_writes.begin(), footprint.array_writes.end());
+      }
+      else
+      {
+        serial_array_writes.insert(footprint.array_writes.begin(), footprint.array_writes.end());
+        serial_scalar_writes.insert(footprint.scalar_writes.begin(),
+                                    footprint.scalar_writes.end());
+      }
+    }
+
+    auto demote = [&](size_t k)
+    {
+      if (parallel[k])
+      {
+        parallel[k] = false;
+        changed = true;
+      }
+    };
+
+    for (size_t k = 0; k < footprints.size(); k++)
+    {
+      if (!parallel[k])
+      {
+        continue;
+      }
+
+      const StatementFootprint& footprint = footprints[k];
+      std::set<std::string> arrays = footprint.array_reads;
+      arrays.insert(footprint.array_writes.begin(), footprint.array_writes.end());
+
+      for (const auto& name : arrays)
+      {
+        // a[i-1] next to a parallel store of a[i] is carried, anything the serial loop
+        // stores would be read before it is produced
+        if ((parallel_writes.count(name) && footprint.offset_arrays.count(name)) ||
+            serial_array_writes.count(name))
+        {
+          demote(k);
+        }
+      }
+      for (const auto& name : footprint.scalar_reads)
+      {
+        if (serial_scalar_writes.count(name))
+        {
+          demote(k);
+        }
+      }
+    }
+
+    // the serial loop may consume a parallel result only at [i] and only after it was produced
+    for (size_t s = 0; s < footprints.size(); s++)
+    {
+      if (parallel[s])
+      {
+        continue;
+      }
+
+      std::set<std::string> arrays = footprints[s].array_reads;
+      arrays.insert(footprints[s].array_writes.begin(), footprints[s].array_writes.end());
+      for (const auto& name : arrays)
+      {
+        for (size_t k = 0; k < footprints.size(); k++)
+        {
+          if (parallel[k] && footprints[k].array_writes.count(name) &&
+              (k > s || footprints[s].offset_arrays.count(name)))
+          {
+            demote(k);
+          }
+        }
+      }
+    }
+  }
+
+  return parallel;
+}
+
+} // namespace paralyze
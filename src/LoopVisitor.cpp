@@ -1,7 +1,12 @@
 #include "analyzer/LoopVisitor.h"
+#include "analyzer/AnalysisStats.h"
 #include "clang/AST/Expr.h"
 #include "clang/AST/ParentMapContext.h"
 #include "clang/AST/Stmt.h"
+#include "llvm/Support/TimeProfiler.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
 
@@ -18,6 +23,7 @@ bool LoopVisitor::TraverseForStmt(ForStmt* forLoop)
   SourceLocation loc = forLoop->getForLoc();
   addLoop(forLoop, loc, "for");
   size_t currentIndex = loops_.size() - 1;
+  llvm::TimeTraceScope trace("AnalyzeLoop", [&] { return traceDetail(currentIndex); });
 
   // set up parent-child relationship
   if (!loop_stack_.empty())
@@ -28,8 +34,10 @@ bool LoopVisitor::TraverseForStmt(ForStmt* forLoop)
   }
 
   analyzeForLoopBounds(forLoop, loops_[currentIndex]);
+  computeTripCount(loops_[currentIndex]);
 
   loop_stack_.push(currentIndex);
+  loops_[currentIndex].body_accesses.begin = nest_accesses_.size();
 
   // traverse init, condition, increment in context of this loop
   if (forLoop->getInit())
@@ -44,9 +52,7 @@ bool LoopVisitor::TraverseForStmt(ForStmt* forLoop)
     TraverseStmt(forLoop->getBody());
 
   // finalize after all traversal is complete
-  markInductionVariable(loops_[currentIndex]);
-  finalizeDependencyAnalysis(loops_[currentIndex]);
-  loops_[currentIndex].finalizeMetrics();
+  analyzeLoopBody(currentIndex);
 
   loop_stack_.pop();
 
@@ -61,6 +67,7 @@ bool LoopVisitor::TraverseWhileStmt(WhileStmt* whileLoop)
   SourceLocation loc = whileLoop->getWhileLoc();
   addLoop(whileLoop, loc, "while");
   size_t currentIndex = loops_.size() - 1;
+  llvm::TimeTraceScope trace("AnalyzeLoop", [&] { return traceDetail(currentIndex); });
 
   if (!loop_stack_.empty())
   {
@@ -69,7 +76,12 @@ bool LoopVisitor::TraverseWhileStmt(WhileStmt* whileLoop)
     loops_[parentIndex].addChildLoop(currentIndex);
   }
 
+  // try to bring the loop into for-form so it gets a real iterator
+  canonicalizer_.canonicalizeWhileLoop(whileLoop, loops_[currentIndex]);
+  computeTripCount(loops_[currentIndex]);
+
   loop_stack_.push(currentIndex);
+  loops_[currentIndex].body_accesses.begin = nest_accesses_.size();
 
   // traverse condition and body
   if (whileLoop->getCond())
@@ -77,9 +89,7 @@ bool LoopVisitor::TraverseWhileStmt(WhileStmt* whileLoop)
   if (whileLoop->getBody())
     TraverseStmt(whileLoop->getBody());
 
-  markInductionVariable(loops_[currentIndex]);
-  finalizeDependencyAnalysis(loops_[currentIndex]);
-  loops_[currentIndex].finalizeMetrics();
+  analyzeLoopBody(currentIndex);
 
   loop_stack_.pop();
   return true;
@@ -93,6 +103,7 @@ bool LoopVisitor::TraverseDoStmt(DoStmt* doLoop)
   SourceLocation loc = doLoop->getDoLoc();
   addLoop(doLoop, loc, "do-while");
   size_t currentIndex = loops_.size() - 1;
+  llvm::TimeTraceScope trace("AnalyzeLoop", [&] { return traceDetail(currentIndex); });
 
   if (!loop_stack_.empty())
   {
@@ -101,7 +112,11 @@ bool LoopVisitor::TraverseDoStmt(DoStmt* doLoop)
     loops_[parentIndex].addChildLoop(currentIndex);
   }
 
+  canonicalizer_.canonicalizeDoLoop(doLoop, loops_[currentIndex]);
+  computeTripCount(loops_[currentIndex]);
+
   loop_stack_.push(currentIndex);
+  loops_[currentIndex].body_accesses.begin = nest_accesses_.size();
 
   // traverse body and condition
   if (doLoop->getBody())
@@ -109,9 +124,7 @@ bool LoopVisitor::TraverseDoStmt(DoStmt* doLoop)
   if (doLoop->getCond())
     TraverseStmt(doLoop->getCond());
 
-  markInductionVariable(loops_[currentIndex]);
-  finalizeDependencyAnalysis(loops_[currentIndex]);
-  loops_[currentIndex].finalizeMetrics();
+  analyzeLoopBody(currentIndex);
 
   loop_stack_.pop();
   return true;
@@ -127,7 +140,7 @@ bool LoopVisitor::VisitVarDecl(VarDecl* varDecl)
   const std::string varName = varDecl->getNameAsString();
   VariableScope scope = determineVariableScope(varDecl);
   SourceLocation loc = varDecl->getLocation();
-  VariableInfo varInfo(varName, varDecl, scope, loc);
+  VariableInfo varInfo(varName, varDecl, scope, loc, &arena_);
 
   if (loop_stack_.empty())
   {
@@ -172,7 +185,7 @@ bool LoopVisitor::VisitDeclRefExpr(DeclRefExpr* declRef)
     if (it == currentLoop->variables.end())
     {
       VariableScope scope = determineVariableScope(varDecl);
-      VariableInfo varInfo(varName, varDecl, scope, varDecl->getLocation());
+      VariableInfo varInfo(varName, varDecl, scope, varDecl->getLocation(), &arena_);
       currentLoop->addVariable(varInfo);
     }
 
@@ -228,6 +241,39 @@ bool LoopVisitor::VisitUnaryOperator(UnaryOperator* unaryOp)
   {
     Expr* subExpr = unaryOp->getSubExpr()->IgnoreParenImpCasts();
 
+    // pointer walks are analyzed in indexed form: *p and *p++ become p[idx]
+    LoopInfo* currentLoop = getCurrentLoop();
+    if (currentLoop->canonical.form == CanonicalForm::POINTER_WALK)
+    {
+      Expr* pointer = subExpr;
+      if (auto* step = dyn_cast<UnaryOperator>(pointer))
+      {
+        pointer = step->getSubExpr()->IgnoreParenImpCasts();
+      }
+
+      std::string pointerName = extractPointerBaseName(pointer);
+      if (currentLoop->canonical.walksPointer(pointerName))
+      {
+        SourceLocation loc = unaryOp->getExprLoc();
+        unsigned line = context_->getSourceManager().getSpellingLineNumber(loc);
+        bool is_write = isWriteAccessUnary(unaryOp);
+
+        ArrayAccess access(pointerName, currentLoop->canonical.index_ref, loc, line, is_write);
+        access.distinct_base = isDistinctBase(pointer);
+        currentLoop->addArrayAccess(access);
+        nest_accesses_.add(pointerName, {currentLoop->canonical.index_ref}, line, is_write,
+                           loop_stack_.top());
+
+        if (verbose_)
+        {
+          line_access_summaries_[line].line_number = line;
+          line_access_summaries_[line].accesses.push_back(
+              {pointerName + "[" + currentLoop->canonical.index_var + "]", is_write});
+        }
+        return true;
+      }
+    }
+
     // check if dereferencing something with addition (pointer arithmetic)
     if (auto* binOp = dyn_cast<BinaryOperator>(subExpr))
     {
@@ -246,7 +292,9 @@ bool LoopVisitor::VisitUnaryOperator(UnaryOperator* unaryOp)
 
           // create array access with the offset expression
           ArrayAccess access(baseName, binOp->getRHS(), loc, line, is_write);
+          access.distinct_base = isDistinctBase(binOp->getLHS());
           getCurrentLoop()->addArrayAccess(access);
+          nest_accesses_.add(baseName, {binOp->getRHS()}, line, is_write, loop_stack_.top());
 
           if (verbose_)
           {
@@ -310,12 +358,126 @@ bool LoopVisitor::VisitCallExpr(CallExpr* callExpr)
 
   currentLoop->addDetectedFunctionCall(func_name, is_safe);
 
+  // calls into user code can cost anything
+  if (isOpaqueCall(callExpr))
+  {
+    currentLoop->metrics.opaque_calls++;
+  }
+
+  return true;
+}
+
+bool LoopVisitor::VisitBreakStmt(BreakStmt* breakStmt)
+{
+  if (!breakStmt || !isInsideLoop())
+  {
+    return true;
+  }
+
+  // a break inside a switch only leaves the switch
+  LoopInfo* currentLoop = getCurrentLoop();
+  if (!isInsideSwitch(breakStmt, currentLoop->stmt))
+  {
+    recordEarlyExit(*currentLoop, EarlyExitKind::BREAK, breakStmt);
+  }
+  return true;
+}
+
+bool LoopVisitor::VisitReturnStmt(ReturnStmt* returnStmt)
+{
+  if (!returnStmt || !isInsideLoop())
+  {
+    return true;
+  }
+
+  // a return leaves every enclosing loop
+  std::optional<size_t> index = loop_stack_.top();
+  while (index)
+  {
+    recordEarlyExit(loops_[*index], EarlyExitKind::RETURN, returnStmt);
+    index = loops_[*index].parent_loop_index;
+  }
+  return true;
+}
+
+bool LoopVisitor::VisitGotoStmt(GotoStmt* gotoStmt)
+{
+  if (!gotoStmt || !isInsideLoop())
+  {
+    return true;
+  }
+
+  // jumps to a label inside the loop stay in that loop and all loops around it
+  SourceLocation target = gotoStmt->getLabel()->getLocation();
+  std::optional<size_t> index = loop_stack_.top();
+  while (index && !containsLocation(loops_[*index].stmt, target))
+  {
+    recordEarlyExit(loops_[*index], EarlyExitKind::GOTO, gotoStmt);
+    index = loops_[*index].parent_loop_index;
+  }
+  return true;
+}
+
+bool LoopVisitor::VisitIndirectGotoStmt(IndirectGotoStmt* gotoStmt)
+{
+  if (!gotoStmt || !isInsideLoop())
+  {
+    return true;
+  }
+
+  // computed gotos can land anywhere
+  std::optional<size_t> index = loop_stack_.top();
+  while (index)
+  {
+    recordEarlyExit(loops_[*index], EarlyExitKind::GOTO, gotoStmt);
+    index = loops_[*index].parent_loop_index;
+  }
   return true;
 }
 
+void LoopVisitor::recordEarlyExit(LoopInfo& loop, EarlyExitKind kind, Stmt* stmt)
+{
+  unsigned line = context_->getSourceManager().getSpellingLineNumber(stmt->getBeginLoc());
+  loop.early_exits.emplace_back(kind, stmt, line);
+
+  if (verbose_)
+  {
+    const char* name = kind == EarlyExitKind::BREAK    ? "break"
+                       : kind == EarlyExitKind::RETURN ? "return"
+                                                       : "goto";
+    std::cout << "  Early exit (" << name << ") at line " << line << " leaves loop at line "
+              << loop.line_number << "\n";
+  }
+}
+
+bool LoopVisitor::isInsideSwitch(Stmt* stmt, const Stmt* loopStmt)
+{
+  const Stmt* current = stmt;
+  while (current && current != loopStmt)
+  {
+    if (isa<SwitchStmt>(current))
+    {
+      return true;
+    }
+
+    AnalysisStats::get().count(Counter::PARENT_LOOKUPS);
+    auto parents = context_->getParents(*current);
+    current = parents.empty() ? nullptr : parents[0].get<Stmt>();
+  }
+  return false;
+}
+
+bool LoopVisitor::containsLocation(const Stmt* stmt, SourceLocation loc) const
+{
+  const SourceManager& sm = context_->getSourceManager();
+  SourceRange range = stmt->getSourceRange();
+  return !sm.isBeforeInTranslationUnit(loc, range.getBegin()) &&
+         !sm.isBeforeInTranslationUnit(range.getEnd(), loc);
+}
+
 void LoopVisitor::analyzeForLoopBounds(ForStmt* forLoop, LoopInfo& info)
 {
-  info.bounds.init_expr = nullptr;
+  info.bounds.init_expr = forLoop->getInit();
   info.bounds.condition_expr = forLoop->getCond();
   info.bounds.increment_expr = forLoop->getInc();
 
@@ -363,8 +525,416 @@ void LoopVisitor::analyzeForLoopBounds(ForStmt* forLoop, LoopInfo& info)
   }
 }
 
+void LoopVisitor::computeTripCount(LoopInfo& info)
+{
+  LoopBounds& bounds = info.bounds;
+  if (!bounds.is_simple_pattern || !bounds.init_expr || !bounds.condition_expr ||
+      !bounds.increment_expr)
+  {
+    return;
+  }
+
+  // start value: int i = 0 or i = 0
+  Expr* init = nullptr;
+  if (auto* declStmt = dyn_cast<DeclStmt>(bounds.init_expr))
+  {
+    if (declStmt->isSingleDecl())
+    {
+      if (auto* varDecl = dyn_cast<VarDecl>(declStmt->getSingleDecl()))
+      {
+        init = varDecl->getInit();
+      }
+    }
+  }
+  else if (auto* assign = dyn_cast<BinaryOperator>(bounds.init_expr))
+  {
+    if (assign->getOpcode() == BO_Assign)
+    {
+      init = assign->getRHS();
+    }
+  }
+
+  // step: i++, i--, i += c, i -= c
+  long long step = 0;
+  Expr* inc = bounds.increment_expr->IgnoreParenImpCasts();
+  if (auto* unaryOp = dyn_cast<UnaryOperator>(inc))
+  {
+    if (unaryOp->isIncrementDecrementOp())
+    {
+      step = unaryOp->isIncrementOp() ? 1 : -1;
+    }
+  }
+  else if (auto* compound = dyn_cast<CompoundAssignOperator>(inc))
+  {
+    Expr::EvalResult amount;
+    if ((compound->getOpcode() == BO_AddAssign || compound->getOpcode() == BO_SubAssign) &&
+        compound->getRHS()->EvaluateAsInt(amount, *context_))
+    {
+      step = amount.Val.getInt().getExtValue();
+      if (compound->getOpcode() == BO_SubAssign)
+      {
+        step = -step;
+      }
+    }
+  }
+
+  bounds.step = step;
+
+  // bound: i < n or n > i
+  auto* cond = dyn_cast<BinaryOperator>(bounds.condition_expr->IgnoreParenImpCasts());
+  if (!init || step == 0 || !cond || !cond->isComparisonOp())
+  {
+    return;
+  }
+
+  auto isIterator = [&bounds](Expr* expr)
+  {
+    auto* declRef = dyn_cast<DeclRefExpr>(expr->IgnoreParenImpCasts());
+    return declRef && declRef->getDecl()->getNameAsString() == bounds.iterator_var;
+  };
+
+  BinaryOperatorKind relation = cond->getOpcode();
+  Expr* limit = cond->getRHS();
+  if (!isIterator(cond->getLHS()))
+  {
+    if (!isIterator(cond->getRHS()))
+    {
+      return;
+    }
+    relation = BinaryOperator::reverseComparisonOp(relation);
+    limit = cond->getLHS();
+  }
+
+  bounds.trip_count_text = tripCountText(init, limit, relation, step, bounds);
+  if (!bounds.trip_count_text.empty())
+  {
+    bounds.start_text = source_.getWrittenText(init->getSourceRange());
+  }
+
+  Expr::EvalResult start_value, limit_value;
+  if (!init->EvaluateAsInt(start_value, *context_) || !limit->EvaluateAsInt(limit_value, *context_))
+  {
+    return;
+  }
+
+  long long start = start_value.Val.getInt().getExtValue();
+  long long end = limit_value.Val.getInt().getExtValue();
+  long long distance = step > 0 ? end - start : start - end;
+  long long stride = step > 0 ? step : -step;
+  long long trips = -1;
+
+  switch (relation)
+  {
+  case BO_LT:
+  case BO_GT:
+    if ((relation == BO_LT) == (step > 0))
+      trips = distance > 0 ? (distance + stride - 1) / stride : 0;
+    break;
+  case BO_LE:
+  case BO_GE:
+    if ((relation == BO_LE) == (step > 0))
+      trips = distance >= 0 ? distance / stride + 1 : 0;
+    break;
+  case BO_NE:
+    if (stride == 1 && distance >= 0)
+      trips = distance;
+    break;
+  default:
+    break;
+  }
+
+  if (trips >= 0)
+  {
+    bounds.constant_trip_count = trips;
+  }
+}
+
+void LoopVisitor::estimateIterationWork(LoopInfo& loop)
+{
+  LoopMetrics& metrics = loop.metrics;
+  metrics.iteration_cost = metrics.getOwnIterationCost();
+  metrics.iteration_flops =
+      metrics.arithmetic_ops + metrics.function_calls * LoopMetrics::kCallCost;
+  metrics.iteration_accesses = metrics.memory_accesses;
+  metrics.uneven_iterations = hasUnevenWork(loop.body(), loop);
+
+  for (size_t child_index : loop.child_loop_indices)
+  {
+    const LoopInfo& child = loops_[child_index];
+    double trips = child.bounds.constant_trip_count
+                       ? static_cast<double>(*child.bounds.constant_trip_count)
+                       : LoopMetrics::kAssumedTripCount;
+    metrics.iteration_cost += child.metrics.iteration_cost * trips;
+    metrics.iteration_flops += child.metrics.iteration_flops * trips;
+    metrics.iteration_accesses += child.metrics.iteration_accesses * trips;
+
+    // inner trip counts that follow the outer index or the data make iterations uneven
+    if (child.metrics.uneven_iterations || !child.bounds.is_simple_pattern ||
+        dependsOnIteration(child.bounds.init_expr, loop) ||
+        dependsOnIteration(child.bounds.condition_expr, loop))
+    {
+      metrics.uneven_iterations = true;
+    }
+  }
+
+  if (verbose_ && metrics.uneven_iterations)
+  {
+    std::cout << "  Uneven iterations at line " << loop.line_number << " (~"
+              << static_cast<long long>(metrics.iteration_cost) << " ops per iteration)\n";
+  }
+}
+
+std::string LoopVisitor::tripCountText(const Expr* start, const Expr* limit,
+                                       BinaryOperatorKind relation, long long step,
+                                       const LoopBounds& bounds) const
+{
+  // the text is re-evaluated in front of the loop, so it must be side-effect free and
+  // must not need the iterator, which isn't in scope there yet
+  if (start->HasSideEffects(*context_) || limit->HasSideEffects(*context_) ||
+      mentionsVariable(start, bounds.iterator_var) || mentionsVariable(limit, bounds.iterator_var))
+  {
+    return "";
+  }
+
+  std::string start_text = source_.getWrittenText(start->getSourceRange());
+  std::string limit_text = source_.getWrittenText(limit->getSourceRange());
+  if (start_text.empty() || limit_text.empty())
+  {
+    return "";
+  }
+
+  auto operand = [](const std::string& text)
+  {
+    bool simple = std::all_of(text.begin(), text.end(),
+                              [](char c) { return std::isalnum(static_cast<unsigned char>(c)) ||
+                                                  c == '_'; });
+    return simple ? text : "(" + text + ")";
+  };
+
+  // i < n counts n - start, i <= n one more; descending loops count the other way
+  bool ascending = step > 0;
+  bool inclusive = relation == BO_LE || relation == BO_GE;
+  bool matches = relation == BO_NE ? std::llabs(step) == 1
+                                   : (relation == BO_LT || relation == BO_LE) == ascending;
+  if (!matches)
+  {
+    return "";
+  }
+
+  const std::string& high = ascending ? limit_text : start_text;
+  const std::string& low = ascending ? start_text : limit_text;
+  std::string distance = low == "0" ? operand(high) : operand(high) + " - " + operand(low);
+  long long stride = std::llabs(step);
+  if (stride == 1 && !inclusive)
+  {
+    // i < n - 1 from zero counts n - 1 as written, callers bracket it where they need to
+    return low == "0" ? high : distance;
+  }
+  if (stride == 1)
+  {
+    return distance + " + 1";
+  }
+
+  std::string rounded = inclusive ? distance + " + " + std::to_string(stride)
+                                  : distance + " + " + std::to_string(stride - 1);
+  return "(" + rounded + ") / " + std::to_string(stride);
+}
+
+bool LoopVisitor::mentionsVariable(const Stmt* stmt, const std::string& name) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+  if (auto* declRef = dyn_cast<DeclRefExpr>(stmt))
+  {
+    return declRef->getDecl()->getNameAsString() == name;
+  }
+  for (const Stmt* child : stmt->children())
+  {
+    if (mentionsVariable(child, name))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool LoopVisitor::dependsOnIteration(const Stmt* stmt, const LoopInfo& outer) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+
+  // j < i, j < row_ptr[i + 1] or j < len with len set in the outer body
+  if (auto* declRef = dyn_cast<DeclRefExpr>(stmt))
+  {
+    std::string name = declRef->getDecl()->getNameAsString();
+    auto it = outer.variables.find(name);
+    return name == outer.bounds.iterator_var ||
+           (it != outer.variables.end() && it->second.scope == VariableScope::LOOP_LOCAL);
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    if (dependsOnIteration(child, outer))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool LoopVisitor::isOpaqueCall(const CallExpr* call) const
+{
+  const FunctionDecl* callee = call->getDirectCallee();
+  return !callee || (callee->getBuiltinID() == 0 &&
+                     !context_->getSourceManager().isInSystemHeader(callee->getLocation()));
+}
+
+bool LoopVisitor::hasUnevenWork(const Stmt* stmt, const LoopInfo& loop) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+
+  // nested loops report their own bounds through estimateIterationWork
+  if (isa<ForStmt>(stmt) || isa<WhileStmt>(stmt) || isa<DoStmt>(stmt))
+  {
+    return false;
+  }
+
+  // if (mask[i]) { heavy } else { light }: only some iterations pay for the heavy arm
+  if (auto* branch = dyn_cast<IfStmt>(stmt))
+  {
+    if (dependsOnIteration(branch->getCond(), loop) &&
+        containsHeavyWork(branch->getThen()) != containsHeavyWork(branch->getElse()))
+    {
+      return true;
+    }
+  }
+
+  // weigh(&items[i]) where weigh loops over a count it reads from its argument
+  if (auto* call = dyn_cast<CallExpr>(stmt))
+  {
+    const FunctionDecl* callee = call->getDirectCallee();
+    const FunctionDecl* definition = callee ? callee->getDefinition() : nullptr;
+    bool per_item = std::any_of(call->arg_begin(), call->arg_end(), [&](const Expr* arg)
+                                { return dependsOnIteration(arg, loop); });
+    if (definition && per_item && hasParameterBoundLoop(definition->getBody(), definition))
+    {
+      return true;
+    }
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    if (hasUnevenWork(child, loop))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool LoopVisitor::containsHeavyWork(const Stmt* stmt) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+  if (isa<ForStmt>(stmt) || isa<WhileStmt>(stmt) || isa<DoStmt>(stmt))
+  {
+    return true;
+  }
+  if (auto* call = dyn_cast<CallExpr>(stmt))
+  {
+    if (isOpaqueCall(call))
+    {
+      return true;
+    }
+  }
+  for (const Stmt* child : stmt->children())
+  {
+    if (containsHeavyWork(child))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool LoopVisitor::hasParameterBoundLoop(const Stmt* stmt, const FunctionDecl* function) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+
+  // k < item->count or k < len, with item or len a parameter
+  const Expr* cond = nullptr;
+  if (auto* forLoop = dyn_cast<ForStmt>(stmt))
+  {
+    cond = forLoop->getCond();
+  }
+  else if (auto* whileLoop = dyn_cast<WhileStmt>(stmt))
+  {
+    cond = whileLoop->getCond();
+  }
+  else if (auto* doLoop = dyn_cast<DoStmt>(stmt))
+  {
+    cond = doLoop->getCond();
+  }
+  if (cond && referencesParameter(cond, function))
+  {
+    return true;
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    if (hasParameterBoundLoop(child, function))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool LoopVisitor::referencesParameter(const Stmt* stmt, const FunctionDecl* function) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+  if (auto* declRef = dyn_cast<DeclRefExpr>(stmt))
+  {
+    auto* param = dyn_cast<ParmVarDecl>(declRef->getDecl());
+    return param && param->getDeclContext() == function;
+  }
+  for (const Stmt* child : stmt->children())
+  {
+    if (referencesParameter(child, function))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
 void LoopVisitor::markInductionVariable(LoopInfo& loop)
 {
+  // pointers of a lowered pointer walk advance with the index
+  for (const auto& pointer : loop.canonical.walked_pointers)
+  {
+    auto it = loop.variables.find(pointer);
+    if (it != loop.variables.end())
+    {
+      it->second.setRole(VariableRole::INDUCTION_VAR);
+    }
+  }
+
   if (!loop.bounds.iterator_var.empty())
   {
     auto it = loop.variables.find(loop.bounds.iterator_var);
@@ -399,14 +969,40 @@ void LoopVisitor::finalizeDependencyAnalysis(LoopInfo& loop)
   // combine both checks
   bool has_deps = dependency_analyzer_->hasDependencies(loop);
   bool has_unsafe_nested = loop.hasUnsafeCallsRecursive(loops_);
+  bool encloses_pipeline = enclosesPipelinedNest(loop);
+  bool carries_nested = !loop.nest_conflicts.empty();
 
   if (has_unsafe_nested && verbose_)
   {
     std::cout << "  Note: Nested loop contains unsafe function calls\n";
   }
+  if (encloses_pipeline && verbose_)
+  {
+    std::cout << "  Note: Loop re-runs a doacross nest over the same arrays\n";
+  }
+
+  if (carries_nested)
+  {
+    loop.blocking_factors.insert(loop.blocking_factors.end(), loop.nest_conflicts.begin(),
+                                 loop.nest_conflicts.end());
+  }
+
+  // mark as having dependencies if any condition is true
+  loop.setHasDependencies(has_deps || has_unsafe_nested || encloses_pipeline || carries_nested);
+  loop.safelen_covered =
+      loop.safelen_covered && !has_unsafe_nested && !encloses_pipeline && !carries_nested;
+}
 
-  // mark as having dependencies if either condition is true
-  loop.setHasDependencies(has_deps || has_unsafe_nested);
+bool LoopVisitor::enclosesPipelinedNest(const LoopInfo& loop) const
+{
+  for (size_t child : loop.child_loop_indices)
+  {
+    if (loops_[child].doacross.isPipelined() || enclosesPipelinedNest(loops_[child]))
+    {
+      return true;
+    }
+  }
+  return false;
 }
 
 bool LoopVisitor::VisitArraySubscriptExpr(ArraySubscriptExpr* arrayExpr)
@@ -423,6 +1019,7 @@ bool LoopVisitor::VisitArraySubscriptExpr(ArraySubscriptExpr* arrayExpr)
 
   // check if this is a write by looking at parent context
   bool is_write = false;
+  AnalysisStats::get().count(Counter::PARENT_LOOKUPS);
   auto parents = context_->getParents(*arrayExpr);
   for (const auto& parent : parents)
   {
@@ -434,11 +1031,26 @@ bool LoopVisitor::VisitArraySubscriptExpr(ArraySubscriptExpr* arrayExpr)
         break;
       }
     }
+    else if (auto* unaryOp = parent.get<UnaryOperator>())
+    {
+      if (unaryOp->isIncrementDecrementOp())
+      {
+        is_write = true;
+        break;
+      }
+    }
   }
 
   ArrayAccess access(arrayName, arrayExpr->getIdx(), loc, line, is_write);
+  access.distinct_base = isDistinctBase(arrayExpr->getBase());
   getCurrentLoop()->addArrayAccess(access);
 
+  // the nest table keeps whole elements: a[i][j] once with both subscripts
+  if (inner_subscripts_.erase(arrayExpr) == 0)
+  {
+    recordNestAccess(arrayExpr, arrayName, line, is_write);
+  }
+
   // collect for clean summary output
   if (verbose_)
   {
@@ -470,6 +1082,25 @@ std::string LoopVisitor::extractArrayBaseName(ArraySubscriptExpr* arrayExpr)
   return "unknown";
 }
 
+bool LoopVisitor::isDistinctBase(const Expr* base) const
+{
+  base = base->IgnoreParenImpCasts();
+  while (auto* inner = dyn_cast<ArraySubscriptExpr>(base))
+  {
+    base = inner->getBase()->IgnoreParenImpCasts();
+  }
+
+  // array parameters decay to plain pointers, so only a declared array is its own object
+  auto* declRef = dyn_cast<DeclRefExpr>(base);
+  auto* var = declRef ? dyn_cast<VarDecl>(declRef->getDecl()) : nullptr;
+  if (!var)
+  {
+    return false;
+  }
+  return (var->getType()->isArrayType() && !isa<ParmVarDecl>(var)) ||
+         var->getType().isRestrictQualified();
+}
+
 std::string LoopVisitor::extractPointerBaseName(Expr* expr)
 {
   if (!expr)
@@ -493,6 +1124,7 @@ std::string LoopVisitor::extractPointerBaseName(Expr* expr)
 
 bool LoopVisitor::isWriteAccessUnary(UnaryOperator* unaryOp)
 {
+  AnalysisStats::get().count(Counter::PARENT_LOOKUPS);
   auto parents = context_->getParents(*unaryOp);
   for (const auto& parent : parents)
   {
@@ -576,6 +1208,7 @@ void LoopVisitor::printArrayAccessSummary()
 
 bool LoopVisitor::isWriteAccess(DeclRefExpr* declRef)
 {
+  AnalysisStats::get().count(Counter::PARENT_LOOKUPS);
   auto parents = context_->getParents(*declRef);
   for (const auto& parent : parents)
   {
@@ -702,12 +1335,159 @@ void LoopVisitor::addLoop(Stmt* stmt, SourceLocation loc, const std::string& typ
   loops_.emplace_back(stmt, loc, line, type);
   unsigned depth = static_cast<unsigned>(loop_stack_.size());
 
+  LoopInfo& loop = loops_.back();
+  loop.function_name = current_function_;
+  loop.end_line_number = sm.getSpellingLineNumber(stmt->getEndLoc());
+  loop.indentation = source_.getIndentation(line);
+  linkPreviousSibling(stmt, loops_.size() - 1);
+
   if (verbose_)
   {
     std::cout << "Found " << type << " loop at line " << line << " (depth " << depth << ")\n";
   }
 }
 
+void LoopVisitor::linkPreviousSibling(Stmt* stmt, size_t index)
+{
+  AnalysisStats::get().count(Counter::PARENT_LOOKUPS);
+  auto parents = context_->getParents(*stmt);
+  const auto* block = parents.empty() ? nullptr : parents[0].get<CompoundStmt>();
+  if (!block)
+  {
+    return;
+  }
+
+  // find the statement right before this loop in the same block
+  const Stmt* previous = nullptr;
+  for (const Stmt* child : block->body())
+  {
+    if (child == stmt)
+    {
+      break;
+    }
+    previous = child;
+  }
+
+  if (!previous)
+  {
+    return;
+  }
+
+  for (size_t i = index; i-- > 0;)
+  {
+    if (loops_[i].stmt == previous)
+    {
+      loops_[i].next_sibling_loop = index;
+      return;
+    }
+  }
+}
+
+void LoopVisitor::analyzeLoopBody(size_t index)
+{
+  LoopInfo& loop = loops_[index];
+  markInductionVariable(loop);
+
+  // a while loop only gets a pragma through its for-form, and the analyses that read or
+  // rewrite the header text need a header that is really there
+  auto* forLoop = dyn_cast<ForStmt>(loop.stmt);
+  bool for_form = forLoop || loop.canonical.isCanonical();
+
+  // a first-match search can still run in parallel with cancellation
+  if (forLoop && loop.hasEarlyExit())
+  {
+    search_analyzer_.analyzeSearchLoop(forLoop, loop);
+  }
+
+  // work arrays rewritten from scratch every iteration don't carry anything across,
+  // and arrays only ever accumulated into can be combined after the loop
+  if (for_form)
+  {
+    privatizer_.analyzeLoop(loop.stmt, loop);
+    reduction_analyzer_.analyzeLoop(loop.stmt, loop);
+  }
+
+  if (forLoop)
+  {
+    // out[i] = out[i - 1] + in[i] and friends are prefix scans, not serial recurrences
+    scan_analyzer_.analyzeLoop(forLoop, loop);
+
+    // whether the lanes of a simd directive would be legal and worth it, and which
+    // counters advance linearly
+    simd_analyzer_.analyzeLoop(forLoop, loop);
+  }
+
+  // arrays each iteration owns a row of, for matching first-touch placement later
+  if (for_form)
+  {
+    first_touch_analyzer_.analyzeLoop(loop.stmt, loop);
+  }
+
+  // a few shared scalar updates can go atomic when the rest of the iteration outweighs them
+  estimateIterationWork(loop);
+  roofline_analyzer_.analyzeLoop(index, loops_);
+  if (forLoop)
+  {
+    prefetch_analyzer_.analyzeLoop(forLoop, loop);
+  }
+  if (for_form)
+  {
+    shared_update_analyzer_.analyzeLoop(loop.stmt, loop);
+  }
+
+  analyzeNestAccesses(index);
+  finalizeDependencyAnalysis(loop);
+  loop.finalizeMetrics();
+
+  // constant-distance recurrences in a perfect nest can still run as a pipeline
+  if (forLoop && !doacross_analyzer_.analyzeNest(loops_, index))
+  {
+    restructureLoop(index);
+  }
+}
+
+void LoopVisitor::analyzeNestAccesses(size_t index)
+{
+  // every level of the nest reads the same table, nothing is copied up from inner loops
+  loops_[index].body_accesses.end = nest_accesses_.size();
+  nest_analyzer_.analyzeLoop(index, loops_, nest_accesses_);
+}
+
+void LoopVisitor::finishFunction()
+{
+  // the loops stay for pragma generation after the whole TU, their usage counts with them
+  for (size_t i = function_first_loop_; i < loops_.size(); i++)
+  {
+    for (auto& [name, var] : loops_[i].variables)
+    {
+      var.releaseUsages();
+    }
+  }
+  inner_subscripts_ = decltype(inner_subscripts_)(inner_subscripts_.get_allocator());
+
+  AnalysisStats::get().count(Counter::ARENA_BYTES, arena_.getBytesAllocated());
+  arena_.Reset();
+}
+
+void LoopVisitor::restructureLoop(size_t index)
+{
+  // a loop with a recurrence may still have statements that can run apart from it
+  if (transformer_.tryFission(loops_, index))
+  {
+    return;
+  }
+
+  // merge into the loop right before this one when it walks the same data
+  for (size_t i = index; i-- > 0;)
+  {
+    if (loops_[i].next_sibling_loop == index)
+    {
+      transformer_.tryFusion(loops_, i, index);
+      return;
+    }
+  }
+}
+
 void LoopVisitor::printLoopSummary() const
 {
   std::cout << "\n=== Loop Analysis Results ===\n";
@@ -719,14 +1499,44 @@ void LoopVisitor::printLoopSummary() const
     return;
   }
 
-  // count parallelizable loops
+  // count parallelizable and canonicalized loops
   size_t parallelizable_count = 0;
+  size_t pointer_walk_count = 0;
+  size_t counted_count = 0;
+  size_t fused_count = 0;
+  size_t split_count = 0;
+  size_t doacross_count = 0;
+  size_t scan_count = 0;
   for (const auto& loop : loops_)
   {
+    if (loop.scan.isScan())
+    {
+      scan_count++;
+    }
+    if (loop.doacross.isPipelined())
+    {
+      doacross_count++;
+    }
+    if (loop.transform.isFusion())
+    {
+      fused_count++;
+    }
+    if (loop.transform.isFission())
+    {
+      split_count++;
+    }
     if (loop.isParallelizable())
     {
       parallelizable_count++;
     }
+    if (loop.canonical.form == CanonicalForm::POINTER_WALK)
+    {
+      pointer_walk_count++;
+    }
+    if (loop.canonical.isCounted())
+    {
+      counted_count++;
+    }
   }
 
   std::cout << "Found " << loops_.size() << " loop" << (loops_.size() > 1 ? "s" : "") << ", "
@@ -760,7 +1570,35 @@ void LoopVisitor::printLoopSummary() const
     {
       status = "SAFE";
 
-      if (loop.bounds.is_simple_pattern && !loop.array_accesses.empty())
+      if (loop.doacross.isPipelined())
+      {
+        reason = "Doacross pipeline";
+      }
+      else if (loop.scan.isScan())
+      {
+        reason = "Prefix scan (omp scan)";
+      }
+      else if (loop.transform.isFusion())
+      {
+        reason = "Fused with next loop";
+      }
+      else if (loop.fused_into)
+      {
+        reason = "Fused into previous";
+      }
+      else if (loop.canonical.form == CanonicalForm::POINTER_WALK)
+      {
+        reason = "Pointer walk (indexed)";
+      }
+      else if (loop.canonical.isCounted())
+      {
+        reason = "Counted loop (for-form)";
+      }
+      else if (loop.search.is_search)
+      {
+        reason = "Search loop (cancel)";
+      }
+      else if (loop.bounds.is_simple_pattern && !loop.array_accesses.empty())
       {
         reason = "Simple array operations";
       }
@@ -777,7 +1615,15 @@ void LoopVisitor::printLoopSummary() const
     {
       status = "UNSAFE";
 
-      if (loop.hasUnsafeFunctionCalls())
+      if (loop.transform.isFission())
+      {
+        reason = "Split: parallel part";
+      }
+      else if (loop.hasUnsafeEarlyExit())
+      {
+        reason = "Early exit (break/return)";
+      }
+      else if (loop.hasUnsafeFunctionCalls())
       {
         reason = "Function call side effects";
       }
@@ -809,8 +1655,56 @@ void LoopVisitor::printLoopSummary() const
   std::cout << "\nSummary:\n";
   std::cout << "  Parallelizable: " << parallelizable_count << "/" << loops_.size() << " ("
             << (loops_.size() > 0 ? (parallelizable_count * 100 / loops_.size()) : 0) << "%)\n";
+  if (pointer_walk_count > 0)
+  {
+    std::cout << "  Pointer walks lowered to indexed for: " << pointer_walk_count << "\n";
+  }
+  if (counted_count > 0)
+  {
+    std::cout << "  While/do-while loops convertible to for: " << counted_count << "\n";
+  }
+  if (fused_count > 0)
+  {
+    std::cout << "  Loop pairs fused: " << fused_count << "\n";
+  }
+  if (split_count > 0)
+  {
+    std::cout << "  Loops split by fission: " << split_count << "\n";
+  }
+  if (doacross_count > 0)
+  {
+    std::cout << "  Nests pipelined with ordered(n): " << doacross_count << "\n";
+  }
+  if (scan_count > 0)
+  {
+    std::cout << "  Prefix scans with omp scan: " << scan_count << "\n";
+  }
 
   std::cout << "============================\n";
 }
 
+void LoopVisitor::recordNestAccess(ArraySubscriptExpr* element, const std::string& array,
+                                   unsigned line, bool is_write)
+{
+  // a[i][j] is visited again as a[i]; that one is part of this element, not an access
+  llvm::SmallVector<const Expr*, 4> subscripts;
+  subscripts.push_back(element->getIdx());
+  Expr* base = element->getBase()->IgnoreParenImpCasts();
+  while (auto* level = dyn_cast<ArraySubscriptExpr>(base))
+  {
+    inner_subscripts_.insert(level);
+    subscripts.push_back(level->getIdx());
+    base = level->getBase()->IgnoreParenImpCasts();
+  }
+  std::reverse(subscripts.begin(), subscripts.end());
+
+  nest_accesses_.add(array, subscripts, line, is_write, loop_stack_.top());
+}
+
+std::string LoopVisitor::traceDetail(size_t index) const
+{
+  // same function:line shape as the detail clang gives its own spans
+  return current_function_ + ":" + std::to_string(loops_[index].line_number);
+}
+
 } // namespace paralyze
\ No newline at end of file
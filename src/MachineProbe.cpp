@@ -0,0 +1,54 @@
+#include "analyzer/MachineProbe.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace paralyze
+{
+
+MachineModel MachineProbe::measure(MachineModel machine) const
+{
+  machine.core_bandwidth_gbs = triadBandwidth(1);
+  machine.bandwidth_gbs = std::max(machine.core_bandwidth_gbs, triadBandwidth(machine.cores));
+  machine.measured = true;
+  return machine;
+}
+
+double MachineProbe::triadBandwidth(unsigned threads) const
+{
+  std::vector<double> a(kProbeElements), b(kProbeElements, 1.0), c(kProbeElements, 2.0);
+  size_t chunk = (kProbeElements + threads - 1) / threads;
+
+  double best = 0.0;
+  for (int run = 0; run < kProbeRuns; run++)
+  {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> team;
+    for (unsigned t = 0; t < threads; t++)
+    {
+      team.emplace_back(
+          [&, t]()
+          {
+            size_t end = std::min(kProbeElements, (t + 1) * chunk);
+            for (size_t i = t * chunk; i < end; i++)
+            {
+              a[i] = b[i] + 3.0 * c[i];
+            }
+          });
+    }
+    for (auto& thread : team)
+    {
+      thread.join();
+    }
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+    // counted the way the roofline counts a triad: two loads, the store and its
+    // write-allocate read
+    double bytes = 4.0 * sizeof(double) * kProbeElements;
+    best = std::max(best, bytes / seconds.count() / 1e9);
+  }
+  return best;
+}
+
+} // namespace paralyze
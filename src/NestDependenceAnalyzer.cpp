@@ -0,0 +1,190 @@
+#include "analyzer/NestDependenceAnalyzer.h"
+#include <iostream>
+#include <map>
+
+using namespace clang;
+
+namespace paralyze
+{
+
+void NestDependenceAnalyzer::analyzeLoop(size_t index, std::vector<LoopInfo>& loops,
+                                         const NestAccessTable& table)
+{
+  LoopInfo& loop = loops[index];
+  loop.nest_conflicts.clear();
+
+  // the loop's own statements are the array analysis's job
+  if (loop.child_loop_indices.empty())
+  {
+    return;
+  }
+
+  std::map<std::string, std::vector<size_t>> arrays;
+  for (size_t i = loop.body_accesses.begin; i < loop.body_accesses.end; i++)
+  {
+    arrays[table[i].array].push_back(i);
+  }
+
+  const std::string& iterator = loop.bounds.iterator_var;
+  for (const auto& entry : arrays)
+  {
+    const std::string& array = entry.first;
+    bool written = false;
+    bool nested = false;
+    for (size_t i : entry.second)
+    {
+      written |= table[i].is_write;
+      nested |= table[i].loop != index;
+    }
+
+    // read-only arrays and private copies never carry anything from one iteration to the next
+    if (!written || !nested || loop.isPrivateArray(array) || loop.isReductionArray(array) ||
+        loop.isScanArray(array) || isPartitioned(entry.second, table, iterator))
+    {
+      continue;
+    }
+
+    loop.nest_conflicts.push_back(array + " is shared across iterations" +
+                                  (iterator.empty() ? "" : " of " + iterator) +
+                                  " through a nested loop");
+    if (verbose_)
+    {
+      std::cout << "  Nested loops write " << array << " outside the slice iteration "
+                << (iterator.empty() ? "?" : iterator) << " owns\n";
+    }
+  }
+}
+
+bool NestDependenceAnalyzer::isPartitioned(const std::vector<size_t>& accesses,
+                                           const NestAccessTable& table,
+                                           const std::string& iterator) const
+{
+  if (iterator.empty())
+  {
+    return false;
+  }
+
+  // some dimension where every access agrees on one slice per iteration
+  const NestTableEntry& first = table[accesses.front()];
+  for (unsigned dimension = 0; dimension < first.dimensions; dimension++)
+  {
+    std::optional<std::string> key = partitionKey(table.subscript(first, dimension), iterator);
+    bool agrees = key.has_value();
+    for (size_t i = 1; agrees && i < accesses.size(); i++)
+    {
+      const NestTableEntry& access = table[accesses[i]];
+      agrees = dimension < access.dimensions &&
+               partitionKey(table.subscript(access, dimension), iterator) == key;
+    }
+    if (agrees)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::optional<std::string> NestDependenceAnalyzer::partitionKey(const Expr* subscript,
+                                                                const std::string& iterator) const
+{
+  if (!subscript)
+  {
+    return std::nullopt;
+  }
+
+  const Expr* expr = subscript->IgnoreParenImpCasts();
+  if (isIterator(expr, iterator))
+  {
+    return iterator;
+  }
+
+  auto* op = dyn_cast<BinaryOperator>(expr);
+  if (!op)
+  {
+    return scaleKey(expr, iterator);
+  }
+
+  // i + 1 and i - 1 are other iterations' slices
+  const Expr* lhs = op->getLHS()->IgnoreParenImpCasts();
+  const Expr* rhs = op->getRHS()->IgnoreParenImpCasts();
+  if (op->getOpcode() == BO_Add || op->getOpcode() == BO_Sub)
+  {
+    auto* literal = dyn_cast<IntegerLiteral>(rhs);
+    if (literal && isIterator(lhs, iterator))
+    {
+      return iterator + (op->getOpcode() == BO_Add ? "+" : "-") +
+             std::to_string(literal->getValue().getZExtValue());
+    }
+    literal = dyn_cast<IntegerLiteral>(lhs);
+    if (literal && op->getOpcode() == BO_Add && isIterator(rhs, iterator))
+    {
+      return iterator + "+" + std::to_string(literal->getValue().getZExtValue());
+    }
+  }
+
+  // i * n + j walks row i of a flattened array as long as j stays inside the row
+  if (op->getOpcode() == BO_Add)
+  {
+    if (!mentions(rhs, iterator))
+    {
+      return scaleKey(lhs, iterator);
+    }
+    if (!mentions(lhs, iterator))
+    {
+      return scaleKey(rhs, iterator);
+    }
+  }
+  return scaleKey(expr, iterator);
+}
+
+std::optional<std::string> NestDependenceAnalyzer::scaleKey(const Expr* expr,
+                                                            const std::string& iterator) const
+{
+  auto* op = dyn_cast<BinaryOperator>(expr->IgnoreParenImpCasts());
+  if (!op || op->getOpcode() != BO_Mul)
+  {
+    return std::nullopt;
+  }
+
+  const Expr* lhs = op->getLHS()->IgnoreParenImpCasts();
+  const Expr* rhs = op->getRHS()->IgnoreParenImpCasts();
+  const Expr* scale = isIterator(lhs, iterator) ? rhs : isIterator(rhs, iterator) ? lhs : nullptr;
+  if (!scale || mentions(scale, iterator))
+  {
+    return std::nullopt;
+  }
+  std::string text = source_.getText(scale->getSourceRange());
+  if (text.empty())
+  {
+    return std::nullopt;
+  }
+  return iterator + "*" + text;
+}
+
+bool NestDependenceAnalyzer::isIterator(const Expr* expr, const std::string& iterator) const
+{
+  auto* ref = dyn_cast<DeclRefExpr>(expr->IgnoreParenImpCasts());
+  return ref && ref->getDecl()->getNameAsString() == iterator;
+}
+
+bool NestDependenceAnalyzer::mentions(const Stmt* stmt, const std::string& name) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+  if (auto* ref = dyn_cast<DeclRefExpr>(stmt))
+  {
+    return ref->getDecl()->getNameAsString() == name;
+  }
+  for (const Stmt* child : stmt->children())
+  {
+    if (mentions(child, name))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace paralyze
@@ -37,7 +37,7 @@ void PointerAnalyzer::analyzePointerUsage(LoopInfo& loop)
   }
 }
 
-PointerRisk PointerAnalyzer::getPointerRisk(const LoopInfo& loop) const
+PointerRisk PointerAnalyzer::getPointerRisk(const LoopInfo&) const
 {
   if (pointer_ops_.empty())
   {
@@ -61,7 +61,7 @@ PointerRisk PointerAnalyzer::getPointerRisk(const LoopInfo& loop) const
   return PointerRisk::SAFE;
 }
 
-void PointerAnalyzer::visitUnaryOperator(UnaryOperator* unaryOp, LoopInfo& loop)
+void PointerAnalyzer::visitUnaryOperator(UnaryOperator* unaryOp, LoopInfo&)
 {
   if (!unaryOp)
   {
@@ -124,7 +124,7 @@ void PointerAnalyzer::visitUnaryOperator(UnaryOperator* unaryOp, LoopInfo& loop)
   }
 }
 
-void PointerAnalyzer::visitBinaryOperator(BinaryOperator* binOp, LoopInfo& loop)
+void PointerAnalyzer::visitBinaryOperator(BinaryOperator* binOp, LoopInfo&)
 {
   if (!binOp)
   {
@@ -179,7 +179,7 @@ void PointerAnalyzer::visitBinaryOperator(BinaryOperator* binOp, LoopInfo& loop)
   }
 }
 
-void PointerAnalyzer::visitMemberExpr(MemberExpr* memberExpr, LoopInfo& loop)
+void PointerAnalyzer::visitMemberExpr(MemberExpr* memberExpr, LoopInfo&)
 {
   if (!memberExpr)
   {
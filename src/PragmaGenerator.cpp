@@ -1,5 +1,10 @@
 #include "analyzer/PragmaGenerator.h"
+#include "analyzer/AnalysisStats.h"
+#include "llvm/Support/TimeProfiler.h"
 #include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
 
 namespace paralyze
@@ -7,16 +12,61 @@ namespace paralyze
 
 void PragmaGenerator::generatePragmasForLoops(const std::vector<LoopInfo>& loops)
 {
+  ScopedTimer timer(Phase::PRAGMAS);
+  llvm::TimeTraceScope trace("GeneratePragmas");
   generated_pragmas_.clear();
+  pragma_for_loop_.clear();
+  rewritten_loop_count_ = 0;
+  loop_fusion_count_ = 0;
+  loop_fission_count_ = 0;
+  doacross_count_ = 0;
+  array_reduction_count_ = 0;
+  synchronized_loop_count_ = 0;
+  scan_count_ = 0;
+  search_loop_count_ = 0;
+  peel_reports_.clear();
+  roofline_reports_.clear();
+  prefetch_reports_.clear();
+  prefetch_advice_.clear();
+  inner_level_count_ = 0;
+  guarded_loop_count_ = 0;
+  first_touch_arrays_.clear();
+  spread_count_ = 0;
+  close_count_ = 0;
+  first_touch_advice_.clear();
+  fused_region_count_ = 0;
+  fused_loop_count_ = 0;
+  barriers_removed_ = 0;
 
   if (verbose_)
   {
     std::cout << "\n=== Generating OpenMP Pragmas ===\n";
   }
 
-  for (const auto& loop : loops)
+  // each nest gets its team of threads at one level, the rest of it runs serially or in lanes
+  parallel_levels_.clear();
+  for (size_t loop_index = 0; loop_index < loops.size(); loop_index++)
   {
-    PragmaType pragma_type = determinePragmaType(loop);
+    if (!loops[loop_index].hasParent())
+    {
+      chooseParallelLevels(loop_index, loops);
+    }
+  }
+
+  for (size_t loop_index = 0; loop_index < loops.size(); loop_index++)
+  {
+    const LoopInfo& loop = loops[loop_index];
+
+    // a fused loop's body runs under the pragma of the loop that absorbed it
+    // loops inside a doacross nest are covered by its ordered(n)
+    bool parallel_level = parallel_levels_.count(loop_index) > 0;
+    PragmaType pragma_type = loop.fused_into || isInsidePipelinedNest(loop, loops)
+                                 ? PragmaType::NO_PRAGMA
+                                 : determinePragmaType(loop, parallel_level);
+    if (loop.transform.isFusion() && pragma_type != PragmaType::NO_PRAGMA)
+    {
+      pragma_type = fusedPragmaType(pragma_type, loops[*loop.transform.fused_loop]);
+    }
 
     if (pragma_type != PragmaType::NO_PRAGMA)
     {
@@ -25,8 +75,37 @@ void PragmaGenerator::generatePragmasForLoops(const std::vector<LoopInfo>& loops
 
       GeneratedPragma pragma(pragma_type, pragma_text, loop.loop_type, loop.line_number, reasoning);
 
+      // while loops only parallelize through their canonical for-form
+      pragma.edits = loop.canonical.edits;
+      pragma.edits.insert(pragma.edits.end(), loop.search.edits.begin(), loop.search.edits.end());
+      pragma.edits.insert(pragma.edits.end(), loop.transform.edits.begin(),
+                          loop.transform.edits.end());
+      pragma.edits.insert(pragma.edits.end(), loop.doacross.edits.begin(),
+                          loop.doacross.edits.end());
+      for (const auto& reduction : loop.array_reductions)
+      {
+        pragma.edits.insert(pragma.edits.end(), reduction.edits.begin(), reduction.edits.end());
+      }
+      if (loop.shared_updates.isSynchronized())
+      {
+        pragma.edits.insert(pragma.edits.end(), loop.shared_updates.edits.begin(),
+                            loop.shared_updates.edits.end());
+        synchronized_loop_count_++;
+      }
+      pragma.edits.insert(pragma.edits.end(), loop.scan.edits.begin(), loop.scan.edits.end());
+
       // add private variables if needed
       std::vector<std::string> private_vars = identifyPrivateVariables(loop);
+      if (loop.transform.isFusion())
+      {
+        for (const auto& name : identifyPrivateVariables(loops[*loop.transform.fused_loop]))
+        {
+          if (std::find(private_vars.begin(), private_vars.end(), name) == private_vars.end())
+          {
+            private_vars.push_back(name);
+          }
+        }
+      }
       if (!private_vars.empty())
       {
         pragma.requires_private_vars = true;
@@ -41,6 +120,82 @@ void PragmaGenerator::generatePragmasForLoops(const std::vector<LoopInfo>& loops
         pragma.pragma_text += ")";
       }
 
+      // accumulate-only arrays combine per-thread copies: reduction(+:hist[0:256])
+      std::string sections;
+      for (const auto& reduction : loop.array_reductions)
+      {
+        if (reduction.strategy == ReductionStrategy::SECTION)
+        {
+          sections += (sections.empty() ? "" : ", ") + reduction.section();
+        }
+      }
+      if (!sections.empty())
+      {
+        pragma.pragma_text += " reduction(+:" + sections + ")";
+        array_reduction_count_++;
+      }
+
+      // a running sum hands each iteration its prefix through the scan directive
+      if (loop.scan.isScan())
+      {
+        pragma.pragma_text += " " + loop.scan.clause();
+        scan_count_++;
+      }
+
+      // lane counts and alignment only mean something on simd directives, while a hand-rolled
+      // counter needs linear(j:1) under any worksharing loop
+      if (pragma_type == PragmaType::SIMD || pragma_type == PragmaType::PARALLEL_FOR_SIMD)
+      {
+        pragma.pragma_text += loop.simd.clauses();
+        if (!loop.simd.peel_array.empty())
+        {
+          peel_reports_.emplace_back(loop.line_number, loop.simd.peelNote());
+        }
+      }
+      if (pragma_type != PragmaType::TASKLOOP && pragma_type != PragmaType::DOACROSS)
+      {
+        pragma.pragma_text += loop.simd.linearClause();
+      }
+
+      // a counter declared before a rewritten while loop is still live after it
+      if (loop.canonical.isCounted())
+      {
+        pragma.pragma_text += " lastprivate(" + loop.canonical.index_var + ")";
+        rewritten_loop_count_++;
+      }
+
+      // the same source may run on tiny and huge inputs, so size the team at runtime, and
+      // place it by what the loop waits on
+      if (pragma_type == PragmaType::PARALLEL_FOR || pragma_type == PragmaType::PARALLEL_FOR_SIMD ||
+          pragma_type == PragmaType::DOACROSS)
+      {
+        addThreadGuard(loop, pragma);
+        pragma.proc_bind = chooseProcBind(loop);
+        pragma.pragma_text += procBindClause(pragma);
+        if (!pragma.proc_bind.empty())
+        {
+          pragma.reasoning += describeProcBind(loop, pragma.proc_bind);
+        }
+        spread_count_ += pragma.proc_bind == "spread" ? 1 : 0;
+        close_count_ += pragma.proc_bind == "close" ? 1 : 0;
+        if (loop.roofline.isKnown())
+        {
+          roofline_reports_.emplace_back(loop.line_number, describeRoofline(loop));
+          pragma.reasoning += "; roofline: " + roofline_reports_.back().second;
+        }
+      }
+
+      // cancelled threads stop inside their own chunk, so chunks must be contiguous and fixed
+      if (loop.search.is_search)
+      {
+        pragma.pragma_text += " schedule(static)";
+        if (loop.search.counter_outside)
+        {
+          pragma.pragma_text += " lastprivate(" + loop.bounds.iterator_var + ")";
+        }
+        search_loop_count_++;
+      }
+
       // calculate confidence score
       if (confidence_scorer_)
       {
@@ -53,6 +208,12 @@ void PragmaGenerator::generatePragmasForLoops(const std::vector<LoopInfo>& loops
         pragma.confidence.reasoning = "Confidence scorer not available";
       }
 
+      inner_level_count_ += parallel_level && loop.depth > 0 ? 1 : 0;
+      loop_fusion_count_ += loop.transform.isFusion() ? 1 : 0;
+      loop_fission_count_ += loop.transform.isFission() ? 1 : 0;
+      doacross_count_ += pragma_type == PragmaType::DOACROSS ? 1 : 0;
+
+      pragma_for_loop_[loop_index] = generated_pragmas_.size();
       generated_pragmas_.push_back(pragma);
 
       // only show detailed info in verbose mode
@@ -61,7 +222,7 @@ void PragmaGenerator::generatePragmasForLoops(const std::vector<LoopInfo>& loops
         std::cout << "\nGenerated pragma for " << loop.loop_type << " loop at line "
                   << loop.line_number << ":\n";
         std::cout << "  " << pragma.pragma_text << "\n";
-        std::cout << "\nReasoning:\n  " << reasoning << "\n";
+        std::cout << "\nReasoning:\n  " << pragma.reasoning << "\n";
 
         if (confidence_scorer_)
         {
@@ -77,11 +238,20 @@ void PragmaGenerator::generatePragmasForLoops(const std::vector<LoopInfo>& loops
       if (verbose_)
       {
         std::cout << "\nNo pragma generated for " << loop.loop_type << " loop at line "
-                  << loop.line_number << " (has dependencies)\n";
+                  << loop.line_number
+                  << (loop.fused_into ? " (fused into the loop before it)\n"
+                                      : " (has dependencies)\n");
       }
     }
   }
 
+  if (prefetch_enabled_)
+  {
+    attachPrefetches(loops);
+  }
+  placeFirstTouch(loops);
+  fuseParallelRegions(loops);
+
   if (verbose_)
   {
     std::cout << "======================================================\n";
@@ -96,6 +266,132 @@ void PragmaGenerator::printCleanSummary() const
     return;
   }
 
+  if (fused_region_count_ > 0)
+  {
+    std::cout << "Fused " << fused_loop_count_ << " loops into " << fused_region_count_
+              << " parallel region" << (fused_region_count_ > 1 ? "s" : "") << ", removed "
+              << barriers_removed_ << " barrier" << (barriers_removed_ != 1 ? "s" : "") << ".\n";
+  }
+
+  if (rewritten_loop_count_ > 0)
+  {
+    std::cout << "Rewrote " << rewritten_loop_count_ << " while/do-while loop"
+              << (rewritten_loop_count_ > 1 ? "s" : "") << " into for loops.\n";
+  }
+
+  if (doacross_count_ > 0)
+  {
+    std::cout << "Pipelined " << doacross_count_ << " loop nest"
+              << (doacross_count_ > 1 ? "s" : "") << " with ordered(n) doacross.\n";
+  }
+
+  if (array_reduction_count_ > 0)
+  {
+    std::cout << "Reduced accumulate-only arrays in " << array_reduction_count_ << " loop"
+              << (array_reduction_count_ > 1 ? "s" : "") << " with reduction(+:array[0:n]).\n";
+  }
+
+  if (scan_count_ > 0)
+  {
+    std::cout << "Rewrote " << scan_count_ << " prefix computation" << (scan_count_ > 1 ? "s" : "")
+              << " as reduction(inscan) with a pre-5.0 fallback.\n";
+  }
+
+  if (search_loop_count_ > 0)
+  {
+    std::cout << "Cancelled " << search_loop_count_ << " search loop"
+              << (search_loop_count_ > 1 ? "s" : "")
+              << " at the first match; run with OMP_CANCELLATION=true to stop early.\n";
+  }
+
+  if (synchronized_loop_count_ > 0)
+  {
+    std::cout << "Isolated shared scalar updates under atomic/critical in "
+              << synchronized_loop_count_ << " loop" << (synchronized_loop_count_ > 1 ? "s" : "")
+              << ".\n";
+  }
+
+  if (!first_touch_arrays_.empty())
+  {
+    std::cout << "Placed first touch of";
+    for (size_t i = 0; i < first_touch_arrays_.size(); i++)
+    {
+      std::cout << (i > 0 ? ", " : " ") << first_touch_arrays_[i];
+    }
+    std::cout << ": initializers share a static schedule with the loops that use them.\n";
+  }
+  for (const auto& advice : first_touch_advice_)
+  {
+    std::cout << "  line " << advice.first << ": " << advice.second << "\n";
+  }
+
+  if (spread_count_ > 0 || close_count_ > 0)
+  {
+    std::cout << "Bound " << spread_count_ << " loop" << (spread_count_ != 1 ? "s" : "")
+              << " with proc_bind(spread) and " << close_count_ << " with proc_bind(close).\n";
+  }
+
+  if (guarded_loop_count_ > 0)
+  {
+    std::cout << "Guarded " << guarded_loop_count_ << " loop"
+              << (guarded_loop_count_ > 1 ? "s" : "")
+              << " with if()/num_threads() so small inputs stay serial.\n";
+  }
+
+  if (inner_level_count_ > 0)
+  {
+    std::cout << "Parallelized " << inner_level_count_ << " nest"
+              << (inner_level_count_ > 1 ? "s" : "")
+              << " at an inner level (outer loop serial or too short).\n";
+  }
+
+  if (!peel_reports_.empty())
+  {
+    std::cout << "Simd loops that would reach a 64-byte aligned main body after a peel loop:\n";
+    for (const auto& report : peel_reports_)
+    {
+      std::cout << "  line " << report.first << ": " << report.second << "\n";
+    }
+  }
+
+  if (!prefetch_reports_.empty())
+  {
+    std::cout << "Prefetched indirect gathers in " << prefetch_reports_.size() << " loop"
+              << (prefetch_reports_.size() > 1 ? "s" : "") << ":\n";
+    for (const auto& report : prefetch_reports_)
+    {
+      std::cout << "  line " << report.first << ": " << report.second << "\n";
+    }
+  }
+  if (!prefetch_advice_.empty())
+  {
+    std::cout << "Indirect gathers in serial nests, left for a manual prefetch:\n";
+    for (const auto& advice : prefetch_advice_)
+    {
+      std::cout << "  line " << advice.first << ": " << advice.second << "\n";
+    }
+  }
+
+  if (!roofline_reports_.empty())
+  {
+    char machine[128];
+    std::snprintf(machine, sizeof(machine), "%.0f GFLOP/s peak, %.1f GB/s %s, ridge at %.2f",
+                  machine_.peakGflops(), machine_.bandwidth_gbs,
+                  machine_.measured ? "measured" : "assumed", machine_.ridgePoint());
+    std::cout << "Roofline (" << machine << " flops/byte):\n";
+    for (const auto& report : roofline_reports_)
+    {
+      std::cout << "  line " << report.first << ": " << report.second << "\n";
+    }
+  }
+
+  if (loop_fusion_count_ > 0 || loop_fission_count_ > 0)
+  {
+    std::cout << "Fused " << loop_fusion_count_ << " loop pair"
+              << (loop_fusion_count_ != 1 ? "s" : "") << ", split " << loop_fission_count_
+              << " loop" << (loop_fission_count_ != 1 ? "s" : "") << " by fission.\n";
+  }
+
   // std::cout << "\nGenerated " << generated_pragmas_.size() << " OpenMP pragma";
   // if (generated_pragmas_.size() > 1)
   //   std::cout << "s";
@@ -118,6 +414,7 @@ void PragmaGenerator::printPragmaSummary() const
   int parallel_for_count = 0;
   int parallel_for_simd_count = 0;
   int simd_count = 0;
+  int taskloop_count = 0;
   double avg_confidence = 0.0;
 
   for (const auto& pragma : generated_pragmas_)
@@ -133,6 +430,11 @@ void PragmaGenerator::printPragmaSummary() const
     case PragmaType::SIMD:
       simd_count++;
       break;
+    case PragmaType::TASKLOOP:
+      taskloop_count++;
+      break;
+    case PragmaType::DOACROSS:
+      break;
     default:
       break;
     }
@@ -164,34 +466,103 @@ void PragmaGenerator::printPragmaSummary() const
   std::cout << "  #pragma omp parallel for: " << parallel_for_count << "\n";
   std::cout << "  #pragma omp parallel for simd: " << parallel_for_simd_count << "\n";
   std::cout << "  #pragma omp simd: " << simd_count << "\n";
+  std::cout << "  #pragma omp taskloop: " << taskloop_count << "\n";
+  std::cout << "  #pragma omp parallel for ordered(n): " << doacross_count_ << "\n";
+  std::cout << "  Fused parallel regions: " << fused_region_count_ << " (" << fused_loop_count_
+            << " loops, " << barriers_removed_ << " barriers removed)\n";
+  std::cout << "  While/do-while loops rewritten to for: " << rewritten_loop_count_ << "\n";
+  std::cout << "  Loop pairs fused: " << loop_fusion_count_ << "\n";
+  std::cout << "  Loops split by fission: " << loop_fission_count_ << "\n";
+  std::cout << "  Array-section reductions: " << array_reduction_count_ << "\n";
+  std::cout << "  Loops with atomic/critical updates: " << synchronized_loop_count_ << "\n";
+  std::cout << "  Prefix scans with omp scan: " << scan_count_ << "\n";
   std::cout << "  Average confidence: " << static_cast<int>(avg_confidence * 100) << "%\n";
 }
 
-PragmaType PragmaGenerator::determinePragmaType(const LoopInfo& loop)
+PragmaType PragmaGenerator::determinePragmaType(const LoopInfo& loop, bool parallel_level)
 {
+  // inscan needs a worksharing loop, and the rewritten body has to stay in one thread's order
+  if (loop.scan.isScan())
+  {
+    return PragmaType::PARALLEL_FOR;
+  }
+
+  // the nest carries dependences, but only at constant distances the sinks cover
+  if (loop.doacross.isPipelined())
+  {
+    return PragmaType::DOACROSS;
+  }
+
+  // only the split-off statements are parallel, the recurrence stays in its own loop
+  if (loop.transform.isFission())
+  {
+    return PragmaType::PARALLEL_FOR;
+  }
+
+  // a recurrence several iterations back still leaves that many lanes free
+  if (loop.has_dependencies && loop.safelen_covered && loop.loop_type == "for")
+  {
+    return PragmaType::SIMD;
+  }
+
   if (loop.has_dependencies)
   {
     return PragmaType::NO_PRAGMA;
   }
 
-  // be conservative with nested loops
-  if (loop.depth > 0)
+  // worksharing needs a for loop, so while loops must have been canonicalized
+  if (loop.loop_type != "for" && !loop.canonical.isCanonical())
   {
-    if (shouldUseSimd(loop))
+    return PragmaType::NO_PRAGMA;
+  }
+
+  // cancel needs its own worksharing loop and simd lanes can't leave early
+  if (loop.search.is_search)
+  {
+    return parallel_level ? PragmaType::PARALLEL_FOR : PragmaType::NO_PRAGMA;
+  }
+
+  // uneven iterations balance better as tasks than as static chunks, but taskloop takes
+  // no linear clause and its reductions need OpenMP 5.0 task reductions
+  if (parallel_level && loop.metrics.uneven_iterations &&
+      !loop.hasArrayReduction(ReductionStrategy::SECTION) && loop.simd.linear.empty())
+  {
+    return PragmaType::TASKLOOP;
+  }
+
+  // atomic updates and critical sections don't belong in simd lanes
+  bool atomic_updates = loop.hasArrayReduction(ReductionStrategy::ATOMIC) ||
+                        loop.shared_updates.isSynchronized();
+
+  // below or beside the nest's parallel level only vector lanes are left
+  if (!parallel_level)
+  {
+    if (shouldUseSimd(loop) && !atomic_updates)
     {
       return PragmaType::SIMD;
     }
     return PragmaType::NO_PRAGMA;
   }
 
-  // for outermost loops, consider SIMD + parallelization
-  if (shouldUseSimd(loop))
+  // at the parallel level, consider SIMD + parallelization
+  if (shouldUseSimd(loop) && !atomic_updates)
   {
     return PragmaType::PARALLEL_FOR_SIMD;
   }
   return PragmaType::PARALLEL_FOR;
 }
 
+PragmaType PragmaGenerator::fusedPragmaType(PragmaType type, const LoopInfo& absorbed)
+{
+  // the merged body has to suit both loops, and fusion only happens between top-level loops
+  PragmaType other = determinePragmaType(absorbed, true);
+  if (type == PragmaType::TASKLOOP || other == PragmaType::TASKLOOP)
+  {
+    return PragmaType::TASKLOOP;
+  }
+  return other == type ? type : PragmaType::PARALLEL_FOR;
+}
+
 std::string PragmaGenerator::generatePragmaText(PragmaType type, const LoopInfo& loop)
 {
   switch (type)
@@ -202,6 +573,13 @@ std::string PragmaGenerator::generatePragmaText(PragmaType type, const LoopInfo&
     return "#pragma omp parallel for simd";
   case PragmaType::SIMD:
     return "#pragma omp simd";
+  case PragmaType::TASKLOOP:
+    // nothing else runs in the single region, so nogroup would save nothing: the region's
+    // closing barrier waits for the tasks either way
+    return "#pragma omp parallel\n#pragma omp single\n#pragma omp taskloop " +
+           generateTaskloopClauses(loop);
+  case PragmaType::DOACROSS:
+    return "#pragma omp parallel for ordered(" + std::to_string(loop.doacross.depth) + ")";
   case PragmaType::NO_PRAGMA:
   default:
     return "";
@@ -215,53 +593,526 @@ std::string PragmaGenerator::generateReasoning(PragmaType type, const LoopInfo&
   {
   case PragmaType::PARALLEL_FOR:
     reason = "Loop has no dependencies and good parallelization potential";
+    if (loop.depth > 0)
+    {
+      reason += " (outermost independent, profitable level of its nest)";
+    }
+    if (!loop.simd.blocker.empty() && loop.child_loop_indices.empty() &&
+        !loop.has_dependencies && !loop.scan.isScan())
+    {
+      reason += " (no simd: " + loop.simd.blocker + ")";
+    }
     break;
   case PragmaType::PARALLEL_FOR_SIMD:
-    reason = "Loop has simple array operations suitable for both parallelization and vectorization";
+    reason = std::string(loop.depth > 0 ? "Outermost independent level of its nest" : "Loop") +
+             " has no dependencies and its unit-stride accesses vectorize in " +
+             std::to_string(loop.simd.simdlen) + " lanes of " +
+             std::to_string(loop.simd.element_bits) + " bits";
     break;
   case PragmaType::SIMD:
-    reason = "Inner loop with simple operations suitable for vectorization";
+    if (loop.safelen_covered)
+    {
+      reason = "Recurrence reaches back " + std::to_string(loop.simd.safelen) +
+               " iterations, so it can't run in parallel but up to that many lanes can";
+      break;
+    }
+    reason = "Inner loop whose unit-stride accesses vectorize in " +
+             std::to_string(loop.simd.simdlen) + " lanes of " +
+             std::to_string(loop.simd.element_bits) + " bits";
+    break;
+  case PragmaType::TASKLOOP:
+    reason = "Iterations do uneven amounts of work (~" +
+             std::to_string(static_cast<long long>(loop.metrics.iteration_cost)) +
+             " ops each, varying per iteration), so tasks balance better than a static schedule";
+    break;
+  case PragmaType::DOACROSS:
+    reason = "Nest carries dependences only at constant distances, so iterations run as a "
+             "doacross pipeline that waits on";
+    for (size_t k = 0; k < loop.doacross.sinks.size(); k++)
+    {
+      reason += k > 0 ? "," : "";
+      for (size_t d = 0; d < loop.doacross.sinks[k].size(); d++)
+      {
+        reason += (d > 0 ? " " : " (") + std::to_string(loop.doacross.sinks[k][d]);
+      }
+      reason += ")";
+    }
     break;
   case PragmaType::NO_PRAGMA:
   default:
     reason = "Loop has dependencies or is not suitable for parallelization";
     break;
   }
+
+  if (loop.canonical.form == CanonicalForm::POINTER_WALK)
+  {
+    reason += " (pointer walk rewritten as indexed for loop over " + loop.canonical.trip_count +
+              " elements)";
+  }
+  else if (loop.canonical.isCounted())
+  {
+    reason += " (counted " + loop.loop_type + " loop rewritten as for loop over " +
+              loop.canonical.index_var + ")";
+  }
+
+  if (loop.transform.kind != LoopTransformKind::NONE)
+  {
+    reason += " (" + loop.transform.justification + ")";
+  }
+
+  for (const auto& reduction : loop.array_reductions)
+  {
+    if (reduction.strategy == ReductionStrategy::SECTION)
+    {
+      reason += " (" + reduction.array_name + " reduced over " + reduction.section() + ": " +
+                reduction.justification + ")";
+    }
+    else if (reduction.strategy == ReductionStrategy::ATOMIC)
+    {
+      reason += " (" + reduction.array_name + " updated atomically: " + reduction.justification +
+                ")";
+    }
+  }
+
+  if (loop.scan.isScan())
+  {
+    reason += " (" + loop.scan.justification + ")";
+  }
+
+  if ((type == PragmaType::SIMD || type == PragmaType::PARALLEL_FOR_SIMD) &&
+      !loop.simd.peel_array.empty())
+  {
+    reason += " (" + loop.simd.peelNote() + ")";
+  }
+
+  if (!loop.simd.linear.empty() && type != PragmaType::TASKLOOP && type != PragmaType::DOACROSS)
+  {
+    reason += " (" + loop.simd.linear.front().first +
+              " advances by a fixed step each iteration, so it is linear rather than shared)";
+  }
+
+  if (loop.shared_updates.isSynchronized())
+  {
+    size_t critical = std::count_if(loop.shared_updates.sites.begin(),
+                                    loop.shared_updates.sites.end(), [](const SyncSite& site)
+                                    { return site.kind == SyncKind::CRITICAL; });
+    reason += " (";
+    for (size_t i = 0; i < loop.shared_updates.variables.size(); i++)
+    {
+      reason += (i > 0 ? ", " : "") + loop.shared_updates.variables[i];
+    }
+    reason += critical > 0 ? " updated under atomic/critical: " : " updated atomically: ";
+    reason += loop.shared_updates.justification + ")";
+  }
+
+  if (!loop.private_arrays.empty())
+  {
+    reason += " (";
+    for (size_t i = 0; i < loop.private_arrays.size(); i++)
+    {
+      reason += (i > 0 ? ", " : "") + loop.private_arrays[i];
+    }
+    reason += " fully rewritten before use in every iteration, so each thread gets a private copy)";
+  }
+
+  if (loop.search.is_search)
+  {
+    reason += " (first-match search: threads cancel on a hit and the lowest matching index wins;"
+              " run with OMP_CANCELLATION=true to stop early)";
+  }
   return reason;
 }
 
-bool PragmaGenerator::shouldUseSimd(const LoopInfo& loop)
+std::string PragmaGenerator::generateTaskloopClauses(const LoopInfo& loop) const
 {
-  // SIMD works best with simple array access + arithmetic
-  if (!hasSimpleArrayAccess(loop))
+  // enough iterations per task to amortize task creation
+  double cost = std::max(1.0, loop.metrics.iteration_cost);
+  long long grainsize = static_cast<long long>(std::ceil(kOpsPerTask / cost));
+  grainsize = std::max(1LL, std::min(kMaxGrainsize, grainsize));
+
+  // a known short loop would end up with too few tasks to balance, so split by count instead
+  if (loop.bounds.constant_trip_count)
   {
-    return false;
+    long long trips = *loop.bounds.constant_trip_count;
+    if ((trips + grainsize - 1) / grainsize < kMinTasks)
+    {
+      return "num_tasks(" + std::to_string(std::max(1LL, std::min(trips, kMinTasks))) + ")";
+    }
   }
 
-  // prefer arithmetic-heavy loops
-  if (loop.metrics.arithmetic_ops > loop.metrics.function_calls * 2)
+  return "grainsize(" + std::to_string(grainsize) + ")";
+}
+
+void PragmaGenerator::addThreadGuard(const LoopInfo& loop, GeneratedPragma& pragma)
+{
+  const std::string& trips = loop.bounds.trip_count_text;
+  if (trips.empty())
   {
-    return true;
+    return;
+  }
+
+  // iterations one thread needs before its share outweighs the fork/join
+  double cost = std::max(1.0, loop.metrics.iteration_cost);
+  long long grain = std::max(1LL, static_cast<long long>(std::ceil(kOpsPerThread / cost)));
+
+  // a literal bound that feeds any team needs no runtime check
+  bool literal = std::none_of(trips.begin(), trips.end(), [](char c)
+                              { return std::isalpha(static_cast<unsigned char>(c)) || c == '_'; });
+  if (literal && loop.bounds.constant_trip_count &&
+      *loop.bounds.constant_trip_count >= grain * kMaxUsefulThreads)
+  {
+    return;
   }
 
-  // inner loops with memory access are good SIMD candidates
-  if (isInnerLoop(loop) && loop.metrics.memory_accesses > 0)
+  bool simple = std::all_of(trips.begin(), trips.end(), [](char c)
+                            { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; });
+  std::string count = simple ? trips : "(" + trips + ")";
+  std::string serial = std::to_string(2 * grain); // at least two threads' worth
+  std::string share = grain == 1 ? count : count + " / " + std::to_string(grain);
+
+  pragma.thread_guard = count + " > " + serial;
+  pragma.thread_cap = count + " <= " + serial + " ? 1 : " + share +
+                      " < omp_get_max_threads() ? " + share + " : omp_get_max_threads()";
+  pragma.pragma_text += threadClauses(pragma);
+
+  // omp_get_max_threads() needs its declaration once per file, and a serial build has no
+  // omp.h, so it gets a one-thread stand-in instead
+  if (guarded_loop_count_ == 0)
   {
-    return true;
+    pragma.edits.emplace_back(1, LineEditKind::INSERT_BEFORE,
+                              "#ifdef _OPENMP\n#include <omp.h>\n#else\n"
+                              "#define omp_get_max_threads() 1\n#endif");
+  }
+  guarded_loop_count_++;
+}
+
+void PragmaGenerator::attachPrefetches(const std::vector<LoopInfo>& loops)
+{
+  for (size_t loop_index = 0; loop_index < loops.size(); loop_index++)
+  {
+    const LoopInfo& loop = loops[loop_index];
+    if (!loop.prefetch.isPlanned())
+    {
+      continue;
+    }
+
+    // bodies that fusion, fission or a scan rewrite have no stable line to insert after
+    if (loop.fused_into || loop.transform.isFusion() || loop.transform.isFission() ||
+        loop.scan.isScan())
+    {
+      continue;
+    }
+
+    // edits travel with a pragma, so a serial inner loop rides on its nest's pragma
+    std::optional<size_t> carrier;
+    for (std::optional<size_t> index = loop_index; index && !carrier;
+         index = loops[*index].parent_loop_index)
+    {
+      auto it = pragma_for_loop_.find(*index);
+      if (it != pragma_for_loop_.end())
+      {
+        carrier = it->second;
+      }
+    }
+
+    if (!carrier)
+    {
+      prefetch_advice_.emplace_back(loop.line_number,
+                                    loop.prefetch.note());
+      continue;
+    }
+
+    GeneratedPragma& pragma = generated_pragmas_[*carrier];
+    pragma.edits.insert(pragma.edits.end(), loop.prefetch.edits.begin(),
+                        loop.prefetch.edits.end());
+    prefetch_reports_.emplace_back(loop.line_number, loop.prefetch.note());
+  }
+}
+
+void PragmaGenerator::placeFirstTouch(const std::vector<LoopInfo>& loops)
+{
+  // initializer -> arrays it first touches, and the loop whose schedule it copies
+  std::map<size_t, std::pair<std::vector<std::string>, size_t>> matched;
+
+  for (size_t use = 0; use < loops.size(); use++)
+  {
+    auto use_pragma = pragma_for_loop_.find(use);
+    const LoopInfo& consumer = loops[use];
+    if (use_pragma == pragma_for_loop_.end() ||
+        !isWorksharing(generated_pragmas_[use_pragma->second].type) ||
+        consumer.bounds.trip_count_text.empty())
+    {
+      continue;
+    }
+
+    for (const auto& entry : consumer.partitioned_arrays)
+    {
+      const std::string& name = entry.first;
+      auto init = findFirstToucher(name, use, loops);
+      if (!init)
+      {
+        continue;
+      }
+
+      // same rows to the same threads needs the same iteration space on both sides
+      const LoopInfo& initializer = loops[*init];
+      auto owned = initializer.partitioned_arrays.find(name);
+      if (owned == initializer.partitioned_arrays.end() || !owned->second ||
+          initializer.bounds.trip_count_text != consumer.bounds.trip_count_text ||
+          initializer.bounds.start_text != consumer.bounds.start_text)
+      {
+        continue;
+      }
+
+      auto init_pragma = pragma_for_loop_.find(*init);
+      if (init_pragma == pragma_for_loop_.end() ||
+          !isWorksharing(generated_pragmas_[init_pragma->second].type))
+      {
+        first_touch_advice_.emplace_back(
+            initializer.line_number,
+            name + " is first written by a serial loop, so all its pages land on one socket "
+                   "before the parallel loop at line " +
+                std::to_string(consumer.line_number) + " reads them");
+        continue;
+      }
+
+      // an initializer feeding several loops follows the first of them
+      auto it = matched.find(*init);
+      if (it != matched.end() && it->second.second != use)
+      {
+        continue;
+      }
+      matched[*init].first.push_back(name);
+      matched[*init].second = use;
+      if (std::find(first_touch_arrays_.begin(), first_touch_arrays_.end(), name) ==
+          first_touch_arrays_.end())
+      {
+        first_touch_arrays_.push_back(name);
+      }
+    }
+  }
+
+  for (const auto& entry : matched)
+  {
+    GeneratedPragma& init = generated_pragmas_[pragma_for_loop_[entry.first]];
+    GeneratedPragma& use = generated_pragmas_[pragma_for_loop_[entry.second.second]];
+
+    // static chunks hand iteration i to the same thread in both loops, as long as both
+    // teams are the same size
+    for (GeneratedPragma* pragma : {&init, &use})
+    {
+      if (pragma->pragma_text.find("schedule(") == std::string::npos)
+      {
+        pragma->pragma_text += " schedule(static)";
+      }
+    }
+    eraseClause(init.pragma_text, threadClauses(init));
+    eraseClause(init.pragma_text, procBindClause(init));
+    init.thread_guard = use.thread_guard;
+    init.thread_cap = use.thread_cap;
+    init.proc_bind = use.proc_bind;
+    init.pragma_text += threadClauses(init) + procBindClause(init);
+
+    std::string names;
+    for (const auto& name : entry.second.first)
+    {
+      names += (names.empty() ? "" : ", ") + name;
+    }
+    init.reasoning += " (first touch of " + names + " follows the static schedule of the loop at "
+                      "line " + std::to_string(use.line_number) + ", so pages land near the "
+                      "threads that use them)";
+  }
+}
+
+std::optional<size_t> PragmaGenerator::findFirstToucher(const std::string& name, size_t use,
+                                                        const std::vector<LoopInfo>& loops) const
+{
+  const LoopInfo& consumer = loops[use];
+  for (size_t k = 0; k < use; k++)
+  {
+    const LoopInfo& loop = loops[k];
+    bool touches = std::any_of(loop.array_accesses.begin(), loop.array_accesses.end(),
+                               [&name](const ArrayAccess& access)
+                               { return access.array_name == name; });
+    if (loop.function_name != consumer.function_name || !touches)
+    {
+      continue;
+    }
+
+    // the earliest touch counts, through whichever loop sits beside the consumer
+    size_t level = k;
+    while (loops[level].parent_loop_index != consumer.parent_loop_index)
+    {
+      if (!loops[level].parent_loop_index)
+      {
+        return std::nullopt;
+      }
+      level = *loops[level].parent_loop_index;
+    }
+    return level;
+  }
+  return std::nullopt;
+}
+
+bool PragmaGenerator::isWorksharing(PragmaType type) const
+{
+  return type == PragmaType::PARALLEL_FOR || type == PragmaType::PARALLEL_FOR_SIMD;
+}
+
+std::string PragmaGenerator::chooseProcBind(const LoopInfo& loop) const
+{
+  switch (proc_bind_policy_)
+  {
+  case ProcBindPolicy::SPREAD:
+    return "spread";
+  case ProcBindPolicy::CLOSE:
+    return "close";
+  case ProcBindPolicy::MASTER:
+    return "master";
+  case ProcBindPolicy::NONE:
+    return "";
+  case ProcBindPolicy::AUTO:
+  default:
+    break;
+  }
+
+  // bandwidth-starved loops want every socket's memory controllers, compute-bound ones
+  // want their threads sharing caches
+  if (loop.metrics.iteration_accesses == 0.0)
+  {
+    return "";
+  }
+  return loop.metrics.isMemoryBound() ? "spread" : "close";
+}
+
+std::string PragmaGenerator::describeProcBind(const LoopInfo& loop, const std::string& bind) const
+{
+  if (proc_bind_policy_ != ProcBindPolicy::AUTO)
+  {
+    return " (proc_bind(" + bind + ") set on the command line)";
+  }
+
+  char intensity[32];
+  std::snprintf(intensity, sizeof(intensity), "%.2f", loop.metrics.arithmeticIntensity());
+  return loop.metrics.isMemoryBound()
+             ? " (memory-bound at " + std::string(intensity) +
+                   " ops per access, so threads spread across sockets for bandwidth)"
+             : " (compute-bound at " + std::string(intensity) +
+                   " ops per access, so threads stay close and share caches)";
+}
+
+std::string PragmaGenerator::describeRoofline(const LoopInfo& loop) const
+{
+  const RooflineEstimate& roofline = loop.roofline;
+  char text[160];
+  if (roofline.bytes <= 0.0)
+  {
+    std::snprintf(text, sizeof(text), "data stays in cache, compute-bound at %.1f GFLOP/s",
+                  roofline.attainableGflops(machine_, machine_.cores));
+    return text;
+  }
+  std::snprintf(text, sizeof(text), "%.2f flops/byte, %s at %.1f GFLOP/s, %u threads gain %.1fx",
+                roofline.intensity(),
+                roofline.isMemoryBound(machine_) ? "memory-bound" : "compute-bound",
+                roofline.attainableGflops(machine_, machine_.cores), machine_.cores,
+                roofline.threadSpeedup(machine_));
+  return text;
+}
+
+std::string PragmaGenerator::threadClauses(const GeneratedPragma& pragma) const
+{
+  if (pragma.thread_guard.empty())
+  {
+    return "";
+  }
+  return " if(" + pragma.thread_guard + ") num_threads(" + pragma.thread_cap + ")";
+}
+
+std::string PragmaGenerator::procBindClause(const GeneratedPragma& pragma) const
+{
+  return pragma.proc_bind.empty() ? "" : " proc_bind(" + pragma.proc_bind + ")";
+}
+
+void PragmaGenerator::eraseClause(std::string& text, const std::string& clause) const
+{
+  size_t at = clause.empty() ? std::string::npos : text.find(clause);
+  if (at != std::string::npos)
+  {
+    text.erase(at, clause.size());
+  }
+}
+
+bool PragmaGenerator::shouldUseSimd(const LoopInfo& loop)
+{
+  // the legality and payoff checks already ran over the body
+  return loop.simd.vectorizable;
+}
+
+void PragmaGenerator::chooseParallelLevels(size_t loop_index, const std::vector<LoopInfo>& loops)
+{
+  // a short outer loop gives way to a deeper level with real work, otherwise the outermost
+  // independent level keeps the team
+  const LoopInfo& loop = loops[loop_index];
+  if (isIndependentLevel(loop) &&
+      (isProfitableLevel(loop) || !hasProfitableLevelBelow(loop_index, loops)))
+  {
+    parallel_levels_.insert(loop_index);
+    return;
   }
 
+  // a serial time-step loop or an unprofitable one: look one level further in
+  for (size_t child : loop.child_loop_indices)
+  {
+    chooseParallelLevels(child, loops);
+  }
+}
+
+bool PragmaGenerator::hasProfitableLevelBelow(size_t loop_index,
+                                              const std::vector<LoopInfo>& loops) const
+{
+  for (size_t child : loops[loop_index].child_loop_indices)
+  {
+    if ((isIndependentLevel(loops[child]) && isProfitableLevel(loops[child])) ||
+        hasProfitableLevelBelow(child, loops))
+    {
+      return true;
+    }
+  }
   return false;
 }
 
-bool PragmaGenerator::hasSimpleArrayAccess(const LoopInfo& loop)
+bool PragmaGenerator::isIndependentLevel(const LoopInfo& loop) const
+{
+  // fission and doacross already account for the dependences they carry, and worksharing
+  // needs a for loop
+  bool for_form = loop.loop_type == "for" || loop.canonical.isCanonical();
+  return for_form &&
+         (!loop.has_dependencies || loop.transform.isFission() || loop.doacross.isPipelined());
+}
+
+bool PragmaGenerator::isProfitableLevel(const LoopInfo& loop) const
 {
-  // if loop is parallelizable and has array access, assume it's simple enough
-  return !loop.array_accesses.empty();
+  // unknown bounds are assumed big enough, a known short loop has to carry real work
+  if (!loop.bounds.constant_trip_count)
+  {
+    return true;
+  }
+  long long trips = *loop.bounds.constant_trip_count;
+  return trips >= kMinParallelTrips &&
+         static_cast<double>(trips) * loop.metrics.iteration_cost >= kOpsPerTask;
 }
 
-bool PragmaGenerator::isInnerLoop(const LoopInfo& loop)
+bool PragmaGenerator::isInsidePipelinedNest(const LoopInfo& loop,
+                                            const std::vector<LoopInfo>& loops) const
 {
-  return loop.depth > 0;
+  for (auto parent = loop.parent_loop_index; parent; parent = loops[*parent].parent_loop_index)
+  {
+    if (loops[*parent].doacross.isPipelined())
+    {
+      return true;
+    }
+  }
+  return false;
 }
 
 std::vector<std::string> PragmaGenerator::identifyPrivateVariables(const LoopInfo& loop)
@@ -285,7 +1136,221 @@ std::vector<std::string> PragmaGenerator::identifyPrivateVariables(const LoopInf
     }
   }
 
+  // work arrays declared before the loop but rewritten in full by every iteration
+  private_vars.insert(private_vars.end(), loop.private_arrays.begin(), loop.private_arrays.end());
+
   return private_vars;
 }
 
+void PragmaGenerator::fuseParallelRegions(const std::vector<LoopInfo>& loops)
+{
+  std::set<size_t> visited;
+
+  for (size_t i = 0; i < loops.size(); i++)
+  {
+    if (visited.count(i) || !isFusable(i, loops))
+    {
+      continue;
+    }
+
+    // follow the run of parallel loops that sit back to back in the same block
+    std::vector<size_t> chain = {i};
+    while (loops[lastFusedLoop(chain.back(), loops)].next_sibling_loop &&
+           isFusable(*loops[lastFusedLoop(chain.back(), loops)].next_sibling_loop, loops))
+    {
+      chain.push_back(*loops[lastFusedLoop(chain.back(), loops)].next_sibling_loop);
+    }
+    visited.insert(chain.begin(), chain.end());
+
+    if (chain.size() > 1)
+    {
+      emitFusedRegion(chain, loops);
+    }
+  }
+}
+
+bool PragmaGenerator::isFusable(size_t loop_index, const std::vector<LoopInfo>& loops) const
+{
+  auto it = pragma_for_loop_.find(loop_index);
+  if (it == pragma_for_loop_.end())
+  {
+    return false;
+  }
+
+  // cancel, pointer catch-up code, a split-off serial loop and a version-guarded scan need a
+  // region of their own
+  const LoopInfo& loop = loops[loop_index];
+  PragmaType type = generated_pragmas_[it->second].type;
+  return loop.depth == 0 && !loop.search.is_search && !loop.transform.isFission() &&
+         loop.canonical.form != CanonicalForm::POINTER_WALK && !loop.scan.isScan() &&
+         (type == PragmaType::PARALLEL_FOR || type == PragmaType::PARALLEL_FOR_SIMD);
+}
+
+void PragmaGenerator::emitFusedRegion(const std::vector<size_t>& chain,
+                                      const std::vector<LoopInfo>& loops)
+{
+  // nowait is safe while no loop since the last barrier touches what a later one writes,
+  // or writes what a later one touches. names only tell that apart when every store goes to
+  // a declared array or through a restrict pointer; two pointer parameters may be one buffer
+  std::vector<bool> needs_barrier(chain.size(), false);
+  std::set<std::string> pending_reads, pending_writes;
+  bool pending_opaque = false;
+
+  for (size_t k = 0; k < chain.size(); k++)
+  {
+    const LoopInfo& loop = loops[chain[k]];
+    std::set<std::string> reads, writes;
+    bool aliased_write = false;
+    collectFootprint(chain[k], loops, reads, writes, aliased_write);
+    bool opaque = loop.metrics.opaque_calls > 0 || aliased_write;
+
+    bool hazard = (opaque || pending_opaque) && k > 0;
+    for (const auto& name : writes)
+    {
+      hazard = hazard || pending_reads.count(name) || pending_writes.count(name);
+    }
+    for (const auto& name : reads)
+    {
+      hazard = hazard || pending_writes.count(name);
+    }
+
+    if (hazard)
+    {
+      needs_barrier[k - 1] = true;
+      pending_reads.clear();
+      pending_writes.clear();
+      pending_opaque = false;
+    }
+
+    pending_reads.insert(reads.begin(), reads.end());
+    pending_writes.insert(writes.begin(), writes.end());
+    pending_opaque = pending_opaque || opaque;
+  }
+
+  // the region forks when any of its loops is big enough, unless one always is
+  std::string region_guard;
+  for (size_t index : chain)
+  {
+    const std::string& guard = generated_pragmas_[pragma_for_loop_[index]].thread_guard;
+    if (guard.empty())
+    {
+      region_guard.clear();
+      break;
+    }
+    region_guard += (region_guard.empty() ? " if(" : " || ") + guard;
+  }
+  region_guard += region_guard.empty() ? "" : ")";
+
+  // one memory-bound loop is enough to want the threads spread over the sockets
+  std::string region_bind;
+  for (size_t index : chain)
+  {
+    const std::string& bind = generated_pragmas_[pragma_for_loop_[index]].proc_bind;
+    region_bind = region_bind.empty() || bind == "spread" ? bind : region_bind;
+  }
+  region_guard += region_bind.empty() ? "" : " proc_bind(" + region_bind + ")";
+
+  // the region's closing barrier covers the last loop
+  size_t kept_barriers = 1;
+  for (size_t k = 0; k < chain.size(); k++)
+  {
+    const LoopInfo& loop = loops[chain[k]];
+    GeneratedPragma& pragma = generated_pragmas_[pragma_for_loop_[chain[k]]];
+
+    const std::string combined = "#pragma omp parallel for";
+    pragma.pragma_text = "#pragma omp for" + pragma.pragma_text.substr(combined.size());
+
+    // if(), num_threads() and proc_bind() belong to the region, not to its worksharing loops
+    eraseClause(pragma.pragma_text, threadClauses(pragma));
+    eraseClause(pragma.pragma_text, procBindClause(pragma));
+    if (needs_barrier[k] && k + 1 < chain.size())
+    {
+      kept_barriers++;
+    }
+    else
+    {
+      pragma.pragma_text += " nowait";
+    }
+
+    pragma.reasoning += " (shares a parallel region with " + std::to_string(chain.size() - 1) +
+                        " adjacent loop" + (chain.size() > 2 ? "s" : "") + ")";
+
+    if (k == 0)
+    {
+      pragma.edits.emplace_back(loop.line_number, LineEditKind::INSERT_BEFORE,
+                                loop.indentation + "#pragma omp parallel" + region_guard + "\n" +
+                                    loop.indentation + "{");
+    }
+    if (k + 1 == chain.size())
+    {
+      pragma.edits.emplace_back(loops[lastFusedLoop(chain[k], loops)].end_line_number,
+                                LineEditKind::INSERT_AFTER, loop.indentation + "}");
+    }
+  }
+
+  fused_region_count_++;
+  fused_loop_count_ += chain.size();
+  barriers_removed_ += chain.size() - kept_barriers;
+
+  if (verbose_)
+  {
+    std::cout << "\nFused " << chain.size() << " loops starting at line "
+              << loops[chain.front()].line_number << " into one parallel region ("
+              << chain.size() - kept_barriers << " barriers removed)\n";
+  }
+}
+
+void PragmaGenerator::collectFootprint(size_t loop_index, const std::vector<LoopInfo>& loops,
+                                       std::set<std::string>& reads,
+                                       std::set<std::string>& writes, bool& aliased_write) const
+{
+  const LoopInfo& loop = loops[loop_index];
+
+  for (const auto& access : loop.array_accesses)
+  {
+    (access.is_write ? writes : reads).insert(access.array_name);
+    aliased_write = aliased_write || (access.is_write && !access.distinct_base);
+  }
+
+  // lastprivate stores the counter of a rewritten while loop back after the last iteration
+  if (loop.canonical.isCounted())
+  {
+    writes.insert(loop.canonical.index_var);
+  }
+
+  // shared scalars only, locals and counters are private to each thread
+  for (const auto& var_pair : loop.variables)
+  {
+    const auto& var = var_pair.second;
+    if (var.isInductionVariable() || var.scope == VariableScope::LOOP_LOCAL)
+    {
+      continue;
+    }
+    if (var.hasWrites())
+    {
+      writes.insert(var.name);
+    }
+    if (var.hasReads())
+    {
+      reads.insert(var.name);
+    }
+  }
+
+  for (size_t child : loop.child_loop_indices)
+  {
+    collectFootprint(child, loops, reads, writes, aliased_write);
+  }
+  if (loop.transform.isFusion())
+  {
+    collectFootprint(*loop.transform.fused_loop, loops, reads, writes, aliased_write);
+  }
+}
+
+size_t PragmaGenerator::lastFusedLoop(size_t loop_index, const std::vector<LoopInfo>& loops) const
+{
+  // a loop that absorbed its sibling ends where the sibling ended
+  const LoopInfo& loop = loops[loop_index];
+  return loop.transform.isFusion() ? *loop.transform.fused_loop : loop_index;
+}
+
 } // namespace paralyze
\ No newline at end of file
@@ -122,8 +122,6 @@ std::string PragmaLocationMapper::getIndentationAtLocation(SourceLocation loc)
     return "";
   }
 
-  SourceLocation line_start = moveToStartOfLine(loc);
-
   // TODO: actually read the source file to get real indentation
   return "    ";
 }
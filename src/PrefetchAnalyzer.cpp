@@ -0,0 +1,332 @@
+#include "analyzer/PrefetchAnalyzer.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <iostream>
+
+using namespace clang;
+
+namespace paralyze
+{
+
+void PrefetchAnalyzer::analyzeLoop(ForStmt* forLoop, LoopInfo& loop)
+{
+  // only the innermost loop issues the gathers, and j + d has to mean d iterations ahead
+  const std::string& iterator = loop.bounds.iterator_var;
+  auto* body = dyn_cast_or_null<CompoundStmt>(forLoop->getBody());
+  if (!loop.child_loop_indices.empty() || iterator.empty() || loop.bounds.step != 1 || !body ||
+      body->body_empty())
+  {
+    return;
+  }
+
+  // j < hi, j <= hi or j != hi bounds the look-ahead load of col[j + d]
+  auto* cond = forLoop->getCond()
+                   ? dyn_cast<BinaryOperator>(forLoop->getCond()->IgnoreParenImpCasts())
+                   : nullptr;
+  if (!cond || !cond->isComparisonOp())
+  {
+    return;
+  }
+  auto isIterator = [&iterator](const Expr* expr)
+  {
+    auto* ref = dyn_cast<DeclRefExpr>(expr->IgnoreParenImpCasts());
+    return ref && ref->getDecl()->getNameAsString() == iterator;
+  };
+  BinaryOperatorKind relation = cond->getOpcode();
+  const Expr* limit = cond->getRHS();
+  if (!isIterator(cond->getLHS()))
+  {
+    if (!isIterator(cond->getRHS()))
+    {
+      return;
+    }
+    relation = BinaryOperator::reverseComparisonOp(relation);
+    limit = cond->getLHS();
+  }
+  if (relation != BO_LT && relation != BO_LE && relation != BO_NE)
+  {
+    return;
+  }
+
+  std::set<const ValueDecl*> written;
+  collectWritten(body, written);
+  std::string limit_text = source_.getWrittenText(limit->getSourceRange());
+  if (limit_text.empty() || limit->HasSideEffects(*context_) || mentions(limit, iterator) ||
+      !isInvariant(limit, iterator, written))
+  {
+    return;
+  }
+  if (limit_text.find_first_of("?,=&|") != std::string::npos)
+  {
+    limit_text = "(" + limit_text + ")";
+  }
+
+  // the prefetches go on their own lines right after the opening brace
+  unsigned brace_line = source_.getLine(body->getLBracLoc());
+  unsigned first_line = source_.getLine((*body->body_begin())->getBeginLoc());
+  if (brace_line == 0 || first_line <= brace_line)
+  {
+    return;
+  }
+
+  std::vector<Gather> gathers;
+  collectGathers(body, iterator, false, gathers);
+
+  unsigned distance = prefetchDistance(loop);
+  std::string ahead = std::to_string(distance);
+  std::string guard = "if (" + iterator + " + " + ahead + (relation == BO_LE ? " <= " : " < ") +
+                      limit_text + ") ";
+  std::string indentation = source_.getIndentation(first_line);
+
+  PrefetchPlan plan;
+  plan.distance = distance;
+  std::string text;
+  for (const Gather& gather : gathers)
+  {
+    std::string access = source_.getText(gather.element->getSourceRange());
+    if (access.empty() || !source_.isRewritable(gather.element->getSourceRange()) ||
+        gather.element->HasSideEffects(*context_) ||
+        !isInvariant(gather.element, iterator, written) ||
+        std::find(plan.accesses.begin(), plan.accesses.end(), access) != plan.accesses.end())
+    {
+      continue;
+    }
+
+    // a store target is fetched for writing so the line arrives exclusive
+    plan.accesses.push_back(access);
+    text += (text.empty() ? "" : "\n") + indentation + guard + "__builtin_prefetch(&" +
+            shiftIterator(access, iterator, distance) + (gather.is_write ? ", 1" : "") + ");";
+    if (plan.accesses.size() == kMaxPrefetches)
+    {
+      break;
+    }
+  }
+  if (plan.accesses.empty())
+  {
+    return;
+  }
+
+  plan.edits.emplace_back(brace_line, LineEditKind::INSERT_AFTER, text);
+  loop.prefetch = plan;
+
+  if (verbose_)
+  {
+    std::cout << "  Prefetch at line " << loop.line_number << ": " << plan.note() << " (~"
+              << static_cast<long long>(loop.metrics.iteration_cost) << " ops per iteration)\n";
+  }
+}
+
+unsigned PrefetchAnalyzer::prefetchDistance(const LoopInfo& loop) const
+{
+  // far enough ahead that the line lands just as the iteration that needs it starts
+  double cost = std::max(1.0, loop.metrics.iteration_cost);
+  unsigned distance = static_cast<unsigned>(std::ceil(kMissLatencyOps / cost));
+
+  // the guard drops the last d iterations' prefetches, so short rows want a short reach
+  double trips = loop.bounds.constant_trip_count
+                     ? static_cast<double>(*loop.bounds.constant_trip_count)
+                     : LoopMetrics::kAssumedTripCount;
+  unsigned reach = static_cast<unsigned>(trips / 2);
+  return std::max(kMinDistance, std::min({distance, reach, kMaxDistance}));
+}
+
+void PrefetchAnalyzer::collectGathers(const Stmt* stmt, const std::string& iterator,
+                                      bool is_write, std::vector<Gather>& gathers) const
+{
+  if (!stmt)
+  {
+    return;
+  }
+
+  if (auto* element = dyn_cast<ArraySubscriptExpr>(stmt))
+  {
+    if (isIndirect(element, iterator))
+    {
+      gathers.push_back(Gather{element, is_write});
+    }
+
+    // x[col[idx[j]]] also gathers col; a[i][j] is one access, not two
+    const Expr* base = element;
+    while (auto* level = dyn_cast<ArraySubscriptExpr>(base->IgnoreParenImpCasts()))
+    {
+      collectGathers(level->getIdx(), iterator, false, gathers);
+      base = level->getBase();
+    }
+    return;
+  }
+
+  if (auto* op = dyn_cast<BinaryOperator>(stmt))
+  {
+    if (op->isAssignmentOp())
+    {
+      collectGathers(op->getLHS(), iterator, true, gathers);
+      collectGathers(op->getRHS(), iterator, false, gathers);
+      return;
+    }
+  }
+  else if (auto* unary = dyn_cast<UnaryOperator>(stmt))
+  {
+    if (unary->isIncrementDecrementOp())
+    {
+      collectGathers(unary->getSubExpr(), iterator, true, gathers);
+      return;
+    }
+  }
+
+  bool passes_write = isa<ParenExpr>(stmt) || isa<ImplicitCastExpr>(stmt);
+  for (const Stmt* child : stmt->children())
+  {
+    collectGathers(child, iterator, passes_write && is_write, gathers);
+  }
+}
+
+bool PrefetchAnalyzer::isIndirect(const ArraySubscriptExpr* element,
+                                  const std::string& iterator) const
+{
+  // some subscript of the element holds a load indexed by the iterator
+  std::vector<const Stmt*> pending;
+  const Expr* base = element;
+  while (auto* level = dyn_cast<ArraySubscriptExpr>(base->IgnoreParenImpCasts()))
+  {
+    pending.push_back(level->getIdx());
+    base = level->getBase();
+  }
+
+  while (!pending.empty())
+  {
+    const Stmt* stmt = pending.back();
+    pending.pop_back();
+    if (!stmt)
+    {
+      continue;
+    }
+    if (auto* load = dyn_cast<ArraySubscriptExpr>(stmt))
+    {
+      if (mentions(load->getIdx(), iterator))
+      {
+        return true;
+      }
+    }
+    for (const Stmt* child : stmt->children())
+    {
+      pending.push_back(child);
+    }
+  }
+  return false;
+}
+
+bool PrefetchAnalyzer::isInvariant(const Stmt* stmt, const std::string& iterator,
+                                   const std::set<const ValueDecl*>& written) const
+{
+  if (!stmt)
+  {
+    return true;
+  }
+  if (auto* ref = dyn_cast<DeclRefExpr>(stmt))
+  {
+    return ref->getDecl()->getNameAsString() == iterator || written.count(ref->getDecl()) == 0;
+  }
+  for (const Stmt* child : stmt->children())
+  {
+    if (!isInvariant(child, iterator, written))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void PrefetchAnalyzer::collectWritten(const Stmt* stmt,
+                                      std::set<const ValueDecl*>& written) const
+{
+  if (!stmt)
+  {
+    return;
+  }
+
+  // scalars and pointers the body reassigns; stores into elements don't move addresses
+  const Expr* target = nullptr;
+  if (auto* op = dyn_cast<BinaryOperator>(stmt))
+  {
+    target = op->isAssignmentOp() ? op->getLHS() : nullptr;
+  }
+  else if (auto* unary = dyn_cast<UnaryOperator>(stmt))
+  {
+    target = unary->isIncrementDecrementOp() || unary->getOpcode() == UO_AddrOf
+                 ? unary->getSubExpr()
+                 : nullptr;
+  }
+  if (target)
+  {
+    if (auto* ref = dyn_cast<DeclRefExpr>(target->IgnoreParenImpCasts()))
+    {
+      written.insert(ref->getDecl());
+    }
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    collectWritten(child, written);
+  }
+}
+
+bool PrefetchAnalyzer::mentions(const Stmt* stmt, const std::string& name) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+  if (auto* ref = dyn_cast<DeclRefExpr>(stmt))
+  {
+    return ref->getDecl()->getNameAsString() == name;
+  }
+  for (const Stmt* child : stmt->children())
+  {
+    if (mentions(child, name))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string PrefetchAnalyzer::shiftIterator(const std::string& text, const std::string& iterator,
+                                            unsigned distance) const
+{
+  // col[j] -> col[j + 16], col[2 * j] -> col[2 * (j + 16)]
+  auto isWord = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+  std::string shifted = iterator + " + " + std::to_string(distance);
+  std::string result;
+  size_t i = 0;
+  while (i < text.size())
+  {
+    if (!isWord(text[i]))
+    {
+      result += text[i++];
+      continue;
+    }
+    size_t end = i;
+    while (end < text.size() && isWord(text[end]))
+    {
+      end++;
+    }
+    std::string word = text.substr(i, end - i);
+    if (word != iterator)
+    {
+      result += word;
+    }
+    else
+    {
+      size_t before = text.find_last_not_of(' ', i == 0 ? std::string::npos : i - 1);
+      size_t after = text.find_first_not_of(' ', end);
+      bool alone = i > 0 && before != std::string::npos && text[before] == '[' &&
+                   after != std::string::npos && text[after] == ']';
+      result += alone ? shifted : "(" + shifted + ")";
+    }
+    i = end;
+  }
+  return result;
+}
+
+} // namespace paralyze
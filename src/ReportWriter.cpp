@@ -0,0 +1,259 @@
+#include "analyzer/ReportWriter.h"
+#include <cmath>
+#include <cstdio>
+
+namespace paralyze
+{
+
+void ReportWriter::begin(const MachineModel& machine)
+{
+  first_loop_ = true;
+  if (format_ == ReportFormat::SARIF)
+  {
+    // serial loops are what a dashboard should surface, parallel ones are informational
+    out_ << "{\"$schema\": \"https://json.schemastore.org/sarif-2.1.0.json\",\n"
+         << " \"version\": \"2.1.0\",\n"
+         << " \"runs\": [{\n"
+         << "  \"tool\": {\"driver\": {\"name\": \"paralyze\", \"version\": \"1.0.0\", "
+         << "\"rules\": [\n"
+         << "   {\"id\": \"parallel-loop\", \"shortDescription\": {\"text\": "
+         << "\"Loop can run in parallel\"}, \"defaultConfiguration\": {\"level\": \"note\"}},\n"
+         << "   {\"id\": \"serial-loop\", \"shortDescription\": {\"text\": "
+         << "\"Loop must stay serial\"}, \"defaultConfiguration\": {\"level\": \"warning\"}}]}},\n"
+         << "  \"artifacts\": [{\"location\": {\"uri\": " << quote(file_) << "}}],\n"
+         << "  \"results\": [";
+    return;
+  }
+
+  out_ << "{\"tool\": \"paralyze\", \"version\": \"1.0.0\", \"file\": " << quote(file_) << ",\n"
+       << " \"machine\": {\"cores\": " << machine.cores << ", \"peak_gflops\": ";
+  writeNumber(machine.peakGflops());
+  out_ << ", \"bandwidth_gbs\": ";
+  writeNumber(machine.bandwidth_gbs);
+  out_ << ", \"measured\": " << (machine.measured ? "true" : "false") << "},\n"
+       << " \"loops\": [";
+}
+
+void ReportWriter::writeLoop(size_t index, const std::vector<LoopInfo>& loops,
+                             const GeneratedPragma* pragma, const MachineModel& machine)
+{
+  // one line per loop straight to the stream, no document is built up in memory
+  out_ << (first_loop_ ? "\n" : ",\n");
+  first_loop_ = false;
+
+  const LoopInfo& loop = loops[index];
+  if (format_ == ReportFormat::SARIF)
+  {
+    bool parallel = pragma && pragma->type != PragmaType::NO_PRAGMA;
+    std::string message = parallel ? pragma->pragma_text : "Loop stays serial";
+    if (!parallel && !loop.blocking_factors.empty())
+    {
+      message += ": " + loop.blocking_factors.front();
+    }
+    out_ << "   {\"ruleId\": \"" << (parallel ? "parallel-loop" : "serial-loop")
+         << "\", \"level\": \"" << (parallel ? "note" : "warning") << "\", \"message\": {\"text\": "
+         << quote(message) << "}, \"locations\": [{\"physicalLocation\": {\"artifactLocation\": "
+         << "{\"uri\": " << quote(file_) << "}, \"region\": {\"startLine\": " << loop.line_number;
+    if (loop.end_line_number >= loop.line_number)
+    {
+      out_ << ", \"endLine\": " << loop.end_line_number;
+    }
+    out_ << "}}}], \"properties\": {";
+    writeLoopFields(index, loops, pragma, machine);
+    out_ << "}}";
+  }
+  else
+  {
+    out_ << "  {";
+    writeLoopFields(index, loops, pragma, machine);
+    out_ << "}";
+  }
+  out_.flush();
+}
+
+void ReportWriter::end()
+{
+  out_ << (first_loop_ ? "]" : "\n ]");
+  if (format_ == ReportFormat::SARIF)
+  {
+    out_ << "}]";
+  }
+  out_ << "}\n";
+  out_.flush();
+}
+
+void ReportWriter::writeLoopFields(size_t index, const std::vector<LoopInfo>& loops,
+                                   const GeneratedPragma* pragma, const MachineModel& machine)
+{
+  const LoopInfo& loop = loops[index];
+  out_ << "\"id\": " << loopId(index) << ", \"function\": " << quote(loop.function_name)
+       << ", \"line\": " << loop.line_number << ", \"end_line\": " << loop.end_line_number
+       << ", \"type\": " << quote(loop.loop_type) << ", \"depth\": " << loop.depth
+       << ", \"parent\": " << (loop.parent_loop_index ? loopId(*loop.parent_loop_index) : "null")
+       << ", \"children\": [";
+  for (size_t i = 0; i < loop.child_loop_indices.size(); i++)
+  {
+    out_ << (i ? ", " : "") << loopId(loop.child_loop_indices[i]);
+  }
+  out_ << "]";
+
+  out_ << ", \"iterator\": " << quote(loop.bounds.iterator_var) << ", \"trip_count\": ";
+  if (loop.bounds.constant_trip_count)
+  {
+    out_ << *loop.bounds.constant_trip_count;
+  }
+  else
+  {
+    out_ << "null";
+  }
+  out_ << ", \"trip_count_expr\": "
+       << (loop.bounds.trip_count_text.empty() ? "null" : quote(loop.bounds.trip_count_text));
+
+  out_ << ", \"parallelizable\": " << (loop.isParallelizable() ? "true" : "false")
+       << ", \"dependences\": ";
+  writeStrings(loop.blocking_factors);
+
+  out_ << ", \"function_calls\": [";
+  for (size_t i = 0; i < loop.detected_function_calls.size(); i++)
+  {
+    bool safe = i < loop.function_call_safety.size() && loop.function_call_safety[i];
+    out_ << (i ? ", " : "") << "{\"name\": " << quote(loop.detected_function_calls[i])
+         << ", \"safe\": " << (safe ? "true" : "false") << "}";
+  }
+  out_ << "]";
+
+  if (loop.roofline.isKnown())
+  {
+    out_ << ", \"roofline\": {\"flops\": ";
+    writeNumber(loop.roofline.flops);
+    out_ << ", \"bytes\": ";
+    writeNumber(loop.roofline.bytes);
+    out_ << ", \"intensity\": ";
+    writeNumber(loop.roofline.intensity());
+    out_ << ", \"memory_bound\": " << (loop.roofline.isMemoryBound(machine) ? "true" : "false")
+         << "}";
+  }
+
+  out_ << ", \"pragma\": ";
+  if (pragma && pragma->type != PragmaType::NO_PRAGMA)
+  {
+    writePragma(*pragma);
+  }
+  else
+  {
+    out_ << "null";
+  }
+}
+
+void ReportWriter::writePragma(const GeneratedPragma& pragma)
+{
+  const ConfidenceScore& confidence = pragma.confidence;
+  out_ << "{\"text\": " << quote(pragma.pragma_text) << ", \"kind\": \""
+       << pragmaKind(pragma.type) << "\", \"reasoning\": " << quote(pragma.reasoning)
+       << ", \"confidence\": {\"score\": ";
+  writeNumber(confidence.numerical_score);
+  out_ << ", \"level\": \"" << confidenceLevel(confidence.level) << "\", \"positive\": ";
+  writeStrings(confidence.positive_factors);
+  out_ << ", \"negative\": ";
+  writeStrings(confidence.negative_factors);
+  out_ << "}}";
+}
+
+void ReportWriter::writeStrings(const std::vector<std::string>& values)
+{
+  out_ << "[";
+  for (size_t i = 0; i < values.size(); i++)
+  {
+    out_ << (i ? ", " : "") << quote(values[i]);
+  }
+  out_ << "]";
+}
+
+void ReportWriter::writeNumber(double value)
+{
+  // JSON has no inf or nan
+  if (!std::isfinite(value))
+  {
+    out_ << "null";
+    return;
+  }
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%.4g", value);
+  out_ << buffer;
+}
+
+std::string ReportWriter::quote(const std::string& text)
+{
+  std::string result = "\"";
+  for (char c : text)
+  {
+    switch (c)
+    {
+    case '"':
+      result += "\\\"";
+      break;
+    case '\\':
+      result += "\\\\";
+      break;
+    case '\n':
+      result += "\\n";
+      break;
+    case '\t':
+      result += "\\t";
+      break;
+    case '\r':
+      result += "\\r";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20)
+      {
+        char escaped[8];
+        std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+        result += escaped;
+      }
+      else
+      {
+        result += c;
+      }
+    }
+  }
+  return result + "\"";
+}
+
+const char* ReportWriter::pragmaKind(PragmaType type)
+{
+  switch (type)
+  {
+  case PragmaType::PARALLEL_FOR:
+    return "parallel_for";
+  case PragmaType::PARALLEL_FOR_SIMD:
+    return "parallel_for_simd";
+  case PragmaType::SIMD:
+    return "simd";
+  case PragmaType::TASKLOOP:
+    return "taskloop";
+  case PragmaType::DOACROSS:
+    return "doacross";
+  default:
+    return "none";
+  }
+}
+
+const char* ReportWriter::confidenceLevel(ConfidenceLevel level)
+{
+  switch (level)
+  {
+  case ConfidenceLevel::VERY_HIGH:
+    return "very_high";
+  case ConfidenceLevel::HIGH:
+    return "high";
+  case ConfidenceLevel::MEDIUM:
+    return "medium";
+  case ConfidenceLevel::LOW:
+    return "low";
+  default:
+    return "very_low";
+  }
+}
+
+} // namespace paralyze
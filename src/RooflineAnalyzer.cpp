@@ -0,0 +1,371 @@
+#include "analyzer/RooflineAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+
+using namespace clang;
+
+namespace paralyze
+{
+
+void RooflineAnalyzer::analyzeLoop(size_t index, std::vector<LoopInfo>& loops)
+{
+  LoopInfo& loop = loops[index];
+  Walk state{loops, index, {Level{loop.bounds.iterator_var, 1.0}}, {}};
+  walkLoopBody(loop.stmt, state);
+  loop.roofline = estimate(state);
+
+  if (verbose_ && loop.roofline.isKnown())
+  {
+    std::cout << "  Roofline at line " << loop.line_number << ": ~"
+              << static_cast<long long>(loop.roofline.flops) << " flops and "
+              << static_cast<long long>(loop.roofline.bytes) << " bytes per iteration over "
+              << loop.roofline.streams << " streams";
+    if (loop.roofline.resident_bytes > 0.0)
+    {
+      std::cout << ", " << static_cast<long long>(loop.roofline.resident_bytes)
+                << " bytes reused from cache";
+    }
+    std::cout << "\n";
+  }
+}
+
+bool RooflineAnalyzer::walkLoopBody(const Stmt* stmt, Walk& state) const
+{
+  // the condition runs every iteration too, the increment only moves the iterator
+  if (auto* forLoop = dyn_cast<ForStmt>(stmt))
+  {
+    walk(forLoop->getCond(), state, false, false);
+    walk(forLoop->getBody(), state, false, false);
+    return true;
+  }
+  if (auto* whileLoop = dyn_cast<WhileStmt>(stmt))
+  {
+    walk(whileLoop->getCond(), state, false, false);
+    walk(whileLoop->getBody(), state, false, false);
+    return true;
+  }
+  if (auto* doLoop = dyn_cast<DoStmt>(stmt))
+  {
+    walk(doLoop->getBody(), state, false, false);
+    walk(doLoop->getCond(), state, false, false);
+    return true;
+  }
+  return false;
+}
+
+void RooflineAnalyzer::walk(const Stmt* stmt, Walk& state, bool is_write, bool in_subscript) const
+{
+  if (!stmt)
+  {
+    return;
+  }
+
+  if (isa<ForStmt>(stmt) || isa<WhileStmt>(stmt) || isa<DoStmt>(stmt))
+  {
+    const LoopInfo* nested = findLoop(stmt, state.root, state.loops);
+    double trips = nested && nested->bounds.constant_trip_count
+                       ? static_cast<double>(*nested->bounds.constant_trip_count)
+                       : LoopMetrics::kAssumedTripCount;
+    state.levels.push_back(Level{nested ? nested->bounds.iterator_var : "", trips});
+    walkLoopBody(stmt, state);
+    state.levels.pop_back();
+    return;
+  }
+
+  if (auto* element = dyn_cast<ArraySubscriptExpr>(stmt))
+  {
+    recordTouch(element, state, is_write);
+    return;
+  }
+
+  if (auto* op = dyn_cast<BinaryOperator>(stmt))
+  {
+    bool arithmetic = !in_subscript && op->getType()->isArithmeticType();
+    if (op->isAssignmentOp())
+    {
+      BinaryOperatorKind kind = op->getOpcode();
+      if (arithmetic && (kind == BO_AddAssign || kind == BO_SubAssign || kind == BO_MulAssign ||
+                         kind == BO_DivAssign || kind == BO_RemAssign))
+      {
+        state.flops += repeats(state);
+      }
+      walk(op->getLHS(), state, true, in_subscript);
+      walk(op->getRHS(), state, false, in_subscript);
+      return;
+    }
+    if (arithmetic && (op->isAdditiveOp() || op->isMultiplicativeOp()))
+    {
+      state.flops += repeats(state);
+    }
+  }
+  else if (auto* unary = dyn_cast<UnaryOperator>(stmt))
+  {
+    if (unary->isIncrementDecrementOp())
+    {
+      walk(unary->getSubExpr(), state, true, in_subscript);
+      return;
+    }
+  }
+  else if (auto* call = dyn_cast<CallExpr>(stmt))
+  {
+    // sqrt, exp and friends are a handful of flops each
+    if (!in_subscript && call->getType()->isArithmeticType())
+    {
+      state.flops += LoopMetrics::kCallCost * repeats(state);
+    }
+  }
+
+  // only parentheses and implicit conversions keep the store target
+  bool passes_write = isa<ParenExpr>(stmt) || isa<ImplicitCastExpr>(stmt);
+  for (const Stmt* child : stmt->children())
+  {
+    walk(child, state, passes_write && is_write, in_subscript);
+  }
+}
+
+void RooflineAnalyzer::recordTouch(const ArraySubscriptExpr* element, Walk& state,
+                                   bool is_write) const
+{
+  // a[i][j] is one access to a, not one to a[i] and another to a[i][j]
+  std::vector<const Expr*> subscripts;
+  const Expr* base = element;
+  while (auto* level = dyn_cast<ArraySubscriptExpr>(base->IgnoreParenImpCasts()))
+  {
+    subscripts.push_back(level->getIdx());
+    base = level->getBase();
+  }
+  std::reverse(subscripts.begin(), subscripts.end());
+
+  std::string array = source_.getText(base->IgnoreParenImpCasts()->getSourceRange());
+  QualType type = element->getType();
+  if (!array.empty())
+  {
+    unsigned bytes = type->isIncompleteType()
+                         ? kDefaultElementBytes
+                         : static_cast<unsigned>(context_->getTypeSizeInChars(type).getQuantity());
+    state.touches.push_back(Touch{array, subscripts, bytes, is_write, state.levels});
+  }
+
+  // x[idx[i]] loads idx as well
+  for (const Expr* subscript : subscripts)
+  {
+    walk(subscript, state, false, true);
+  }
+}
+
+const LoopInfo* RooflineAnalyzer::findLoop(const Stmt* stmt, size_t index,
+                                           const std::vector<LoopInfo>& loops) const
+{
+  for (size_t child : loops[index].child_loop_indices)
+  {
+    if (loops[child].stmt == stmt)
+    {
+      return &loops[child];
+    }
+    if (const LoopInfo* nested = findLoop(stmt, child, loops))
+    {
+      return nested;
+    }
+  }
+  return nullptr;
+}
+
+double RooflineAnalyzer::repeats(const Walk& state) const
+{
+  double count = 1.0;
+  for (size_t i = 1; i < state.levels.size(); i++)
+  {
+    count *= state.levels[i].trips;
+  }
+  return count;
+}
+
+RooflineEstimate RooflineAnalyzer::estimate(const Walk& state) const
+{
+  struct Stream
+  {
+    const Touch* touch;
+    size_t level; // innermost loop whose iterator moves the access
+    double bytes; // per touch
+    bool written;
+  };
+
+  // neighbouring accesses like a[i-1], a[i], a[i+1] share lines and merge into one stream
+  std::map<std::string, Stream> streams;
+  for (const Touch& touch : state.touches)
+  {
+    std::optional<size_t> level;
+    for (size_t k = 0; k < touch.levels.size(); k++)
+    {
+      if (movesWith(touch, k))
+      {
+        level = k;
+      }
+    }
+    // the same element every time stays in registers or L1
+    if (!level)
+    {
+      continue;
+    }
+
+    auto inserted = streams.emplace(streamKey(touch, *level),
+                                    Stream{&touch, *level, touchBytes(touch, *level), false});
+    inserted.first->second.written |= touch.is_write;
+  }
+
+  RooflineEstimate result;
+  result.flops = state.flops;
+  result.streams = static_cast<unsigned>(streams.size());
+  for (const auto& entry : streams)
+  {
+    const Stream& stream = entry.second;
+    // walking outward, a loop that doesn't move the access re-reads the same data; it is
+    // still cached when the data touched in between (the reuse distance) fits
+    double footprint = stream.bytes;
+    for (size_t k = stream.level; k >= 1; k--)
+    {
+      if (k == stream.level || movesWith(*stream.touch, k) || footprint > kReuseBytes)
+      {
+        footprint *= stream.touch->levels[k].trips;
+      }
+    }
+
+    // a store first reads its line in, then writes it back
+    double traffic = footprint * (stream.written ? 2.0 : 1.0);
+    if (!movesWith(*stream.touch, 0) && footprint <= kReuseBytes)
+    {
+      result.resident_bytes += traffic;
+    }
+    else
+    {
+      result.bytes += traffic;
+    }
+  }
+  return result;
+}
+
+bool RooflineAnalyzer::movesWith(const Touch& touch, size_t level) const
+{
+  const std::string& iterator = touch.levels[level].iterator;
+  return !iterator.empty() &&
+         std::any_of(touch.subscripts.begin(), touch.subscripts.end(),
+                     [&](const Expr* subscript) { return mentions(subscript, iterator); });
+}
+
+double RooflineAnalyzer::touchBytes(const Touch& touch, size_t level) const
+{
+  // moving along an outer dimension jumps a whole row, a line per touch
+  const std::string& iterator = touch.levels[level].iterator;
+  for (size_t i = 0; i + 1 < touch.subscripts.size(); i++)
+  {
+    if (mentions(touch.subscripts[i], iterator))
+    {
+      return kCacheLineBytes;
+    }
+  }
+
+  // a[i] and a[2*i] use part of each line, gathers like x[idx[i]] a line apiece
+  std::optional<long long> stride = coefficient(touch.subscripts.back(), iterator);
+  if (!stride || *stride == 0)
+  {
+    return kCacheLineBytes;
+  }
+  return std::min(kCacheLineBytes, static_cast<double>(std::llabs(*stride)) * touch.element_bytes);
+}
+
+std::string RooflineAnalyzer::streamKey(const Touch& touch, size_t level) const
+{
+  std::string key = touch.array + "@" + std::to_string(level);
+  for (const Expr* subscript : touch.subscripts)
+  {
+    key += "[" + strippedText(subscript) + "]";
+  }
+  return key;
+}
+
+std::string RooflineAnalyzer::strippedText(const Expr* expr) const
+{
+  // a[i + 1] and a[i - 1] sit next to a[i]
+  expr = expr->IgnoreParenImpCasts();
+  if (auto* op = dyn_cast<BinaryOperator>(expr))
+  {
+    if ((op->getOpcode() == BO_Add || op->getOpcode() == BO_Sub) &&
+        isa<IntegerLiteral>(op->getRHS()->IgnoreParenImpCasts()))
+    {
+      return strippedText(op->getLHS());
+    }
+    if (op->getOpcode() == BO_Add && isa<IntegerLiteral>(op->getLHS()->IgnoreParenImpCasts()))
+    {
+      return strippedText(op->getRHS());
+    }
+  }
+  return source_.getText(expr->getSourceRange());
+}
+
+std::optional<long long> RooflineAnalyzer::coefficient(const Expr* expr,
+                                                       const std::string& iterator) const
+{
+  expr = expr->IgnoreParenCasts();
+  if (!mentions(expr, iterator))
+  {
+    return 0;
+  }
+  if (isa<DeclRefExpr>(expr))
+  {
+    return 1;
+  }
+
+  auto* op = dyn_cast<BinaryOperator>(expr);
+  if (!op)
+  {
+    return std::nullopt;
+  }
+  if (op->getOpcode() == BO_Add || op->getOpcode() == BO_Sub)
+  {
+    std::optional<long long> lhs = coefficient(op->getLHS(), iterator);
+    std::optional<long long> rhs = coefficient(op->getRHS(), iterator);
+    if (!lhs || !rhs)
+    {
+      return std::nullopt;
+    }
+    return op->getOpcode() == BO_Add ? *lhs + *rhs : *lhs - *rhs;
+  }
+  if (op->getOpcode() == BO_Mul)
+  {
+    // k * i and i * k, with k a compile-time constant
+    const Expr* scale = mentions(op->getLHS(), iterator) ? op->getRHS() : op->getLHS();
+    const Expr* term = scale == op->getLHS() ? op->getRHS() : op->getLHS();
+    Expr::EvalResult value;
+    std::optional<long long> inner = coefficient(term, iterator);
+    if (!inner || mentions(scale, iterator) || !scale->EvaluateAsInt(value, *context_))
+    {
+      return std::nullopt;
+    }
+    return *inner * value.Val.getInt().getExtValue();
+  }
+  return std::nullopt;
+}
+
+bool RooflineAnalyzer::mentions(const Stmt* stmt, const std::string& name) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+  if (auto* ref = dyn_cast<DeclRefExpr>(stmt))
+  {
+    return ref->getDecl()->getNameAsString() == name;
+  }
+  for (const Stmt* child : stmt->children())
+  {
+    if (mentions(child, name))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace paralyze
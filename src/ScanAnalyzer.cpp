@@ -0,0 +1,556 @@
+#include "analyzer/ScanAnalyzer.h"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+
+using namespace clang;
+
+namespace paralyze
+{
+
+void ScanAnalyzer::analyzeLoop(ForStmt* forLoop, LoopInfo& loop)
+{
+  if (!forLoop || loop.depth != 0 || !loop.child_loop_indices.empty() || loop.hasEarlyExit())
+  {
+    return;
+  }
+
+  auto* body = dyn_cast_or_null<CompoundStmt>(forLoop->getBody());
+  Header header;
+  if (!body || !readHeader(forLoop, loop, header))
+  {
+    return;
+  }
+
+  // the version guard goes above the header and the fallback below the closing brace
+  SourceLocation close = body->getRBracLoc();
+  if (!source_.startsLine(forLoop->getBeginLoc()) || !source_.isRewritable(close) ||
+      !source_.startsLine(close) || !source_.endsLine(close))
+  {
+    return;
+  }
+
+  std::vector<const Stmt*> stmts;
+  for (const Stmt* child : body->children())
+  {
+    stmts.push_back(child);
+  }
+
+  ScanLoop scan;
+  Replay replay;
+  bool matched = stmts.size() == 1 ? matchArrayScan(stmts[0], header, scan, replay)
+                                   : matchScalarScan(stmts, forLoop, scan, replay);
+  if (!matched)
+  {
+    return;
+  }
+
+  unsigned first_line = source_.getLine(forLoop->getBeginLoc());
+  unsigned last_line = source_.getLine(close);
+  std::string indent = source_.getIndentation(first_line);
+  if (!replay.seed.empty())
+  {
+    scan.edits.emplace_back(first_line, LineEditKind::INSERT_BEFORE, indent + replay.seed);
+  }
+
+  // inscan reductions arrived in OpenMP 5.0, older runtimes get the blocked version
+  scan.edits.emplace_back(first_line, LineEditKind::INSERT_BEFORE, "#if _OPENMP >= 201811");
+  scan.edits.emplace_back(last_line, LineEditKind::INSERT_AFTER,
+                          "#else\n" + buildFallback(scan, header, replay, indent) + "\n#endif");
+
+  scan.justification = std::string(scan.kind == ScanKind::INCLUSIVE ? "inclusive" : "exclusive") +
+                       " " + scan.op + "-scan over " + scan.variable +
+                       ", with a two-pass blocked scan for compilers before OpenMP 5.0";
+  if (verbose_)
+  {
+    std::cout << "  Prefix scan at line " << first_line << ": " << scan.clause() << " ("
+              << scan.justification << ")\n";
+  }
+  loop.scan = scan;
+}
+
+bool ScanAnalyzer::readHeader(const ForStmt* forLoop, const LoopInfo& loop, Header& header) const
+{
+  const VarDecl* iterator = nullptr;
+  const Expr* lower = nullptr;
+  if (auto* decl = dyn_cast_or_null<DeclStmt>(forLoop->getInit()))
+  {
+    iterator = decl->isSingleDecl() ? dyn_cast<VarDecl>(decl->getSingleDecl()) : nullptr;
+    lower = iterator ? iterator->getInit() : nullptr;
+  }
+  else if (auto* assign = dyn_cast_or_null<BinaryOperator>(forLoop->getInit()))
+  {
+    auto* ref = assign->getOpcode() == BO_Assign
+                    ? dyn_cast<DeclRefExpr>(assign->getLHS()->IgnoreParenImpCasts())
+                    : nullptr;
+    iterator = ref ? dyn_cast<VarDecl>(ref->getDecl()) : nullptr;
+    lower = assign->getRHS();
+  }
+  if (!iterator || !lower || iterator->getNameAsString() != loop.bounds.iterator_var)
+  {
+    return false;
+  }
+
+  auto isIterator = [iterator](const Expr* expr)
+  {
+    auto* ref = dyn_cast<DeclRefExpr>(expr->IgnoreParenImpCasts());
+    return ref && ref->getDecl() == iterator;
+  };
+
+  // i < n or i <= n
+  auto* cond = dyn_cast_or_null<BinaryOperator>(forLoop->getCond());
+  if (!cond || (cond->getOpcode() != BO_LT && cond->getOpcode() != BO_LE) ||
+      !isIterator(cond->getLHS()))
+  {
+    return false;
+  }
+
+  // i++, ++i or i += 1
+  Expr::EvalResult step;
+  const Expr* inc = forLoop->getInc() ? forLoop->getInc()->IgnoreParenImpCasts() : nullptr;
+  auto* unary = dyn_cast_or_null<UnaryOperator>(inc);
+  auto* compound = dyn_cast_or_null<CompoundAssignOperator>(inc);
+  bool unit = (unary && unary->isIncrementOp() && isIterator(unary->getSubExpr())) ||
+              (compound && compound->getOpcode() == BO_AddAssign &&
+               isIterator(compound->getLHS()) &&
+               compound->getRHS()->EvaluateAsInt(step, *context_) &&
+               step.Val.getInt().getExtValue() == 1);
+  if (!unit)
+  {
+    return false;
+  }
+
+  // the bounds are repeated in the fallback as written, so i < N keeps its macro
+  header.iterator = iterator->getNameAsString();
+  header.type = iterator->getType().getAsString();
+  header.lower = source_.getWrittenText(lower->getSourceRange());
+  header.end = source_.getWrittenText(cond->getRHS()->getSourceRange());
+  if (header.lower.empty() || header.end.empty())
+  {
+    return false;
+  }
+  if (cond->getOpcode() == BO_LE)
+  {
+    header.end = "(" + header.end + ") + 1";
+  }
+  return true;
+}
+
+bool ScanAnalyzer::matchScalarScan(const std::vector<const Stmt*>& stmts, const ForStmt* forLoop,
+                                   ScanLoop& scan, Replay& replay) const
+{
+  if (stmts.size() != 2 || !isOnOwnLines(stmts[0]) || !isOnOwnLines(stmts[1]))
+  {
+    return false;
+  }
+
+  const SourceManager& sm = context_->getSourceManager();
+  for (size_t u = 0; u < 2; u++)
+  {
+    Update update;
+    auto* var = matchUpdate(stmts[u], update) ? dyn_cast<VarDecl>(update.target) : nullptr;
+    if (!var || !isa<DeclRefExpr>(update.lhs->IgnoreParenImpCasts()) ||
+        !sm.isBeforeInTranslationUnit(var->getLocation(), forLoop->getBeginLoc()))
+    {
+      continue;
+    }
+
+    // x op= e or x = x op e, with e free of x
+    size_t self = 0;
+    bool clean = true;
+    for (const Expr* operand : update.operands)
+    {
+      auto* ref = dyn_cast<DeclRefExpr>(operand->IgnoreParenImpCasts());
+      if (ref && ref->getDecl() == var)
+      {
+        self++;
+      }
+      else
+      {
+        clean = clean && !references(operand, var);
+      }
+    }
+
+    QualType type = var->getType();
+    bool bitwise = update.op != "+" && update.op != "*";
+    if (self != 1 || !clean || !(type->isIntegerType() || type->isRealFloatingType()) ||
+        (bitwise && !type->isIntegerType()))
+    {
+      continue;
+    }
+
+    // the other statement reads the running value without changing it
+    const Stmt* reader = stmts[1 - u];
+    if (!isa<Expr>(reader) || !references(reader, var) || writes(reader, var))
+    {
+      continue;
+    }
+
+    // and the update doesn't read back what it stores: acc += out[i - 1] feeds on itself
+    const ValueDecl* stored = storedTarget(cast<Expr>(reader));
+    if (stored && references(stmts[u], stored))
+    {
+      continue;
+    }
+
+    scan.kind = u == 0 ? ScanKind::INCLUSIVE : ScanKind::EXCLUSIVE;
+    scan.variable = var->getNameAsString();
+    scan.op = update.op;
+
+    unsigned line = source_.getLine(stmts[1]->getBeginLoc());
+    scan.edits.emplace_back(line, LineEditKind::INSERT_BEFORE,
+                            source_.getIndentation(line) + scan.directive());
+
+    replay.type = type.getAsString();
+    replay.update_lines = linesOf(stmts[u], stmts[u]);
+    replay.body_lines = linesOf(stmts[0], stmts[1]);
+    return true;
+  }
+  return false;
+}
+
+bool ScanAnalyzer::matchArrayScan(const Stmt* stmt, const Header& header, ScanLoop& scan,
+                                  Replay& replay) const
+{
+  Update update;
+  if (!matchUpdate(stmt, update) || update.operands.size() != 2 ||
+      !isElementAt(update.lhs, update.target, header.iterator, 0))
+  {
+    return false;
+  }
+
+  // one operand is the previous element, the other is what this iteration adds in
+  const Expr* addend = nullptr;
+  if (isElementAt(update.operands[0], update.target, header.iterator, -1))
+  {
+    addend = update.operands[1];
+  }
+  else if (isElementAt(update.operands[1], update.target, header.iterator, -1))
+  {
+    addend = update.operands[0];
+  }
+
+  // a[i] += a[i - 1] adds the element's own old value, anything else of a is off limits
+  if (!addend ||
+      (references(addend, update.target) &&
+       !isElementAt(addend, update.target, header.iterator, 0)))
+  {
+    return false;
+  }
+
+  QualType type = update.lhs->getType();
+  bool bitwise = update.op != "+" && update.op != "*";
+  unsigned line = source_.getLine(stmt->getBeginLoc());
+  if (!(type->isIntegerType() || type->isRealFloatingType()) ||
+      (bitwise && !type->isIntegerType()) || !isOnOwnLines(stmt) ||
+      source_.getLine(stmt->getEndLoc()) != line)
+  {
+    return false;
+  }
+
+  std::string element = source_.getText(update.lhs->getSourceRange());
+  std::string added = source_.getText(addend->getSourceRange());
+  if (element.empty() || added.empty())
+  {
+    return false;
+  }
+
+  // the scan starts from the element just before the first one the loop writes
+  std::string array = update.target->getNameAsString();
+  bool literal = !header.lower.empty() &&
+                 std::all_of(header.lower.begin(), header.lower.end(), ::isdigit);
+  std::string previous = literal ? std::to_string(std::stoll(header.lower) - 1)
+                                 : header.lower + " - 1";
+
+  scan.kind = ScanKind::INCLUSIVE;
+  scan.variable = array + "_scan";
+  scan.array_name = array;
+  scan.op = update.op;
+
+  std::string indent = source_.getIndentation(line);
+  std::string accumulate = scan.variable + " " + scan.op + "= " + added + ";";
+  std::string store = element + " = " + scan.variable + ";";
+  scan.edits.emplace_back(line, LineEditKind::REPLACE,
+                          indent + accumulate + "\n" + indent + scan.directive() + "\n" + indent +
+                              store);
+
+  replay.type = type.getAsString();
+  replay.seed = replay.type + " " + scan.variable + " = " + array + "[" + previous + "];";
+  replay.update_lines = {indent + accumulate};
+  replay.body_lines = {indent + accumulate, indent + store};
+  return true;
+}
+
+bool ScanAnalyzer::matchUpdate(const Stmt* stmt, Update& update) const
+{
+  auto opOf = [](BinaryOperatorKind kind) -> std::string
+  {
+    switch (kind)
+    {
+    case BO_Add:
+    case BO_AddAssign:
+      return "+";
+    case BO_Mul:
+    case BO_MulAssign:
+      return "*";
+    case BO_And:
+    case BO_AndAssign:
+      return "&";
+    case BO_Or:
+    case BO_OrAssign:
+      return "|";
+    case BO_Xor:
+    case BO_XorAssign:
+      return "^";
+    default:
+      return "";
+    }
+  };
+
+  auto* expr = dyn_cast<Expr>(stmt);
+  if (!expr)
+  {
+    return false;
+  }
+  expr = expr->IgnoreParenImpCasts();
+
+  if (auto* unary = dyn_cast<UnaryOperator>(expr))
+  {
+    if (!unary->isIncrementOp())
+    {
+      return false;
+    }
+    update.lhs = unary->getSubExpr();
+    update.operands = {update.lhs};
+    update.op = "+";
+  }
+  else if (auto* compound = dyn_cast<CompoundAssignOperator>(expr))
+  {
+    update.lhs = compound->getLHS();
+    update.operands = {compound->getLHS(), compound->getRHS()};
+    update.op = opOf(compound->getOpcode());
+  }
+  else if (auto* assign = dyn_cast<BinaryOperator>(expr))
+  {
+    auto* combine = assign->getOpcode() == BO_Assign
+                        ? dyn_cast<BinaryOperator>(assign->getRHS()->IgnoreParenImpCasts())
+                        : nullptr;
+    if (!combine)
+    {
+      return false;
+    }
+    update.lhs = assign->getLHS();
+    update.operands = {combine->getLHS(), combine->getRHS()};
+    update.op = opOf(combine->getOpcode());
+  }
+
+  // x, or the array behind x[...]
+  const Expr* target = update.lhs ? update.lhs->IgnoreParenImpCasts() : nullptr;
+  if (auto* element = dyn_cast_or_null<ArraySubscriptExpr>(target))
+  {
+    target = element->getBase()->IgnoreParenImpCasts();
+  }
+  auto* ref = dyn_cast_or_null<DeclRefExpr>(target);
+  update.target = ref ? ref->getDecl() : nullptr;
+  return update.target && !update.op.empty();
+}
+
+const ValueDecl* ScanAnalyzer::storedTarget(const Expr* expr) const
+{
+  // x, or the array behind x[...], on the left of an assignment
+  auto* assign = dyn_cast<BinaryOperator>(expr->IgnoreParenImpCasts());
+  if (!assign || !assign->isAssignmentOp())
+  {
+    return nullptr;
+  }
+  const Expr* target = assign->getLHS()->IgnoreParenImpCasts();
+  while (auto* element = dyn_cast<ArraySubscriptExpr>(target))
+  {
+    target = element->getBase()->IgnoreParenImpCasts();
+  }
+  auto* ref = dyn_cast<DeclRefExpr>(target);
+  return ref ? ref->getDecl() : nullptr;
+}
+
+bool ScanAnalyzer::isElementAt(const Expr* expr, const ValueDecl* array,
+                               const std::string& iterator, int offset) const
+{
+  auto* element = dyn_cast<ArraySubscriptExpr>(expr->IgnoreParenImpCasts());
+  auto* base =
+      element ? dyn_cast<DeclRefExpr>(element->getBase()->IgnoreParenImpCasts()) : nullptr;
+  if (!base || base->getDecl() != array)
+  {
+    return false;
+  }
+
+  auto isIterator = [&iterator](const Expr* index)
+  {
+    auto* ref = dyn_cast<DeclRefExpr>(index->IgnoreParenImpCasts());
+    return ref && ref->getDecl()->getNameAsString() == iterator;
+  };
+
+  const Expr* index = element->getIdx()->IgnoreParenImpCasts();
+  if (offset == 0)
+  {
+    return isIterator(index);
+  }
+
+  // a[i - 1]
+  auto* shifted = dyn_cast<BinaryOperator>(index);
+  Expr::EvalResult distance;
+  return shifted && shifted->getOpcode() == BO_Sub && isIterator(shifted->getLHS()) &&
+         shifted->getRHS()->EvaluateAsInt(distance, *context_) &&
+         distance.Val.getInt().getExtValue() == -offset;
+}
+
+bool ScanAnalyzer::references(const Stmt* stmt, const ValueDecl* decl) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+
+  if (auto* ref = dyn_cast<DeclRefExpr>(stmt))
+  {
+    return ref->getDecl() == decl;
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    if (references(child, decl))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ScanAnalyzer::writes(const Stmt* stmt, const ValueDecl* decl) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+
+  auto isDecl = [decl](const Expr* expr)
+  {
+    auto* ref = dyn_cast<DeclRefExpr>(expr->IgnoreParenImpCasts());
+    return ref && ref->getDecl() == decl;
+  };
+
+  if (auto* assign = dyn_cast<BinaryOperator>(stmt))
+  {
+    if (assign->isAssignmentOp() && isDecl(assign->getLHS()))
+    {
+      return true;
+    }
+  }
+  else if (auto* unary = dyn_cast<UnaryOperator>(stmt))
+  {
+    if ((unary->isIncrementDecrementOp() || unary->getOpcode() == UO_AddrOf) &&
+        isDecl(unary->getSubExpr()))
+    {
+      return true;
+    }
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    if (writes(child, decl))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ScanAnalyzer::isOnOwnLines(const Stmt* stmt) const
+{
+  SourceRange range = stmt->getSourceRange();
+  return source_.isRewritable(range) && source_.startsLine(range.getBegin()) &&
+         source_.endsLine(range.getEnd());
+}
+
+std::vector<std::string> ScanAnalyzer::linesOf(const Stmt* first, const Stmt* last) const
+{
+  std::vector<std::string> lines;
+  unsigned end = source_.getLine(last->getEndLoc());
+  for (unsigned line = source_.getLine(first->getBeginLoc()); line <= end; line++)
+  {
+    lines.push_back(source_.getLineText(line));
+  }
+  return lines;
+}
+
+std::string ScanAnalyzer::buildFallback(const ScanLoop& scan, const Header& header,
+                                        const Replay& replay, const std::string& indent) const
+{
+  const std::string unit = "    ";
+  const std::string in1 = indent + unit;
+  const std::string in2 = in1 + unit;
+  const std::string in3 = in2 + unit;
+  const std::string blocks = std::to_string(kFallbackBlocks);
+  const std::string lower = "(long)(" + header.lower + ")";
+  const std::string end = "(long)(" + header.end + ")";
+  const std::string& v = scan.variable;
+  const std::string identity = scan.op == "*" ? "1" : scan.op == "&" ? "~0" : "0";
+
+  // replayed statements keep their own layout, shifted under the block loop
+  auto replayLines = [&in3](const std::vector<std::string>& lines)
+  {
+    size_t strip = std::string::npos;
+    for (const auto& line : lines)
+    {
+      size_t first = line.find_first_not_of(" \t");
+      if (first != std::string::npos)
+      {
+        strip = std::min(strip, first);
+      }
+    }
+
+    std::string text;
+    for (const auto& line : lines)
+    {
+      text += in3 + (line.size() > strip ? line.substr(strip) : "") + "\n";
+    }
+    return text;
+  };
+
+  // each block walks [scan_lo, scan_hi) of the original range
+  std::string block_loop = in1 + "for (int scan_block = 0; scan_block < " + blocks +
+                           "; scan_block++)\n" + in1 + "{\n" + in2 +
+                           "long scan_lo = " + lower + " + scan_block * scan_chunk;\n" + in2 +
+                           "long scan_hi = scan_lo + scan_chunk < " + end +
+                           " ? scan_lo + scan_chunk : " + end + ";\n";
+  std::string element_loop = in2 + "for (" + header.type + " " + header.iterator +
+                             " = scan_lo; " + header.iterator + " < scan_hi; " +
+                             header.iterator + "++)\n" + in2 + "{\n";
+
+  std::string text = indent + "{\n";
+  text += in1 + "long scan_chunk = (" + end + " - " + lower + " + " +
+          std::to_string(kFallbackBlocks - 1) + ") / " + blocks + ";\n";
+  text += in1 + replay.type + " scan_total[" + blocks + " + 1];\n";
+  text += in1 + "scan_total[0] = " + v + ";\n";
+
+  // pass 1: every block totals its own updates
+  text += in1 + "#pragma omp parallel for\n" + block_loop;
+  text += in2 + replay.type + " " + v + " = " + identity + ";\n";
+  text += element_loop + replayLines(replay.update_lines) + in2 + "}\n";
+  text += in2 + "scan_total[scan_block + 1] = " + v + ";\n" + in1 + "}\n";
+
+  // block totals become block offsets
+  text += in1 + "for (int scan_block = 0; scan_block < " + blocks + "; scan_block++)\n";
+  text += in1 + "{\n" + in2 + "scan_total[scan_block + 1] = scan_total[scan_block] " + scan.op +
+          " scan_total[scan_block + 1];\n" + in1 + "}\n";
+
+  // pass 2: every block replays the body starting from its offset
+  text += in1 + "#pragma omp parallel for\n" + block_loop;
+  text += in2 + replay.type + " " + v + " = scan_total[scan_block];\n";
+  text += element_loop + replayLines(replay.body_lines) + in2 + "}\n" + in1 + "}\n";
+
+  text += in1 + v + " = scan_total[" + blocks + "];\n";
+  text += indent + "}";
+  return text;
+}
+
+} // namespace paralyze
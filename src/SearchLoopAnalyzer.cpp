@@ -0,0 +1,386 @@
+#include "analyzer/SearchLoopAnalyzer.h"
+#include "analyzer/AnalysisStats.h"
+#include "clang/AST/Expr.h"
+#include "clang/AST/ParentMapContext.h"
+#include <iostream>
+
+using namespace clang;
+
+namespace paralyze
+{
+
+bool SearchLoopAnalyzer::analyzeSearchLoop(ForStmt* forLoop, LoopInfo& loop)
+{
+  // a single break or return is the only way out of a search loop
+  if (!forLoop || !forLoop->getBody() || loop.early_exits.size() != 1 ||
+      loop.early_exits.front().kind == EarlyExitKind::GOTO || !loop.bounds.is_simple_pattern)
+  {
+    return false;
+  }
+
+  // the rewrite is line based, so the loop has to be plain source on its own lines
+  if (!source_.isRewritable(forLoop->getSourceRange()) ||
+      !source_.startsLine(forLoop->getForLoc()) || !source_.endsLine(forLoop->getEndLoc()) ||
+      !isInCompoundStmt(forLoop))
+  {
+    return false;
+  }
+
+  VarDecl* counter = findCounter(loop);
+  IfStmt* test = findMatchTest(forLoop);
+  if (!counter || !test)
+  {
+    return false;
+  }
+
+  std::vector<Stmt*> actions;
+  if (!collectMatchActions(test, loop, actions) || actions.back() != loop.early_exits.front().stmt)
+  {
+    return false;
+  }
+
+  for (Stmt* action : actions)
+  {
+    if (!isOnOwnLine(action))
+    {
+      return false;
+    }
+  }
+
+  // the cancellation point goes on its own lines right after the opening brace
+  auto* body = dyn_cast<CompoundStmt>(forLoop->getBody());
+  if (!body || body->body_empty())
+  {
+    return false;
+  }
+  unsigned brace_line = source_.getLine(body->getLBracLoc());
+  unsigned first_line = source_.getLine((*body->body_begin())->getBeginLoc());
+  if (brace_line == 0 || first_line <= brace_line)
+  {
+    return false;
+  }
+
+  std::string tag = std::to_string(loop.line_number);
+  std::string hit = "pz_hit_" + tag;
+  std::string first = "pz_first_" + tag;
+  std::string seen = "pz_seen_" + tag;
+  std::string low = "pz_low_" + tag;
+  std::string name = counter->getNameAsString();
+  std::string type = counter->getType().getUnqualifiedType().getAsString();
+  bool counter_outside = !isa<DeclStmt>(forLoop->getInit());
+
+  unsigned header_line = source_.getLine(forLoop->getForLoc());
+  unsigned last_line = source_.getLine(forLoop->getEndLoc());
+  std::string indent = source_.getIndentation(header_line);
+  std::string unit = indentUnit(forLoop);
+
+  // the lowest match has the counter's own type; hit says whether there is one yet
+  std::vector<LineEdit> edits;
+  std::string note = "// threads past the lowest match stop early with OMP_CANCELLATION=true";
+  edits.emplace_back(header_line, LineEditKind::INSERT_BEFORE,
+                     indent + note + "\n" + indent + "int " + hit + " = 0;\n" + indent + type +
+                         " " + first + " = 0;");
+
+  // a thread may only give up its chunk once a lower index has matched, otherwise an
+  // earlier match further down its chunk would be lost
+  std::string head = source_.getIndentation(first_line);
+  edits.emplace_back(brace_line, LineEditKind::INSERT_AFTER,
+                     head + "int " + seen + ";\n" + head + "#pragma omp atomic read seq_cst\n" +
+                         head + seen + " = " + hit + ";\n" + head + "if (" + seen + ") {\n" +
+                         head + unit + type + " " + low + ";\n" + head + unit +
+                         "#pragma omp atomic read\n" + head + unit + low + " = " + first +
+                         ";\n" + head + unit + "if (" + low + " < " + name + ") {\n" + head +
+                         unit + unit + "#pragma omp cancellation point for\n" + head + unit +
+                         "}\n" + head + "}");
+
+  // each thread keeps scanning its own chunk until it matches, so the smallest index wins.
+  // first and hit are read outside the critical section, so they are only ever stored
+  // atomically, hit last so a thread that sees it also sees a match in first
+  auto combine = [&](const std::string& at)
+  {
+    return "#pragma omp critical\n" + at + "{\n" + at + unit + "if (!" + hit + " || " + name +
+           " < " + first + ") {\n" + at + unit + unit + "#pragma omp atomic write\n" + at +
+           unit + unit + first + " = " + name + ";\n" + at + unit + "}\n" + at + unit +
+           "#pragma omp atomic write seq_cst\n" + at + unit + hit + " = 1;\n" + at + "}\n" +
+           at + "#pragma omp cancel for";
+  };
+
+  unsigned action_line = source_.getLine(actions.front()->getBeginLoc());
+  std::string action_indent = source_.getIndentation(action_line);
+  if (isa<CompoundStmt>(test->getThen()))
+  {
+    edits.emplace_back(action_line, LineEditKind::REPLACE, action_indent + combine(action_indent));
+    for (size_t i = 1; i < actions.size(); i++)
+    {
+      edits.emplace_back(source_.getLine(actions[i]->getBeginLoc()), LineEditKind::REMOVE);
+    }
+  }
+  else
+  {
+    // the pragmas need a block to live in
+    std::string inner = action_indent + unit;
+    edits.emplace_back(action_line, LineEditKind::REPLACE,
+                       action_indent + "{\n" + inner + combine(inner) + "\n" + action_indent + "}");
+  }
+
+  // replay the matching iteration's actions after the loop
+  bool uses_counter = false;
+  std::string replay;
+  for (Stmt* action : actions)
+  {
+    if (isa<BreakStmt>(action))
+    {
+      continue;
+    }
+    std::string text = source_.getText(action->getSourceRange());
+    replay += indent + unit + text + ";\n";
+    uses_counter = uses_counter || referencesDecl(action, counter);
+  }
+
+  std::string after = indent + "if (" + hit + ") {\n";
+  if (counter_outside)
+  {
+    after += indent + unit + name + " = " + first + ";\n";
+  }
+  else if (uses_counter)
+  {
+    after += indent + unit + type + " " + name + " = " + first + ";\n";
+  }
+  after += replay + indent + "}";
+  edits.emplace_back(last_line, LineEditKind::INSERT_AFTER, after);
+
+  loop.search.is_search = true;
+  loop.search.counter_outside = counter_outside;
+  loop.search.hit_var = hit;
+  loop.search.first_var = first;
+  loop.search.edits = edits;
+
+  if (verbose_)
+  {
+    std::cout << "  Search loop: first match on " << name
+              << " combined across threads, exits through cancel\n";
+  }
+  return true;
+}
+
+IfStmt* SearchLoopAnalyzer::findMatchTest(ForStmt* forLoop) const
+{
+  Stmt* body = forLoop->getBody();
+  IfStmt* test = dyn_cast<IfStmt>(body);
+
+  // { locals...; if (match) { ... } }
+  if (auto* compound = dyn_cast<CompoundStmt>(body))
+  {
+    if (compound->body_empty())
+    {
+      return nullptr;
+    }
+
+    for (Stmt* stmt : compound->body())
+    {
+      if (stmt == compound->body_back())
+      {
+        break;
+      }
+
+      auto* declStmt = dyn_cast<DeclStmt>(stmt);
+      if (!declStmt)
+      {
+        return nullptr;
+      }
+      for (Decl* decl : declStmt->decls())
+      {
+        auto* varDecl = dyn_cast<VarDecl>(decl);
+        if (!varDecl || (varDecl->getInit() && varDecl->getInit()->HasSideEffects(*context_)))
+        {
+          return nullptr;
+        }
+      }
+    }
+    test = dyn_cast<IfStmt>(compound->body_back());
+  }
+
+  if (!test || test->getElse() || test->getInit() || test->getConditionVariable() ||
+      test->getCond()->HasSideEffects(*context_))
+  {
+    return nullptr;
+  }
+  return test;
+}
+
+bool SearchLoopAnalyzer::collectMatchActions(IfStmt* test, const LoopInfo& loop,
+                                             std::vector<Stmt*>& actions) const
+{
+  if (auto* compound = dyn_cast<CompoundStmt>(test->getThen()))
+  {
+    for (Stmt* stmt : compound->body())
+    {
+      actions.push_back(stmt);
+    }
+  }
+  else
+  {
+    actions.push_back(test->getThen());
+  }
+
+  if (actions.empty())
+  {
+    return false;
+  }
+
+  // results first, then the exit
+  for (size_t i = 0; i + 1 < actions.size(); i++)
+  {
+    if (!isResultAssignment(actions[i], loop))
+    {
+      return false;
+    }
+  }
+
+  Stmt* exit = actions.back();
+  if (isa<BreakStmt>(exit))
+  {
+    return true;
+  }
+
+  auto* returnStmt = dyn_cast<ReturnStmt>(exit);
+  if (!returnStmt)
+  {
+    return false;
+  }
+
+  Expr* value = returnStmt->getRetValue();
+  return !value || (!value->HasSideEffects(*context_) && !referencesLoopLocal(value, loop));
+}
+
+bool SearchLoopAnalyzer::isResultAssignment(Stmt* stmt, const LoopInfo& loop) const
+{
+  auto* assign = dyn_cast<BinaryOperator>(stmt);
+  if (!assign || assign->getOpcode() != BO_Assign || assign->getRHS()->HasSideEffects(*context_))
+  {
+    return false;
+  }
+
+  auto* declRef = dyn_cast<DeclRefExpr>(assign->getLHS()->IgnoreParenImpCasts());
+  if (!declRef || !isa<VarDecl>(declRef->getDecl()))
+  {
+    return false;
+  }
+
+  // the result has to outlive the loop and must not feed back into the search
+  std::string name = declRef->getDecl()->getNameAsString();
+  auto it = loop.variables.find(name);
+  if (name == loop.bounds.iterator_var || it == loop.variables.end() ||
+      it->second.scope == VariableScope::LOOP_LOCAL || it->second.hasReads())
+  {
+    return false;
+  }
+
+  // the replayed assignment only sees the counter, not locals of the loop body
+  return !referencesLoopLocal(assign->getRHS(), loop);
+}
+
+bool SearchLoopAnalyzer::referencesLoopLocal(Stmt* stmt, const LoopInfo& loop) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+
+  if (auto* declRef = dyn_cast<DeclRefExpr>(stmt))
+  {
+    auto it = loop.variables.find(declRef->getDecl()->getNameAsString());
+    return it != loop.variables.end() && it->second.scope == VariableScope::LOOP_LOCAL &&
+           it->first != loop.bounds.iterator_var;
+  }
+
+  for (Stmt* child : stmt->children())
+  {
+    if (referencesLoopLocal(child, loop))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SearchLoopAnalyzer::referencesDecl(Stmt* stmt, const Decl* decl) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+
+  if (auto* declRef = dyn_cast<DeclRefExpr>(stmt))
+  {
+    return declRef->getDecl() == decl;
+  }
+
+  for (Stmt* child : stmt->children())
+  {
+    if (referencesDecl(child, decl))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SearchLoopAnalyzer::isOnOwnLine(Stmt* stmt) const
+{
+  if (!source_.isRewritable(stmt->getSourceRange()))
+  {
+    return false;
+  }
+
+  unsigned line = source_.getLine(stmt->getBeginLoc());
+  if (line != source_.getLine(stmt->getEndLoc()))
+  {
+    return false;
+  }
+
+  std::string content = source_.getLineText(line);
+  size_t begin = content.find_first_not_of(" \t");
+  size_t end = content.find_last_not_of(" \t");
+  if (begin == std::string::npos)
+  {
+    return false;
+  }
+  return content.substr(begin, end - begin + 1) == source_.getText(stmt->getSourceRange()) + ";";
+}
+
+bool SearchLoopAnalyzer::isInCompoundStmt(Stmt* stmt)
+{
+  AnalysisStats::get().count(Counter::PARENT_LOOKUPS);
+  auto parents = context_->getParents(*stmt);
+  return !parents.empty() && parents[0].get<CompoundStmt>() != nullptr;
+}
+
+VarDecl* SearchLoopAnalyzer::findCounter(const LoopInfo& loop) const
+{
+  auto it = loop.variables.find(loop.bounds.iterator_var);
+  if (it == loop.variables.end() || !it->second.decl ||
+      !it->second.decl->getType()->isIntegerType())
+  {
+    return nullptr;
+  }
+  return it->second.decl;
+}
+
+std::string SearchLoopAnalyzer::indentUnit(ForStmt* forLoop) const
+{
+  std::string outer = source_.getIndentation(source_.getLine(forLoop->getForLoc()));
+
+  auto* body = dyn_cast<CompoundStmt>(forLoop->getBody());
+  if (body && !body->body_empty())
+  {
+    std::string inner = source_.getIndentation(source_.getLine(body->body_front()->getBeginLoc()));
+    if (inner.size() > outer.size() && inner.compare(0, outer.size(), outer) == 0)
+    {
+      return inner.substr(outer.size());
+    }
+  }
+  return "    ";
+}
+
+} // namespace paralyze
@@ -0,0 +1,541 @@
+#include "analyzer/SharedUpdateAnalyzer.h"
+#include <algorithm>
+#include <iostream>
+
+using namespace clang;
+
+namespace paralyze
+{
+
+void SharedUpdateAnalyzer::analyzeLoop(Stmt* loopStmt, LoopInfo& loop)
+{
+  if (!loopStmt || !loop.body())
+  {
+    return;
+  }
+  const Stmt* body = loop.body();
+
+  VarSet candidates, in_place, written, header_vars;
+  collectShared(body, loopStmt, loop, candidates, in_place);
+  collectWritten(body, written);
+  collectHeaderVars(body, header_vars);
+
+  // counters of nested loops declared up front keep their usual handling
+  VarSet shared;
+  for (const VarDecl* var : candidates)
+  {
+    if (written.count(var) && !header_vars.count(var))
+    {
+      shared.insert(var);
+    }
+  }
+  if (shared.empty())
+  {
+    return;
+  }
+
+  std::vector<const Stmt*> statements;
+  if (isa<CompoundStmt>(body))
+  {
+    for (const Stmt* child : body->children())
+    {
+      statements.push_back(child);
+    }
+  }
+  else
+  {
+    statements.push_back(body);
+  }
+
+  SharedUpdates& updates = loop.shared_updates;
+  std::vector<Site> sites;
+  bool resolved = true;
+
+  for (const Stmt* stmt : statements)
+  {
+    std::vector<Site> atomic_sites;
+    findAtomicSites(stmt, shared, 1.0, atomic_sites);
+
+    std::set<const Stmt*> covered;
+    for (const auto& site : atomic_sites)
+    {
+      covered.insert(site.stmt);
+    }
+
+    VarSet remaining;
+    collectReferences(stmt, shared, covered, remaining);
+    if (remaining.empty())
+    {
+      sites.insert(sites.end(), atomic_sites.begin(), atomic_sites.end());
+      continue;
+    }
+
+    // anything the atomics don't cover runs as one critical block, atomics inside included
+    VarSet block_vars;
+    collectReferences(stmt, shared, {}, block_vars);
+    if (!isCriticalBlock(stmt, block_vars))
+    {
+      resolved = false;
+      updates.justification = "shared scalars are used outside a single update or "
+                               "compare-and-update statement";
+      break;
+    }
+    sites.push_back(Site{SyncKind::CRITICAL, stmt, block_vars, "critical", "", 1.0});
+  }
+
+  // a variable spread over several sites is only safe when every update commutes
+  for (const VarDecl* var : shared)
+  {
+    const Site* first = nullptr;
+    for (const auto& site : sites)
+    {
+      if (!resolved || !site.vars.count(var))
+      {
+        continue;
+      }
+      if (!first)
+      {
+        first = &site;
+      }
+      else if (first->kind != SyncKind::ATOMIC || site.kind != SyncKind::ATOMIC ||
+               first->family != site.family)
+      {
+        resolved = false;
+        updates.justification = var->getNameAsString() + " is updated in ways that don't "
+                                                         "commute across iterations";
+      }
+    }
+  }
+
+  double serialized = 0.0;
+  for (const auto& site : sites)
+  {
+    serialized += site.weight * (site.kind == SyncKind::ATOMIC ? kAtomicCost : kCriticalCost);
+  }
+  updates.contention = serialized / std::max(1.0, loop.metrics.iteration_cost);
+  int percent = static_cast<int>(updates.contention * 100.0 + 0.5);
+
+  if (resolved && updates.contention > kMaxContention)
+  {
+    resolved = false;
+    updates.justification = "synchronizing would serialize ~" + std::to_string(percent) +
+                            "% of each iteration";
+  }
+
+  if (!resolved)
+  {
+    // x++ and x += e carry a value from one iteration to the next
+    for (const VarDecl* var : shared)
+    {
+      if (in_place.count(var))
+      {
+        updates.carried.push_back(var->getNameAsString());
+      }
+    }
+
+    if (verbose_ && !updates.carried.empty())
+    {
+      std::cout << "  Shared updates left serial: " << updates.justification << "\n";
+    }
+    return;
+  }
+
+  for (const VarDecl* var : shared)
+  {
+    updates.variables.push_back(var->getNameAsString());
+  }
+
+  for (const auto& site : sites)
+  {
+    std::vector<std::string> names;
+    for (const VarDecl* var : site.vars)
+    {
+      names.push_back(var->getNameAsString());
+    }
+
+    unsigned line = source_.getLine(site.stmt->getBeginLoc());
+    updates.sites.emplace_back(site.kind, line, names);
+    std::string directive = site.kind == SyncKind::ATOMIC ? "#pragma omp atomic" + site.clause
+                                                          : "#pragma omp critical";
+    updates.edits.emplace_back(line, LineEditKind::INSERT_BEFORE,
+                               source_.getIndentation(line) + directive);
+  }
+
+  updates.justification = "~" + std::to_string(percent) + "% of each iteration serialized";
+
+  if (verbose_)
+  {
+    std::cout << "  Shared updates synchronized (" << updates.sites.size() << " site"
+              << (updates.sites.size() > 1 ? "s" : "") << "): " << updates.justification
+              << "\n";
+  }
+}
+
+void SharedUpdateAnalyzer::collectShared(const Stmt* stmt, const Stmt* loopStmt,
+                                         const LoopInfo& loop, VarSet& shared,
+                                         VarSet& in_place) const
+{
+  if (!stmt)
+  {
+    return;
+  }
+
+  if (auto* ref = dyn_cast<DeclRefExpr>(stmt))
+  {
+    auto* var = dyn_cast<VarDecl>(ref->getDecl());
+    if (var && isCandidate(var, loopStmt, loop))
+    {
+      shared.insert(var);
+    }
+    return;
+  }
+
+  const Expr* target = nullptr;
+  if (auto* unary = dyn_cast<UnaryOperator>(stmt))
+  {
+    target = unary->isIncrementDecrementOp() ? unary->getSubExpr() : nullptr;
+  }
+  else if (auto* compound = dyn_cast<CompoundAssignOperator>(stmt))
+  {
+    target = compound->getLHS();
+  }
+  if (target)
+  {
+    auto* ref = dyn_cast<DeclRefExpr>(target->IgnoreParenImpCasts());
+    if (auto* var = ref ? dyn_cast<VarDecl>(ref->getDecl()) : nullptr)
+    {
+      in_place.insert(var);
+    }
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    collectShared(child, loopStmt, loop, shared, in_place);
+  }
+}
+
+void SharedUpdateAnalyzer::collectHeaderVars(const Stmt* stmt, VarSet& header_vars) const
+{
+  if (!stmt)
+  {
+    return;
+  }
+
+  // for (j = 0; ...; j++) with j declared outside
+  if (auto* nested = dyn_cast<ForStmt>(stmt))
+  {
+    collectWritten(nested->getInit(), header_vars);
+    collectWritten(nested->getInc(), header_vars);
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    collectHeaderVars(child, header_vars);
+  }
+}
+
+bool SharedUpdateAnalyzer::isCandidate(const VarDecl* var, const Stmt* loopStmt,
+                                       const LoopInfo& loop) const
+{
+  // a running sum is already carried by the scan, a counter by linear(j:step)
+  if (var->getNameAsString() == loop.bounds.iterator_var ||
+      (loop.scan.isScan() && var->getNameAsString() == loop.scan.variable) ||
+      loop.simd.isLinear(var->getNameAsString()))
+  {
+    return false;
+  }
+
+  QualType type = var->getType();
+  if (!(type->isIntegerType() || type->isRealFloatingType()))
+  {
+    return false;
+  }
+
+  // declared in the body means every iteration has its own copy
+  const SourceManager& sm = context_->getSourceManager();
+  return sm.isBeforeInTranslationUnit(var->getLocation(), loopStmt->getBeginLoc());
+}
+
+void SharedUpdateAnalyzer::findAtomicSites(const Stmt* stmt, const VarSet& shared, double weight,
+                                           std::vector<Site>& sites) const
+{
+  if (!stmt)
+  {
+    return;
+  }
+
+  // only whole statements can take a directive, conditions and operands can't
+  if (auto* expr = dyn_cast<Expr>(stmt))
+  {
+    Site site{SyncKind::ATOMIC, expr, {}, "", "", weight};
+    if (matchAtomic(expr, shared, site) && isOnOwnLines(expr))
+    {
+      sites.push_back(site);
+    }
+    return;
+  }
+
+  if (isa<CompoundStmt>(stmt))
+  {
+    for (const Stmt* child : stmt->children())
+    {
+      findAtomicSites(child, shared, weight, sites);
+    }
+  }
+  else if (auto* branch = dyn_cast<IfStmt>(stmt))
+  {
+    findAtomicSites(branch->getThen(), shared, weight, sites);
+    findAtomicSites(branch->getElse(), shared, weight, sites);
+  }
+  else if (auto* nested = dyn_cast<ForStmt>(stmt))
+  {
+    findAtomicSites(nested->getBody(), shared, weight * LoopMetrics::kAssumedTripCount, sites);
+  }
+  else if (auto* nested = dyn_cast<WhileStmt>(stmt))
+  {
+    findAtomicSites(nested->getBody(), shared, weight * LoopMetrics::kAssumedTripCount, sites);
+  }
+  else if (auto* nested = dyn_cast<DoStmt>(stmt))
+  {
+    findAtomicSites(nested->getBody(), shared, weight * LoopMetrics::kAssumedTripCount, sites);
+  }
+}
+
+bool SharedUpdateAnalyzer::matchAtomic(const Expr* expr, const VarSet& shared, Site& site) const
+{
+  auto familyOf = [](BinaryOperatorKind op) -> std::string
+  {
+    switch (op)
+    {
+    case BO_Add:
+    case BO_Sub:
+    case BO_AddAssign:
+    case BO_SubAssign:
+      return "+";
+    case BO_Mul:
+    case BO_MulAssign:
+      return "*";
+    case BO_Div:
+    case BO_DivAssign:
+      return "/";
+    case BO_And:
+    case BO_AndAssign:
+      return "&";
+    case BO_Or:
+    case BO_OrAssign:
+      return "|";
+    case BO_Xor:
+    case BO_XorAssign:
+      return "^";
+    default:
+      return "";
+    }
+  };
+
+  const VarDecl* var = nullptr;
+  const Expr* operand = nullptr;
+  expr = expr->IgnoreParenImpCasts();
+
+  if (auto* unary = dyn_cast<UnaryOperator>(expr))
+  {
+    if (unary->isIncrementDecrementOp())
+    {
+      var = sharedRef(unary->getSubExpr(), shared);
+      site.family = "+";
+    }
+  }
+  else if (auto* compound = dyn_cast<CompoundAssignOperator>(expr))
+  {
+    var = sharedRef(compound->getLHS(), shared);
+    operand = compound->getRHS();
+    site.family = familyOf(compound->getOpcode());
+  }
+  else if (auto* assign = dyn_cast<BinaryOperator>(expr))
+  {
+    var = assign->getOpcode() == BO_Assign ? sharedRef(assign->getLHS(), shared) : nullptr;
+    auto* op = var ? dyn_cast<BinaryOperator>(assign->getRHS()->IgnoreParenImpCasts()) : nullptr;
+    Expr::EvalResult value;
+
+    // x = x op e, or x = e op x when op commutes
+    if (op && sharedRef(op->getLHS(), shared) == var)
+    {
+      operand = op->getRHS();
+      site.family = familyOf(op->getOpcode());
+    }
+    else if (op && op->getOpcode() != BO_Sub && op->getOpcode() != BO_Div &&
+             sharedRef(op->getRHS(), shared) == var)
+    {
+      operand = op->getLHS();
+      site.family = familyOf(op->getOpcode());
+    }
+    else if (var && assign->getRHS()->EvaluateAsInt(value, *context_))
+    {
+      // found = 1: every thread stores the same value
+      site.family = "=" + std::to_string(value.Val.getInt().getExtValue());
+      site.clause = " write";
+    }
+    else
+    {
+      var = nullptr;
+    }
+  }
+
+  // the other operand must not read shared state, or the update isn't one atomic step
+  if (!var || site.family.empty() || (operand && readsAny(operand, shared)))
+  {
+    return false;
+  }
+  site.vars = {var};
+  return true;
+}
+
+void SharedUpdateAnalyzer::collectReferences(const Stmt* stmt, const VarSet& shared,
+                                             const std::set<const Stmt*>& skip,
+                                             VarSet& found) const
+{
+  if (!stmt || skip.count(stmt))
+  {
+    return;
+  }
+
+  if (auto* ref = dyn_cast<DeclRefExpr>(stmt))
+  {
+    auto* var = dyn_cast<VarDecl>(ref->getDecl());
+    if (var && shared.count(var))
+    {
+      found.insert(var);
+    }
+    return;
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    collectReferences(child, shared, skip, found);
+  }
+}
+
+bool SharedUpdateAnalyzer::isCriticalBlock(const Stmt* stmt, const VarSet& vars) const
+{
+  if (isa<DeclStmt>(stmt) || hasJumpOrLoop(stmt) || !isOnOwnLines(stmt))
+  {
+    return false;
+  }
+
+  // a compare-and-update reads what it writes, so the blocks end the same in any order
+  VarSet written, updated;
+  collectWritten(stmt, written);
+  for (const VarDecl* var : written)
+  {
+    if (vars.count(var))
+    {
+      updated.insert(var);
+    }
+  }
+  return !updated.empty() && readsAny(stmt, updated);
+}
+
+bool SharedUpdateAnalyzer::readsAny(const Stmt* stmt, const VarSet& vars) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+
+  // a plain store doesn't read its target
+  if (auto* assign = dyn_cast<BinaryOperator>(stmt))
+  {
+    if (assign->getOpcode() == BO_Assign)
+    {
+      const Expr* lhs = assign->getLHS()->IgnoreParenImpCasts();
+      return (!isa<DeclRefExpr>(lhs) && readsAny(lhs, vars)) || readsAny(assign->getRHS(), vars);
+    }
+  }
+
+  if (auto* ref = dyn_cast<DeclRefExpr>(stmt))
+  {
+    auto* var = dyn_cast<VarDecl>(ref->getDecl());
+    return var && vars.count(var);
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    if (readsAny(child, vars))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void SharedUpdateAnalyzer::collectWritten(const Stmt* stmt, VarSet& written) const
+{
+  if (!stmt)
+  {
+    return;
+  }
+
+  const Expr* target = nullptr;
+  if (auto* assign = dyn_cast<BinaryOperator>(stmt))
+  {
+    target = assign->isAssignmentOp() ? assign->getLHS() : nullptr;
+  }
+  else if (auto* unary = dyn_cast<UnaryOperator>(stmt))
+  {
+    // taking the address lets anything write it
+    bool writes = unary->isIncrementDecrementOp() || unary->getOpcode() == UO_AddrOf;
+    target = writes ? unary->getSubExpr() : nullptr;
+  }
+
+  if (target)
+  {
+    auto* ref = dyn_cast<DeclRefExpr>(target->IgnoreParenImpCasts());
+    if (auto* var = ref ? dyn_cast<VarDecl>(ref->getDecl()) : nullptr)
+    {
+      written.insert(var);
+    }
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    collectWritten(child, written);
+  }
+}
+
+bool SharedUpdateAnalyzer::hasJumpOrLoop(const Stmt* stmt) const
+{
+  if (!stmt)
+  {
+    return false;
+  }
+
+  if (isa<BreakStmt>(stmt) || isa<ContinueStmt>(stmt) || isa<ReturnStmt>(stmt) ||
+      isa<GotoStmt>(stmt) || isa<ForStmt>(stmt) || isa<WhileStmt>(stmt) || isa<DoStmt>(stmt))
+  {
+    return true;
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    if (hasJumpOrLoop(child))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SharedUpdateAnalyzer::isOnOwnLines(const Stmt* stmt) const
+{
+  SourceRange range = stmt->getSourceRange();
+  return source_.isRewritable(range) && source_.startsLine(range.getBegin()) &&
+         source_.endsLine(range.getEnd());
+}
+
+const VarDecl* SharedUpdateAnalyzer::sharedRef(const Expr* expr, const VarSet& shared) const
+{
+  auto* ref = dyn_cast<DeclRefExpr>(expr->IgnoreParenImpCasts());
+  auto* var = ref ? dyn_cast<VarDecl>(ref->getDecl()) : nullptr;
+  return var && shared.count(var) ? var : nullptr;
+}
+
+} // namespace paralyze
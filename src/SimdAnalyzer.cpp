@@ -0,0 +1,729 @@
+#include "analyzer/SimdAnalyzer.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+using namespace clang;
+
+namespace paralyze
+{
+
+void SimdAnalyzer::analyzeLoop(ForStmt* forLoop, LoopInfo& loop)
+{
+  SimdPlan& plan = loop.simd;
+  plan = SimdPlan();
+  if (!forLoop || !forLoop->getBody())
+  {
+    return;
+  }
+
+  const Stmt* body = forLoop->getBody();
+  Scope scope;
+  scope.iterator = loop.bounds.iterator_var;
+  scope.loop = forLoop;
+  collectWritten(body, scope.written);
+
+  // counters bumped once per iteration are linear whether or not the loop vectorizes
+  if (auto* block = dyn_cast<CompoundStmt>(body))
+  {
+    findLinear(block, loop, scope, plan);
+  }
+
+  const ValueDecl* stepped = nullptr;
+  auto step = forLoop->getInc() ? constantStep(forLoop->getInc(), stepped) : std::nullopt;
+  std::vector<Access> accesses;
+  unsigned branches = 0;
+
+  if (!step || *step == 0 || !stepped || stepped->getNameAsString() != scope.iterator)
+  {
+    plan.blocker = "the step isn't a constant";
+  }
+  else if (loop.hasEarlyExit())
+  {
+    plan.blocker = "lanes can't leave the loop early";
+  }
+  else
+  {
+    scope.step = *step;
+    std::string blocker;
+    if (!walk(body, scope, false, accesses, branches, blocker))
+    {
+      plan.blocker = blocker;
+    }
+  }
+
+  if (plan.blocker.empty() && branches > kMaxBranches)
+  {
+    plan.blocker = "control-flow heavy, " + std::to_string(branches) +
+                   " branches would all run under masks";
+  }
+
+  if (plan.blocker.empty())
+  {
+    for (const auto& access : accesses)
+    {
+      bool contiguous = access.stride && std::llabs(*access.stride) == 1;
+      bool broadcast = access.stride && *access.stride == 0;
+      plan.contiguous_accesses += contiguous ? 1 : 0;
+      plan.gathers += !contiguous && !broadcast && !access.is_write ? 1 : 0;
+    }
+
+    if (plan.contiguous_accesses == 0)
+    {
+      plan.blocker = "no unit-stride accesses to vectorize";
+    }
+    else if (plan.gathers > plan.contiguous_accesses)
+    {
+      plan.blocker = "gathers outnumber unit-stride accesses (" + std::to_string(plan.gathers) +
+                     " vs " + std::to_string(plan.contiguous_accesses) + ")";
+    }
+  }
+
+  plan.vectorizable = plan.blocker.empty() && checkElementTypes(accesses, plan) &&
+                      checkRecurrences(accesses, scope, plan);
+  if (plan.vectorizable)
+  {
+    chooseClauses(accesses, plan);
+    planPeel(forLoop, accesses, scope, plan);
+  }
+
+  if (verbose_)
+  {
+    std::cout << "  SIMD at line " << loop.line_number << ": ";
+    if (plan.vectorizable)
+    {
+      std::cout << "vectorizable," << plan.clauses() << plan.linearClause() << "\n";
+      if (!plan.peel_array.empty())
+      {
+        std::cout << "    " << plan.peelNote() << "\n";
+      }
+    }
+    else
+    {
+      std::cout << "not vectorized (" << plan.blocker << ")" << plan.linearClause() << "\n";
+    }
+  }
+}
+
+void SimdAnalyzer::findLinear(const CompoundStmt* body, const LoopInfo& loop, Scope& scope,
+                              SimdPlan& plan) const
+{
+  for (const Stmt* stmt : body->children())
+  {
+    const ValueDecl* var = nullptr;
+    auto step = constantStep(stmt, var);
+    auto* decl = dyn_cast_or_null<VarDecl>(var);
+    if (!step || *step == 0 || !decl || !decl->getType()->isIntegerType() ||
+        decl->getNameAsString() == scope.iterator || !isDeclaredBefore(decl, scope.loop) ||
+        (loop.scan.isScan() && decl->getNameAsString() == loop.scan.variable))
+    {
+      continue;
+    }
+
+    // j++ at the top of the body is its only write, so iteration k always sees j0 + k * step
+    if (countWrites(body, decl) != 1)
+    {
+      continue;
+    }
+    scope.linear[decl] = *step;
+    plan.linear.emplace_back(decl->getNameAsString(), *step);
+  }
+}
+
+std::optional<long long> SimdAnalyzer::constantStep(const Stmt* stmt, const ValueDecl*& var) const
+{
+  auto* expr = dyn_cast_or_null<Expr>(stmt);
+  if (!expr)
+  {
+    return std::nullopt;
+  }
+  expr = expr->IgnoreParenImpCasts();
+
+  auto declOf = [](const Expr* operand) -> const ValueDecl*
+  {
+    auto* ref = dyn_cast<DeclRefExpr>(operand->IgnoreParenImpCasts());
+    return ref ? ref->getDecl() : nullptr;
+  };
+
+  Expr::EvalResult value;
+  if (auto* unary = dyn_cast<UnaryOperator>(expr))
+  {
+    if (unary->isIncrementDecrementOp())
+    {
+      var = declOf(unary->getSubExpr());
+      return unary->isIncrementOp() ? 1 : -1;
+    }
+  }
+  else if (auto* compound = dyn_cast<CompoundAssignOperator>(expr))
+  {
+    bool add = compound->getOpcode() == BO_AddAssign;
+    if ((add || compound->getOpcode() == BO_SubAssign) &&
+        compound->getRHS()->EvaluateAsInt(value, *context_))
+    {
+      var = declOf(compound->getLHS());
+      long long amount = value.Val.getInt().getExtValue();
+      return add ? amount : -amount;
+    }
+  }
+  else if (auto* assign = dyn_cast<BinaryOperator>(expr))
+  {
+    // j = j + c, j = c + j or j = j - c
+    auto* sum = assign->getOpcode() == BO_Assign
+                    ? dyn_cast<BinaryOperator>(assign->getRHS()->IgnoreParenImpCasts())
+                    : nullptr;
+    const ValueDecl* target = declOf(assign->getLHS());
+    if (!sum || !target || (sum->getOpcode() != BO_Add && sum->getOpcode() != BO_Sub))
+    {
+      return std::nullopt;
+    }
+
+    if (declOf(sum->getLHS()) == target && sum->getRHS()->EvaluateAsInt(value, *context_))
+    {
+      var = target;
+      long long amount = value.Val.getInt().getExtValue();
+      return sum->getOpcode() == BO_Add ? amount : -amount;
+    }
+    if (sum->getOpcode() == BO_Add && declOf(sum->getRHS()) == target &&
+        sum->getLHS()->EvaluateAsInt(value, *context_))
+    {
+      var = target;
+      return value.Val.getInt().getExtValue();
+    }
+  }
+  return std::nullopt;
+}
+
+bool SimdAnalyzer::walk(const Stmt* stmt, const Scope& scope, bool is_write,
+                        std::vector<Access>& accesses, unsigned& branches,
+                        std::string& blocker) const
+{
+  if (!stmt)
+  {
+    return true;
+  }
+
+  if (isa<ForStmt>(stmt) || isa<WhileStmt>(stmt) || isa<DoStmt>(stmt))
+  {
+    blocker = "the body holds a nested loop";
+    return false;
+  }
+  if (isa<SwitchStmt>(stmt))
+  {
+    blocker = "a switch can't be if-converted";
+    return false;
+  }
+  if (isa<BreakStmt>(stmt) || isa<ReturnStmt>(stmt) || isa<GotoStmt>(stmt) ||
+      isa<IndirectGotoStmt>(stmt))
+  {
+    blocker = "lanes can't leave the loop early";
+    return false;
+  }
+  if (isa<MemberExpr>(stmt))
+  {
+    blocker = "struct fields are strided across lanes";
+    return false;
+  }
+
+  // every if becomes a mask, a continue masks off the rest of the body
+  if (isa<IfStmt>(stmt) || isa<ContinueStmt>(stmt))
+  {
+    branches++;
+  }
+
+  if (auto* call = dyn_cast<CallExpr>(stmt))
+  {
+    if (!isVectorMathCall(call))
+    {
+      auto* callee = call->getDirectCallee();
+      blocker = "calls " + (callee ? callee->getNameAsString() + "()" : "through a pointer") +
+                ", which has no vector variant";
+      return false;
+    }
+  }
+
+  if (auto* unary = dyn_cast<UnaryOperator>(stmt))
+  {
+    if (unary->getOpcode() == UO_Deref || unary->getOpcode() == UO_AddrOf)
+    {
+      blocker = "works through pointers it can't follow";
+      return false;
+    }
+    if (unary->isIncrementDecrementOp())
+    {
+      return walk(unary->getSubExpr(), scope, true, accesses, branches, blocker);
+    }
+  }
+
+  if (auto* assign = dyn_cast<BinaryOperator>(stmt))
+  {
+    if (assign->isAssignmentOp())
+    {
+      return walk(assign->getLHS(), scope, true, accesses, branches, blocker) &&
+             walk(assign->getRHS(), scope, false, accesses, branches, blocker);
+    }
+  }
+
+  if (auto* element = dyn_cast<ArraySubscriptExpr>(stmt))
+  {
+    recordAccess(element, scope, is_write, accesses);
+
+    // the subscripts are loads of their own, a[idx[i]] also reads idx[i]
+    const Expr* current = element;
+    while (auto* sub = dyn_cast<ArraySubscriptExpr>(current->IgnoreParenImpCasts()))
+    {
+      if (!walk(sub->getIdx(), scope, false, accesses, branches, blocker))
+      {
+        return false;
+      }
+      current = sub->getBase();
+    }
+    return true;
+  }
+
+  if (auto* ref = dyn_cast<DeclRefExpr>(stmt))
+  {
+    auto* var = dyn_cast<VarDecl>(ref->getDecl());
+    if (is_write && var && isDeclaredBefore(var, scope.loop) &&
+        var->getNameAsString() != scope.iterator && !scope.linear.count(var))
+    {
+      blocker = "writes the shared scalar " + var->getNameAsString();
+      return false;
+    }
+    return true;
+  }
+
+  // parentheses and casts on the left of an assignment are still the store
+  bool passes_write = is_write && (isa<ParenExpr>(stmt) || isa<ImplicitCastExpr>(stmt));
+  for (const Stmt* child : stmt->children())
+  {
+    if (!walk(child, scope, passes_write, accesses, branches, blocker))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void SimdAnalyzer::recordAccess(const ArraySubscriptExpr* element, const Scope& scope,
+                                bool is_write, std::vector<Access>& accesses) const
+{
+  // a[x][y]: y moves through memory, x has to stay put for the access to be contiguous
+  std::vector<const Expr*> indexes;
+  const Expr* base = element;
+  while (auto* sub = dyn_cast<ArraySubscriptExpr>(base->IgnoreParenImpCasts()))
+  {
+    indexes.push_back(sub->getIdx());
+    base = sub->getBase();
+  }
+
+  auto* ref = dyn_cast<DeclRefExpr>(base->IgnoreParenImpCasts());
+  Access access{ref ? ref->getDecl() : nullptr, element, is_write, std::nullopt, std::nullopt};
+
+  auto inner = strideOf(indexes.front(), scope);
+  bool outer_fixed = std::all_of(indexes.begin() + 1, indexes.end(),
+                                 [this, &scope](const Expr* index)
+                                 {
+                                   auto stride = strideOf(index, scope);
+                                   return stride && *stride == 0;
+                                 });
+  if (inner && outer_fixed)
+  {
+    access.stride = *inner;
+  }
+  if (indexes.size() == 1 && std::llabs(scope.step) == 1)
+  {
+    access.offset = offsetOf(indexes.front(), scope);
+  }
+  accesses.push_back(access);
+}
+
+std::optional<long long> SimdAnalyzer::strideOf(const Expr* expr, const Scope& scope) const
+{
+  expr = expr->IgnoreParenImpCasts();
+
+  Expr::EvalResult value;
+  if (expr->EvaluateAsInt(value, *context_))
+  {
+    return 0;
+  }
+
+  if (auto* ref = dyn_cast<DeclRefExpr>(expr))
+  {
+    if (ref->getDecl()->getNameAsString() == scope.iterator)
+    {
+      return scope.step;
+    }
+    auto linear = scope.linear.find(ref->getDecl());
+    if (linear != scope.linear.end())
+    {
+      return linear->second;
+    }
+  }
+  else if (auto* op = dyn_cast<BinaryOperator>(expr))
+  {
+    auto lhs = strideOf(op->getLHS(), scope);
+    auto rhs = strideOf(op->getRHS(), scope);
+    switch (op->getOpcode())
+    {
+    case BO_Add:
+      return lhs && rhs ? std::optional<long long>(*lhs + *rhs) : std::nullopt;
+    case BO_Sub:
+      return lhs && rhs ? std::optional<long long>(*lhs - *rhs) : std::nullopt;
+    case BO_Mul:
+      // 2 * i strides by two, i * n only when n is a known constant
+      if (op->getLHS()->EvaluateAsInt(value, *context_) && rhs)
+      {
+        return value.Val.getInt().getExtValue() * *rhs;
+      }
+      if (op->getRHS()->EvaluateAsInt(value, *context_) && lhs)
+      {
+        return *lhs * value.Val.getInt().getExtValue();
+      }
+      return lhs && rhs && *lhs == 0 && *rhs == 0 ? std::optional<long long>(0) : std::nullopt;
+    default:
+      break;
+    }
+  }
+
+  if (isInvariant(expr, scope))
+  {
+    return 0;
+  }
+  return std::nullopt;
+}
+
+std::optional<long long> SimdAnalyzer::offsetOf(const Expr* expr, const Scope& scope) const
+{
+  auto isIterator = [&scope](const Expr* operand)
+  {
+    auto* ref = dyn_cast<DeclRefExpr>(operand->IgnoreParenImpCasts());
+    return ref && ref->getDecl()->getNameAsString() == scope.iterator;
+  };
+
+  expr = expr->IgnoreParenImpCasts();
+  if (isIterator(expr))
+  {
+    return 0;
+  }
+
+  // i + c, c + i or i - c
+  Expr::EvalResult value;
+  auto* op = dyn_cast<BinaryOperator>(expr);
+  if (!op || (op->getOpcode() != BO_Add && op->getOpcode() != BO_Sub))
+  {
+    return std::nullopt;
+  }
+  if (isIterator(op->getLHS()) && op->getRHS()->EvaluateAsInt(value, *context_))
+  {
+    long long amount = value.Val.getInt().getExtValue();
+    return op->getOpcode() == BO_Add ? amount : -amount;
+  }
+  if (op->getOpcode() == BO_Add && isIterator(op->getRHS()) &&
+      op->getLHS()->EvaluateAsInt(value, *context_))
+  {
+    return value.Val.getInt().getExtValue();
+  }
+  return std::nullopt;
+}
+
+bool SimdAnalyzer::isInvariant(const Expr* expr, const Scope& scope) const
+{
+  std::vector<const Stmt*> pending = {expr};
+  while (!pending.empty())
+  {
+    const Stmt* stmt = pending.back();
+    pending.pop_back();
+
+    // calls may return something different each time
+    if (isa<CallExpr>(stmt))
+    {
+      return false;
+    }
+
+    if (auto* ref = dyn_cast<DeclRefExpr>(stmt))
+    {
+      auto* var = dyn_cast<VarDecl>(ref->getDecl());
+      if (var && (var->getNameAsString() == scope.iterator || scope.linear.count(var) ||
+                  scope.written.count(var) || !isDeclaredBefore(var, scope.loop)))
+      {
+        return false;
+      }
+    }
+
+    for (const Stmt* child : stmt->children())
+    {
+      if (child)
+      {
+        pending.push_back(child);
+      }
+    }
+  }
+  return true;
+}
+
+bool SimdAnalyzer::isVectorMathCall(const CallExpr* call) const
+{
+  // libm routines compilers map onto vector math libraries
+  static const std::set<std::string> kVectorMath = {
+      "sqrt",  "sqrtf", "exp",  "expf",  "exp2",   "log",    "logf",  "log2",     "log10",
+      "sin",   "sinf",  "cos",  "cosf",  "tan",    "tanh",   "atan",  "atan2",    "pow",
+      "powf",  "fabs",  "fabsf", "abs",  "fmin",   "fminf",  "fmax",  "fmaxf",    "floor",
+      "floorf", "ceil", "ceilf", "round", "trunc", "fma",    "fmaf",  "cbrt",     "hypot",
+      "erf",   "copysign", "copysignf"};
+
+  auto* callee = call->getDirectCallee();
+  return callee && kVectorMath.count(callee->getNameAsString());
+}
+
+bool SimdAnalyzer::checkElementTypes(const std::vector<Access>& accesses, SimdPlan& plan) const
+{
+  for (const auto& access : accesses)
+  {
+    QualType type = access.expr->getType();
+    std::string name = access.array ? access.array->getNameAsString() : "an array";
+    if (!type->isIntegerType() && !type->isRealFloatingType())
+    {
+      plan.blocker = "elements of " + name + " aren't plain numbers";
+      return false;
+    }
+
+    unsigned bits = static_cast<unsigned>(context_->getTypeSize(type));
+    if (bits > 64)
+    {
+      plan.blocker = "elements of " + name + " are wider than any vector lane";
+      return false;
+    }
+    plan.element_bits = std::max(plan.element_bits, bits);
+  }
+  return plan.element_bits > 0;
+}
+
+bool SimdAnalyzer::checkRecurrences(const std::vector<Access>& accesses, const Scope& scope,
+                                    SimdPlan& plan) const
+{
+  long long distance = 0;
+  for (const auto& store : accesses)
+  {
+    if (!store.is_write)
+    {
+      continue;
+    }
+
+    // arrays declared in the body are private to each lane
+    if (store.array && !isDeclaredBefore(store.array, scope.loop))
+    {
+      continue;
+    }
+
+    std::string name = store.array ? store.array->getNameAsString() : "an array";
+    if (!store.array || !store.stride || std::llabs(*store.stride) != 1)
+    {
+      plan.blocker = store.stride && *store.stride == 0
+                         ? "every lane stores to the same element of " + name
+                         : "stores scatter into " + name;
+      return false;
+    }
+
+    std::string store_text = source_.getText(store.expr->getSourceRange());
+    for (const auto& other : accesses)
+    {
+      if (&other == &store || other.array != store.array)
+      {
+        continue;
+      }
+
+      // a[i] against a[i]: same element, same lane
+      if (!store.offset || !other.offset)
+      {
+        if (!store_text.empty() && source_.getText(other.expr->getSourceRange()) == store_text)
+        {
+          continue;
+        }
+        plan.blocker = "can't tell how far apart the accesses to " + name + " are";
+        return false;
+      }
+
+      long long gap = std::llabs(*store.offset - *other.offset);
+      if (gap == 1)
+      {
+        plan.blocker = name + " carries a recurrence between neighbouring iterations";
+        return false;
+      }
+      if (gap > 1)
+      {
+        distance = distance == 0 ? gap : std::min(distance, gap);
+      }
+    }
+  }
+
+  plan.safelen = static_cast<unsigned>(distance);
+  return true;
+}
+
+void SimdAnalyzer::chooseClauses(const std::vector<Access>& accesses, SimdPlan& plan) const
+{
+  // lanes of the widest element, capped to a power of two that fits under safelen
+  unsigned lanes = std::max(2u, kVectorBits / plan.element_bits);
+  while (plan.safelen > 0 && lanes > plan.safelen)
+  {
+    lanes /= 2;
+  }
+  plan.simdlen = lanes;
+
+  // aligned() is a promise, so only storage traced back to its allocation qualifies, and
+  // only when it covers at least one full vector register
+  for (const auto& access : accesses)
+  {
+    if (!access.array || !access.stride || std::llabs(*access.stride) != 1)
+    {
+      continue;
+    }
+
+    unsigned bytes = alignment_.knownAlignment(access.array);
+    std::string name = access.array->getNameAsString();
+    bool listed = std::any_of(plan.aligned.begin(), plan.aligned.end(),
+                              [&name](const std::pair<std::string, unsigned>& entry)
+                              { return entry.first == name; });
+    if (bytes >= kVectorBits / 8 && !listed)
+    {
+      plan.aligned.emplace_back(name, bytes);
+    }
+  }
+}
+
+void SimdAnalyzer::planPeel(const ForStmt* forLoop, const std::vector<Access>& accesses,
+                            const Scope& scope, SimdPlan& plan) const
+{
+  if (scope.step != 1)
+  {
+    return;
+  }
+
+  // misaligned stores cost more than loads, so line up the first contiguous store
+  const Access* target = nullptr;
+  for (const auto& access : accesses)
+  {
+    bool contiguous = access.array && access.offset && access.stride && *access.stride == 1;
+    if (contiguous && (!target || (access.is_write && !target->is_write)))
+    {
+      target = &access;
+    }
+  }
+  if (!target)
+  {
+    return;
+  }
+
+  long long element = static_cast<long long>(context_->getTypeSize(target->expr->getType()) / 8);
+  if (element == 0 || kPeelAlignment % element != 0)
+  {
+    return;
+  }
+
+  unsigned bytes = alignment_.knownAlignment(target->array);
+  auto start = startIndex(forLoop, scope);
+  if (bytes >= kPeelAlignment && start)
+  {
+    // the base sits on the boundary, so the first element's offset fixes the peel
+    long long misaligned = ((*start + *target->offset) * element) % kPeelAlignment;
+    misaligned = misaligned < 0 ? misaligned + kPeelAlignment : misaligned;
+    if (misaligned != 0 && misaligned % element == 0)
+    {
+      plan.peel_array = target->array->getNameAsString();
+      plan.peel_iterations = static_cast<unsigned>((kPeelAlignment - misaligned) / element);
+    }
+  }
+  else if (bytes < kPeelAlignment)
+  {
+    // a runtime peel runs until &a[i] crosses a boundary, never a full line's worth
+    plan.peel_array = target->array->getNameAsString();
+    plan.peel_iterations = 0;
+    plan.peel_limit = static_cast<unsigned>(kPeelAlignment / element - 1);
+  }
+}
+
+std::optional<long long> SimdAnalyzer::startIndex(const ForStmt* forLoop,
+                                                  const Scope& scope) const
+{
+  const Expr* value = nullptr;
+  if (auto* decl = dyn_cast_or_null<DeclStmt>(forLoop->getInit()))
+  {
+    auto* var = decl->isSingleDecl() ? dyn_cast<VarDecl>(decl->getSingleDecl()) : nullptr;
+    value = var && var->getNameAsString() == scope.iterator ? var->getInit() : nullptr;
+  }
+  else if (auto* assign = dyn_cast_or_null<BinaryOperator>(forLoop->getInit()))
+  {
+    value = assign->getOpcode() == BO_Assign ? assign->getRHS() : nullptr;
+  }
+
+  Expr::EvalResult result;
+  if (!value || !value->EvaluateAsInt(result, *context_))
+  {
+    return std::nullopt;
+  }
+  return result.Val.getInt().getExtValue();
+}
+
+void SimdAnalyzer::collectWritten(const Stmt* stmt, std::set<const ValueDecl*>& written) const
+{
+  if (!stmt)
+  {
+    return;
+  }
+
+  const Expr* target = nullptr;
+  if (auto* assign = dyn_cast<BinaryOperator>(stmt))
+  {
+    target = assign->isAssignmentOp() ? assign->getLHS() : nullptr;
+  }
+  else if (auto* unary = dyn_cast<UnaryOperator>(stmt))
+  {
+    bool writes = unary->isIncrementDecrementOp() || unary->getOpcode() == UO_AddrOf;
+    target = writes ? unary->getSubExpr() : nullptr;
+  }
+
+  if (auto* ref = target ? dyn_cast<DeclRefExpr>(target->IgnoreParenImpCasts()) : nullptr)
+  {
+    written.insert(ref->getDecl());
+  }
+
+  for (const Stmt* child : stmt->children())
+  {
+    collectWritten(child, written);
+  }
+}
+
+unsigned SimdAnalyzer::countWrites(const Stmt* stmt, const ValueDecl* decl) const
+{
+  if (!stmt)
+  {
+    return 0;
+  }
+
+  const Expr* target = nullptr;
+  if (auto* assign = dyn_cast<BinaryOperator>(stmt))
+  {
+    target = assign->isAssignmentOp() ? assign->getLHS() : nullptr;
+  }
+  else if (auto* unary = dyn_cast<UnaryOperator>(stmt))
+  {
+    bool writes = unary->isIncrementDecrementOp() || unary->getOpcode() == UO_AddrOf;
+    target = writes ? unary->getSubExpr() : nullptr;
+  }
+
+  auto* ref = target ? dyn_cast<DeclRefExpr>(target->IgnoreParenImpCasts()) : nullptr;
+  unsigned count = ref && ref->getDecl() == decl ? 1 : 0;
+  for (const Stmt* child : stmt->children())
+  {
+    count += countWrites(child, decl);
+  }
+  return count;
+}
+
+bool SimdAnalyzer::isDeclaredBefore(const ValueDecl* decl, const ForStmt* forLoop) const
+{
+  const SourceManager& sm = context_->getSourceManager();
+  return sm.isBeforeInTranslationUnit(decl->getLocation(), forLoop->getBeginLoc());
+}
+
+} // namespace paralyze
@@ -1,4 +1,6 @@
 #include "analyzer/SourceAnnotator.h"
+#include "analyzer/AnalysisStats.h"
+#include "llvm/Support/TimeProfiler.h"
 #include <algorithm>
 #include <fstream>
 #include <iostream>
@@ -12,6 +14,8 @@ void SourceAnnotator::annotateSourceWithPragmas(
     const std::string& input_filename, const std::vector<GeneratedPragma>& pragmas,
     const std::vector<PragmaInsertionPoint>& insertion_points)
 {
+  ScopedTimer timer(Phase::ANNOTATION);
+  llvm::TimeTraceScope trace("AnnotateSource", input_filename);
   std::cout << "\n=== Annotating Source with OpenMP Pragmas ===\n";
   std::cout << "Input file: " << input_filename << "\n";
 
@@ -29,6 +33,8 @@ void SourceAnnotator::annotateSourceWithPragmas(
 
 bool SourceAnnotator::writeAnnotatedFile(const std::string& output_filename)
 {
+  ScopedTimer timer(Phase::ANNOTATION);
+  llvm::TimeTraceScope trace("WriteAnnotatedFile", output_filename);
   std::ofstream outfile(output_filename);
   if (!outfile.is_open())
   {
@@ -40,14 +46,27 @@ bool SourceAnnotator::writeAnnotatedFile(const std::string& output_filename)
 
   for (const auto& line : annotated_lines_)
   {
+    for (const auto& inserted : line.inserted_before)
+    {
+      outfile << inserted << "\n";
+    }
+
     // Write pragma annotation first (if any)
     if (line.has_pragma)
     {
       outfile << line.pragma_annotation << "\n";
     }
 
-    // Write original line
-    outfile << line.original_content << "\n";
+    // Write original (or rewritten) line
+    if (!line.is_removed)
+    {
+      outfile << (line.is_rewritten ? line.rewritten_content : line.original_content) << "\n";
+    }
+
+    for (const auto& inserted : line.inserted_after)
+    {
+      outfile << inserted << "\n";
+    }
   }
 
   outfile.close();
@@ -116,8 +135,30 @@ void SourceAnnotator::insertPragmaAnnotations(
     if (insertion_it != insertion_points.end())
     {
       std::string indentation = getIndentationForLine(pragma.line_number);
-      std::string full_pragma = indentation + pragma.pragma_text;
+
+      // every line of a stacked pragma (parallel / single / taskloop) gets the loop's indentation
+      std::string full_pragma;
+      std::stringstream pragma_stream(pragma.pragma_text);
+      std::string pragma_line;
+      while (std::getline(pragma_stream, pragma_line))
+      {
+        if (!full_pragma.empty())
+          full_pragma += "\n";
+        full_pragma += indentation + pragma_line;
+      }
       pragma_map[pragma.line_number] = full_pragma;
+
+      // rewrites only make sense together with the pragma they enable
+      for (const auto& edit : pragma.edits)
+      {
+        applyLineEdit(edit);
+      }
+
+      if (!pragma.edits.empty())
+      {
+        std::cout << "  Rewriting loop at line " << pragma.line_number << " ("
+                  << pragma.edits.size() << " line edits)\n";
+      }
     }
   }
 
@@ -136,6 +177,42 @@ void SourceAnnotator::insertPragmaAnnotations(
   }
 }
 
+void SourceAnnotator::applyLineEdit(const LineEdit& edit)
+{
+  if (edit.line_number == 0 || edit.line_number > annotated_lines_.size())
+  {
+    return;
+  }
+
+  AnnotatedLine& line = annotated_lines_[edit.line_number - 1];
+
+  // split multi-line edit text so each output line is kept separately
+  std::vector<std::string> text_lines;
+  std::stringstream text_stream(edit.text);
+  std::string text_line;
+  while (std::getline(text_stream, text_line))
+  {
+    text_lines.push_back(text_line);
+  }
+
+  switch (edit.kind)
+  {
+  case LineEditKind::REPLACE:
+    line.is_rewritten = true;
+    line.rewritten_content = edit.text;
+    break;
+  case LineEditKind::REMOVE:
+    line.is_removed = true;
+    break;
+  case LineEditKind::INSERT_BEFORE:
+    line.inserted_before.insert(line.inserted_before.end(), text_lines.begin(), text_lines.end());
+    break;
+  case LineEditKind::INSERT_AFTER:
+    line.inserted_after.insert(line.inserted_after.end(), text_lines.begin(), text_lines.end());
+    break;
+  }
+}
+
 std::string SourceAnnotator::getIndentationForLine(unsigned line_number)
 {
   // find the line and extract its indentation
@@ -0,0 +1,139 @@
+#include "analyzer/SourceTextReader.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Lex/Lexer.h"
+
+using namespace clang;
+
+namespace paralyze
+{
+
+std::string SourceTextReader::getText(SourceRange range) const
+{
+  if (!isRewritable(range))
+  {
+    return "";
+  }
+
+  return Lexer::getSourceText(CharSourceRange::getTokenRange(range), context_->getSourceManager(),
+                              context_->getLangOpts())
+      .str();
+}
+
+std::string SourceTextReader::getWrittenText(SourceRange range) const
+{
+  if (range.getBegin().isInvalid() || range.getEnd().isInvalid())
+  {
+    return "";
+  }
+
+  SourceManager& sm = context_->getSourceManager();
+  CharSourceRange written = sm.getExpansionRange(range);
+  if (!sm.isInMainFile(written.getBegin()) || !sm.isInMainFile(written.getEnd()))
+  {
+    return "";
+  }
+  return Lexer::getSourceText(written, sm, context_->getLangOpts()).str();
+}
+
+std::string SourceTextReader::getLineText(unsigned line) const
+{
+  SourceManager& sm = context_->getSourceManager();
+  FileID file_id = sm.getMainFileID();
+
+  SourceLocation line_start = sm.translateLineCol(file_id, line, 1);
+  if (line_start.isInvalid())
+  {
+    return "";
+  }
+
+  StringRef buffer = sm.getBufferData(file_id);
+  unsigned offset = sm.getFileOffset(line_start);
+  if (offset >= buffer.size())
+  {
+    return "";
+  }
+
+  StringRef rest = buffer.substr(offset);
+  return rest.substr(0, rest.find_first_of("\r\n")).str();
+}
+
+std::string SourceTextReader::getIndentation(unsigned line) const
+{
+  std::string content = getLineText(line);
+  size_t first_non_space = content.find_first_not_of(" \t");
+  if (first_non_space == std::string::npos)
+  {
+    return content;
+  }
+  return content.substr(0, first_non_space);
+}
+
+unsigned SourceTextReader::getLine(SourceLocation loc) const
+{
+  return context_->getSourceManager().getSpellingLineNumber(loc);
+}
+
+unsigned SourceTextReader::getColumn(SourceLocation loc) const
+{
+  return context_->getSourceManager().getSpellingColumnNumber(loc);
+}
+
+unsigned SourceTextReader::getEndColumn(SourceLocation loc) const
+{
+  SourceManager& sm = context_->getSourceManager();
+  SourceLocation end = Lexer::getLocForEndOfToken(loc, 0, sm, context_->getLangOpts());
+  if (end.isInvalid())
+  {
+    return getColumn(loc) + 1;
+  }
+  return sm.getSpellingColumnNumber(end);
+}
+
+bool SourceTextReader::isRewritable(SourceRange range) const
+{
+  if (range.getBegin().isInvalid() || range.getEnd().isInvalid())
+  {
+    return false;
+  }
+
+  if (range.getBegin().isMacroID() || range.getEnd().isMacroID())
+  {
+    return false;
+  }
+
+  SourceManager& sm = context_->getSourceManager();
+  return sm.isInMainFile(range.getBegin()) && sm.isInMainFile(range.getEnd());
+}
+
+bool SourceTextReader::startsLine(SourceLocation loc) const
+{
+  std::string content = getLineText(getLine(loc));
+  unsigned col = getColumn(loc);
+  if (col == 0 || col - 1 > content.size())
+  {
+    return false;
+  }
+
+  return content.substr(0, col - 1).find_first_not_of(" \t") == std::string::npos;
+}
+
+bool SourceTextReader::endsLine(SourceLocation loc) const
+{
+  std::string content = getLineText(getLine(loc));
+  unsigned end_col = getEndColumn(loc);
+  if (end_col == 0 || end_col - 1 > content.size())
+  {
+    return false;
+  }
+
+  // a single trailing ';' still counts, so unbraced statement bodies qualify
+  std::string rest = content.substr(end_col - 1);
+  size_t first = rest.find_first_not_of(" \t");
+  if (first != std::string::npos && rest[first] == ';')
+  {
+    first = rest.find_first_not_of(" \t", first + 1);
+  }
+  return first == std::string::npos || rest.compare(first, 2, "//") == 0;
+}
+
+} // namespace paralyze
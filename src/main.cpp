@@ -1,8 +1,13 @@
 #include "analyzer/ASTVisitor.h"
+#include "analyzer/AnalysisStats.h"
+#include "analyzer/MachineProbe.h"
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Frontend/FrontendActions.h"
 #include "clang/Tooling/CommonOptionsParser.h"
 #include "clang/Tooling/Tooling.h"
+#include "llvm/Support/TimeProfiler.h"
+#include <algorithm>
+#include <cstdlib>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -16,6 +21,15 @@ using namespace clang::tooling;
 bool generate_pragmas = false;
 bool verbose_mode = false;
 std::string output_filename;
+paralyze::ProcBindPolicy proc_bind_policy = paralyze::ProcBindPolicy::AUTO;
+double peak_gflops = 0.0;   // whole machine, 0 keeps the default
+double bandwidth_gbs = 0.0; // whole machine, 0 keeps the default or the measurement
+bool measure_bandwidth = false;
+bool insert_prefetches = false;
+paralyze::ReportFormat report_format = paralyze::ReportFormat::TEXT;
+bool print_stats = false;
+bool stats_as_json = false;
+std::string trace_filename; // --trace, Chrome trace-event JSON like clang -ftime-trace
 
 // generate output filename by adding "_openmp" before extension
 std::string generateOutputFilename(const std::string& input_file)
@@ -41,12 +55,23 @@ private:
   std::string output_filename_;
   std::string input_filename_;
   bool verbose_;
+  paralyze::ProcBindPolicy proc_bind_;
+  paralyze::MachineModel machine_;
+  bool prefetch_;
+  paralyze::ReportFormat format_;
+  std::ostream* report_;
 
 public:
   AnalyzerAction(bool gen_pragmas = false, const std::string& output = "",
-                 const std::string& input = "", bool verbose = false)
+                 const std::string& input = "", bool verbose = false,
+                 paralyze::ProcBindPolicy proc_bind = paralyze::ProcBindPolicy::AUTO,
+                 const paralyze::MachineModel& machine = paralyze::MachineModel(),
+                 bool prefetch = false,
+                 paralyze::ReportFormat format = paralyze::ReportFormat::TEXT,
+                 std::ostream* report = nullptr)
       : generate_pragmas_(gen_pragmas), output_filename_(output), input_filename_(input),
-        verbose_(verbose)
+        verbose_(verbose), proc_bind_(proc_bind), machine_(machine), prefetch_(prefetch),
+        format_(format), report_(report)
   {
   }
 
@@ -59,13 +84,16 @@ public:
   }
 
   std::unique_ptr<ASTConsumer> CreateASTConsumer(CompilerInstance& compiler,
-                                                 StringRef file) override
+                                                 StringRef) override
   {
     auto consumer = std::make_unique<paralyze::AnalyzerConsumer>(&compiler.getASTContext());
 
     if (generate_pragmas_)
     {
       consumer->enablePragmaGeneration(output_filename_, input_filename_);
+      consumer->setProcBindPolicy(proc_bind_);
+      consumer->setMachine(machine_);
+      consumer->setPrefetch(prefetch_);
       consumer->setVerbose(false);
       consumer->setPragmaVerbose(verbose_);
     }
@@ -73,7 +101,9 @@ public:
     {
       consumer->setVerbose(verbose_);
       consumer->setPragmaVerbose(false);
+      consumer->setMachine(machine_);
     }
+    consumer->setReport(format_, report_, input_filename_);
 
     return consumer;
   }
@@ -94,6 +124,19 @@ void printUsage(const char* progName)
   std::cout << "OPTIONS:\n";
   std::cout << "  --generate-pragmas    Generate OpenMP pragma annotations\n";
   std::cout << "  --verbose            Show detailed analysis information\n";
+  std::cout << "  --proc-bind=POLICY   Thread placement for parallel loops: auto (default,\n";
+  std::cout << "                       spread if memory-bound, close if compute-bound),\n";
+  std::cout << "                       spread, close, master or none\n";
+  std::cout << "  --peak-gflops=N      Machine peak for the roofline (default 16 per core)\n";
+  std::cout << "  --bandwidth=N        Machine memory bandwidth in GB/s (default 40)\n";
+  std::cout << "  --measure-bandwidth  Time a STREAM triad here instead of assuming bandwidth\n";
+  std::cout << "  --prefetch           Prefetch indirect gathers like x[col[j]] a few iterations\n";
+  std::cout << "                       ahead (with --generate-pragmas)\n";
+  std::cout << "  --format=FORMAT      Report as text (default), json or sarif on stdout\n";
+  std::cout << "                       (anything else the tool prints then goes to stderr)\n";
+  std::cout << "  --stats[=json]       Phase times and counters on stderr, as a table or JSON\n";
+  std::cout << "  --trace FILE         Write analysis spans as Chrome trace events (the format\n";
+  std::cout << "                       of clang -ftime-trace) for chrome://tracing or Perfetto\n";
   std::cout << "  -h, --help           Show this help message\n";
   std::cout << "  -v, --version        Show version information\n\n";
 }
@@ -143,6 +186,20 @@ void printModeInfo(const std::string& input_file)
   }
 }
 
+// positive number after the '=' of a --name=value option
+bool parseRate(const std::string& arg, double& value)
+{
+  std::string text = arg.substr(arg.find('=') + 1);
+  char* end = nullptr;
+  value = std::strtod(text.c_str(), &end);
+  if (text.empty() || *end != '\0' || value <= 0.0)
+  {
+    std::cerr << "Error: Expected a positive number in '" << arg << "'\n";
+    return false;
+  }
+  return true;
+}
+
 // parse CLI args and set global flags
 bool parseArgs(int argc, char** argv, std::string& input_file)
 {
@@ -168,6 +225,74 @@ bool parseArgs(int argc, char** argv, std::string& input_file)
     {
       verbose_mode = true;
     }
+    else if (arg.rfind("--proc-bind=", 0) == 0)
+    {
+      std::string policy = arg.substr(std::string("--proc-bind=").size());
+      if (policy == "auto")
+        proc_bind_policy = paralyze::ProcBindPolicy::AUTO;
+      else if (policy == "spread")
+        proc_bind_policy = paralyze::ProcBindPolicy::SPREAD;
+      else if (policy == "close")
+        proc_bind_policy = paralyze::ProcBindPolicy::CLOSE;
+      else if (policy == "master")
+        proc_bind_policy = paralyze::ProcBindPolicy::MASTER;
+      else if (policy == "none")
+        proc_bind_policy = paralyze::ProcBindPolicy::NONE;
+      else
+      {
+        std::cerr << "Error: Unknown proc_bind policy '" << policy << "'\n";
+        std::cerr << "Use --help for usage information.\n";
+        return false;
+      }
+    }
+    else if (arg.rfind("--peak-gflops=", 0) == 0)
+    {
+      if (!parseRate(arg, peak_gflops))
+        return false;
+    }
+    else if (arg.rfind("--bandwidth=", 0) == 0)
+    {
+      if (!parseRate(arg, bandwidth_gbs))
+        return false;
+    }
+    else if (arg == "--measure-bandwidth")
+    {
+      measure_bandwidth = true;
+    }
+    else if (arg == "--prefetch")
+    {
+      insert_prefetches = true;
+    }
+    else if (arg.rfind("--format=", 0) == 0)
+    {
+      std::string format = arg.substr(std::string("--format=").size());
+      if (format == "text")
+        report_format = paralyze::ReportFormat::TEXT;
+      else if (format == "json")
+        report_format = paralyze::ReportFormat::JSON;
+      else if (format == "sarif")
+        report_format = paralyze::ReportFormat::SARIF;
+      else
+      {
+        std::cerr << "Error: Unknown report format '" << format << "'\n";
+        std::cerr << "Use --help for usage information.\n";
+        return false;
+      }
+    }
+    else if (arg == "--stats" || arg == "--stats=json")
+    {
+      print_stats = true;
+      stats_as_json = arg == "--stats=json";
+    }
+    else if (arg == "--trace" || arg.rfind("--trace=", 0) == 0)
+    {
+      if (arg == "--trace" && i + 1 >= argc)
+      {
+        std::cerr << "Error: --trace needs an output file\n";
+        return false;
+      }
+      trace_filename = arg == "--trace" ? argv[++i] : arg.substr(std::string("--trace=").size());
+    }
     else if (!arg.empty() && arg[0] != '-')
     {
       input_file = arg;
@@ -209,6 +334,14 @@ int main(int argc, char** argv)
     output_filename = generateOutputFilename(input_file);
   }
 
+  // json and sarif own stdout; everything else the tool prints moves to stderr
+  std::ostream report(std::cout.rdbuf());
+  bool machine_report = report_format != paralyze::ReportFormat::TEXT;
+  if (machine_report)
+  {
+    std::cout.rdbuf(std::cerr.rdbuf());
+  }
+
   // show current mode
   printModeInfo(input_file);
 
@@ -224,12 +357,63 @@ int main(int argc, char** argv)
   std::string source_code((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
   file.close();
 
+  // roofs for the roofline; numbers given on the command line beat the probe
+  paralyze::MachineModel machine;
+  if (measure_bandwidth)
+  {
+    machine = paralyze::MachineProbe().measure(machine);
+    std::cout << "Measured triad bandwidth: " << machine.core_bandwidth_gbs
+              << " GB/s on one thread, " << machine.bandwidth_gbs << " GB/s on " << machine.cores
+              << "\n";
+  }
+  if (peak_gflops > 0.0)
+  {
+    machine.core_gflops = peak_gflops / machine.cores;
+  }
+  if (bandwidth_gbs > 0.0)
+  {
+    machine.bandwidth_gbs = bandwidth_gbs;
+    machine.core_bandwidth_gbs = std::min(machine.core_bandwidth_gbs, bandwidth_gbs);
+  }
+
+  paralyze::AnalysisStats::get().setEnabled(print_stats);
+
   // create analyzer frontend action
   std::unique_ptr<FrontendAction> action =
-      std::make_unique<AnalyzerAction>(generate_pragmas, output_filename, input_file, verbose_mode);
+      std::make_unique<AnalyzerAction>(generate_pragmas, output_filename, input_file, verbose_mode,
+                                       proc_bind_policy, machine, insert_prefetches,
+                                       report_format, &report);
+
+  // every span is kept; a loop analysis is far shorter than clang's 500us default
+  if (!trace_filename.empty())
+  {
+    llvm::timeTraceProfilerInitialize(0, "paralyze");
+  }
 
   // run clang tooling
-  bool result = runToolOnCode(std::move(action), source_code, input_file);
+  bool result;
+  {
+    llvm::TimeTraceScope trace("ExecuteCompiler", input_file);
+    result = runToolOnCode(std::move(action), source_code, input_file);
+  }
+
+  if (!trace_filename.empty())
+  {
+    if (llvm::Error error = llvm::timeTraceProfilerWrite(trace_filename, input_file))
+    {
+      std::cerr << "Error: Could not write trace: " << llvm::toString(std::move(error)) << "\n";
+    }
+    llvm::timeTraceProfilerCleanup();
+  }
+
+  // stderr, so stdout stays the same with or without --stats
+  if (print_stats)
+  {
+    if (stats_as_json)
+      paralyze::AnalysisStats::get().printJson(std::cerr);
+    else
+      paralyze::AnalysisStats::get().printTable(std::cerr);
+  }
 
   if (!result)
   {
@@ -237,6 +421,12 @@ int main(int argc, char** argv)
     return 1;
   }
 
+  if (machine_report)
+  {
+    std::cout.rdbuf(report.rdbuf());
+    return 0;
+  }
+
   std::cout << "\nAnalysis completed successfully.\n";
   return 0;
 }
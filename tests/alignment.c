@@ -0,0 +1,64 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#define N 100000
+
+static double lattice[N] __attribute__((aligned(64)));
+
+// Buffers from aligned_alloc - aligned(x:64) aligned(y:64)
+void scale_aligned(double a, int n) {
+    double* x = aligned_alloc(64, n * sizeof(double));
+    double* y = aligned_alloc(64, n * sizeof(double));
+    for (int i = 0; i < n; i++) {
+        x[i] = i;
+    }
+    for (int i = 0; i < n; i++) {
+        y[i] = a * x[i];
+    }
+    printf("%f\n", y[n - 1]);
+    free(x);
+    free(y);
+}
+
+// posix_memalign through the address - aligned(buf:32)
+void fill_memalign(int n) {
+    float* buf;
+    if (posix_memalign((void**)&buf, 32, n * sizeof(float)) != 0) {
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        buf[i] = 0.5f * i;
+    }
+    printf("%f\n", buf[n - 1]);
+    free(buf);
+}
+
+// 64-byte aligned base, first store at lattice[1] - peeling 7 iterations realigns it
+void shift(void) {
+    for (int i = 1; i < N; i++) {
+        lattice[i] = 0.5 * i;
+    }
+}
+
+// Parameter of unknown alignment - runtime peel report, no aligned clause
+void axpy(double a, double* x, double* y, double* z, int n) {
+    for (int i = 0; i < n; i++) {
+        z[i] = a * x[i] + y[i];
+    }
+}
+
+int main() {
+    static double x[N], y[N], z[N];
+    for (int i = 0; i < N; i++) {
+        x[i] = i;
+        lattice[i] = 1.0;
+    }
+
+    scale_aligned(2.0, N);
+    fill_memalign(N);
+    shift();
+    axpy(2.0, x, y, z, N);
+
+    printf("%f %f\n", lattice[N - 1], z[N - 1]);
+    return 0;
+}
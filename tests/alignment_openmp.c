@@ -0,0 +1,78 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+
+#define N 100000
+
+static double lattice[N] __attribute__((aligned(64)));
+
+// Buffers from aligned_alloc - aligned(x:64) aligned(y:64)
+void scale_aligned(double a, int n) {
+    double* x = aligned_alloc(64, n * sizeof(double));
+    double* y = aligned_alloc(64, n * sizeof(double));
+    #pragma omp parallel if(n > 6668 || n > 6668) proc_bind(spread)
+    {
+    #pragma omp for simd simdlen(4) aligned(x:64) schedule(static)
+    for (int i = 0; i < n; i++) {
+        x[i] = i;
+    }
+    #pragma omp for simd simdlen(4) aligned(y:64) aligned(x:64) schedule(static) nowait
+    for (int i = 0; i < n; i++) {
+        y[i] = a * x[i];
+    }
+    }
+    printf("%f\n", y[n - 1]);
+    free(x);
+    free(y);
+}
+
+// posix_memalign through the address - aligned(buf:32)
+void fill_memalign(int n) {
+    float* buf;
+    if (posix_memalign((void**)&buf, 32, n * sizeof(float)) != 0) {
+        return;
+    }
+    #pragma omp parallel for simd simdlen(8) aligned(buf:32) if(n > 8000) num_threads(n <= 8000 ? 1 : n / 4000 < omp_get_max_threads() ? n / 4000 : omp_get_max_threads()) proc_bind(close)
+    for (int i = 0; i < n; i++) {
+        buf[i] = 0.5f * i;
+    }
+    printf("%f\n", buf[n - 1]);
+    free(buf);
+}
+
+// 64-byte aligned base, first store at lattice[1] - peeling 7 iterations realigns it
+void shift(void) {
+    #pragma omp parallel for simd simdlen(4) aligned(lattice:64) if((N - 1) > 8000) num_threads((N - 1) <= 8000 ? 1 : (N - 1) / 4000 < omp_get_max_threads() ? (N - 1) / 4000 : omp_get_max_threads()) proc_bind(close)
+    for (int i = 1; i < N; i++) {
+        lattice[i] = 0.5 * i;
+    }
+}
+
+// Parameter of unknown alignment - runtime peel report, no aligned clause
+void axpy(double a, double* x, double* y, double* z, int n) {
+    #pragma omp parallel for simd simdlen(4) if(n > 5000) num_threads(n <= 5000 ? 1 : n / 2500 < omp_get_max_threads() ? n / 2500 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < n; i++) {
+        z[i] = a * x[i] + y[i];
+    }
+}
+
+int main() {
+    static double x[N], y[N], z[N];
+    #pragma omp parallel for simd simdlen(4) aligned(lattice:64) if(N > 6668) num_threads(N <= 6668 ? 1 : N / 3334 < omp_get_max_threads() ? N / 3334 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < N; i++) {
+        x[i] = i;
+        lattice[i] = 1.0;
+    }
+
+    scale_aligned(2.0, N);
+    fill_memalign(N);
+    shift();
+    axpy(2.0, x, y, z, N);
+
+    printf("%f %f\n", lattice[N - 1], z[N - 1]);
+    return 0;
+}
@@ -1,3 +1,8 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
 // Testing array access dependency patterns
 
 #include <stdio.h>
@@ -6,7 +11,7 @@
 void test_independent_access() {
     int src[50], dst[50];
     
-    #pragma omp parallel for simd
+    #pragma omp parallel for simd simdlen(8) if(50 > 6668) num_threads(50 <= 6668 ? 1 : 50 / 3334 < omp_get_max_threads() ? 50 / 3334 : omp_get_max_threads()) proc_bind(spread)
     for (int i = 0; i < 50; i++) {
         dst[i] = src[i] * 2;
     }
@@ -34,7 +39,7 @@ void test_loop_carried() {
 void test_write_only() {
     int results[30];
     
-    #pragma omp parallel for simd
+    #pragma omp parallel for simd simdlen(8) if(30 > 8000) num_threads(30 <= 8000 ? 1 : 30 / 4000 < omp_get_max_threads() ? 30 / 4000 : omp_get_max_threads()) proc_bind(close)
     for (int i = 0; i < 30; i++) {
         results[i] = i * i;
     }
@@ -44,6 +49,7 @@ void test_write_only() {
 void test_constant_offset() {
     int data[50];
     
+    #pragma omp simd simdlen(2) safelen(3)
     for (int i = 0; i < 45; i++) {
         data[i+3] = data[i] + 1;
     }
@@ -53,7 +59,7 @@ void test_constant_offset() {
 void test_multiple_arrays() {
     int a[25], b[25], c[25];
     
-    #pragma omp parallel for simd
+    #pragma omp parallel for simd simdlen(8) if(25 > 5716) num_threads(25 <= 5716 ? 1 : 25 / 2858 < omp_get_max_threads() ? 25 / 2858 : omp_get_max_threads()) proc_bind(spread)
     for (int i = 0; i < 25; i++) {
         c[i] = a[i] + b[i];
     }
@@ -0,0 +1,116 @@
+#include <stdio.h>
+
+#define N 1000
+
+// Counted while loop - should be converted to a for loop
+void scale(double* a, double* b, int n) {
+    int i = 0;
+    while (i < n) {
+        a[i] = b[i] * 2.0;
+        i++;
+    }
+}
+
+// Counter reset by assignment, counting down - should be converted
+void reverse_fill(int* a, int n) {
+    int i;
+    i = n - 1;
+    while (i >= 0) {
+        a[i] = i * 3;
+        i--;
+    }
+}
+
+// Start value set on a line it shares with other code - converted, and the
+// assignment moves into the header instead of running twice
+void ramp(int* a, int n) {
+    int i, t;
+    t = 1; i = 2;
+    while (i < n) {
+        a[i] = i * t;
+        i++;
+    }
+}
+
+// != test is only a worksharing loop from OpenMP 5.0 on - stays as is
+void fill_to(int* a, int n) {
+    int i = 0;
+    while (i != n) {
+        a[i] = 1;
+        i++;
+    }
+}
+
+// Do-while with constant bounds - first test holds, should be converted
+void clear_buffer(float buf[N]) {
+    int k = 0;
+    do {
+        buf[k] = 0.0f;
+        k += 1;
+    } while (k < N);
+}
+
+// Do-while with unknown bound - may run once with n <= 0, stays as is
+void clear_some(float* buf, int n) {
+    int k = 0;
+    do {
+        buf[k] = 0.0f;
+        k++;
+    } while (k < n);
+}
+
+// Bound changes inside the body - not countable
+void shrink(int* a, int n) {
+    int i = 0;
+    while (i < n) {
+        a[i] = 0;
+        n--;
+        i++;
+    }
+}
+
+// Continue skips the step - not countable
+void skip_negative(int* a, int n) {
+    int i = 0;
+    while (i < n) {
+        if (a[i] < 0) {
+            continue;
+        }
+        a[i] = a[i] * 2;
+        i++;
+    }
+}
+
+// Counted while loop accumulating into a histogram - converted, and hist gets
+// the same reduction(+:hist[0:256]) its for-loop twin would
+void count_keys(int hist[256], const int* key, int n) {
+    int i = 0;
+    while (i < n) {
+        hist[key[i] & 255]++;
+        i++;
+    }
+}
+
+int main() {
+    double a[N], b[N];
+    int c[N];
+    float buf[N];
+    int hist[256] = {0};
+
+    for (int i = 0; i < N; i++) {
+        b[i] = i;
+    }
+
+    scale(a, b, N);
+    reverse_fill(c, N);
+    ramp(c, N);
+    fill_to(c, N);
+    clear_buffer(buf);
+    clear_some(buf, N);
+    shrink(c, N);
+    skip_negative(c, N);
+    count_keys(hist, c, N);
+
+    printf("%f %d %f %d\n", a[10], c[10], buf[10], hist[0]);
+    return 0;
+}
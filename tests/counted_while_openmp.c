@@ -0,0 +1,121 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
+#include <stdio.h>
+
+#define N 1000
+
+// Counted while loop - should be converted to a for loop
+void scale(double* a, double* b, int n) {
+    int i = 0;
+    #pragma omp parallel for lastprivate(i) if(n > 6668) num_threads(n <= 6668 ? 1 : n / 3334 < omp_get_max_threads() ? n / 3334 : omp_get_max_threads()) proc_bind(spread)
+    for (i = 0; i < n; i++) {
+        a[i] = b[i] * 2.0;
+    }
+}
+
+// Counter reset by assignment, counting down - should be converted
+void reverse_fill(int* a, int n) {
+    int i;
+    #pragma omp parallel for lastprivate(i) if(((n - 1) + 1) > 8000) num_threads(((n - 1) + 1) <= 8000 ? 1 : ((n - 1) + 1) / 4000 < omp_get_max_threads() ? ((n - 1) + 1) / 4000 : omp_get_max_threads()) proc_bind(close)
+    for (i = n - 1; i >= 0; i--) {
+        a[i] = i * 3;
+    }
+}
+
+// Start value set on a line it shares with other code - converted, and the
+// assignment moves into the header instead of running twice
+void ramp(int* a, int n) {
+    int i, t;
+    t = 1; ;
+    #pragma omp parallel for lastprivate(i) if((n - 2) > 8000) num_threads((n - 2) <= 8000 ? 1 : (n - 2) / 4000 < omp_get_max_threads() ? (n - 2) / 4000 : omp_get_max_threads()) proc_bind(close)
+    for (i = 2; i < n; i++) {
+        a[i] = i * t;
+    }
+}
+
+// != test is only a worksharing loop from OpenMP 5.0 on - stays as is
+void fill_to(int* a, int n) {
+    int i = 0;
+    while (i != n) {
+        a[i] = 1;
+        i++;
+    }
+}
+
+// Do-while with constant bounds - first test holds, should be converted
+void clear_buffer(float buf[N]) {
+    int k = 0;
+    #pragma omp parallel for lastprivate(k) if(N > 10000) num_threads(N <= 10000 ? 1 : N / 5000 < omp_get_max_threads() ? N / 5000 : omp_get_max_threads()) proc_bind(spread)
+    for (k = 0; k < N; k += 1) {
+        buf[k] = 0.0f;
+    }
+}
+
+// Do-while with unknown bound - may run once with n <= 0, stays as is
+void clear_some(float* buf, int n) {
+    int k = 0;
+    do {
+        buf[k] = 0.0f;
+        k++;
+    } while (k < n);
+}
+
+// Bound changes inside the body - not countable
+void shrink(int* a, int n) {
+    int i = 0;
+    while (i < n) {
+        a[i] = 0;
+        n--;
+        i++;
+    }
+}
+
+// Continue skips the step - not countable
+void skip_negative(int* a, int n) {
+    int i = 0;
+    while (i < n) {
+        if (a[i] < 0) {
+            continue;
+        }
+        a[i] = a[i] * 2;
+        i++;
+    }
+}
+
+// Counted while loop accumulating into a histogram - converted, and hist gets
+// the same reduction(+:hist[0:256]) its for-loop twin would
+void count_keys(int hist[256], const int* key, int n) {
+    int i = 0;
+    #pragma omp parallel for reduction(+:hist[0:256]) lastprivate(i) if(n > 8000) num_threads(n <= 8000 ? 1 : n / 4000 < omp_get_max_threads() ? n / 4000 : omp_get_max_threads()) proc_bind(spread)
+    for (i = 0; i < n; i++) {
+        hist[key[i] & 255]++;
+    }
+}
+
+int main() {
+    double a[N], b[N];
+    int c[N];
+    float buf[N];
+    int hist[256] = {0};
+
+    #pragma omp parallel for simd simdlen(4) if(N > 10000) num_threads(N <= 10000 ? 1 : N / 5000 < omp_get_max_threads() ? N / 5000 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < N; i++) {
+        b[i] = i;
+    }
+
+    scale(a, b, N);
+    reverse_fill(c, N);
+    ramp(c, N);
+    fill_to(c, N);
+    clear_buffer(buf);
+    clear_some(buf, N);
+    shrink(c, N);
+    skip_negative(c, N);
+    count_keys(hist, c, N);
+
+    printf("%f %d %f %d\n", a[10], c[10], buf[10], hist[0]);
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include <stdio.h>
+
+#define N 1000
+#define TSTEPS 20
+
+// seidel-2d: every point waits on its north and west neighbours - ordered(2) pipeline
+void seidel_2d(double A[N][N]) {
+    for (int t = 0; t < TSTEPS; t++) {
+        for (int i = 1; i < N - 1; i++) {
+            for (int j = 1; j < N - 1; j++) {
+                A[i][j] = (A[i - 1][j] + A[i][j - 1] + A[i][j] + A[i + 1][j] + A[i][j + 1]) / 5.0;
+            }
+        }
+    }
+}
+
+// 2-D recurrence with an unbraced body - ordered(2) pipeline
+void recurrence(double A[N][N], double B[N][N]) {
+    for (int i = 1; i < N; i++) {
+        for (int j = 1; j < N; j++)
+            A[i][j] = A[i - 1][j] + A[i][j - 1] + B[i][j];
+    }
+}
+
+// Indirect column index - distance is not constant, stays serial
+void indirect(double A[N][N], int* col) {
+    for (int i = 1; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            A[i][j] = A[i - 1][col[j]] * 0.5;
+        }
+    }
+}
+
+int main() {
+    static double A[N][N], B[N][N];
+    static int col[N];
+
+    for (int i = 0; i < N; i++) {
+        col[i] = (i * 7) % N;
+    }
+
+    seidel_2d(A);
+    recurrence(A, B);
+    indirect(A, col);
+
+    printf("%f\n", A[N / 2][N / 2]);
+    return 0;
+}
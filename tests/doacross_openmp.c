@@ -0,0 +1,62 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
+#include <stdio.h>
+
+#define N 1000
+#define TSTEPS 20
+
+// seidel-2d: every point waits on its north and west neighbours - ordered(2) pipeline
+void seidel_2d(double A[N][N]) {
+    for (int t = 0; t < TSTEPS; t++) {
+        #pragma omp parallel for ordered(2) if(((N - 1) - 1) > 2) num_threads(((N - 1) - 1) <= 2 ? 1 : ((N - 1) - 1) < omp_get_max_threads() ? ((N - 1) - 1) : omp_get_max_threads()) proc_bind(spread)
+        for (int i = 1; i < N - 1; i++) {
+            for (int j = 1; j < N - 1; j++) {
+                #pragma omp ordered depend(sink: i-1, j) depend(sink: i, j-1)
+                A[i][j] = (A[i - 1][j] + A[i][j - 1] + A[i][j] + A[i + 1][j] + A[i][j + 1]) / 5.0;
+                #pragma omp ordered depend(source)
+            }
+        }
+    }
+}
+
+// 2-D recurrence with an unbraced body - ordered(2) pipeline
+void recurrence(double A[N][N], double B[N][N]) {
+    #pragma omp parallel for ordered(2) if((N - 1) > 4) num_threads((N - 1) <= 4 ? 1 : (N - 1) / 2 < omp_get_max_threads() ? (N - 1) / 2 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 1; i < N; i++) {
+        for (int j = 1; j < N; j++)
+        {
+            #pragma omp ordered depend(sink: i-1, j) depend(sink: i, j-1)
+            A[i][j] = A[i - 1][j] + A[i][j - 1] + B[i][j];
+            #pragma omp ordered depend(source)
+        }
+    }
+}
+
+// Indirect column index - distance is not constant, stays serial
+void indirect(double A[N][N], int* col) {
+    for (int i = 1; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            A[i][j] = A[i - 1][col[j]] * 0.5;
+        }
+    }
+}
+
+int main() {
+    static double A[N][N], B[N][N];
+    static int col[N];
+
+    #pragma omp parallel for simd simdlen(8) if(N > 6668) num_threads(N <= 6668 ? 1 : N / 3334 < omp_get_max_threads() ? N / 3334 : omp_get_max_threads()) proc_bind(close)
+    for (int i = 0; i < N; i++) {
+        col[i] = (i * 7) % N;
+    }
+
+    seidel_2d(A);
+    recurrence(A, B);
+    indirect(A, col);
+
+    printf("%f\n", A[N / 2][N / 2]);
+    return 0;
+}
@@ -0,0 +1,82 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+
+// Initializer and consumer walk the same rows - both get schedule(static) and the same team
+void stream_triad(int n) {
+    double* a = malloc(n * sizeof(double));
+    double* b = malloc(n * sizeof(double));
+    double* c = malloc(n * sizeof(double));
+
+    #pragma omp parallel if(n > 5000 || n > 5000) proc_bind(spread)
+    {
+    #pragma omp for simd simdlen(4) schedule(static)
+    for (int i = 0; i < n; i++) {
+        a[i] = 0.0;
+        b[i] = 1.0;
+        c[i] = 2.0;
+    }
+
+    #pragma omp for simd simdlen(4) schedule(static) nowait
+    for (int i = 0; i < n; i++) {
+        a[i] = b[i] + 3.0 * c[i];
+    }
+    }
+
+    printf("%f\n", a[n - 1]);
+    free(a);
+    free(b);
+    free(c);
+}
+
+// Seeded initializer stays serial - reported, the pages all land on one socket
+void seeded(int n) {
+    double* x = malloc(n * sizeof(double));
+    unsigned seed = 42;
+
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        x[i] = (double)(seed % 1000);
+    }
+
+    #pragma omp parallel for simd simdlen(4) if(n > 10000) num_threads(n <= 10000 ? 1 : n / 5000 < omp_get_max_threads() ? n / 5000 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < n; i++) {
+        x[i] *= 0.5;
+    }
+
+    printf("%f\n", x[n - 1]);
+    free(x);
+}
+
+// Row-wise 2-D initializer matched to a row-parallel sweep
+void rows(int n, double m[][512]) {
+    #pragma omp parallel if(n > 10 || n > 10) proc_bind(spread)
+    {
+    #pragma omp for schedule(static)
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < 512; j++) {
+            m[i][j] = i + j;
+        }
+    }
+
+    #pragma omp for schedule(static) nowait
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < 512; j++) {
+            m[i][j] = m[i][j] * 2.0;
+        }
+    }
+    }
+}
+
+int main() {
+    static double m[1024][512];
+    stream_triad(1 << 20);
+    seeded(1 << 20);
+    rows(1024, m);
+    printf("%f\n", m[1023][511]);
+    return 0;
+}
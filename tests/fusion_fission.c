@@ -0,0 +1,96 @@
+#include <stdio.h>
+
+#define N 1000
+
+// mvt: both nests read A - fused into one loop
+void mvt(double A[N][N], double* restrict x1, double* restrict x2, double* y1, double* y2) {
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            x1[i] = x1[i] + A[i][j] * y1[j];
+        }
+    }
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            x2[i] = x2[i] + A[j][i] * y2[j];
+        }
+    }
+}
+
+// Second loop consumes b[i] where the first produced it - fused
+void scale_then_add(double* a, double* restrict b, double* restrict c, int n) {
+    for (int i = 0; i < n; i++) {
+        b[i] = a[i] * 2.0;
+    }
+    for (int i = 0; i < n; i++) {
+        c[i] = b[i] + a[i];
+    }
+}
+
+// b may be a, so b[i + 1] would be read before the first loop wrote it - not fused
+void shift_add(double* a, double* b, double* c, int n) {
+    for (int i = 0; i < n - 1; i++) {
+        a[i] = c[i] * 2.0;
+    }
+    for (int i = 0; i < n - 1; i++) {
+        c[i] = b[i + 1] + a[i];
+    }
+}
+
+// Second loop reads neighbours the first loop writes - not fused
+void stencil_pair(double* a, double* b, int n) {
+    for (int i = 1; i < n - 1; i++) {
+        b[i] = a[i] * 0.5;
+    }
+    for (int i = 1; i < n - 1; i++) {
+        a[i] = b[i - 1] + b[i + 1];
+    }
+}
+
+// Prefix sum next to an independent scale - split, scale runs in parallel
+void scale_and_prefix(double* a, double* b, double* s, int n) {
+    for (int i = 1; i < n; i++) {
+        b[i] = a[i] * 2.0;
+        s[i] = s[i - 1] + a[i];
+    }
+}
+
+// Scalar recurrence reads what the copy produced - split, copy goes first
+double copy_and_sum(double* a, double* b, int n) {
+    double total = 0.0;
+    for (int i = 0; i < n; i++) {
+        b[i] = a[i] * a[i];
+        total = total + b[i];
+    }
+    return total;
+}
+
+// Independent-looking statement reads the recurrence - no split
+void coupled(double* a, double* s, double* out, int n) {
+    for (int i = 1; i < n; i++) {
+        s[i] = s[i - 1] + a[i];
+        out[i] = s[i] * 0.5;
+    }
+}
+
+int main() {
+    static double A[N][N];
+    static double x1[N], x2[N], y1[N], y2[N];
+    static double a[N], b[N], c[N], s[N];
+
+    for (int i = 0; i < N; i++) {
+        a[i] = i;
+        y1[i] = 1.0;
+        y2[i] = 2.0;
+    }
+
+    mvt(A, x1, x2, y1, y2);
+    scale_then_add(a, b, c, N);
+    shift_add(a, a, c, N);
+    stencil_pair(a, b, N);
+    scale_and_prefix(a, b, s, N);
+    printf("%f\n", copy_and_sum(a, b, N));
+    coupled(a, s, c, N);
+
+    printf("%f %f %f %f\n", x1[10], x2[10], c[10], s[10]);
+    return 0;
+}
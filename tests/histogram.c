@@ -0,0 +1,55 @@
+#include <stdio.h>
+
+#define N 100000
+#define BINS 256
+
+// Classic binning: few bins, many updates - reduction(+:local[0:256])
+void histogram(int* key, int* hist) {
+    static int local[BINS];
+    for (int i = 0; i < N; i++) {
+        local[key[i]]++;
+    }
+    for (int b = 0; b < BINS; b++) {
+        hist[b] = local[b];
+    }
+}
+
+// Bin count only known at runtime, bounded by the modulo - reduction(+:hist[0:nbins])
+void weighted_histogram(int* key, double* weight, double* hist, int nbins, int n) {
+    for (int i = 0; i < n; i++) {
+        hist[key[i] % nbins] += weight[i];
+    }
+}
+
+// Nothing bounds the index - atomic updates
+void scatter_add(int* idx, double* val, double* out, int n) {
+    for (int i = 0; i < n; i++) {
+        out[idx[i]] = out[idx[i]] + val[i];
+    }
+}
+
+// Histogram is also read in the loop - stays serial
+void running_rank(int* key, int* hist, int* rank, int n) {
+    for (int i = 0; i < n; i++) {
+        rank[i] = hist[key[i]];
+        hist[key[i]]++;
+    }
+}
+
+int main() {
+    static int key[N], hist[BINS], rank[N];
+    static double weight[N], whist[BINS], out[N];
+
+    for (int i = 0; i < N; i++) {
+        key[i] = (i * 7919) % BINS;
+        weight[i] = 1.0;
+    }
+
+    histogram(key, hist);
+    weighted_histogram(key, weight, whist, BINS, N);
+    scatter_add(key, weight, out, N);
+    running_rank(key, hist, rank, N);
+
+    printf("%d %f %f %d\n", hist[3], whist[3], out[3], rank[N - 1]);
+    return 0;
+}
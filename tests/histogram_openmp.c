@@ -0,0 +1,69 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
+#include <stdio.h>
+
+#define N 100000
+#define BINS 256
+
+// Classic binning: few bins, many updates - reduction(+:local[0:256])
+void histogram(int* key, int* hist) {
+    static int local[BINS];
+    #pragma omp parallel if(N > 8000 || BINS > 8000) proc_bind(spread)
+    {
+    #pragma omp for reduction(+:local[0:256])
+    for (int i = 0; i < N; i++) {
+        local[key[i]]++;
+    }
+    #pragma omp for simd simdlen(8) nowait
+    for (int b = 0; b < BINS; b++) {
+        hist[b] = local[b];
+    }
+    }
+}
+
+// Bin count only known at runtime, bounded by the modulo - reduction(+:hist[0:nbins])
+void weighted_histogram(int* key, double* weight, double* hist, int nbins, int n) {
+    #pragma omp parallel for reduction(+:hist[0:nbins]) if(n > 5716) num_threads(n <= 5716 ? 1 : n / 2858 < omp_get_max_threads() ? n / 2858 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < n; i++) {
+        hist[key[i] % nbins] += weight[i];
+    }
+}
+
+// Nothing bounds the index - atomic updates
+void scatter_add(int* idx, double* val, double* out, int n) {
+    #pragma omp parallel for if(n > 4446) num_threads(n <= 4446 ? 1 : n / 2223 < omp_get_max_threads() ? n / 2223 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < n; i++) {
+        #pragma omp atomic
+        out[idx[i]] = out[idx[i]] + val[i];
+    }
+}
+
+// Histogram is also read in the loop - stays serial
+void running_rank(int* key, int* hist, int* rank, int n) {
+    for (int i = 0; i < n; i++) {
+        rank[i] = hist[key[i]];
+        hist[key[i]]++;
+    }
+}
+
+int main() {
+    static int key[N], hist[BINS], rank[N];
+    static double weight[N], whist[BINS], out[N];
+
+    #pragma omp parallel for simd simdlen(4) if(N > 5000) num_threads(N <= 5000 ? 1 : N / 2500 < omp_get_max_threads() ? N / 2500 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < N; i++) {
+        key[i] = (i * 7919) % BINS;
+        weight[i] = 1.0;
+    }
+
+    histogram(key, hist);
+    weighted_histogram(key, weight, whist, BINS, N);
+    scatter_add(key, weight, out, N);
+    running_rank(key, hist, rank, N);
+
+    printf("%d %f %f %d\n", hist[3], whist[3], out[3], rank[N - 1]);
+    return 0;
+}
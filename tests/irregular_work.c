@@ -0,0 +1,98 @@
+#include <stdio.h>
+
+#define N 2000
+
+typedef struct {
+    int count;
+    double values[64];
+} Item;
+
+double weigh(const Item* item) {
+    double total = 0.0;
+    for (int k = 0; k < item->count; k++) {
+        total += item->values[k] * item->values[k];
+    }
+    return total;
+}
+
+// Per-item call on variable-size items - taskloop
+void weigh_items(Item* items, double* weights, int n) {
+    for (int i = 0; i < n; i++) {
+        weights[i] = weigh(&items[i]);
+    }
+}
+
+// Triangular nest, inner trip count follows the outer index - taskloop
+void lower_sums(double m[N][N], double* sums) {
+    for (int i = 0; i < N; i++) {
+        double s = 0.0;
+        for (int j = 0; j <= i; j++) {
+            s += m[i][j];
+        }
+        sums[i] = s;
+    }
+}
+
+// CSR rows of different lengths - taskloop
+void row_sums(int* row_ptr, double* vals, double* out, int rows) {
+    for (int r = 0; r < rows; r++) {
+        double s = 0.0;
+        for (int k = row_ptr[r]; k < row_ptr[r + 1]; k++) {
+            s += vals[k];
+        }
+        out[r] = s;
+    }
+}
+
+// Every iteration does the same work - regular parallel for
+void scale(double* a, double* b, int n) {
+    for (int i = 0; i < n; i++) {
+        a[i] = b[i] * 2.0;
+    }
+}
+
+double clamp(double x) {
+    return x < 0.0 ? 0.0 : x;
+}
+
+// Opaque-looking call with the same cost every time - regular parallel for
+void clamp_all(double* a, double* b, int n) {
+    for (int i = 0; i < n; i++) {
+        a[i] = clamp(b[i]);
+    }
+}
+
+// Only masked iterations run the inner loop - taskloop
+void masked_sums(double m[N][N], int* mask, double* sums) {
+    for (int i = 0; i < N; i++) {
+        double s = 0.0;
+        if (mask[i]) {
+            for (int j = 0; j < N; j++) {
+                s += m[i][j];
+            }
+        }
+        sums[i] = s;
+    }
+}
+
+int main() {
+    static Item items[N];
+    static double weights[N], sums[N], a[N], b[N];
+    static double m[N][N];
+    static int mask[N];
+
+    for (int i = 0; i < N; i++) {
+        items[i].count = i % 64;
+        b[i] = i;
+        mask[i] = i % 3 == 0;
+    }
+
+    weigh_items(items, weights, N);
+    lower_sums(m, sums);
+    scale(a, b, N);
+    clamp_all(a, b, N);
+    masked_sums(m, mask, sums);
+
+    printf("%f %f %f\n", weights[10], sums[10], a[10]);
+    return 0;
+}
@@ -1,3 +1,8 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
 #include <stdio.h>
 #include <math.h>
 
@@ -5,7 +10,7 @@
 void matrix_multiply() {
     int A[20][20], B[20][20], C[20][20];
     
-    #pragma omp parallel for
+    #pragma omp parallel for if(20 > 10) num_threads(20 <= 10 ? 1 : 20 / 5 < omp_get_max_threads() ? 20 / 5 : omp_get_max_threads()) proc_bind(spread)
     for (int i = 0; i < 20; i++) {        
         for (int j = 0; j < 20; j++) {    
             C[i][j] = 0;
@@ -21,14 +26,13 @@ void vector_operations() {
     double a[1000], b[1000], c[1000];
     
     // Vector addition - should be SAFE
-    #pragma omp parallel for simd
+    #pragma omp parallel for simd simdlen(4) if(1000 > 5716) num_threads(1000 <= 5716 ? 1 : 1000 / 2858 < omp_get_max_threads() ? 1000 / 2858 : omp_get_max_threads()) proc_bind(spread)
     for (int i = 0; i < 1000; i++) {
         c[i] = a[i] + b[i];  
     }
     
     // Dot product reduction - should be UNSAFE
     double sum = 0.0;
-    #pragma omp parallel for simd
     for (int i = 0; i < 1000; i++) {
         sum += a[i] * b[i];  // sum has read-after-write dependency
     }
@@ -39,8 +43,9 @@ void image_processing() {
     int image[50][50];
     int filtered[50][50];
     
-    #pragma omp parallel for
+    #pragma omp parallel for if((49 - 1) > 36) num_threads((49 - 1) <= 36 ? 1 : (49 - 1) / 18 < omp_get_max_threads() ? (49 - 1) / 18 : omp_get_max_threads()) proc_bind(spread)
     for (int i = 1; i < 49; i++) {        // safe - independent rows
+        #pragma omp simd simdlen(8)
         for (int j = 1; j < 49; j++) {    // safe - independent columns
             filtered[i][j] = (image[i-1][j] + image[i+1][j] + 
                              image[i][j-1] + image[i][j+1] + 
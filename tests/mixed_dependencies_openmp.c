@@ -1,3 +1,8 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
 #include <stdio.h>   // printf
 #include <stdlib.h>  // malloc, free, rand
 #include <math.h>    // sin, cos
@@ -6,7 +11,7 @@
 void test_simple_safe() {
     int a[100], b[100], c[100];
     
-    #pragma omp parallel for simd
+    #pragma omp parallel for simd simdlen(8) if(100 > 5716) num_threads(100 <= 5716 ? 1 : 100 / 2858 < omp_get_max_threads() ? 100 / 2858 : omp_get_max_threads()) proc_bind(spread)
     for (int i = 0; i < 100; i++) {
         c[i] = a[i] + b[i];  // No dependencies between iterations
     }
@@ -60,7 +65,7 @@ void test_math_functions() {
     double input[60];
     double output[60];
     
-    #pragma omp parallel for
+    #pragma omp parallel for simd simdlen(4) if(60 > 1540) num_threads(60 <= 1540 ? 1 : 60 / 770 < omp_get_max_threads() ? 60 / 770 : omp_get_max_threads()) proc_bind(close)
     for (int n = 0; n < 60; n++) {
         output[n] = sin(input[n]) + cos(input[n]);  // Pure math functions
     }
@@ -92,7 +97,7 @@ void test_nested_loops() {
     int data[20][20];
     
     // Outer loop should be safe, inner has dependency
-    #pragma omp parallel for
+    #pragma omp parallel for if(20 > 232) num_threads(20 <= 232 ? 1 : 20 / 116 < omp_get_max_threads() ? 20 / 116 : omp_get_max_threads()) proc_bind(spread)
     for (int i = 0; i < 20; i++) {
         int temp = 0;
         for (int j = 1; j < 20; j++) {
@@ -119,7 +124,7 @@ void test_pointer_aliasing() {
 void test_write_only() {
     int results[300];
     
-    #pragma omp parallel for simd
+    #pragma omp parallel for simd simdlen(8) if(300 > 6668) num_threads(300 <= 6668 ? 1 : 300 / 3334 < omp_get_max_threads() ? 300 / 3334 : omp_get_max_threads()) proc_bind(close)
     for (int i = 0; i < 300; i++) {
         results[i] = i * i * i;  // Only writing, no reads
     }
@@ -130,7 +135,6 @@ void test_reduction_local() {
     int source[100];
     int total = 0;
     
-    #pragma omp parallel for simd
     for (int i = 0; i < 100; i++) {
         int local = source[i] * 2;  // Local variable - safe
         total += local;             // Reduction - dependency
@@ -0,0 +1,69 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
+#include <stdio.h>
+
+#define N 1024
+#define STEPS 100
+
+// Time-step loop carries the grid forward - parallel for on i, simd on j
+void heat(double* u, double* v) {
+    for (int t = 0; t < STEPS; t++) {
+        #pragma omp parallel for if(((N - 1) - 1) > 2) num_threads(((N - 1) - 1) <= 2 ? 1 : ((N - 1) - 1) < omp_get_max_threads() ? ((N - 1) - 1) : omp_get_max_threads()) proc_bind(close)
+        for (int i = 1; i < N - 1; i++) {
+            #pragma omp simd simdlen(4)
+            for (int j = 1; j < N - 1; j++) {
+                v[i * N + j] = 0.25 * (u[(i - 1) * N + j] + u[(i + 1) * N + j] + u[i * N + j - 1] + u[i * N + j + 1]);
+            }
+        }
+        #pragma omp parallel for if(((N - 1) - 1) > 4) num_threads(((N - 1) - 1) <= 4 ? 1 : ((N - 1) - 1) / 2 < omp_get_max_threads() ? ((N - 1) - 1) / 2 : omp_get_max_threads()) proc_bind(close)
+        for (int i = 1; i < N - 1; i++) {
+            #pragma omp simd simdlen(4)
+            for (int j = 1; j < N - 1; j++) {
+                u[i * N + j] = v[i * N + j];
+            }
+        }
+    }
+}
+
+// Three colour planes are too few to share out - parallel for simd on the pixel loop
+void brighten(float* out, float* img, float gain) {
+    for (int c = 0; c < 3; c++) {
+        #pragma omp parallel for simd simdlen(8) if((N * N) > 3078) num_threads((N * N) <= 3078 ? 1 : (N * N) / 1539 < omp_get_max_threads() ? (N * N) / 1539 : omp_get_max_threads()) proc_bind(close)
+        for (int p = 0; p < N * N; p++) {
+            out[c * (N * N) + p] = img[c * (N * N) + p] * gain;
+        }
+    }
+}
+
+// Outer loop is independent and long - parallel for stays on it, simd on j
+void scale_rows(double* r, double* m, double* s) {
+    #pragma omp parallel for if(N > 4) num_threads(N <= 4 ? 1 : N / 2 < omp_get_max_threads() ? N / 2 : omp_get_max_threads()) proc_bind(close)
+    for (int i = 0; i < N; i++) {
+        #pragma omp simd simdlen(4)
+        for (int j = 0; j < N; j++) {
+            r[i * N + j] = m[i * N + j] * s[i];
+        }
+    }
+}
+
+int main() {
+    static double u[N * N], v[N * N], m[N * N], r[N * N], s[N];
+    static float img[3 * N * N], out[3 * N * N];
+
+    #pragma omp parallel for if(N > 3078) num_threads(N <= 3078 ? 1 : N / 1539 < omp_get_max_threads() ? N / 1539 : omp_get_max_threads()) proc_bind(close)
+    for (int i = 0; i < N; i++) {
+        s[i] = 1.0 / (i + 1);
+        u[i * N] = 1.0;
+        m[i * N + i] = 2.0;
+    }
+
+    heat(u, v);
+    brighten(out, img, 1.5f);
+    scale_rows(r, m, s);
+
+    printf("%f %f %f\n", u[N / 2 * N + N / 2], out[2 * N * N + N], r[N * N - 1]);
+    return 0;
+}
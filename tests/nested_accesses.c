@@ -0,0 +1,63 @@
+#include <stdio.h>
+
+#define N 512
+
+// Outer loop owns row i of c - parallel for stays on i
+void matmul(double a[N][N], double b[N][N], double c[N][N]) {
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            c[i][j] = 0.0;
+            for (int k = 0; k < N; k++) {
+                c[i][j] += a[i][k] * b[k][j];
+            }
+        }
+    }
+}
+
+// Flattened rows - i * N + j stays inside row i, still parallel on i
+void scale_flat(double* m, double s) {
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            m[i * N + j] = m[i * N + j] * s;
+        }
+    }
+}
+
+// The inner loop reads all of x while the outer loop writes x[i] - outer stays serial
+void relax(double* x, double* w) {
+    for (int i = 0; i < N; i++) {
+        double sum = 0.0;
+        for (int j = 0; j < N; j++) {
+            sum += w[j] * x[j];
+        }
+        x[i] = sum / N;
+    }
+}
+
+// Every step rewrites the whole grid - step loop serial, i loop parallel
+void smooth(double* u, double* v) {
+    for (int step = 0; step < 10; step++) {
+        for (int i = 1; i < N - 1; i++) {
+            v[i] = (u[i - 1] + u[i + 1]) * 0.5;
+        }
+        for (int i = 1; i < N - 1; i++) {
+            u[i] = v[i];
+        }
+    }
+}
+
+int main() {
+    static double a[N][N], b[N][N], c[N][N], m[N * N], x[N], w[N], u[N], v[N];
+
+    for (int i = 0; i < N; i++) {
+        x[i] = w[i] = u[i] = 1.0;
+    }
+
+    matmul(a, b, c);
+    scale_flat(m, 2.0);
+    relax(x, w);
+    smooth(u, v);
+
+    printf("%f %f %f %f\n", c[1][1], m[N], x[N - 1], u[N / 2]);
+    return 0;
+}
@@ -0,0 +1,73 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
+#include <stdio.h>
+
+#define N 512
+
+// Outer loop owns row i of c - parallel for stays on i
+void matmul(double a[N][N], double b[N][N], double c[N][N]) {
+    #pragma omp parallel for if(N > 2) num_threads(N <= 2 ? 1 : N < omp_get_max_threads() ? N : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            c[i][j] = 0.0;
+            for (int k = 0; k < N; k++) {
+                c[i][j] += a[i][k] * b[k][j];
+            }
+        }
+    }
+}
+
+// Flattened rows - i * N + j stays inside row i, still parallel on i
+void scale_flat(double* m, double s) {
+    #pragma omp parallel for if(N > 8) num_threads(N <= 8 ? 1 : N / 4 < omp_get_max_threads() ? N / 4 : omp_get_max_threads()) proc_bind(close)
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            m[i * N + j] = m[i * N + j] * s;
+        }
+    }
+}
+
+// The inner loop reads all of x while the outer loop writes x[i] - outer stays serial
+void relax(double* x, double* w) {
+    for (int i = 0; i < N; i++) {
+        double sum = 0.0;
+        for (int j = 0; j < N; j++) {
+            sum += w[j] * x[j];
+        }
+        x[i] = sum / N;
+    }
+}
+
+// Every step rewrites the whole grid - step loop serial, i loop parallel
+void smooth(double* u, double* v) {
+    for (int step = 0; step < 10; step++) {
+        #pragma omp parallel for simd simdlen(4) if(((N - 1) - 1) > 4000) num_threads(((N - 1) - 1) <= 4000 ? 1 : ((N - 1) - 1) / 2000 < omp_get_max_threads() ? ((N - 1) - 1) / 2000 : omp_get_max_threads()) proc_bind(spread)
+        for (int i = 1; i < N - 1; i++) {
+            v[i] = (u[i - 1] + u[i + 1]) * 0.5;
+        }
+        #pragma omp parallel for simd simdlen(4) if(((N - 1) - 1) > 8000) num_threads(((N - 1) - 1) <= 8000 ? 1 : ((N - 1) - 1) / 4000 < omp_get_max_threads() ? ((N - 1) - 1) / 4000 : omp_get_max_threads()) proc_bind(spread)
+        for (int i = 1; i < N - 1; i++) {
+            u[i] = v[i];
+        }
+    }
+}
+
+int main() {
+    static double a[N][N], b[N][N], c[N][N], m[N * N], x[N], w[N], u[N], v[N];
+
+    #pragma omp parallel for simd simdlen(4) if(N > 5000) num_threads(N <= 5000 ? 1 : N / 2500 < omp_get_max_threads() ? N / 2500 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < N; i++) {
+        x[i] = w[i] = u[i] = 1.0;
+    }
+
+    matmul(a, b, c);
+    scale_flat(m, 2.0);
+    relax(x, w);
+    smooth(u, v);
+
+    printf("%f %f %f %f\n", c[1][1], m[N], x[N - 1], u[N / 2]);
+    return 0;
+}
@@ -1,11 +1,17 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
 #include <stdio.h>
 
 // Simple nested loops - should be SAFE
 void test_simple_nested() {
     int matrix[10][10];
     
-    #pragma omp parallel for
+    #pragma omp parallel for if(10 > 646) num_threads(10 <= 646 ? 1 : 10 / 323 < omp_get_max_threads() ? 10 / 323 : omp_get_max_threads()) proc_bind(spread)
     for (int i = 0; i < 10; i++) {
+        #pragma omp simd simdlen(8)
         for (int j = 0; j < 10; j++) {
             matrix[i][j] = i * j;
         }
@@ -16,6 +22,7 @@ void test_simple_nested() {
 void test_stride_conflict() {
     int data[100];
     
+    #pragma omp simd simdlen(2) safelen(3)
     for (int i = 0; i < 95; i++) {
         data[i+3] = data[i] + 1;
     }
@@ -25,7 +32,7 @@ void test_stride_conflict() {
 void test_nested_inner_dependency() {
     int arr[20][20];
     
-    #pragma omp parallel for
+    #pragma omp parallel for if(20 > 232) num_threads(20 <= 232 ? 1 : 20 / 116 < omp_get_max_threads() ? 20 / 116 : omp_get_max_threads()) proc_bind(spread)
     for (int i = 0; i < 20; i++) {
         for (int j = 1; j < 20; j++) {
             arr[i][j] = arr[i][j-1] + 1;
@@ -46,8 +53,9 @@ void test_cross_read_write() {
 void test_nested_independent() {
     int a[15][15], b[15][15], c[15][15];
     
-    #pragma omp parallel for
+    #pragma omp parallel for if(15 > 264) num_threads(15 <= 264 ? 1 : 15 / 132 < omp_get_max_threads() ? 15 / 132 : omp_get_max_threads()) proc_bind(spread)
     for (int i = 0; i < 15; i++) {
+        #pragma omp simd simdlen(8)
         for (int j = 0; j < 15; j++) {
             c[i][j] = a[i][j] + b[i][j];
         }
@@ -58,6 +66,7 @@ void test_nested_independent() {
 void test_multiple_offsets() {
     int values[80];
     
+    #pragma omp simd simdlen(2) safelen(2)
     for (int i = 5; i < 75; i++) {
         values[i] = values[i-3] + values[i+2];
     }
@@ -68,9 +77,9 @@ void test_nested_outer_dependency() {
     int grid[12][12];
     int sum = 0;
     
-    #pragma omp parallel for
     for (int i = 0; i < 12; i++) {
         sum += i;
+        #pragma omp parallel for simd simdlen(8) if(12 > 8000) num_threads(12 <= 8000 ? 1 : 12 / 4000 < omp_get_max_threads() ? 12 / 4000 : omp_get_max_threads()) proc_bind(spread)
         for (int j = 0; j < 12; j++) {
             grid[i][j] = sum;
         }
@@ -1,3 +1,8 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -5,7 +10,7 @@
 void test_no_pointers() {
     int data[40];
     
-    #pragma omp parallel for simd
+    #pragma omp parallel for simd simdlen(8) if(40 > 8000) num_threads(40 <= 8000 ? 1 : 40 / 4000 < omp_get_max_threads() ? 40 / 4000 : omp_get_max_threads()) proc_bind(close)
     for (int i = 0; i < 40; i++) {
         data[i] = i * 2;
     }
@@ -27,7 +32,7 @@ void test_pointer_arithmetic() {
     int data[50];
     int *p = &data[0];
     
-    #pragma omp parallel for simd
+    #pragma omp parallel for if(50 > 6668) num_threads(50 <= 6668 ? 1 : 50 / 3334 < omp_get_max_threads() ? 50 / 3334 : omp_get_max_threads()) proc_bind(close)
     for (int i = 0; i < 50; i++) {
         *(p + i) = i * 3;
     }
@@ -0,0 +1,45 @@
+#include <stdio.h>
+#include <string.h>
+
+// String copy through pointer walk - should be lowered to an indexed for loop
+void copy_string(char* dst, char* src) {
+    while (*src) {
+        *dst++ = *src++;
+    }
+    *dst = '\0';
+}
+
+// Bounded buffer walk with separate steps - should be lowered
+void scale_buffer(float* out, float* in, float* end) {
+    while (in != end) {
+        *out = *in * 2.0f;
+        out++;
+        in++;
+    }
+}
+
+// Single statement body - should be lowered
+void to_upper(char* s, char* d) {
+    while (*s != '\0') *d++ = *s++ - 32;
+}
+
+// Conditional step - not a unit-step walk, stays a while loop
+void skip_spaces(char* s, char* d) {
+    while (*s) {
+        if (*s != ' ') {
+            *d++ = *s;
+        }
+        s++;
+    }
+}
+
+int main() {
+    char src[64] = "pointer walks";
+    char dst[64];
+    float in[16], out[16];
+    copy_string(dst, src);
+    scale_buffer(out, in, in + 16);
+    to_upper(src, dst);
+    skip_spaces(src, dst);
+    return 0;
+}
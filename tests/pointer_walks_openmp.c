@@ -0,0 +1,55 @@
+#include <stdio.h>
+#include <string.h>
+
+// String copy through pointer walk - should be lowered to an indexed for loop
+void copy_string(char* dst, char* src) {
+    const long pz_len_6 = (long)(__builtin_strlen(src));
+    #pragma omp parallel for proc_bind(spread)
+    for (long pz_idx_6 = 0; pz_idx_6 < pz_len_6; pz_idx_6++) {
+        dst[pz_idx_6] = src[pz_idx_6];
+    }
+    dst += pz_len_6;
+    src += pz_len_6;
+    *dst = '\0';
+}
+
+// Bounded buffer walk with separate steps - should be lowered
+void scale_buffer(float* out, float* in, float* end) {
+    const long pz_len_14 = (long)(end - in);
+    #pragma omp parallel for proc_bind(spread)
+    for (long pz_idx_14 = 0; pz_idx_14 < pz_len_14; pz_idx_14++) {
+        out[pz_idx_14] = in[pz_idx_14] * 2.0f;
+    }
+    in += pz_len_14;
+    out += pz_len_14;
+}
+
+// Single statement body - should be lowered
+void to_upper(char* s, char* d) {
+    const long pz_len_23 = (long)(__builtin_strlen(s));
+    #pragma omp parallel for proc_bind(spread)
+    for (long pz_idx_23 = 0; pz_idx_23 < pz_len_23; pz_idx_23++) d[pz_idx_23] = s[pz_idx_23] - 32;
+    d += pz_len_23;
+    s += pz_len_23;
+}
+
+// Conditional step - not a unit-step walk, stays a while loop
+void skip_spaces(char* s, char* d) {
+    while (*s) {
+        if (*s != ' ') {
+            *d++ = *s;
+        }
+        s++;
+    }
+}
+
+int main() {
+    char src[64] = "pointer walks";
+    char dst[64];
+    float in[16], out[16];
+    copy_string(dst, src);
+    scale_buffer(out, in, in + 16);
+    to_upper(src, dst);
+    skip_spaces(src, dst);
+    return 0;
+}
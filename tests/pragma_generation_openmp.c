@@ -1,3 +1,8 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
 #include <stdio.h>
 #include <math.h>
 
@@ -5,7 +10,7 @@
 void test_simple_parallel() {
     int a[1000], b[1000], c[1000];
     
-    #pragma omp parallel for simd
+    #pragma omp parallel for simd simdlen(8) if(1000 > 5716) num_threads(1000 <= 5716 ? 1 : 1000 / 2858 < omp_get_max_threads() ? 1000 / 2858 : omp_get_max_threads()) proc_bind(spread)
     for (int i = 0; i < 1000; i++) {
         c[i] = a[i] + b[i];  
     }
@@ -16,7 +21,7 @@ void test_simd_candidate() {
     double data[500];
     double results[500];
     
-    #pragma omp parallel for simd
+    #pragma omp parallel for simd simdlen(4) if(500 > 2106) num_threads(500 <= 2106 ? 1 : 500 / 1053 < omp_get_max_threads() ? 500 / 1053 : omp_get_max_threads()) proc_bind(close)
     for (int j = 0; j < 500; j++) {
         results[j] = data[j] * data[j] + sin(data[j]);  // Arithmetic + math function
     }
@@ -28,9 +33,10 @@ void test_complex_safe() {
     float output[100][100];
     int temp;
     
-    #pragma omp parallel for
+    #pragma omp parallel for if(100 > 50) num_threads(100 <= 50 ? 1 : 100 / 25 < omp_get_max_threads() ? 100 / 25 : omp_get_max_threads()) proc_bind(spread)
     for (int i = 0; i < 100; i++) {
         temp = i * 2; 
+        #pragma omp simd simdlen(8)
         for (int j = 0; j < 100; j++) {
             output[i][j] = matrix[i][j] + temp;
         }
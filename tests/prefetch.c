@@ -0,0 +1,55 @@
+#include <stdio.h>
+
+#define ROWS 100000
+#define PER_ROW 16
+#define NNZ (ROWS * PER_ROW)
+
+// CSR sparse matrix-vector product - x[col[j]] gathers, prefetch col[j + d] ahead
+void spmv(int* row_ptr, int* col, double* val, double* x, double* y) {
+    for (int i = 0; i < ROWS; i++) {
+        double sum = 0.0;
+        for (int j = row_ptr[i]; j < row_ptr[i + 1]; j++) {
+            sum += val[j] * x[col[j]];
+        }
+        y[i] = sum;
+    }
+}
+
+// Scatter through a permutation - out[perm[k]] is prefetched for writing
+void scatter(int* perm, double* in, double* out) {
+    for (int k = 0; k < NNZ; k++) {
+        out[perm[k]] = in[k] * 0.5;
+    }
+}
+
+// Unit-stride access - nothing to prefetch, the hardware prefetcher already streams it
+void scale(double* x, double s) {
+    for (int i = 0; i < ROWS; i++) {
+        x[i] *= s;
+    }
+}
+
+int main() {
+    static int row_ptr[ROWS + 1], col[NNZ], perm[NNZ];
+    static double val[NNZ], x[ROWS], y[ROWS], in[NNZ], out[NNZ];
+
+    for (int i = 0; i <= ROWS; i++) {
+        row_ptr[i] = i * PER_ROW;
+    }
+    for (int j = 0; j < NNZ; j++) {
+        col[j] = (j * 7919) % ROWS;
+        perm[j] = (j * 104729) % NNZ;
+        val[j] = 1.0;
+        in[j] = j;
+    }
+    for (int i = 0; i < ROWS; i++) {
+        x[i] = i * 0.001;
+    }
+
+    spmv(row_ptr, col, val, x, y);
+    scatter(perm, in, out);
+    scale(x, 2.0);
+
+    printf("%f %f %f\n", y[ROWS - 1], out[NNZ - 1], x[ROWS - 1]);
+    return 0;
+}
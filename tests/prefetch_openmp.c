@@ -0,0 +1,73 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
+#include <stdio.h>
+
+#define ROWS 100000
+#define PER_ROW 16
+#define NNZ (ROWS * PER_ROW)
+
+// CSR sparse matrix-vector product - x[col[j]] gathers, prefetch col[j + d] ahead
+void spmv(int* row_ptr, int* col, double* val, double* x, double* y) {
+    #pragma omp parallel
+    #pragma omp single
+    #pragma omp taskloop grainsize(61)
+    for (int i = 0; i < ROWS; i++) {
+        double sum = 0.0;
+        for (int j = row_ptr[i]; j < row_ptr[i + 1]; j++) {
+            if (j + 8 < row_ptr[i + 1]) __builtin_prefetch(&x[col[j + 8]]);
+            sum += val[j] * x[col[j]];
+        }
+        y[i] = sum;
+    }
+}
+
+// Scatter through a permutation - out[perm[k]] is prefetched for writing
+void scatter(int* perm, double* in, double* out) {
+    #pragma omp parallel for if(NNZ > 5716) num_threads(NNZ <= 5716 ? 1 : NNZ / 2858 < omp_get_max_threads() ? NNZ / 2858 : omp_get_max_threads()) proc_bind(spread)
+    for (int k = 0; k < NNZ; k++) {
+        if (k + 29 < NNZ) __builtin_prefetch(&out[perm[k + 29]], 1);
+        out[perm[k]] = in[k] * 0.5;
+    }
+}
+
+// Unit-stride access - nothing to prefetch, the hardware prefetcher already streams it
+void scale(double* x, double s) {
+    #pragma omp parallel for simd simdlen(4) if(ROWS > 10000) num_threads(ROWS <= 10000 ? 1 : ROWS / 5000 < omp_get_max_threads() ? ROWS / 5000 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < ROWS; i++) {
+        x[i] *= s;
+    }
+}
+
+int main() {
+    static int row_ptr[ROWS + 1], col[NNZ], perm[NNZ];
+    static double val[NNZ], x[ROWS], y[ROWS], in[NNZ], out[NNZ];
+
+    #pragma omp parallel if((ROWS + 1) > 8000 || NNZ > 2858 || ROWS > 8000) proc_bind(spread)
+    {
+    #pragma omp for simd simdlen(8) nowait
+    for (int i = 0; i <= ROWS; i++) {
+        row_ptr[i] = i * PER_ROW;
+    }
+    #pragma omp for simd simdlen(4) nowait
+    for (int j = 0; j < NNZ; j++) {
+        col[j] = (j * 7919) % ROWS;
+        perm[j] = (j * 104729) % NNZ;
+        val[j] = 1.0;
+        in[j] = j;
+    }
+    #pragma omp for simd simdlen(4) nowait
+    for (int i = 0; i < ROWS; i++) {
+        x[i] = i * 0.001;
+    }
+    }
+
+    spmv(row_ptr, col, val, x, y);
+    scatter(perm, in, out);
+    scale(x, 2.0);
+
+    printf("%f %f %f\n", y[ROWS - 1], out[NNZ - 1], x[ROWS - 1]);
+    return 0;
+}
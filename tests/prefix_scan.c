@@ -0,0 +1,67 @@
+#include <stdio.h>
+
+#define N 100000
+
+// Recurrence on the output array - rewritten as an inclusive scan over out_scan
+void running_total(double* in, double* out) {
+    out[0] = in[0];
+    for (int i = 1; i < N; i++) {
+        out[i] = out[i - 1] + in[i];
+    }
+}
+
+// In-place prefix sum - inclusive scan that reads a[i] before storing it
+void prefix_in_place(int* a, int n) {
+    for (int i = 1; i < n; i++) {
+        a[i] += a[i - 1];
+    }
+}
+
+// Offsets for a CSR row pointer - exclusive scan over sum
+void row_offsets(int* counts, int* offsets, int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+        offsets[i] = sum;
+        sum += counts[i];
+    }
+    offsets[n] = sum;
+}
+
+// Running product - inclusive scan with *
+void compound_growth(double* rate, double* value) {
+    double factor = 1.0;
+    for (int i = 0; i < N; i++) {
+        factor *= rate[i];
+        value[i] = factor;
+    }
+}
+
+// Running sum feeds back into the input - stays serial
+void feedback(double* in, double* out) {
+    double acc = 0.0;
+    for (int i = 1; i < N; i++) {
+        acc += in[i] + out[i - 1];
+        out[i] = acc;
+    }
+}
+
+int main() {
+    static double in[N], out[N], rate[N], value[N];
+    static int counts[N], offsets[N + 1], a[N];
+
+    for (int i = 0; i < N; i++) {
+        in[i] = 1.0;
+        rate[i] = 1.0 + 1e-6;
+        counts[i] = i % 5;
+        a[i] = 1;
+    }
+
+    running_total(in, out);
+    prefix_in_place(a, N);
+    row_offsets(counts, offsets, N);
+    compound_growth(rate, value);
+    feedback(in, out);
+
+    printf("%f %d %d %f %f\n", out[N - 1], a[N - 1], offsets[N], value[N - 1], out[N - 1]);
+    return 0;
+}
@@ -0,0 +1,233 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
+#include <stdio.h>
+
+#define N 100000
+
+// Recurrence on the output array - rewritten as an inclusive scan over out_scan
+void running_total(double* in, double* out) {
+    out[0] = in[0];
+    double out_scan = out[0];
+#if _OPENMP >= 201811
+    #pragma omp parallel for reduction(inscan, +:out_scan) if((N - 1) > 5000) num_threads((N - 1) <= 5000 ? 1 : (N - 1) / 2500 < omp_get_max_threads() ? (N - 1) / 2500 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 1; i < N; i++) {
+        out_scan += in[i];
+        #pragma omp scan inclusive(out_scan)
+        out[i] = out_scan;
+    }
+#else
+    {
+        long scan_chunk = ((long)(N) - (long)(1) + 63) / 64;
+        double scan_total[64 + 1];
+        scan_total[0] = out_scan;
+        #pragma omp parallel for
+        for (int scan_block = 0; scan_block < 64; scan_block++)
+        {
+            long scan_lo = (long)(1) + scan_block * scan_chunk;
+            long scan_hi = scan_lo + scan_chunk < (long)(N) ? scan_lo + scan_chunk : (long)(N);
+            double out_scan = 0;
+            for (int i = scan_lo; i < scan_hi; i++)
+            {
+                out_scan += in[i];
+            }
+            scan_total[scan_block + 1] = out_scan;
+        }
+        for (int scan_block = 0; scan_block < 64; scan_block++)
+        {
+            scan_total[scan_block + 1] = scan_total[scan_block] + scan_total[scan_block + 1];
+        }
+        #pragma omp parallel for
+        for (int scan_block = 0; scan_block < 64; scan_block++)
+        {
+            long scan_lo = (long)(1) + scan_block * scan_chunk;
+            long scan_hi = scan_lo + scan_chunk < (long)(N) ? scan_lo + scan_chunk : (long)(N);
+            double out_scan = scan_total[scan_block];
+            for (int i = scan_lo; i < scan_hi; i++)
+            {
+                out_scan += in[i];
+                out[i] = out_scan;
+            }
+        }
+        out_scan = scan_total[64];
+    }
+#endif
+}
+
+// In-place prefix sum - inclusive scan that reads a[i] before storing it
+void prefix_in_place(int* a, int n) {
+    int a_scan = a[0];
+#if _OPENMP >= 201811
+    #pragma omp parallel for reduction(inscan, +:a_scan) if((n - 1) > 6668) num_threads((n - 1) <= 6668 ? 1 : (n - 1) / 3334 < omp_get_max_threads() ? (n - 1) / 3334 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 1; i < n; i++) {
+        a_scan += a[i];
+        #pragma omp scan inclusive(a_scan)
+        a[i] = a_scan;
+    }
+#else
+    {
+        long scan_chunk = ((long)(n) - (long)(1) + 63) / 64;
+        int scan_total[64 + 1];
+        scan_total[0] = a_scan;
+        #pragma omp parallel for
+        for (int scan_block = 0; scan_block < 64; scan_block++)
+        {
+            long scan_lo = (long)(1) + scan_block * scan_chunk;
+            long scan_hi = scan_lo + scan_chunk < (long)(n) ? scan_lo + scan_chunk : (long)(n);
+            int a_scan = 0;
+            for (int i = scan_lo; i < scan_hi; i++)
+            {
+                a_scan += a[i];
+            }
+            scan_total[scan_block + 1] = a_scan;
+        }
+        for (int scan_block = 0; scan_block < 64; scan_block++)
+        {
+            scan_total[scan_block + 1] = scan_total[scan_block] + scan_total[scan_block + 1];
+        }
+        #pragma omp parallel for
+        for (int scan_block = 0; scan_block < 64; scan_block++)
+        {
+            long scan_lo = (long)(1) + scan_block * scan_chunk;
+            long scan_hi = scan_lo + scan_chunk < (long)(n) ? scan_lo + scan_chunk : (long)(n);
+            int a_scan = scan_total[scan_block];
+            for (int i = scan_lo; i < scan_hi; i++)
+            {
+                a_scan += a[i];
+                a[i] = a_scan;
+            }
+        }
+        a_scan = scan_total[64];
+    }
+#endif
+}
+
+// Offsets for a CSR row pointer - exclusive scan over sum
+void row_offsets(int* counts, int* offsets, int n) {
+    int sum = 0;
+#if _OPENMP >= 201811
+    #pragma omp parallel for reduction(inscan, +:sum) if(n > 6668) num_threads(n <= 6668 ? 1 : n / 3334 < omp_get_max_threads() ? n / 3334 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < n; i++) {
+        offsets[i] = sum;
+        #pragma omp scan exclusive(sum)
+        sum += counts[i];
+    }
+#else
+    {
+        long scan_chunk = ((long)(n) - (long)(0) + 63) / 64;
+        int scan_total[64 + 1];
+        scan_total[0] = sum;
+        #pragma omp parallel for
+        for (int scan_block = 0; scan_block < 64; scan_block++)
+        {
+            long scan_lo = (long)(0) + scan_block * scan_chunk;
+            long scan_hi = scan_lo + scan_chunk < (long)(n) ? scan_lo + scan_chunk : (long)(n);
+            int sum = 0;
+            for (int i = scan_lo; i < scan_hi; i++)
+            {
+                sum += counts[i];
+            }
+            scan_total[scan_block + 1] = sum;
+        }
+        for (int scan_block = 0; scan_block < 64; scan_block++)
+        {
+            scan_total[scan_block + 1] = scan_total[scan_block] + scan_total[scan_block + 1];
+        }
+        #pragma omp parallel for
+        for (int scan_block = 0; scan_block < 64; scan_block++)
+        {
+            long scan_lo = (long)(0) + scan_block * scan_chunk;
+            long scan_hi = scan_lo + scan_chunk < (long)(n) ? scan_lo + scan_chunk : (long)(n);
+            int sum = scan_total[scan_block];
+            for (int i = scan_lo; i < scan_hi; i++)
+            {
+                offsets[i] = sum;
+                sum += counts[i];
+            }
+        }
+        sum = scan_total[64];
+    }
+#endif
+    offsets[n] = sum;
+}
+
+// Running product - inclusive scan with *
+void compound_growth(double* rate, double* value) {
+    double factor = 1.0;
+#if _OPENMP >= 201811
+    #pragma omp parallel for reduction(inscan, *:factor) if(N > 6668) num_threads(N <= 6668 ? 1 : N / 3334 < omp_get_max_threads() ? N / 3334 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < N; i++) {
+        factor *= rate[i];
+        #pragma omp scan inclusive(factor)
+        value[i] = factor;
+    }
+#else
+    {
+        long scan_chunk = ((long)(N) - (long)(0) + 63) / 64;
+        double scan_total[64 + 1];
+        scan_total[0] = factor;
+        #pragma omp parallel for
+        for (int scan_block = 0; scan_block < 64; scan_block++)
+        {
+            long scan_lo = (long)(0) + scan_block * scan_chunk;
+            long scan_hi = scan_lo + scan_chunk < (long)(N) ? scan_lo + scan_chunk : (long)(N);
+            double factor = 1;
+            for (int i = scan_lo; i < scan_hi; i++)
+            {
+                factor *= rate[i];
+            }
+            scan_total[scan_block + 1] = factor;
+        }
+        for (int scan_block = 0; scan_block < 64; scan_block++)
+        {
+            scan_total[scan_block + 1] = scan_total[scan_block] * scan_total[scan_block + 1];
+        }
+        #pragma omp parallel for
+        for (int scan_block = 0; scan_block < 64; scan_block++)
+        {
+            long scan_lo = (long)(0) + scan_block * scan_chunk;
+            long scan_hi = scan_lo + scan_chunk < (long)(N) ? scan_lo + scan_chunk : (long)(N);
+            double factor = scan_total[scan_block];
+            for (int i = scan_lo; i < scan_hi; i++)
+            {
+                factor *= rate[i];
+                value[i] = factor;
+            }
+        }
+        factor = scan_total[64];
+    }
+#endif
+}
+
+// Running sum feeds back into the input - stays serial
+void feedback(double* in, double* out) {
+    double acc = 0.0;
+    for (int i = 1; i < N; i++) {
+        acc += in[i] + out[i - 1];
+        out[i] = acc;
+    }
+}
+
+int main() {
+    static double in[N], out[N], rate[N], value[N];
+    static int counts[N], offsets[N + 1], a[N];
+
+    #pragma omp parallel for simd simdlen(4) if(N > 3334) num_threads(N <= 3334 ? 1 : N / 1667 < omp_get_max_threads() ? N / 1667 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < N; i++) {
+        in[i] = 1.0;
+        rate[i] = 1.0 + 1e-6;
+        counts[i] = i % 5;
+        a[i] = 1;
+    }
+
+    running_total(in, out);
+    prefix_in_place(a, N);
+    row_offsets(counts, offsets, N);
+    compound_growth(rate, value);
+    feedback(in, out);
+
+    printf("%f %d %d %f %f\n", out[N - 1], a[N - 1], offsets[N], value[N - 1], out[N - 1]);
+    return 0;
+}
@@ -0,0 +1,84 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
+#include <stdio.h>
+
+#define N 4096
+#define TAPS 8
+
+// Filter bank: tmp is refilled from scratch for every output - private(tmp)
+void filter_bank(double* in, double* w, double* out) {
+    double tmp[TAPS];
+    #pragma omp parallel for private(tmp) if((N - TAPS) > 398) num_threads((N - TAPS) <= 398 ? 1 : (N - TAPS) / 199 < omp_get_max_threads() ? (N - TAPS) / 199 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < N - TAPS; i++) {
+        #pragma omp simd simdlen(4)
+        for (int k = 0; k < TAPS; k++) {
+            tmp[k] = in[i + k] * w[k];
+        }
+        double acc = 0.0;
+        for (int k = 0; k < TAPS; k++) {
+            acc += tmp[k];
+        }
+        out[i] = acc;
+    }
+}
+
+// Every element is stored by name before it is read - private(tmp)
+void rgb_to_gray(double* r, double* g, double* b, double* gray) {
+    double tmp[3];
+    #pragma omp parallel for private(tmp) if(N > 1906) num_threads(N <= 1906 ? 1 : N / 953 < omp_get_max_threads() ? N / 953 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < N; i++) {
+        tmp[0] = r[i] * 0.299;
+        tmp[1] = g[i] * 0.587;
+        tmp[2] = b[i] * 0.114;
+        gray[i] = tmp[0] + tmp[1] + tmp[2];
+    }
+}
+
+// Only half the array is refilled, the rest carries over - tmp not privatized
+void partial_refill(double* in, double* out) {
+    double tmp[TAPS] = {0};
+    for (int i = 0; i < N - TAPS; i++) {
+        #pragma omp parallel for simd simdlen(4) if((TAPS / 2) > 5716) num_threads((TAPS / 2) <= 5716 ? 1 : (TAPS / 2) / 2858 < omp_get_max_threads() ? (TAPS / 2) / 2858 : omp_get_max_threads()) proc_bind(spread)
+        for (int k = 0; k < TAPS / 2; k++) {
+            tmp[k] = in[i + k];
+        }
+        out[i] = tmp[0] + tmp[TAPS - 1];
+    }
+}
+
+// tmp is still read after the loop - not privatized
+double live_after(double* in, double* out) {
+    double tmp[2];
+    for (int i = 0; i < N; i++) {
+        tmp[0] = in[i];
+        tmp[1] = in[i] * in[i];
+        out[i] = tmp[0] + tmp[1];
+    }
+    return tmp[1];
+}
+
+int main() {
+    static double in[N], w[TAPS], out[N], r[N], g[N], b[N], gray[N];
+
+    #pragma omp parallel if(N > 3638 || TAPS > 8000) proc_bind(spread)
+    {
+    #pragma omp for simd simdlen(4) nowait
+    for (int i = 0; i < N; i++) {
+        in[i] = i * 0.5;
+        r[i] = g[i] = b[i] = i;
+    }
+    #pragma omp for simd simdlen(4) nowait
+    for (int k = 0; k < TAPS; k++) {
+        w[k] = 1.0 / TAPS;
+    }
+    }
+
+    filter_bank(in, w, out);
+    rgb_to_gray(r, g, b, gray);
+    partial_refill(in, out);
+    printf("%f %f %f\n", out[10], gray[10], live_after(in, out));
+    return 0;
+}
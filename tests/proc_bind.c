@@ -0,0 +1,33 @@
+#include <math.h>
+#include <stdio.h>
+
+#define N 1000000
+
+// Two loads and a store per multiply-add - memory-bound, proc_bind(spread)
+void triad(double* a, double* b, double* c, double s) {
+    for (int i = 0; i < N; i++) {
+        a[i] = b[i] + s * c[i];
+    }
+}
+
+// Transcendental math on one load - compute-bound, proc_bind(close)
+void activate(double* x, double* y) {
+    for (int i = 0; i < N; i++) {
+        y[i] = exp(-x[i] * x[i]) * sqrt(x[i] + 1.0) + sin(x[i]) * cos(x[i]);
+    }
+}
+
+int main() {
+    static double a[N], b[N], c[N], y[N];
+
+    for (int i = 0; i < N; i++) {
+        b[i] = i * 0.5;
+        c[i] = 1.0;
+    }
+
+    triad(a, b, c, 3.0);
+    activate(b, y);
+
+    printf("%f %f\n", a[N - 1], y[N - 1]);
+    return 0;
+}
@@ -0,0 +1,41 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
+#include <math.h>
+#include <stdio.h>
+
+#define N 1000000
+
+// Two loads and a store per multiply-add - memory-bound, proc_bind(spread)
+void triad(double* a, double* b, double* c, double s) {
+    #pragma omp parallel for simd simdlen(4) if(N > 5000) num_threads(N <= 5000 ? 1 : N / 2500 < omp_get_max_threads() ? N / 2500 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < N; i++) {
+        a[i] = b[i] + s * c[i];
+    }
+}
+
+// Transcendental math on one load - compute-bound, proc_bind(close)
+void activate(double* x, double* y) {
+    #pragma omp parallel for simd simdlen(4) if(N > 742) num_threads(N <= 742 ? 1 : N / 371 < omp_get_max_threads() ? N / 371 : omp_get_max_threads()) proc_bind(close)
+    for (int i = 0; i < N; i++) {
+        y[i] = exp(-x[i] * x[i]) * sqrt(x[i] + 1.0) + sin(x[i]) * cos(x[i]);
+    }
+}
+
+int main() {
+    static double a[N], b[N], c[N], y[N];
+
+    #pragma omp parallel for simd simdlen(4) if(N > 5716) num_threads(N <= 5716 ? 1 : N / 2858 < omp_get_max_threads() ? N / 2858 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < N; i++) {
+        b[i] = i * 0.5;
+        c[i] = 1.0;
+    }
+
+    triad(a, b, c, 3.0);
+    activate(b, y);
+
+    printf("%f %f\n", a[N - 1], y[N - 1]);
+    return 0;
+}
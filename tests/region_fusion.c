@@ -0,0 +1,64 @@
+#include <stdio.h>
+
+#define N 1000
+
+// Independent loops back to back through restrict pointers - one region, every loop nowait
+void init_vectors(double* restrict x, double* restrict y, double* restrict z, int n) {
+    for (int i = 0; i < n; i++) {
+        x[i] = i * 0.5;
+    }
+    for (int i = 0; i < n; i++) {
+        y[i] = i * 2.0;
+    }
+    for (int i = 0; i < n; i++) {
+        z[i] = 1.0;
+    }
+}
+
+// Second loop reads what the first writes - one region, barrier kept between them
+void gemver_like(double A[N][N], double* u, double* v, double* x, double* w) {
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            A[i][j] = A[i][j] + u[i] * v[j];
+        }
+    }
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            x[i] = x[i] + A[j][i] * w[j];
+        }
+    }
+}
+
+// Plain pointer parameters may name the same buffer - one region, barrier kept between them
+void fill_pair(double* dst, double* src, int n) {
+    for (int i = 0; i < n; i++) {
+        src[i] = i;
+    }
+    for (int i = 0; i < n; i++) {
+        dst[i] = 0.0;
+    }
+}
+
+// Statement between the loops - no fusion
+void separated(double* a, double* b, int n) {
+    for (int i = 0; i < n; i++) {
+        a[i] = i;
+    }
+    printf("%f\n", a[0]);
+    for (int i = 0; i < n; i++) {
+        b[i] = i;
+    }
+}
+
+int main() {
+    static double x[N], y[N], z[N], u[N], v[N], w[N];
+    static double A[N][N];
+
+    init_vectors(x, y, z, N);
+    gemver_like(A, u, v, x, w);
+    fill_pair(x, x, N);
+    separated(x, y, N);
+
+    printf("%f %f\n", x[10], y[10]);
+    return 0;
+}
@@ -0,0 +1,87 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
+#include <stdio.h>
+
+#define N 1000
+
+// Independent loops back to back through restrict pointers - one region, every loop nowait
+void init_vectors(double* restrict x, double* restrict y, double* restrict z, int n) {
+    #pragma omp parallel if(n > 8000 || n > 8000 || n > 10000) proc_bind(spread)
+    {
+    #pragma omp for simd simdlen(4) nowait
+    for (int i = 0; i < n; i++) {
+        x[i] = i * 0.5;
+    }
+    #pragma omp for simd simdlen(4) nowait
+    for (int i = 0; i < n; i++) {
+        y[i] = i * 2.0;
+    }
+    #pragma omp for simd simdlen(4) nowait
+    for (int i = 0; i < n; i++) {
+        z[i] = 1.0;
+    }
+    }
+}
+
+// Second loop reads what the first writes - one region, barrier kept between them
+void gemver_like(double A[N][N], double* u, double* v, double* x, double* w) {
+    #pragma omp parallel if(N > 4 || N > 4) proc_bind(spread)
+    {
+    #pragma omp for
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            A[i][j] = A[i][j] + u[i] * v[j];
+        }
+    }
+    #pragma omp for nowait
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            x[i] = x[i] + A[j][i] * w[j];
+        }
+    }
+    }
+}
+
+// Plain pointer parameters may name the same buffer - one region, barrier kept between them
+void fill_pair(double* dst, double* src, int n) {
+    #pragma omp parallel if(n > 10000 || n > 10000) proc_bind(spread)
+    {
+    #pragma omp for simd simdlen(4)
+    for (int i = 0; i < n; i++) {
+        src[i] = i;
+    }
+    #pragma omp for simd simdlen(4) nowait
+    for (int i = 0; i < n; i++) {
+        dst[i] = 0.0;
+    }
+    }
+}
+
+// Statement between the loops - no fusion
+void separated(double* a, double* b, int n) {
+    #pragma omp parallel for simd simdlen(4) if(n > 10000) num_threads(n <= 10000 ? 1 : n / 5000 < omp_get_max_threads() ? n / 5000 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < n; i++) {
+        a[i] = i;
+    }
+    printf("%f\n", a[0]);
+    #pragma omp parallel for simd simdlen(4) if(n > 10000) num_threads(n <= 10000 ? 1 : n / 5000 < omp_get_max_threads() ? n / 5000 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < n; i++) {
+        b[i] = i;
+    }
+}
+
+int main() {
+    static double x[N], y[N], z[N], u[N], v[N], w[N];
+    static double A[N][N];
+
+    init_vectors(x, y, z, N);
+    gemver_like(A, u, v, x, w);
+    fill_pair(x, x, N);
+    separated(x, y, N);
+
+    printf("%f %f\n", x[10], y[10]);
+    return 0;
+}
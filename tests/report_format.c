@@ -0,0 +1,37 @@
+#include <stdio.h>
+
+#define N 1024
+
+// Run with --format=json or --format=sarif; stdout is then only the report
+
+double a[N], b[N], c[N];
+
+// Parallel, constant trip count
+void scale(double s) {
+    for (int i = 0; i < N; i++) {
+        a[i] = s * b[i];
+    }
+}
+
+// Serial - each element needs the one before it
+void running_sum(int n) {
+    for (int i = 1; i < n; i++) {
+        c[i] = c[i - 1] + a[i];
+    }
+}
+
+// Nest whose inner loop calls printf
+void dump(int rows, int cols) {
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            printf("%f\n", a[i * cols + j]);
+        }
+    }
+}
+
+int main() {
+    scale(2.0);
+    running_sum(N);
+    dump(4, 8);
+    return 0;
+}
@@ -0,0 +1,84 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
+#include <stdio.h>
+
+#define N 1024
+
+// Run with --format=json or --format=sarif; stdout is then only the report
+
+double a[N], b[N], c[N];
+
+// Parallel, constant trip count
+void scale(double s) {
+    #pragma omp parallel for simd simdlen(4) if(N > 6668) num_threads(N <= 6668 ? 1 : N / 3334 < omp_get_max_threads() ? N / 3334 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < N; i++) {
+        a[i] = s * b[i];
+    }
+}
+
+// Serial - each element needs the one before it
+void running_sum(int n) {
+    double c_scan = c[0];
+#if _OPENMP >= 201811
+    #pragma omp parallel for reduction(inscan, +:c_scan) if((n - 1) > 5000) num_threads((n - 1) <= 5000 ? 1 : (n - 1) / 2500 < omp_get_max_threads() ? (n - 1) / 2500 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 1; i < n; i++) {
+        c_scan += a[i];
+        #pragma omp scan inclusive(c_scan)
+        c[i] = c_scan;
+    }
+#else
+    {
+        long scan_chunk = ((long)(n) - (long)(1) + 63) / 64;
+        double scan_total[64 + 1];
+        scan_total[0] = c_scan;
+        #pragma omp parallel for
+        for (int scan_block = 0; scan_block < 64; scan_block++)
+        {
+            long scan_lo = (long)(1) + scan_block * scan_chunk;
+            long scan_hi = scan_lo + scan_chunk < (long)(n) ? scan_lo + scan_chunk : (long)(n);
+            double c_scan = 0;
+            for (int i = scan_lo; i < scan_hi; i++)
+            {
+                c_scan += a[i];
+            }
+            scan_total[scan_block + 1] = c_scan;
+        }
+        for (int scan_block = 0; scan_block < 64; scan_block++)
+        {
+            scan_total[scan_block + 1] = scan_total[scan_block] + scan_total[scan_block + 1];
+        }
+        #pragma omp parallel for
+        for (int scan_block = 0; scan_block < 64; scan_block++)
+        {
+            long scan_lo = (long)(1) + scan_block * scan_chunk;
+            long scan_hi = scan_lo + scan_chunk < (long)(n) ? scan_lo + scan_chunk : (long)(n);
+            double c_scan = scan_total[scan_block];
+            for (int i = scan_lo; i < scan_hi; i++)
+            {
+                c_scan += a[i];
+                c[i] = c_scan;
+            }
+        }
+        c_scan = scan_total[64];
+    }
+#endif
+}
+
+// Nest whose inner loop calls printf
+void dump(int rows, int cols) {
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            printf("%f\n", a[i * cols + j]);
+        }
+    }
+}
+
+int main() {
+    scale(2.0);
+    running_sum(N);
+    dump(4, 8);
+    return 0;
+}
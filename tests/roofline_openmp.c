@@ -0,0 +1,65 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
+#include <stdio.h>
+
+#define N 2000000
+#define M 1024
+
+// 2 flops per 32 bytes - memory-bound, threads stop helping once bandwidth is full
+void triad(double* a, double* b, double* c, double s) {
+    #pragma omp parallel for simd simdlen(4) if(N > 5000) num_threads(N <= 5000 ? 1 : N / 2500 < omp_get_max_threads() ? N / 2500 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < N; i++) {
+        a[i] = b[i] + s * c[i];
+    }
+}
+
+// Neighbours share lines - b counts once, not three times
+void stencil(double* a, double* b) {
+    #pragma omp parallel for simd simdlen(4) if(((N - 1) - 1) > 2668) num_threads(((N - 1) - 1) <= 2668 ? 1 : ((N - 1) - 1) / 1334 < omp_get_max_threads() ? ((N - 1) - 1) / 1334 : omp_get_max_threads()) proc_bind(close)
+    for (int i = 1; i < N - 1; i++) {
+        a[i] = 0.25 * b[i - 1] + 0.5 * b[i] + 0.25 * b[i + 1];
+    }
+}
+
+// x is reused from cache on every row, only m streams from memory
+void matvec(double m[M][M], double* x, double* y) {
+    #pragma omp parallel for if(M > 6) num_threads(M <= 6 ? 1 : M / 3 < omp_get_max_threads() ? M / 3 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < M; i++) {
+        double sum = 0.0;
+        for (int j = 0; j < M; j++) {
+            sum += m[i][j] * x[j];
+        }
+        y[i] = sum;
+    }
+}
+
+// Long polynomial per element - compute-bound, scales with every core
+void horner(double* x, double* y) {
+    #pragma omp parallel for simd simdlen(4) if(N > 2224) num_threads(N <= 2224 ? 1 : N / 1112 < omp_get_max_threads() ? N / 1112 : omp_get_max_threads()) proc_bind(close)
+    for (int i = 0; i < N; i++) {
+        double v = x[i];
+        y[i] = ((((((v * 0.1 + 0.2) * v + 0.3) * v + 0.4) * v + 0.5) * v + 0.6) * v + 0.7) * v;
+    }
+}
+
+int main() {
+    static double a[N], b[N], c[N], y[M];
+    static double m[M][M], x[M];
+
+    #pragma omp parallel for simd simdlen(4) if(N > 5716) num_threads(N <= 5716 ? 1 : N / 2858 < omp_get_max_threads() ? N / 2858 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < N; i++) {
+        b[i] = i * 0.5;
+        c[i] = 1.0;
+    }
+
+    triad(a, b, c, 3.0);
+    stencil(c, a);
+    matvec(m, x, y);
+    horner(b, a);
+
+    printf("%f %f %f\n", a[N - 1], c[N - 2], y[M - 1]);
+    return 0;
+}
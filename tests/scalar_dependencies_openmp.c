@@ -1,3 +1,8 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
 #include <stdio.h>
 
 // Basic dependency - should be unsafe
@@ -15,7 +20,7 @@ void test_accumulator() {
 void test_simple_safe() {
     int arr[100];
     
-    #pragma omp parallel for simd
+    #pragma omp parallel for simd simdlen(8) if(100 > 8000) num_threads(100 <= 8000 ? 1 : 100 / 4000 < omp_get_max_threads() ? 100 / 4000 : omp_get_max_threads()) proc_bind(close)
     for (int i = 0; i < 100; i++) {
         arr[i] = i * 2;  // just using loop variable
     }
@@ -25,7 +30,7 @@ void test_simple_safe() {
 void test_local_var() {
     int results[60];
     
-    #pragma omp parallel for simd
+    #pragma omp parallel for simd simdlen(8) if(60 > 6668) num_threads(60 <= 6668 ? 1 : 60 / 3334 < omp_get_max_threads() ? 60 / 3334 : omp_get_max_threads()) proc_bind(close)
     for (int i = 0; i < 60; i++) {
         int temp = i * 3;
         results[i] = temp + 1;  // temp is local each iteration
@@ -49,7 +54,7 @@ void test_read_only() {
     int source[80], output[80];
     int multiplier = 5;
     
-    #pragma omp parallel for simd
+    #pragma omp parallel for simd simdlen(8) if(80 > 6668) num_threads(80 <= 6668 ? 1 : 80 / 3334 < omp_get_max_threads() ? 80 / 3334 : omp_get_max_threads()) proc_bind(spread)
     for (int i = 0; i < 80; i++) {
         output[i] = source[i] * multiplier;  // multiplier never changes
     }
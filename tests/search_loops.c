@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <string.h>
+
+#define N 100000
+
+// First index holding key - search loop, parallel for + cancel
+int find_index(int* a, int n, int key) {
+    int found = -1;
+    for (int i = 0; i < n; i++) {
+        if (a[i] == key) {
+            found = i;
+            break;
+        }
+    }
+    return found;
+}
+
+// size_t counter - the lowest match is tracked as size_t too, no sign-compare warnings
+size_t find_byte(const unsigned char* buf, size_t len, unsigned char byte) {
+    size_t at = len;
+    for (size_t i = 0; i < len; i++) {
+        if (buf[i] == byte) {
+            at = i;
+            break;
+        }
+    }
+    return at;
+}
+
+// Return on first match - search loop
+int find_name(const char** names, int n, const char* key) {
+    for (int i = 0; i < n; i++) {
+        if (strcmp(names[i], key) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Existence check with the counter declared outside - search loop, counter is lastprivate
+int contains_negative(double* v, int n) {
+    int i;
+    int any = 0;
+    for (i = 0; i < n; i++) {
+        if (v[i] < 0.0) {
+            any = 1;
+            break;
+        }
+    }
+    return any;
+}
+
+// Work before the exit - not a pure search, unsafe
+int sum_until_zero(int* a, int n) {
+    int total = 0;
+    for (int i = 0; i < n; i++) {
+        if (a[i] == 0) {
+            break;
+        }
+        total += a[i];
+    }
+    return total;
+}
+
+// Break inside a switch only leaves the switch - no early exit
+void classify(int* a, int* out, int n) {
+    for (int i = 0; i < n; i++) {
+        switch (a[i] % 3) {
+        case 0:
+            out[i] = 1;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+// Return from the inner loop leaves both loops - outer stays serial, inner is a search
+int find_pair(int* a, int n, int target) {
+    for (int i = 0; i < n; i++) {
+        for (int j = i + 1; j < n; j++) {
+            if (a[i] + a[j] == target) {
+                return i * n + j;
+            }
+        }
+    }
+    return -1;
+}
+
+int main() {
+    static int a[N];
+    static double v[N];
+    static int out[N];
+    const char* names[3] = {"alpha", "beta", "gamma"};
+
+    for (int i = 0; i < N; i++) {
+        a[i] = i % 1000;
+        v[i] = i - 50.0;
+    }
+
+    printf("%d\n", find_index(a, N, 999));
+    printf("%zu\n", find_byte((const unsigned char*)"paralyze", 8, 'l'));
+    printf("%d\n", find_name(names, 3, "beta"));
+    printf("%d\n", contains_negative(v, N));
+    printf("%d\n", sum_until_zero(a, N));
+    classify(a, out, N);
+    printf("%d\n", find_pair(a, 100, 150));
+    return 0;
+}
@@ -0,0 +1,253 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
+#include <stdio.h>
+#include <string.h>
+
+#define N 100000
+
+// First index holding key - search loop, parallel for + cancel
+int find_index(int* a, int n, int key) {
+    int found = -1;
+    // threads past the lowest match stop early with OMP_CANCELLATION=true
+    int pz_hit_9 = 0;
+    int pz_first_9 = 0;
+    #pragma omp parallel for if(n > 8000) num_threads(n <= 8000 ? 1 : n / 4000 < omp_get_max_threads() ? n / 4000 : omp_get_max_threads()) proc_bind(spread) schedule(static)
+    for (int i = 0; i < n; i++) {
+        int pz_seen_9;
+        #pragma omp atomic read seq_cst
+        pz_seen_9 = pz_hit_9;
+        if (pz_seen_9) {
+            int pz_low_9;
+            #pragma omp atomic read
+            pz_low_9 = pz_first_9;
+            if (pz_low_9 < i) {
+                #pragma omp cancellation point for
+            }
+        }
+        if (a[i] == key) {
+            #pragma omp critical
+            {
+                if (!pz_hit_9 || i < pz_first_9) {
+                    #pragma omp atomic write
+                    pz_first_9 = i;
+                }
+                #pragma omp atomic write seq_cst
+                pz_hit_9 = 1;
+            }
+            #pragma omp cancel for
+        }
+    }
+    if (pz_hit_9) {
+        int i = pz_first_9;
+        found = i;
+    }
+    return found;
+}
+
+// size_t counter - the lowest match is tracked as size_t too, no sign-compare warnings
+size_t find_byte(const unsigned char* buf, size_t len, unsigned char byte) {
+    size_t at = len;
+    // threads past the lowest match stop early with OMP_CANCELLATION=true
+    int pz_hit_21 = 0;
+    size_t pz_first_21 = 0;
+    #pragma omp parallel for if(len > 8000) num_threads(len <= 8000 ? 1 : len / 4000 < omp_get_max_threads() ? len / 4000 : omp_get_max_threads()) proc_bind(spread) schedule(static)
+    for (size_t i = 0; i < len; i++) {
+        int pz_seen_21;
+        #pragma omp atomic read seq_cst
+        pz_seen_21 = pz_hit_21;
+        if (pz_seen_21) {
+            size_t pz_low_21;
+            #pragma omp atomic read
+            pz_low_21 = pz_first_21;
+            if (pz_low_21 < i) {
+                #pragma omp cancellation point for
+            }
+        }
+        if (buf[i] == byte) {
+            #pragma omp critical
+            {
+                if (!pz_hit_21 || i < pz_first_21) {
+                    #pragma omp atomic write
+                    pz_first_21 = i;
+                }
+                #pragma omp atomic write seq_cst
+                pz_hit_21 = 1;
+            }
+            #pragma omp cancel for
+        }
+    }
+    if (pz_hit_21) {
+        size_t i = pz_first_21;
+        at = i;
+    }
+    return at;
+}
+
+// Return on first match - search loop
+int find_name(const char** names, int n, const char* key) {
+    // threads past the lowest match stop early with OMP_CANCELLATION=true
+    int pz_hit_32 = 0;
+    int pz_first_32 = 0;
+    #pragma omp parallel for if(n > 2858) num_threads(n <= 2858 ? 1 : n / 1429 < omp_get_max_threads() ? n / 1429 : omp_get_max_threads()) proc_bind(close) schedule(static)
+    for (int i = 0; i < n; i++) {
+        int pz_seen_32;
+        #pragma omp atomic read seq_cst
+        pz_seen_32 = pz_hit_32;
+        if (pz_seen_32) {
+            int pz_low_32;
+            #pragma omp atomic read
+            pz_low_32 = pz_first_32;
+            if (pz_low_32 < i) {
+                #pragma omp cancellation point for
+            }
+        }
+        if (strcmp(names[i], key) == 0) {
+            #pragma omp critical
+            {
+                if (!pz_hit_32 || i < pz_first_32) {
+                    #pragma omp atomic write
+                    pz_first_32 = i;
+                }
+                #pragma omp atomic write seq_cst
+                pz_hit_32 = 1;
+            }
+            #pragma omp cancel for
+        }
+    }
+    if (pz_hit_32) {
+        int i = pz_first_32;
+        return i;
+    }
+    return -1;
+}
+
+// Existence check with the counter declared outside - search loop, counter is lastprivate
+int contains_negative(double* v, int n) {
+    int i;
+    int any = 0;
+    // threads past the lowest match stop early with OMP_CANCELLATION=true
+    int pz_hit_44 = 0;
+    int pz_first_44 = 0;
+    #pragma omp parallel for if(n > 6668) num_threads(n <= 6668 ? 1 : n / 3334 < omp_get_max_threads() ? n / 3334 : omp_get_max_threads()) proc_bind(spread) schedule(static) lastprivate(i)
+    for (i = 0; i < n; i++) {
+        int pz_seen_44;
+        #pragma omp atomic read seq_cst
+        pz_seen_44 = pz_hit_44;
+        if (pz_seen_44) {
+            int pz_low_44;
+            #pragma omp atomic read
+            pz_low_44 = pz_first_44;
+            if (pz_low_44 < i) {
+                #pragma omp cancellation point for
+            }
+        }
+        if (v[i] < 0.0) {
+            #pragma omp critical
+            {
+                if (!pz_hit_44 || i < pz_first_44) {
+                    #pragma omp atomic write
+                    pz_first_44 = i;
+                }
+                #pragma omp atomic write seq_cst
+                pz_hit_44 = 1;
+            }
+            #pragma omp cancel for
+        }
+    }
+    if (pz_hit_44) {
+        i = pz_first_44;
+        any = 1;
+    }
+    return any;
+}
+
+// Work before the exit - not a pure search, unsafe
+int sum_until_zero(int* a, int n) {
+    int total = 0;
+    for (int i = 0; i < n; i++) {
+        if (a[i] == 0) {
+            break;
+        }
+        total += a[i];
+    }
+    return total;
+}
+
+// Break inside a switch only leaves the switch - no early exit
+void classify(int* a, int* out, int n) {
+    #pragma omp parallel for if(n > 6668) num_threads(n <= 6668 ? 1 : n / 3334 < omp_get_max_threads() ? n / 3334 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < n; i++) {
+        switch (a[i] % 3) {
+        case 0:
+            out[i] = 1;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+// Return from the inner loop leaves both loops - outer stays serial, inner is a search
+int find_pair(int* a, int n, int target) {
+    for (int i = 0; i < n; i++) {
+        // threads past the lowest match stop early with OMP_CANCELLATION=true
+        int pz_hit_81 = 0;
+        int pz_first_81 = 0;
+        #pragma omp parallel for if((n - (i + 1)) > 4446) num_threads((n - (i + 1)) <= 4446 ? 1 : (n - (i + 1)) / 2223 < omp_get_max_threads() ? (n - (i + 1)) / 2223 : omp_get_max_threads()) proc_bind(close) schedule(static)
+        for (int j = i + 1; j < n; j++) {
+            int pz_seen_81;
+            #pragma omp atomic read seq_cst
+            pz_seen_81 = pz_hit_81;
+            if (pz_seen_81) {
+                int pz_low_81;
+                #pragma omp atomic read
+                pz_low_81 = pz_first_81;
+                if (pz_low_81 < j) {
+                    #pragma omp cancellation point for
+                }
+            }
+            if (a[i] + a[j] == target) {
+                #pragma omp critical
+                {
+                    if (!pz_hit_81 || j < pz_first_81) {
+                        #pragma omp atomic write
+                        pz_first_81 = j;
+                    }
+                    #pragma omp atomic write seq_cst
+                    pz_hit_81 = 1;
+                }
+                #pragma omp cancel for
+            }
+        }
+        if (pz_hit_81) {
+            int j = pz_first_81;
+            return i * n + j;
+        }
+    }
+    return -1;
+}
+
+int main() {
+    static int a[N];
+    static double v[N];
+    static int out[N];
+    const char* names[3] = {"alpha", "beta", "gamma"};
+
+    #pragma omp parallel for simd simdlen(4) if(N > 5000) num_threads(N <= 5000 ? 1 : N / 2500 < omp_get_max_threads() ? N / 2500 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < N; i++) {
+        a[i] = i % 1000;
+        v[i] = i - 50.0;
+    }
+
+    printf("%d\n", find_index(a, N, 999));
+    printf("%zu\n", find_byte((const unsigned char*)"paralyze", 8, 'l'));
+    printf("%d\n", find_name(names, 3, "beta"));
+    printf("%d\n", contains_negative(v, N));
+    printf("%d\n", sum_until_zero(a, N));
+    classify(a, out, N);
+    printf("%d\n", find_pair(a, 100, 150));
+    return 0;
+}
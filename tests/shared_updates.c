@@ -0,0 +1,78 @@
+#include <stdio.h>
+
+#define N 4096
+#define TAPS 256
+
+// Heavy filter per output, rare counter bump - atomic around hits++
+int count_hits(double* in, double* w, double* out, double threshold) {
+    int hits = 0;
+    for (int i = 0; i < N - TAPS; i++) {
+        double acc = 0.0;
+        for (int k = 0; k < TAPS; k++) {
+            acc += in[i + k] * w[k];
+        }
+        out[i] = acc;
+        if (acc > threshold) {
+            hits++;
+        }
+    }
+    return hits;
+}
+
+// Running maximum behind a compare - critical around the if
+double peak_response(double* in, double* w, double* out) {
+    double best = -1.0e30;
+    for (int i = 0; i < N - TAPS; i++) {
+        double acc = 0.0;
+        for (int k = 0; k < TAPS; k++) {
+            acc += in[i + k] * w[k];
+        }
+        out[i] = acc;
+        if (acc > best) best = acc;
+    }
+    return best;
+}
+
+// Flag set to a constant - atomic write
+int any_negative(double* in, double* w, double* out) {
+    int found = 0;
+    for (int i = 0; i < N - TAPS; i++) {
+        double acc = 0.0;
+        for (int k = 0; k < TAPS; k++) {
+            acc += in[i + k] * w[k];
+        }
+        out[i] = acc;
+        if (acc < 0.0) {
+            found = 1;
+        }
+    }
+    return found;
+}
+
+// Nothing else to do per iteration, the atomic would dominate - stays serial
+double plain_sum(double* a) {
+    double sum = 0.0;
+    for (int i = 0; i < N; i++) {
+        sum += a[i];
+    }
+    return sum;
+}
+
+int main() {
+    static double in[N], w[TAPS], out[N];
+
+    for (int i = 0; i < N; i++) {
+        in[i] = (i % 17) - 8.0;
+    }
+    for (int k = 0; k < TAPS; k++) {
+        w[k] = 1.0 / (k + 1);
+    }
+
+    int hits = count_hits(in, w, out, 1.0);
+    double best = peak_response(in, w, out);
+    int found = any_negative(in, w, out);
+    double sum = plain_sum(in);
+
+    printf("%d %f %d %f\n", hits, best, found, sum);
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <math.h>
+#include <stdio.h>
+
+#define N 100000
+
+static double grid[N] __attribute__((aligned(64)));
+
+// Unit-stride arithmetic - parallel for simd simdlen(4)
+void saxpy(double a, double* x, double* y, double* z) {
+    for (int i = 0; i < N; i++) {
+        z[i] = a * x[i] + y[i];
+    }
+}
+
+// Gather through an index array - parallel for, no simd
+void gather(double* x, double* y, int* idx) {
+    for (int i = 0; i < N; i++) {
+        int k = idx[i];
+        y[i] = x[k] + x[k + 1] + x[k + 2];
+    }
+}
+
+// Too many masked arms to pay off - parallel for, no simd
+void classify(double* x, int* neg, int* big, int* half) {
+    for (int i = 0; i < N; i++) {
+        if (x[i] < 0.0) {
+            neg[i] = 1;
+        }
+        if (x[i] > 1.0) {
+            big[i] = 1;
+        }
+        if (x[i] == 0.5) {
+            half[i] = 1;
+        }
+    }
+}
+
+// Declared 64-byte alignment - aligned(grid:64), sqrt has a vector variant
+void smooth(float* out) {
+    for (int i = 0; i < N; i++) {
+        out[i] = (float)sqrt(grid[i]);
+    }
+}
+
+// Recurrence four iterations back - simd safelen(4), no parallel for
+void lagged(double* a, double c) {
+    for (int i = 4; i < N; i++) {
+        a[i] = a[i - 4] * c;
+    }
+}
+
+// Same recurrence, but *scale may point into a - no pragma
+void lagged_scaled(double* a, double* scale) {
+    for (int i = 4; i < N; i++) {
+        a[i] = a[i - 4] * *scale;
+    }
+}
+
+// Hand-rolled output counter - linear(j:1)
+void copy_out(double* in, double* out) {
+    int j = 0;
+    for (int i = 0; i < N; i++) {
+        out[j] = in[i] * 2.0;
+        j++;
+    }
+}
+
+int main() {
+    static double x[N], y[N], z[N], a[N], out[N];
+    static float f[N];
+    static int idx[N], neg[N], big[N], half[N];
+
+    for (int i = 0; i < N; i++) {
+        x[i] = i * 0.5;
+        idx[i] = (i * 7) % (N - 2);
+        grid[i] = i;
+        a[i] = 1.0;
+    }
+
+    saxpy(2.0, x, y, z);
+    gather(x, y, idx);
+    classify(x, neg, big, half);
+    smooth(f);
+    lagged(a, 1.0001);
+    lagged_scaled(a, &y[0]);
+    copy_out(x, out);
+
+    printf("%f %d %f %f %f\n", z[N - 1], big[N - 1], f[N - 1], a[N - 1], out[N - 1]);
+    return 0;
+}
@@ -0,0 +1,102 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
+#include <math.h>
+#include <stdio.h>
+
+#define N 100000
+
+static double grid[N] __attribute__((aligned(64)));
+
+// Unit-stride arithmetic - parallel for simd simdlen(4)
+void saxpy(double a, double* x, double* y, double* z) {
+    #pragma omp parallel for simd simdlen(4) if(N > 5000) num_threads(N <= 5000 ? 1 : N / 2500 < omp_get_max_threads() ? N / 2500 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < N; i++) {
+        z[i] = a * x[i] + y[i];
+    }
+}
+
+// Gather through an index array - parallel for, no simd
+void gather(double* x, double* y, int* idx) {
+    #pragma omp parallel for if(N > 3334) num_threads(N <= 3334 ? 1 : N / 1667 < omp_get_max_threads() ? N / 1667 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < N; i++) {
+        int k = idx[i];
+        y[i] = x[k] + x[k + 1] + x[k + 2];
+    }
+}
+
+// Too many masked arms to pay off - parallel for, no simd
+void classify(double* x, int* neg, int* big, int* half) {
+    #pragma omp parallel for if(N > 2858) num_threads(N <= 2858 ? 1 : N / 1429 < omp_get_max_threads() ? N / 1429 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < N; i++) {
+        if (x[i] < 0.0) {
+            neg[i] = 1;
+        }
+        if (x[i] > 1.0) {
+            big[i] = 1;
+        }
+        if (x[i] == 0.5) {
+            half[i] = 1;
+        }
+    }
+}
+
+// Declared 64-byte alignment - aligned(grid:64), sqrt has a vector variant
+void smooth(float* out) {
+    #pragma omp parallel for simd simdlen(4) aligned(grid:64) if(N > 2668) num_threads(N <= 2668 ? 1 : N / 1334 < omp_get_max_threads() ? N / 1334 : omp_get_max_threads()) proc_bind(close)
+    for (int i = 0; i < N; i++) {
+        out[i] = (float)sqrt(grid[i]);
+    }
+}
+
+// Recurrence four iterations back - simd safelen(4), no parallel for
+void lagged(double* a, double c) {
+    #pragma omp simd simdlen(4) safelen(4)
+    for (int i = 4; i < N; i++) {
+        a[i] = a[i - 4] * c;
+    }
+}
+
+// Same recurrence, but *scale may point into a - no pragma
+void lagged_scaled(double* a, double* scale) {
+    for (int i = 4; i < N; i++) {
+        a[i] = a[i - 4] * *scale;
+    }
+}
+
+// Hand-rolled output counter - linear(j:1)
+void copy_out(double* in, double* out) {
+    int j = 0;
+    #pragma omp parallel for simd simdlen(4) linear(j:1) if(N > 5716) num_threads(N <= 5716 ? 1 : N / 2858 < omp_get_max_threads() ? N / 2858 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < N; i++) {
+        out[j] = in[i] * 2.0;
+        j++;
+    }
+}
+
+int main() {
+    static double x[N], y[N], z[N], a[N], out[N];
+    static float f[N];
+    static int idx[N], neg[N], big[N], half[N];
+
+    #pragma omp parallel for simd simdlen(4) aligned(grid:64) if(N > 2858) num_threads(N <= 2858 ? 1 : N / 1429 < omp_get_max_threads() ? N / 1429 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < N; i++) {
+        x[i] = i * 0.5;
+        idx[i] = (i * 7) % (N - 2);
+        grid[i] = i;
+        a[i] = 1.0;
+    }
+
+    saxpy(2.0, x, y, z);
+    gather(x, y, idx);
+    classify(x, neg, big, half);
+    smooth(f);
+    lagged(a, 1.0001);
+    lagged_scaled(a, &y[0]);
+    copy_out(x, out);
+
+    printf("%f %d %f %f %f\n", z[N - 1], big[N - 1], f[N - 1], a[N - 1], out[N - 1]);
+    return 0;
+}
@@ -1,3 +1,8 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
 #include <stdio.h>
 
 int main() {
@@ -6,13 +11,12 @@ int main() {
     int sum = 0;
     
     // Simple for loop
-    #pragma omp parallel for simd
+    #pragma omp parallel for simd simdlen(8) if(100 > 6668) num_threads(100 <= 6668 ? 1 : 100 / 3334 < omp_get_max_threads() ? 100 / 3334 : omp_get_max_threads()) proc_bind(close)
     for (i = 0; i < 100; i++) {
         arr[i] = i * 2;
     }
     
     // Nested for loops
-    #pragma omp parallel for
     for (i = 0; i < 10; i++) {
         for (j = 0; j < 10; j++) {
             sum += i + j;
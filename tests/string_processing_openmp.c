@@ -1,3 +1,8 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
@@ -8,14 +13,13 @@ void process_text() {
     int len = strlen(text);
     
     // Character transformation - should be safe
-    #pragma omp parallel for
+    #pragma omp parallel for if(len > 2668) num_threads(len <= 2668 ? 1 : len / 1334 < omp_get_max_threads() ? len / 1334 : omp_get_max_threads()) proc_bind(close)
     for (int i = 0; i < len; i++) {
         processed[i] = toupper(text[i]);
     }
     
     // Character counting - unsafe
     int vowels = 0;
-    #pragma omp parallel for
     for (int i = 0; i < len; i++) {
         char c = tolower(text[i]);
         if (c == 'a' || c == 'e' || c == 'i' || c == 'o' || c == 'u') {
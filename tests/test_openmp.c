@@ -1,7 +1,12 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
 void simple_test() {
     int arr[10];
     int i;
-    #pragma omp parallel for simd
+    #pragma omp parallel for simd simdlen(8) if(10 > 8000) num_threads(10 <= 8000 ? 1 : 10 / 4000 < omp_get_max_threads() ? 10 / 4000 : omp_get_max_threads()) proc_bind(spread)
     for (i = 0; i < 10; i++) {
         arr[i] = i;
     }
@@ -0,0 +1,51 @@
+#include <stdio.h>
+
+#define NX 64
+#define NY 64
+
+// Tiny fixed-size kernel - if(NX > ...) keeps it serial unless NX is rebuilt larger
+void atax_like(double A[NX][NY], double* x, double* tmp) {
+    for (int i = 0; i < NX; i++) {
+        tmp[i] = 0.0;
+        for (int j = 0; j < NY; j++) {
+            tmp[i] = tmp[i] + A[i][j] * x[j];
+        }
+    }
+}
+
+// Runtime bound - the team grows with n up to omp_get_max_threads()
+void scale(double* out, double* v, double s, int n) {
+    for (int i = 1; i < n - 1; i++) {
+        out[i] = v[i] * s;
+    }
+}
+
+// Strided runtime bound - trip count (n + 1) / 2
+void every_other(double* v, int n) {
+    for (int i = 0; i < n; i += 2) {
+        v[i] = 0.0;
+    }
+}
+
+// Large literal bound - always worth a team, no guard
+void clear(double* v) {
+    for (int i = 0; i < 100000000; i++) {
+        v[i] = 0.0;
+    }
+}
+
+int main() {
+    static double A[NX][NY], x[NY], tmp[NX];
+    static double v[1000], w[1000];
+
+    for (int i = 0; i < NY; i++) {
+        x[i] = 1.0;
+    }
+
+    atax_like(A, x, tmp);
+    scale(w, v, 2.0, 1000);
+    every_other(v, 1000);
+
+    printf("%f %f\n", tmp[0], w[1]);
+    return 0;
+}
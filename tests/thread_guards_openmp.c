@@ -0,0 +1,61 @@
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
+#include <stdio.h>
+
+#define NX 64
+#define NY 64
+
+// Tiny fixed-size kernel - if(NX > ...) keeps it serial unless NX is rebuilt larger
+void atax_like(double A[NX][NY], double* x, double* tmp) {
+    #pragma omp parallel for if(NX > 64) num_threads(NX <= 64 ? 1 : NX / 32 < omp_get_max_threads() ? NX / 32 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < NX; i++) {
+        tmp[i] = 0.0;
+        for (int j = 0; j < NY; j++) {
+            tmp[i] = tmp[i] + A[i][j] * x[j];
+        }
+    }
+}
+
+// Runtime bound - the team grows with n up to omp_get_max_threads()
+void scale(double* out, double* v, double s, int n) {
+    #pragma omp parallel for simd simdlen(4) if(((n - 1) - 1) > 5716) num_threads(((n - 1) - 1) <= 5716 ? 1 : ((n - 1) - 1) / 2858 < omp_get_max_threads() ? ((n - 1) - 1) / 2858 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 1; i < n - 1; i++) {
+        out[i] = v[i] * s;
+    }
+}
+
+// Strided runtime bound - trip count (n + 1) / 2
+void every_other(double* v, int n) {
+    #pragma omp parallel for if(((n + 1) / 2) > 10000) num_threads(((n + 1) / 2) <= 10000 ? 1 : ((n + 1) / 2) / 5000 < omp_get_max_threads() ? ((n + 1) / 2) / 5000 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < n; i += 2) {
+        v[i] = 0.0;
+    }
+}
+
+// Large literal bound - always worth a team, no guard
+void clear(double* v) {
+    #pragma omp parallel for simd simdlen(4) proc_bind(spread)
+    for (int i = 0; i < 100000000; i++) {
+        v[i] = 0.0;
+    }
+}
+
+int main() {
+    static double A[NX][NY], x[NY], tmp[NX];
+    static double v[1000], w[1000];
+
+    #pragma omp parallel for simd simdlen(4) if(NY > 10000) num_threads(NY <= 10000 ? 1 : NY / 5000 < omp_get_max_threads() ? NY / 5000 : omp_get_max_threads()) proc_bind(spread)
+    for (int i = 0; i < NY; i++) {
+        x[i] = 1.0;
+    }
+
+    atax_like(A, x, tmp);
+    scale(w, v, 2.0, 1000);
+    every_other(v, 1000);
+
+    printf("%f %f\n", tmp[0], w[1]);
+    return 0;
+}